@@ -98,17 +98,20 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 	indigo_property **alignment_properties = DEVICE_PRIVATE_DATA->alignment_point_properties;
 	indigo_device *mount = DEVICE_PRIVATE_DATA->mount;
 	if (mount && alignment_properties) {
-		indigo_alignment_point *alignment_points = ((indigo_mount_context *)(mount->device_context))->alignment_points;
 		for (int i = 0; i < alignment_point_count; i++) {
 			indigo_property *alignment_property = alignment_properties[i];
 			if (indigo_property_match(alignment_property, property)) {
 				indigo_property_copy_values(alignment_property, property, false);
+				pthread_mutex_lock(&((indigo_mount_context *)(mount->device_context))->alignment_mutex);
+				// points are reallocated when the mount adds a point, get them with the mutex locked
+				indigo_alignment_point *alignment_points = ((indigo_mount_context *)(mount->device_context))->alignment_points;
 				alignment_points->ra = AGENT_ALIGNMENT_POINT_RA_ITEM(alignment_property)->number.value;
 				alignment_points->dec = AGENT_ALIGNMENT_POINT_DEC_ITEM(alignment_property)->number.value;
 				alignment_points->raw_ra = AGENT_ALIGNMENT_POINT_RAW_RA_ITEM(alignment_property)->number.value;
 				alignment_points->raw_dec = AGENT_ALIGNMENT_POINT_RAW_DEC_ITEM(alignment_property)->number.value;
 				alignment_points->lst = AGENT_ALIGNMENT_POINT_LST_ITEM(alignment_property)->number.value;
 				alignment_points->side_of_pier = AGENT_ALIGNMENT_POINT_SOP_ITEM(alignment_property)->number.value;
+				pthread_mutex_unlock(&((indigo_mount_context *)(mount->device_context))->alignment_mutex);
 				indigo_mount_update_alignment_points(DEVICE_PRIVATE_DATA->mount);
 				indigo_update_property(device, alignment_property, NULL);
 			}
@@ -153,10 +156,13 @@ static void process_connection_change(indigo_client *client, indigo_device *devi
 			}
 		}
 		if (define) {
+			// copy points, they are reallocated when the mount adds a point
+			pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
 			int alignment_point_count = MOUNT_CONTEXT->alignment_point_count;
+			indigo_alignment_point *points = indigo_safe_malloc_copy(alignment_point_count * sizeof(indigo_alignment_point), MOUNT_CONTEXT->alignment_points);
+			pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
 			indigo_property **alignment_properties = indigo_safe_malloc(alignment_point_count * sizeof(indigo_property *));
 			CLIENT_PRIVATE_DATA->mount = device;
-			indigo_alignment_point *points = MOUNT_CONTEXT->alignment_points;
 			for (int j = 0; j < alignment_point_count; j++) {
 				char name[INDIGO_NAME_SIZE], label[INDIGO_NAME_SIZE];
 				sprintf(name, AGENT_ALIGNMENT_POINT_PROPERY_NAME, j);
@@ -171,6 +177,7 @@ static void process_connection_change(indigo_client *client, indigo_device *devi
 				alignment_properties[j] = alignment_property;
 				indigo_define_property(agent_device, alignment_property, NULL);
 			}
+			free(points);
 			CLIENT_PRIVATE_DATA->alignment_point_count = alignment_point_count;
 			CLIENT_PRIVATE_DATA->alignment_point_properties = alignment_properties;
 		}
@@ -24,6 +24,7 @@
  */
 
 #include <math.h>
+#include <stdarg.h>
 #include <zlib.h>
 
 #include <indigo/indigo_io.h>
@@ -890,9 +891,10 @@ void indigo_alpaca_ccd_update_property(indigo_alpaca_device *alpaca_device, indi
 			for (int i = 0; i < property->count; i++) {
 				indigo_item *item = property->items + i;
 				if (!strcmp(item->name, CCD_IMAGE_ITEM_NAME)) {
-					if (item->blob.value && item->blob.size > 0 && *alpaca_device->ccd.lastexposuretarttime)
+					if (item->blob.value && item->blob.size > 0 && *alpaca_device->ccd.lastexposuretarttime) {
 						alpaca_device->ccd.imageready = item;
-					else
+						alpaca_device->ccd.image_sequence++;
+					} else
 						alpaca_device->ccd.imageready = NULL;
 				}
 			}
@@ -1311,7 +1313,118 @@ long indigo_alpaca_ccd_set_command(indigo_alpaca_device *alpaca_device, int vers
 	return snprintf(buffer, buffer_length, "\"ErrorNumber\": %d, \"ErrorMessage\": \"%s\"", indigo_alpaca_error_NotImplemented, indigo_alpaca_error_string(indigo_alpaca_error_NotImplemented));
 }
 
-#define PRINTF(fmt, ...) if (use_gzip) gzprintf(gzf, fmt, ##__VA_ARGS__); else indigo_printf(socket, fmt, ##__VA_ARGS__);
+#define TRANSPOSE_TILE	64
+
+// Alpaca image arrays are column-major with the bottom row first, columns [col_start, col_end) are transposed to the strip buffer tile by tile to keep both sides in cache
+
+#define TRANSPOSE(name, type) \
+static void name(const type *data, type *buffer, int width, int height, int channels, const int *order, int col_start, int col_end) { \
+	for (int row_start = 0; row_start < height; row_start += TRANSPOSE_TILE) { \
+		int row_end = row_start + TRANSPOSE_TILE < height ? row_start + TRANSPOSE_TILE : height; \
+		for (int row = row_start; row < row_end; row++) { \
+			const type *in = data + ((size_t)row * width + col_start) * channels; \
+			type *out = buffer + (size_t)(height - 1 - row) * channels; \
+			size_t stride = (size_t)height * channels; \
+			if (channels == 1) { \
+				for (int col = col_start; col < col_end; col++, in++, out += stride) \
+					*out = *in; \
+			} else { \
+				for (int col = col_start; col < col_end; col++, in += channels, out += stride) \
+					for (int c = 0; c < channels; c++) \
+						out[c] = in[order[c]]; \
+			} \
+		} \
+	} \
+}
+
+TRANSPOSE(transpose_8, uint8_t)
+TRANSPOSE(transpose_16, uint16_t)
+
+#define JSON_WRITER_BUFFER_SIZE	(1024 * 1024)
+
+typedef struct {
+	int socket;
+	gzFile gzf;
+	char *buffer;
+	char *pnt;
+	char *end;
+	bool failed;
+} json_writer;
+
+static const char digit_pairs[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static void json_writer_flush(json_writer *writer) {
+	long size = writer->pnt - writer->buffer;
+	if (size > 0 && !writer->failed) {
+		if (writer->gzf)
+			writer->failed = gzwrite(writer->gzf, writer->buffer, (unsigned)size) != size;
+		else
+			writer->failed = !indigo_write(writer->socket, writer->buffer, size);
+	}
+	writer->pnt = writer->buffer;
+}
+
+static void json_writer_printf(json_writer *writer, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	int size = vsnprintf(writer->pnt, writer->end - writer->pnt, format, args);
+	va_end(args);
+	if (size >= writer->end - writer->pnt) {
+		json_writer_flush(writer);
+		va_start(args, format);
+		size = vsnprintf(writer->pnt, writer->end - writer->pnt, format, args);
+		va_end(args);
+	}
+	writer->pnt += size;
+}
+
+static inline void json_writer_append_uint(json_writer *writer, uint32_t value) {
+	char digits[10], *pnt = digits + sizeof(digits);
+	while (value >= 100) {
+		pnt -= 2;
+		memcpy(pnt, digit_pairs + 2 * (value % 100), 2);
+		value /= 100;
+	}
+	if (value >= 10) {
+		pnt -= 2;
+		memcpy(pnt, digit_pairs + 2 * value, 2);
+	} else {
+		*--pnt = '0' + value;
+	}
+	long size = digits + sizeof(digits) - pnt;
+	memcpy(writer->pnt, pnt, size);
+	writer->pnt += size;
+}
+
+static void json_writer_append_column(json_writer *writer, const void *column, int height, int channels, int element_size) {
+	// worst case is "[65535,65535,65535]," per pixel
+	for (int i = 0; i < height; i++) {
+		if (writer->end - writer->pnt < 24)
+			json_writer_flush(writer);
+		if (i > 0)
+			*writer->pnt++ = ',';
+		if (channels > 1)
+			*writer->pnt++ = '[';
+		for (int c = 0; c < channels; c++) {
+			if (c > 0)
+				*writer->pnt++ = ',';
+			int index = i * channels + c;
+			json_writer_append_uint(writer, element_size == 1 ? ((const uint8_t *)column)[index] : ((const uint16_t *)column)[index]);
+		}
+		if (channels > 1)
+			*writer->pnt++ = ']';
+	}
+}
 
 void indigo_alpaca_ccd_get_imagearray(indigo_alpaca_device *alpaca_device, int version, int socket, uint32_t client_transaction_id, uint32_t server_transaction_id, bool use_gzip, bool use_imagebytes) {
 	indigo_alpaca_error result = indigo_alpaca_error_OK;
@@ -1328,168 +1441,156 @@ void indigo_alpaca_ccd_get_imagearray(indigo_alpaca_device *alpaca_device, int v
 			indigo_raw_header *header = (indigo_raw_header *)(entry->content);
 			int width = header->width;
 			int height = header->height;
-			int size = width * height;
-			metadata.dimension1 = width;
-			metadata.dimension2 = height;
+			int channels, element_size;
+			static const int mono_order[] = { 0 };
+			static const int rgb24_order[] = { 2, 0, 1 };
+			static const int rgb48_order[] = { 0, 1, 2 };
+			const int *order;
 			switch (header->signature) {
-				case INDIGO_RAW_MONO8: {
-					metadata.dimension3 = 0;
-					metadata.rank = 2;
-					uint8_t *data = entry->content + sizeof(indigo_raw_header);
-					uint32_t *buffer = malloc(size * 4), *pnt = buffer;
-					for (int col = 0; col < width; col++)
-						for (int row = height - 1; row >= 0; row--)
-							*pnt++ = data[row * width + col];
-					indigo_printf(socket, "HTTP/1.1 200 OK\r\nContent-Type: application/imagebytes\r\nContent-Length: %d\r\n\r\n", size * 4); // ASCOM BUG, should be + sizeof(metadata)
-					indigo_write(socket, (const char *)&metadata, sizeof(metadata));
-					indigo_write(socket, (const char *)buffer, size * 4);
+				case INDIGO_RAW_MONO8:
+					channels = 1;
+					element_size = 1;
+					order = mono_order;
 					break;
-				}
-				case INDIGO_RAW_MONO16: {
-					metadata.dimension3 = 0;
-					metadata.rank = 2;
-					uint16_t *data = entry->content + sizeof(indigo_raw_header);
-					uint32_t *buffer = malloc(size * 4), *pnt = buffer;
-					for (int col = 0; col < width; col++)
-						for (int row = height - 1; row >= 0; row--)
-							*pnt++ = data[row * width + col];
-					indigo_printf(socket, "HTTP/1.1 200 OK\r\nContent-Type: application/imagebytes\r\nContent-Length: %d\r\n\r\n", size * 4); // ASCOM BUG, should be + sizeof(metadata)
-					indigo_write(socket, (const char *)&metadata, sizeof(metadata));
-					indigo_write(socket, (const char *)buffer, size * 4);
-					free(buffer);
+				case INDIGO_RAW_MONO16:
+					channels = 1;
+					element_size = 2;
+					order = mono_order;
 					break;
-				}
-				case INDIGO_RAW_RGB24: {
-					metadata.dimension3 = 3;
-					metadata.rank = 3;
-					uint8_t *data = entry->content + sizeof(indigo_raw_header);
-					uint32_t *buffer = malloc(size * 12), *pnt = buffer;
-					for (int col = 0; col < width; col++)
-						for (int row = height - 1; row >= 0; row--) {
-							int base = 3 * (row * width + col);
-							*pnt++ = data[base + 2];
-							*pnt++ = data[base + 0];
-							*pnt++ = data[base + 1];
-						}
-					indigo_printf(socket, "HTTP/1.1 200 OK\r\nContent-Type: application/imagebytes\r\nContent-Length: %d\r\n\r\n", size * 12); // ASCOM BUG, should be + sizeof(metadata)
-					indigo_write(socket, (const char *)&metadata, sizeof(metadata));
-					indigo_write(socket, (const char *)buffer, size * 12);
+				case INDIGO_RAW_RGB24:
+					channels = 3;
+					element_size = 1;
+					order = rgb24_order;
 					break;
-				}
-				case INDIGO_RAW_RGB48: {
-					metadata.dimension3 = 3;
-					metadata.rank = 3;
-					indigo_write(socket, (const char *)&metadata, sizeof(metadata));
-					uint16_t *data = entry->content + sizeof(indigo_raw_header);
-					uint32_t *buffer = malloc(size * 12), *pnt = buffer;
-					for (int col = 0; col < width; col++)
-						for (int row = height - 1; row >= 0; row--) {
-							int base = 3 * (row * width + col);
-							*pnt++ = data[base + 0];
-							*pnt++ = data[base + 1];
-							*pnt++ = data[base + 2];
-						}
-					indigo_printf(socket, "HTTP/1.1 200 OK\r\nContent-Type: application/imagebytes\r\nContent-Length: %d\r\n\r\n", size * 12); // ASCOM BUG, should be + sizeof(metadata)
-					indigo_write(socket, (const char *)&metadata, sizeof(metadata));
-					indigo_write(socket, (const char *)buffer, size * 12);
+				case INDIGO_RAW_RGB48:
+					channels = 3;
+					element_size = 2;
+					order = rgb48_order;
 					break;
+				default:
+					channels = 0;
+					element_size = 0;
+					order = NULL;
+					break;
+			}
+			if (channels) {
+				long size = (long)width * height * channels * element_size;
+				metadata.transmission_element_type = element_size == 1 ? indigo_alpaca_type_byte : indigo_alpaca_type_uint16;
+				metadata.dimension1 = width;
+				metadata.dimension2 = height;
+				metadata.dimension3 = channels == 1 ? 0 : channels;
+				metadata.rank = channels == 1 ? 2 : 3;
+				indigo_printf(socket, "HTTP/1.1 200 OK\r\nContent-Type: application/imagebytes\r\nContent-Length: %ld\r\n\r\n", size); // ASCOM BUG, should be + sizeof(metadata)
+				indigo_write(socket, (const char *)&metadata, sizeof(metadata));
+				if (alpaca_device->ccd.imagebytes_sequence == alpaca_device->ccd.image_sequence && alpaca_device->ccd.imagebytes_size == size) {
+					indigo_write(socket, alpaca_device->ccd.imagebytes, size);
+				} else {
+					if (alpaca_device->ccd.imagebytes_allocated < size) {
+						alpaca_device->ccd.imagebytes = indigo_safe_realloc(alpaca_device->ccd.imagebytes, size);
+						alpaca_device->ccd.imagebytes_allocated = size;
+					}
+					alpaca_device->ccd.imagebytes_size = 0;
+					void *data = entry->content + sizeof(indigo_raw_header);
+					long strip_size = (long)height * channels * element_size;
+					bool written = true;
+					for (int col_start = 0; col_start < width && written; col_start += TRANSPOSE_TILE) {
+						int col_end = col_start + TRANSPOSE_TILE < width ? col_start + TRANSPOSE_TILE : width;
+						void *strip = alpaca_device->ccd.imagebytes + col_start * strip_size;
+						if (element_size == 1)
+							transpose_8(data, strip, width, height, channels, order, col_start, col_end);
+						else
+							transpose_16(data, strip, width, height, channels, order, col_start, col_end);
+						written = indigo_write(socket, strip, (col_end - col_start) * strip_size);
+					}
+					if (written) {
+						alpaca_device->ccd.imagebytes_size = size;
+						alpaca_device->ccd.imagebytes_sequence = alpaca_device->ccd.image_sequence;
+					}
 				}
+			} else {
+				result = indigo_alpaca_error_InvalidOperation;
 			}
 			pthread_mutex_unlock(&entry->mutext);
 		} else {
+			result = indigo_alpaca_error_InvalidOperation;
+		}
+		if (result != indigo_alpaca_error_OK) {
+			const char *message = indigo_alpaca_error_string(result);
 			metadata.error_number = result;
+			indigo_printf(socket, "HTTP/1.1 200 OK\r\nContent-Type: application/imagebytes\r\nContent-Length: %ld\r\n\r\n", (long)strlen(message)); // ASCOM BUG, should be + sizeof(metadata)
 			indigo_write(socket, (const char *)&metadata, sizeof(metadata));
-			indigo_printf(socket, "%s", indigo_alpaca_error_string(result));
+			indigo_printf(socket, "%s", message);
 		}
 	} else {
-		gzFile gzf = NULL;
+		json_writer writer = { socket, NULL };
 		if (use_gzip) {
 			indigo_printf(socket, "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Encoding: gzip\r\n\r\n");
-			gzf = gzdopen(socket, "w");
+			writer.gzf = gzdopen(socket, "w");
+			writer.failed = writer.gzf == NULL;
+			gzbuffer(writer.gzf, JSON_WRITER_BUFFER_SIZE);
+			gzsetparams(writer.gzf, Z_BEST_SPEED, Z_DEFAULT_STRATEGY);
 		} else {
 			indigo_printf(socket, "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n\r\n");
 		}
+		writer.pnt = writer.buffer = indigo_safe_malloc(JSON_WRITER_BUFFER_SIZE);
+		writer.end = writer.buffer + JSON_WRITER_BUFFER_SIZE;
 		if (alpaca_device->ccd.imageready && (entry = indigo_validate_blob(alpaca_device->ccd.imageready))) {
 			pthread_mutex_lock(&entry->mutext);
 			indigo_raw_header *header = (indigo_raw_header *)(entry->content);
 			int width = header->width;
 			int height = header->height;
+			int channels, element_size;
+			static const int rgb_order[] = { 0, 1, 2 };
 			switch (header->signature) {
-				case INDIGO_RAW_MONO8: {
-					PRINTF("{ \"Type\": 2, \"Rank\": 2, \"Value\": [");
-					uint8_t *data = entry->content + sizeof(indigo_raw_header);
-					for (int col = 0; col < width; col++) {
-						if (col == 0) {
-							PRINTF("[");
-						} else {
-							PRINTF(", [");
-						}
-						for (int row = height - 1; row >= 0; row--) {
-							if (row == 0) {
-								PRINTF("%d", data[row * width + col]);
-							} else {
-								PRINTF(", %d", data[row * width + col]);
-							}
-						}
-						PRINTF("]");
-					}
+				case INDIGO_RAW_MONO8:
+					channels = 1;
+					element_size = 1;
 					break;
-				}
-				case INDIGO_RAW_MONO16: {
-					PRINTF("{ \"Type\": 2, \"Rank\": 2, \"Value\": [");
-					uint16_t *data = entry->content + sizeof(indigo_raw_header);
-					for (int col = 0; col < width; col++) {
-						if (col == 0) {
-							PRINTF("[");
-						} else {
-							PRINTF(", [");
-						}
-						for (int row = height - 1; row >= 0; row--) {
-							if (row == 0) {
-								PRINTF("%d", data[row * width + col]);
-							} else {
-								PRINTF(", %d", data[row * width + col]);
-							}
-						}
-						PRINTF("]");
-					}
+				case INDIGO_RAW_MONO16:
+					channels = 1;
+					element_size = 2;
 					break;
-				}
-				case INDIGO_RAW_RGB24: {
-					PRINTF("{ \"Type\": 2, \"Rank\": 3, \"Value\": [");
-					uint8_t *data = entry->content + sizeof(indigo_raw_header);
-					for (int col = 0; col < width; col++) {
-						if (col == 0) {
-							PRINTF("[");
-						} else {
-							PRINTF(", [");
-						}
-						for (int row = height - 1; row >= 0; row--) {
-							int base = 3 * (row * width + col);
-							int r = data[base + 0];
-							int g = data[base + 1];
-							int b = data[base + 2];
-							if (row == 0) {
-								PRINTF("[%d,%d,%d]", r, g, b);
-							} else {
-								PRINTF(",[%d,%d,%d]", r, g, b);
-							}
-						}
-						PRINTF("]");
-					}
+				case INDIGO_RAW_RGB24:
+					channels = 3;
+					element_size = 1;
+					break;
+				case INDIGO_RAW_RGB48:
+					channels = 3;
+					element_size = 2;
 					break;
-				}
 				default:
-					PRINTF("{ \"Type\": 2, \"Rank\": 2, \"Value\": [");
+					channels = 0;
+					element_size = 0;
 					break;
 			}
+			json_writer_printf(&writer, "{ \"Type\": 2, \"Rank\": %d, \"Value\": [", channels == 3 ? 3 : 2);
+			if (channels) {
+				void *data = entry->content + sizeof(indigo_raw_header);
+				long column_size = (long)height * channels * element_size;
+				void *strip = indigo_safe_malloc(TRANSPOSE_TILE * column_size);
+				for (int col_start = 0; col_start < width && !writer.failed; col_start += TRANSPOSE_TILE) {
+					int col_end = col_start + TRANSPOSE_TILE < width ? col_start + TRANSPOSE_TILE : width;
+					if (element_size == 1)
+						transpose_8(data, strip, width, height, channels, rgb_order, col_start, col_end);
+					else
+						transpose_16(data, strip, width, height, channels, rgb_order, col_start, col_end);
+					for (int col = col_start; col < col_end; col++) {
+						json_writer_printf(&writer, col == 0 ? "[" : ",[");
+						json_writer_append_column(&writer, strip + (col - col_start) * column_size, height, channels, element_size);
+						json_writer_printf(&writer, "]");
+					}
+				}
+				free(strip);
+			}
 			pthread_mutex_unlock(&entry->mutext);
 		} else {
-			PRINTF("{ \"Type\": 2, \"Rank\": 2, \"Value\": [");
+			json_writer_printf(&writer, "{ \"Type\": 2, \"Rank\": 2, \"Value\": [");
 			result = indigo_alpaca_error_InvalidOperation;
 		}
-		PRINTF("], \"ErrorNumber\": %d, \"ErrorMessage\": \"%s\", \"ClientTransactionID\": %u, \"ServerTransactionID\": %u }", result, indigo_alpaca_error_string(result), client_transaction_id, server_transaction_id);
+		json_writer_printf(&writer, "], \"ErrorNumber\": %d, \"ErrorMessage\": \"%s\", \"ClientTransactionID\": %u, \"ServerTransactionID\": %u }", result, indigo_alpaca_error_string(result), client_transaction_id, server_transaction_id);
+		json_writer_flush(&writer);
+		free(writer.buffer);
 		if (use_gzip)
-			gzclose(gzf);
+			gzclose(writer.gzf);
 	}
 }
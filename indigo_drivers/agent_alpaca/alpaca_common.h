@@ -84,6 +84,11 @@ typedef struct indigo_alpaca_device_struct {
 			double electronsperadu;
 			double fullwellcapacity;
 			indigo_item *imageready;
+			uint32_t image_sequence;
+			void *imagebytes;
+			long imagebytes_size;
+			long imagebytes_allocated;
+			uint32_t imagebytes_sequence;
 			uint32_t maxadu;
 			double pixelsizex;
 			double pixelsizey;
@@ -609,6 +609,8 @@ static indigo_result agent_delete_property(indigo_client *client, indigo_device
 				} else {
 					previous->next = alpaca_device->next;
 				}
+				if (alpaca_device->device_type && !strcmp(alpaca_device->device_type, "Camera"))
+					indigo_safe_free(alpaca_device->ccd.imagebytes);
 				indigo_safe_free(alpaca_device);
 			}
 			break;
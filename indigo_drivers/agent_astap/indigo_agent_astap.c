@@ -262,8 +262,6 @@ typedef struct {
 
 // --------------------------------------------------------------------------------
 
-extern char **environ;
-
 static void parse_line(indigo_device *device, char *line) {
 	char *s = strchr(line, '\n');
 	if (s)
@@ -320,6 +318,11 @@ static void time_limit_timer(indigo_device *device) {
 	indigo_send_message(device, "Time limit reached!");
 }
 
+static bool parse_output_line(indigo_device *device, char *line) {
+	parse_line(device, line);
+	return true;
+}
+
 static bool execute_command(indigo_device *device, char *command, ...) {
 	char buffer[8 * 1024];
 	va_list args;
@@ -328,47 +331,14 @@ static bool execute_command(indigo_device *device, char *command, ...) {
 	va_end(args);
 
 	ASTAP_DEVICE_PRIVATE_DATA->abort_requested = false;
-	char command_buf[8 * 1024];
-	sprintf(command_buf, "%s 2>&1", buffer);
 	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "> %s", buffer);
-	int pipe_stdout[2];
-	if (pipe(pipe_stdout)) {
-		return false;
-	}
-	switch (ASTAP_DEVICE_PRIVATE_DATA->pid = fork()) {
-		case -1: {
-			close(pipe_stdout[0]);
-			close(pipe_stdout[1]);
-			indigo_send_message(device, "Failed to execute %s (%s)", command_buf, strerror(errno));
-			return false;
-		}
-		case 0: {
-			setpgid(0, 0);
-			close(pipe_stdout[0]);
-			dup2(pipe_stdout[1], STDOUT_FILENO);
-			close(pipe_stdout[1]);
-			execl("/bin/sh", "sh", "-c", buffer, NULL, environ);
-			perror("execl");
-			_exit(127);
-		}
-	}
-	close(pipe_stdout[1]);
 	if (!strncmp(command, "astap_cli", 9) && AGENT_PLATESOLVER_HINTS_CPU_LIMIT_ITEM->number.value > 0) {
 		indigo_set_timer(device, AGENT_PLATESOLVER_HINTS_CPU_LIMIT_ITEM->number.value, time_limit_timer, &ASTAP_DEVICE_PRIVATE_DATA->time_limit);
 	} else {
 		ASTAP_DEVICE_PRIVATE_DATA->time_limit = NULL;
 	}
-	FILE *output = fdopen(pipe_stdout[0], "r");
-	bool res = true;
-	char *line = NULL;
-	size_t size = 0;
-	while (getline(&line, &size, output) >= 0)
-		parse_line(device, line);
-	if (line)
-		free(line);
-	fclose(output);
+	bool res = indigo_platesolver_execute(device, buffer, &ASTAP_DEVICE_PRIVATE_DATA->pid, parse_output_line);
 	indigo_cancel_timer(device, &ASTAP_DEVICE_PRIVATE_DATA->time_limit);
-	ASTAP_DEVICE_PRIVATE_DATA->pid = 0;
 	if (ASTAP_DEVICE_PRIVATE_DATA->abort_requested) {
 		res = false;
 		ASTAP_DEVICE_PRIVATE_DATA->abort_requested = false;
@@ -496,6 +466,7 @@ static bool astap_solve(indigo_device *device, void *image, unsigned long image_
 	cleanup:
 		/* globs do not work in quotes */
 		execute_command(device, "rm -rf \"%s\"/image_*", base_dir);
+		indigo_platesolver_update_solve_time(device);
 		if (message[0] == '\0')
 			indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, NULL);
 		else
@@ -507,6 +478,30 @@ static bool astap_solve(indigo_device *device, void *image, unsigned long image_
 	return false;
 }
 
+static void astap_map_indexes(indigo_device *device) {
+	char **paths = NULL;
+	int count = 0;
+	for (int i = 0; i < AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count; i++) {
+		indigo_item *item = AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + i;
+		if (!item->sw.value)
+			continue;
+		for (int j = 0; astap_index[j].name; j++) {
+			if (!strcmp(item->name, astap_index[j].name)) {
+				short *files = astap_index[j].files;
+				for (int k = 0; files[k]; k++) {
+					paths = indigo_safe_realloc(paths, (count + 1) * sizeof(char *));
+					paths[count] = indigo_safe_malloc(INDIGO_VALUE_SIZE);
+					snprintf(paths[count++], INDIGO_VALUE_SIZE, astap_index[j].path, base_dir, files[k]);
+				}
+			}
+		}
+	}
+	indigo_platesolver_map_files(device, count, paths);
+	for (int i = 0; i < count; i++)
+		indigo_safe_free(paths[i]);
+	indigo_safe_free(paths);
+}
+
 static void sync_installed_indexes(indigo_device *device, char *dir, indigo_property *property) {
 	static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 	char path[INDIGO_VALUE_SIZE];
@@ -584,6 +579,8 @@ static void sync_installed_indexes(indigo_device *device, char *dir, indigo_prop
 	indigo_define_property(device, AGENT_PLATESOLVER_USE_INDEX_PROPERTY, NULL);
 	astap_save_config(device);
 	pthread_mutex_unlock(&mutex);
+	// mapping waits for the first solver worker, don't hold index download mutex or caller meanwhile
+	indigo_async((void *(*)(void *))astap_map_indexes, device);
 }
 
 static void index_handler(indigo_device *device) {
@@ -634,6 +631,7 @@ static indigo_result agent_device_attach(indigo_device *device) {
 		ASTAP_DEVICE_PRIVATE_DATA->platesolver.save_config = astap_save_config;
 		ASTAP_DEVICE_PRIVATE_DATA->platesolver.solve = astap_solve;
 		ASTAP_DEVICE_PRIVATE_DATA->platesolver.abort = astap_abort;
+		ASTAP_DEVICE_PRIVATE_DATA->platesolver.map_indexes = astap_map_indexes;
 		indigo_load_properties(device, false);
 		INDIGO_DEVICE_ATTACH_LOG(DRIVER_NAME, device->name);
 		return agent_enumerate_properties(device, NULL, NULL);
@@ -51,6 +51,7 @@
 #include <indigo/indigo_align.h>
 #include <indigo/indigo_platesolver.h>
 #include <indigo/indigo_dslr_raw.h>
+#include <indigo/indigo_raw_utils.h>
 
 #include "indigo_agent_astrometry.h"
 
@@ -179,10 +180,17 @@ static char base_dir[512];
 #define AGENT_ASTROMETRY_INDEX_4201_ITEM    	(AGENT_ASTROMETRY_INDEX_42XX_PROPERTY->items+18)
 #define AGENT_ASTROMETRY_INDEX_4200_ITEM    	(AGENT_ASTROMETRY_INDEX_42XX_PROPERTY->items+19)
 
+#define AGENT_ASTROMETRY_EXTRACTION_PROPERTY	(ASTROMETRY_DEVICE_PRIVATE_DATA->extraction_property)
+#define AGENT_ASTROMETRY_EXTRACTION_IMAGE2XY_ITEM	(AGENT_ASTROMETRY_EXTRACTION_PROPERTY->items+0)
+#define AGENT_ASTROMETRY_EXTRACTION_INDIGO_ITEM	(AGENT_ASTROMETRY_EXTRACTION_PROPERTY->items+1)
+
+#define MAX_EXTRACTED_STARS										100
+
 typedef struct {
 	platesolver_private_data platesolver;
 	indigo_property *index_41xx_property;
 	indigo_property *index_42xx_property;
+	indigo_property *extraction_property;
 	int frame_width;
 	int frame_height;
 	pid_t pid;
@@ -191,7 +199,59 @@ typedef struct {
 
 // --------------------------------------------------------------------------------
 
-extern char **environ;
+static bool parse_line(indigo_device *device, char *line) {
+	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "< %s", line);
+	double d1, d2;
+	char s[16];
+	if (strstr(line, "message:")) {
+		indigo_send_message(device, line + 9);
+	} else if (sscanf(line, "simplexy: nx=%d, ny=%d", &ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width, &ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height) == 2) {
+		ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width *= AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value;
+		ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height *= AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value;
+	} else if (sscanf(line, "Field center: (RA,Dec) = (%lg, %lg)", &d1, &d2) == 2) {
+		AGENT_PLATESOLVER_WCS_RA_ITEM->number.value = d1 / 15;
+		AGENT_PLATESOLVER_WCS_DEC_ITEM->number.value = d2;
+		if (AGENT_PLATESOLVER_HINTS_EPOCH_ITEM->number.target == 0) {
+			indigo_j2k_to_jnow(&AGENT_PLATESOLVER_WCS_RA_ITEM->number.value, &AGENT_PLATESOLVER_WCS_DEC_ITEM->number.value);
+			AGENT_PLATESOLVER_WCS_EPOCH_ITEM->number.value = 0;
+		} else {
+			AGENT_PLATESOLVER_WCS_EPOCH_ITEM->number.value = 2000;
+		}
+		INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->failed = false;
+	} else if (sscanf(line, "Field size: %lg x %lg %s", &d1, &d2, s) == 3) {
+		if (!strcmp(s, "degrees")) {
+			AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.value = d1;
+			AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.value = d2;
+		} else if (!strcmp(s, "arcminutes")) {
+			AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.value = d1 / 60.0;
+			AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.value = d2 / 60.0;
+		} else if (!strcmp(s, "arcseconds")) {
+			AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.value = d1 / 3600.0;
+			AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.value = d2 / 3600.0;
+		}
+		AGENT_PLATESOLVER_WCS_SCALE_ITEM->number.value = (
+			AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.value / ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width +
+			AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.value / ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height
+		) / 2;
+	} else if (sscanf(line, "Field rotation angle: up is %lg", &d1) == 1) {
+		AGENT_PLATESOLVER_WCS_ANGLE_ITEM->number.value = d1;
+	} else if (sscanf(line, "Field 1: solved with index index-%lg", &d1) == 1) {
+		indigo_send_message(device, "Solved");
+		AGENT_PLATESOLVER_WCS_INDEX_ITEM->number.value = d1;
+	} else if (sscanf(line, "Field parity: %3s", s) == 1) {
+		AGENT_PLATESOLVER_WCS_PARITY_ITEM->number.value = !strcmp(s, "pos") ? 1 : -1;
+	} else if (strstr(line, "Total CPU time limit reached")) {
+		indigo_send_message(device, "CPU time limit reached");
+	} else if (strstr(line, "Did not solve")) {
+		indigo_send_message(device, "No solution found");
+	} else if (strstr(line, "You must list at least one index")) {
+		indigo_send_message(device, "You must select at least one index");
+	} else if (strstr(line, ": not found")) {
+		INDIGO_DRIVER_ERROR(DRIVER_NAME, "%s", line);
+		return false;
+	}
+	return true;
+}
 
 static bool execute_command(indigo_device *device, char *command, ...) {
 	char buffer[8 * 1024];
@@ -201,96 +261,8 @@ static bool execute_command(indigo_device *device, char *command, ...) {
 	va_end(args);
 
 	ASTROMETRY_DEVICE_PRIVATE_DATA->abort_requested = false;
-	char command_buf[8 * 1024];
-	sprintf(command_buf, "%s 2>&1", buffer);
 	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "> %s", buffer);
-	int pipe_stdout[2];
-	if (pipe(pipe_stdout)) {
-		return false;
-	}
-	switch (ASTROMETRY_DEVICE_PRIVATE_DATA->pid = fork()) {
-		case -1: {
-			close(pipe_stdout[0]);
-			close(pipe_stdout[1]);
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to execute %s (%s)", command_buf, strerror(errno));
-			return false;
-		}
-		case 0: {
-			setpgid(0, 0);
-			close(pipe_stdout[0]);
-			dup2(pipe_stdout[1], STDOUT_FILENO);
-			close(pipe_stdout[1]);
-			execl("/bin/sh", "sh", "-c", buffer, NULL, environ);
-			perror("execl");
-			_exit(127);
-		}
-	}
-	close(pipe_stdout[1]);
-	FILE *output = fdopen(pipe_stdout[0], "r");
-	char *line = NULL;
-	size_t size = 0;
-	bool res = true;
-	while (getline(&line, &size, output) >= 0) {
-		char *nl = strchr(line, '\n');
-		if (nl)
-			*nl = 0;
-		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "< %s", line);
-		double d1, d2;
-		char s[16];
-		if (strstr(line, "message:")) {
-			indigo_send_message(device, line + 9);
-		} else if (sscanf(line, "simplexy: nx=%d, ny=%d", &ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width, &ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height) == 2) {
-			ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width *= AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value;
-			ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height *= AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value;
-		} else if (sscanf(line, "Field center: (RA,Dec) = (%lg, %lg)", &d1, &d2) == 2) {
-			AGENT_PLATESOLVER_WCS_RA_ITEM->number.value = d1 / 15;
-			AGENT_PLATESOLVER_WCS_DEC_ITEM->number.value = d2;
-			if (AGENT_PLATESOLVER_HINTS_EPOCH_ITEM->number.target == 0) {
-				indigo_j2k_to_jnow(&AGENT_PLATESOLVER_WCS_RA_ITEM->number.value, &AGENT_PLATESOLVER_WCS_DEC_ITEM->number.value);
-				AGENT_PLATESOLVER_WCS_EPOCH_ITEM->number.value = 0;
-			} else {
-				AGENT_PLATESOLVER_WCS_EPOCH_ITEM->number.value = 2000;
-			}
-			INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->failed = false;
-		} else if (sscanf(line, "Field size: %lg x %lg %s", &d1, &d2, s) == 3) {
-			if (!strcmp(s, "degrees")) {
-				AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.value = d1;
-				AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.value = d2;
-			} else if (!strcmp(s, "arcminutes")) {
-				AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.value = d1 / 60.0;
-				AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.value = d2 / 60.0;
-			} else if (!strcmp(s, "arcseconds")) {
-				AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.value = d1 / 3600.0;
-				AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.value = d2 / 3600.0;
-			}
-			AGENT_PLATESOLVER_WCS_SCALE_ITEM->number.value = (
-				AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.value / ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width +
-				AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.value / ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height
-			) / 2;
-		} else if (sscanf(line, "Field rotation angle: up is %lg", &d1) == 1) {
-			AGENT_PLATESOLVER_WCS_ANGLE_ITEM->number.value = d1;
-		} else if (sscanf(line, "Field 1: solved with index index-%lg", &d1) == 1) {
-			indigo_send_message(device, "Solved");
-			AGENT_PLATESOLVER_WCS_INDEX_ITEM->number.value = d1;
-		} else if (sscanf(line, "Field parity: %3s", s) == 1) {
-			AGENT_PLATESOLVER_WCS_PARITY_ITEM->number.value = !strcmp(s, "pos") ? 1 : -1;
-		} else if (strstr(line, "Total CPU time limit reached")) {
-			indigo_send_message(device, "CPU time limit reached");
-		} else if (strstr(line, "Did not solve")) {
-			indigo_send_message(device, "No solution found");
-		} else if (strstr(line, "You must list at least one index")) {
-			indigo_send_message(device, "You must select at least one index");
-		} else if (strstr(line, ": not found")) {
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "%s", line);
-			res = false;
-		}
-		if (line) {
-			free(line);
-			line = NULL;
-		}
-	}
-	fclose(output);
-	ASTROMETRY_DEVICE_PRIVATE_DATA->pid = 0;
+	bool res = indigo_platesolver_execute(device, buffer, &ASTROMETRY_DEVICE_PRIVATE_DATA->pid, parse_line);
 	if (ASTROMETRY_DEVICE_PRIVATE_DATA->abort_requested) {
 		res = false;
 		ASTROMETRY_DEVICE_PRIVATE_DATA->abort_requested = false;
@@ -308,7 +280,103 @@ static void jpeg_decompress_error_callback(j_common_ptr cinfo) {
 	longjmp(((struct indigo_jpeg_decompress_struct *)cinfo)->jpeg_error, 1);
 }
 
-#define astrometry_save_config indigo_platesolver_save_config
+static void astrometry_save_config(indigo_device *device) {
+	if (pthread_mutex_trylock(&DEVICE_CONTEXT->config_mutex) == 0) {
+		pthread_mutex_unlock(&DEVICE_CONTEXT->config_mutex);
+		indigo_save_property(device, NULL, AGENT_ASTROMETRY_EXTRACTION_PROPERTY);
+		indigo_platesolver_save_config(device);
+	}
+}
+
+static void write_fits_float(uint8_t *p, float value) {
+	union { float f; uint32_t i; } u = { value };
+	p[0] = u.i >> 24;
+	p[1] = u.i >> 16;
+	p[2] = u.i >> 8;
+	p[3] = u.i;
+}
+
+// Detect stars in decoded image and write them as astrometry.net xylist (FITS binary table with X, Y and FLUX columns)
+
+static bool astrometry_extract_stars(indigo_device *device, const char *base, void *image, int byte_per_pixel, int components) {
+	int width = ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width;
+	int height = ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height;
+	int downsample = AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value > 1 ? (int)AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value : 1;
+	int binned_width = width / downsample;
+	int binned_height = height / downsample;
+	if (binned_width < 32 || binned_height < 32)
+		return false;
+	uint16_t *binned = indigo_safe_malloc(binned_width * binned_height * sizeof(uint16_t));
+	int divider = downsample * downsample * components;
+	for (int y = 0; y < binned_height; y++) {
+		for (int x = 0; x < binned_width; x++) {
+			uint32_t sum = 0;
+			for (int j = 0; j < downsample; j++) {
+				int offset = ((y * downsample + j) * width + x * downsample) * components;
+				if (byte_per_pixel == 2) {
+					uint16_t *in = (uint16_t *)image + offset;
+					for (int i = 0; i < downsample * components; i++)
+						sum += in[i];
+				} else {
+					uint8_t *in = (uint8_t *)image + offset;
+					for (int i = 0; i < downsample * components; i++)
+						sum += in[i];
+				}
+			}
+			binned[y * binned_width + x] = sum / divider;
+		}
+	}
+	indigo_star_detection stars[MAX_EXTRACTED_STARS];
+	int count = 0;
+	indigo_result result = indigo_find_stars(INDIGO_RAW_MONO16, binned, binned_width, binned_height, MAX_EXTRACTED_STARS, stars, &count);
+	indigo_safe_free(binned);
+	if (result != INDIGO_OK || count == 0)
+		return false;
+	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "%d stars extracted", count);
+	int data_size = count * 3 * sizeof(float);
+	int size = 2 * FITS_LOGICAL_RECORD_LENGTH + ((data_size + FITS_LOGICAL_RECORD_LENGTH - 1) / FITS_LOGICAL_RECORD_LENGTH) * FITS_LOGICAL_RECORD_LENGTH;
+	char *buffer = indigo_safe_malloc(size), *p = buffer;
+	memset(buffer, ' ', 2 * FITS_LOGICAL_RECORD_LENGTH);
+	int t = sprintf(p, "SIMPLE  = %20c", 'T'); p[t] = ' ';
+	t = sprintf(p += 80, "BITPIX  = %20d", 8); p[t] = ' ';
+	t = sprintf(p += 80, "NAXIS   = %20d", 0); p[t] = ' ';
+	t = sprintf(p += 80, "EXTEND  = %20c", 'T'); p[t] = ' ';
+	t = sprintf(p += 80, "END"); p[t] = ' ';
+	p = buffer + FITS_LOGICAL_RECORD_LENGTH;
+	t = sprintf(p, "XTENSION= 'BINTABLE'"); p[t] = ' ';
+	t = sprintf(p += 80, "BITPIX  = %20d", 8); p[t] = ' ';
+	t = sprintf(p += 80, "NAXIS   = %20d", 2); p[t] = ' ';
+	t = sprintf(p += 80, "NAXIS1  = %20d", (int)(3 * sizeof(float))); p[t] = ' ';
+	t = sprintf(p += 80, "NAXIS2  = %20d", count); p[t] = ' ';
+	t = sprintf(p += 80, "PCOUNT  = %20d", 0); p[t] = ' ';
+	t = sprintf(p += 80, "GCOUNT  = %20d", 1); p[t] = ' ';
+	t = sprintf(p += 80, "TFIELDS = %20d", 3); p[t] = ' ';
+	t = sprintf(p += 80, "TTYPE1  = 'X       '"); p[t] = ' ';
+	t = sprintf(p += 80, "TFORM1  = 'E       '"); p[t] = ' ';
+	t = sprintf(p += 80, "TTYPE2  = 'Y       '"); p[t] = ' ';
+	t = sprintf(p += 80, "TFORM2  = 'E       '"); p[t] = ' ';
+	t = sprintf(p += 80, "TTYPE3  = 'FLUX    '"); p[t] = ' ';
+	t = sprintf(p += 80, "TFORM3  = 'E       '"); p[t] = ' ';
+	t = sprintf(p += 80, "IMAGEW  = %20d", width); p[t] = ' ';
+	t = sprintf(p += 80, "IMAGEH  = %20d", height); p[t] = ' ';
+	t = sprintf(p += 80, "END"); p[t] = ' ';
+	uint8_t *data = (uint8_t *)buffer + 2 * FITS_LOGICAL_RECORD_LENGTH;
+	for (int i = 0; i < count; i++) {
+		// binned pixel centers to 1-based FITS coordinates of full frame
+		write_fits_float(data, (stars[i].x + 0.5) * downsample + 0.5);
+		write_fits_float(data + 4, (stars[i].y + 0.5) * downsample + 0.5);
+		write_fits_float(data + 8, stars[i].luminance);
+		data += 12;
+	}
+	char path[512];
+	snprintf(path, sizeof(path), "%s.xy", base);
+	int handle = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	bool success = handle >= 0 && indigo_write(handle, buffer, size);
+	if (handle >= 0)
+		close(handle);
+	indigo_safe_free(buffer);
+	return success;
+}
 
 static void astrometry_abort(indigo_device *device) {
 	if (ASTROMETRY_DEVICE_PRIVATE_DATA->pid) {
@@ -338,7 +406,8 @@ static bool astrometry_solve(indigo_device *device, void *image, unsigned long i
 		char base[512];
 		sprintf(base, "%s/%s_%lX", base_dir, "image", time(0));
 #pragma clang diagnostic pop
-		// convert any input image to FITS file
+		// convert any input image to FITS file or extract stars to xylist
+		bool xylist = false;
 		int handle = open(base, O_WRONLY | O_CREAT | O_TRUNC, 0644);
 		if (handle < 0) {
 			AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_ALERT_STATE;
@@ -434,64 +503,76 @@ static bool astrometry_solve(indigo_device *device, void *image, unsigned long i
 				close(handle);
 				goto cleanup;
 			}
-			int pixel_count = ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width * ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height;
-			image_size = pixel_count * byte_per_pixel + FITS_LOGICAL_RECORD_LENGTH;
-			if (image_size % FITS_LOGICAL_RECORD_LENGTH) {
-				image_size = (image_size / FITS_LOGICAL_RECORD_LENGTH + 1) * FITS_LOGICAL_RECORD_LENGTH;
-			}
-			char *buffer = indigo_safe_malloc(image_size), *p = buffer;
-			memset(buffer, ' ', image_size);
-			int t = sprintf(p, "SIMPLE  = %20c", 'T'); p[t] = ' ';
-			t = sprintf(p += 80, "BITPIX  = %20d", byte_per_pixel * 8); p[t] = ' ';
-			t = sprintf(p += 80, "NAXIS   = %20d", 2); p[t] = ' ';
-			t = sprintf(p += 80, "NAXIS1  = %20d", ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width); p[t] = ' ';
-			t = sprintf(p += 80, "NAXIS2  = %20d", ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height); p[t] = ' ';
-			t = sprintf(p += 80, "EXTEND  = %20c", 'T'); p[t] = ' ';
-			if (byte_per_pixel == 2) {
-				t = sprintf(p += 80, "BZERO   = %20d", 32768); p[t] = ' ';
-				t = sprintf(p += 80, "BSCALE  = %20d", 1); p[t] = ' ';
-			}
-			t = sprintf(p += 80, "END"); p[t] = ' ';
-			p = buffer + FITS_LOGICAL_RECORD_LENGTH;
-			if (components == 1) {
-				// mono
-				if (byte_per_pixel == 2) {
-					// 16 bit RAW - swap endian
-					uint16_t *in = image;
-					uint16_t *out = (uint16_t *)p;
-					for (int i = 0; i < pixel_count; i++) {
-						int value = *in++ - 32768;
-						*out++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-					}
-				} else {
-					// 8 bit RAW
-					memcpy(p, image, pixel_count);
+			if (AGENT_ASTROMETRY_EXTRACTION_INDIGO_ITEM->sw.value) {
+				// detect stars in memory and pass only xylist to solve-field
+				xylist = astrometry_extract_stars(device, base, image, byte_per_pixel, components);
+				indigo_safe_free(intermediate_image);
+				if (!xylist) {
+					AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_ALERT_STATE;
+					message = "Star extraction failed";
+					close(handle);
+					goto cleanup;
 				}
 			} else {
-				// RGB
+				int pixel_count = ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width * ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height;
+				image_size = pixel_count * byte_per_pixel + FITS_LOGICAL_RECORD_LENGTH;
+				if (image_size % FITS_LOGICAL_RECORD_LENGTH) {
+					image_size = (image_size / FITS_LOGICAL_RECORD_LENGTH + 1) * FITS_LOGICAL_RECORD_LENGTH;
+				}
+				char *buffer = indigo_safe_malloc(image_size), *p = buffer;
+				memset(buffer, ' ', image_size);
+				int t = sprintf(p, "SIMPLE  = %20c", 'T'); p[t] = ' ';
+				t = sprintf(p += 80, "BITPIX  = %20d", byte_per_pixel * 8); p[t] = ' ';
+				t = sprintf(p += 80, "NAXIS   = %20d", 2); p[t] = ' ';
+				t = sprintf(p += 80, "NAXIS1  = %20d", ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width); p[t] = ' ';
+				t = sprintf(p += 80, "NAXIS2  = %20d", ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height); p[t] = ' ';
+				t = sprintf(p += 80, "EXTEND  = %20c", 'T'); p[t] = ' ';
 				if (byte_per_pixel == 2) {
-					// 16 bit RGB - average and swap endian
-					uint16_t *in = image;
-					uint16_t *out = (uint16_t *)p;
-					for (int i = 0; i < pixel_count; i++) {
-						int value = (in[0] + in[1] + in[2]) / 3 - 32768;
-						in += 3;
-						*out++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
+					t = sprintf(p += 80, "BZERO   = %20d", 32768); p[t] = ' ';
+					t = sprintf(p += 80, "BSCALE  = %20d", 1); p[t] = ' ';
+				}
+				t = sprintf(p += 80, "END"); p[t] = ' ';
+				p = buffer + FITS_LOGICAL_RECORD_LENGTH;
+				if (components == 1) {
+					// mono
+					if (byte_per_pixel == 2) {
+						// 16 bit RAW - swap endian
+						uint16_t *in = image;
+						uint16_t *out = (uint16_t *)p;
+						for (int i = 0; i < pixel_count; i++) {
+							int value = *in++ - 32768;
+							*out++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
+						}
+					} else {
+						// 8 bit RAW
+						memcpy(p, image, pixel_count);
 					}
 				} else {
-					// 8 bit RGB - average
-					char *in = image;
-					char *out = p;
-					for (int i = 0; i < pixel_count; i++) {
-						int value = (in[0] + in[1] + in[2]) / 3;
-						in += 3;
-						*out++ = value;
+					// RGB
+					if (byte_per_pixel == 2) {
+						// 16 bit RGB - average and swap endian
+						uint16_t *in = image;
+						uint16_t *out = (uint16_t *)p;
+						for (int i = 0; i < pixel_count; i++) {
+							int value = (in[0] + in[1] + in[2]) / 3 - 32768;
+							in += 3;
+							*out++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
+						}
+					} else {
+						// 8 bit RGB - average
+						char *in = image;
+						char *out = p;
+						for (int i = 0; i < pixel_count; i++) {
+							int value = (in[0] + in[1] + in[2]) / 3;
+							in += 3;
+							*out++ = value;
+						}
 					}
 				}
+				indigo_write(handle, buffer, image_size);
+				indigo_safe_free(buffer);
+				indigo_safe_free(intermediate_image);
 			}
-			indigo_write(handle, buffer, image_size);
-			indigo_safe_free(buffer);
-			indigo_safe_free(intermediate_image);
 		}
 		close(handle);
 		// execute astrometry.net plate solver
@@ -526,13 +607,16 @@ static bool astrometry_solve(indigo_device *device, void *image, unsigned long i
 		if (AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value > 1) {
 			hints_index += sprintf(hints + hints_index, " -d %d", (int)AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value);
 		}
-		if (!execute_command(device, "image2xy -O%s -o \"%s.xy\" \"%s\"", hints, base, base)) {
+		if (!xylist && !execute_command(device, "image2xy -O%s -o \"%s.xy\" \"%s\"", hints, base, base)) {
 			AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_ALERT_STATE;
 			message = "Execution of image2xy failed";
 			goto cleanup;
 		}
 		*hints = 0;
 		hints_index = 0;
+		if (xylist) {
+			hints_index += sprintf(hints + hints_index, " --width %d --height %d", ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width, ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height);
+		}
 		if (AGENT_PLATESOLVER_HINTS_RADIUS_ITEM->number.value > 0) {
 			hints_index += sprintf(hints + hints_index, " --ra %g --dec %g --radius %g", AGENT_PLATESOLVER_HINTS_RA_ITEM->number.value * 15, AGENT_PLATESOLVER_HINTS_DEC_ITEM->number.value, AGENT_PLATESOLVER_HINTS_RADIUS_ITEM->number.value);
 		}
@@ -560,6 +644,7 @@ static bool astrometry_solve(indigo_device *device, void *image, unsigned long i
 	cleanup:
 		/* globs do not work in quotes */
 		execute_command(device, "rm -rf \"%s/image_\"*", base_dir);
+		indigo_platesolver_update_solve_time(device);
 		if (message[0] == '\0')
 			indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, NULL);
 		else
@@ -571,6 +656,25 @@ static bool astrometry_solve(indigo_device *device, void *image, unsigned long i
 	return false;
 }
 
+static void astrometry_map_indexes(indigo_device *device) {
+	char *paths[sizeof(index_files) / sizeof(char *)];
+	int count = 0;
+	for (int k = 0; k < AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count; k++) {
+		indigo_item *item = AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + k;
+		if (item->sw.value) {
+			for (int l = 0; index_files[l]; l++) {
+				if (!strncmp(item->name, index_files[l], 4)) {
+					paths[count] = indigo_safe_malloc(INDIGO_VALUE_SIZE);
+					snprintf(paths[count++], INDIGO_VALUE_SIZE, "%s/index-%s.fits", base_dir, index_files[l]);
+				}
+			}
+		}
+	}
+	indigo_platesolver_map_files(device, count, paths);
+	for (int k = 0; k < count; k++)
+		indigo_safe_free(paths[k]);
+}
+
 static void sync_installed_indexes(indigo_device *device, char *dir, indigo_property *property) {
 	static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 	char path[INDIGO_VALUE_SIZE];
@@ -661,6 +765,8 @@ static void sync_installed_indexes(indigo_device *device, char *dir, indigo_prop
 	indigo_define_property(device, AGENT_PLATESOLVER_USE_INDEX_PROPERTY, NULL);
 	astrometry_save_config(device);
 	pthread_mutex_unlock(&mutex);
+	// mapping waits for the first solver worker, don't hold index download mutex or caller meanwhile
+	indigo_async((void *(*)(void *))astrometry_map_indexes, device);
 }
 
 static void index_41xx_handler(indigo_device *device) {
@@ -752,10 +858,17 @@ static indigo_result agent_device_attach(indigo_device *device) {
 			}
 		}
 		indigo_property_sort_items(AGENT_PLATESOLVER_USE_INDEX_PROPERTY, 0);
+		// -------------------------------------------------------------------------------- AGENT_ASTROMETRY_EXTRACTION
+		AGENT_ASTROMETRY_EXTRACTION_PROPERTY = indigo_init_switch_property(NULL, device->name, AGENT_ASTROMETRY_EXTRACTION_PROPERTY_NAME, PLATESOLVER_MAIN_GROUP, "Star extraction", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 2);
+		if (AGENT_ASTROMETRY_EXTRACTION_PROPERTY == NULL)
+			return INDIGO_FAILED;
+		indigo_init_switch_item(AGENT_ASTROMETRY_EXTRACTION_IMAGE2XY_ITEM, AGENT_ASTROMETRY_EXTRACTION_IMAGE2XY_ITEM_NAME, "image2xy (astrometry.net)", true);
+		indigo_init_switch_item(AGENT_ASTROMETRY_EXTRACTION_INDIGO_ITEM, AGENT_ASTROMETRY_EXTRACTION_INDIGO_ITEM_NAME, "INDIGO star detection", false);
 		// --------------------------------------------------------------------------------
 		ASTROMETRY_DEVICE_PRIVATE_DATA->platesolver.save_config = astrometry_save_config;
 		ASTROMETRY_DEVICE_PRIVATE_DATA->platesolver.solve = astrometry_solve;
 		ASTROMETRY_DEVICE_PRIVATE_DATA->platesolver.abort = astrometry_abort;
+		ASTROMETRY_DEVICE_PRIVATE_DATA->platesolver.map_indexes = astrometry_map_indexes;
 		indigo_load_properties(device, false);
 		INDIGO_DEVICE_ATTACH_LOG(DRIVER_NAME, device->name);
 		return agent_enumerate_properties(device, NULL, NULL);
@@ -770,6 +883,8 @@ static indigo_result agent_enumerate_properties(indigo_device *device, indigo_cl
 		indigo_define_property(device, AGENT_ASTROMETRY_INDEX_41XX_PROPERTY, NULL);
 	if (indigo_property_match(AGENT_ASTROMETRY_INDEX_42XX_PROPERTY, property))
 		indigo_define_property(device, AGENT_ASTROMETRY_INDEX_42XX_PROPERTY, NULL);
+	if (indigo_property_match(AGENT_ASTROMETRY_EXTRACTION_PROPERTY, property))
+		indigo_define_property(device, AGENT_ASTROMETRY_EXTRACTION_PROPERTY, NULL);
 	return indigo_platesolver_enumerate_properties(device, client, property);
 }
 
@@ -793,6 +908,13 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		indigo_update_property(device, AGENT_ASTROMETRY_INDEX_42XX_PROPERTY, NULL);
 		indigo_set_timer(device, 0, index_42xx_handler, NULL);
 		return INDIGO_OK;
+	} else if (indigo_property_match(AGENT_ASTROMETRY_EXTRACTION_PROPERTY, property)) {
+	// -------------------------------------------------------------------------------- AGENT_ASTROMETRY_EXTRACTION
+		indigo_property_copy_values(AGENT_ASTROMETRY_EXTRACTION_PROPERTY, property, false);
+		AGENT_ASTROMETRY_EXTRACTION_PROPERTY->state = INDIGO_OK_STATE;
+		astrometry_save_config(device);
+		indigo_update_property(device, AGENT_ASTROMETRY_EXTRACTION_PROPERTY, NULL);
+		return INDIGO_OK;
 	}
 	return indigo_platesolver_change_property(device, client, property);
 }
@@ -801,6 +923,7 @@ static indigo_result agent_device_detach(indigo_device *device) {
 	assert(device != NULL);
 	indigo_release_property(AGENT_ASTROMETRY_INDEX_41XX_PROPERTY);
 	indigo_release_property(AGENT_ASTROMETRY_INDEX_42XX_PROPERTY);
+	indigo_release_property(AGENT_ASTROMETRY_EXTRACTION_PROPERTY);
 	return indigo_platesolver_device_detach(device);
 }
 
@@ -2,17 +2,24 @@ var indigo_devices = { };
 var indigo_event_handlers = { };
 var indigo_timers = [ ];
 
-function indigo_call_handlers(event, device_name, value, check_devices) {
+function indigo_call_handlers(event, device_name, value, check_devices, subscribed) {
 	for (handler_name in indigo_event_handlers) {
 		var handler = indigo_event_handlers[handler_name];
 		if (check_devices && handler.devices && handler.devices.indexOf(device_name) == -1)
 			continue;
+		if (subscribed === false && !handler.devices)
+			continue;
 		if (handler[event]) {
 			handler[event](value);
 		}
 	}
 }
 
+function indigo_watch_devices(devices) {
+	for (var i = 0; i < devices.length; i++)
+		indigo_watch(devices[i]);
+}
+
 function indigo_change_property(device, property, items) {
 	for (var name in items) {
 		var value = items[name];
@@ -78,7 +85,7 @@ function indigo_error_with_property(message, property) {
 		indigo_error("  message: "+message);
 }
 
-function indigo_on_define_property(device_name, property_name, items, item_defs, state, perm, message) {
+function indigo_on_define_property(device_name, property_name, items, item_defs, state, perm, message, subscribed) {
 	var property = { device: device_name, name: property_name, items: items, item_defs: item_defs, state: state, perm: perm, message: message };
 	var properties = indigo_devices[device_name];
 	if (properties == null) {
@@ -89,10 +96,10 @@ function indigo_on_define_property(device_name, property_name, items, item_defs,
 	property.change = function(items) {
 		indigo_change_property(this.device, this.name, items);
 	}
-	indigo_call_handlers("on_define", device_name, property, true);
+	indigo_call_handlers("on_define", device_name, property, true, subscribed);
 }
 
-function indigo_on_update_property(device_name, property_name, items, state, message) {
+function indigo_on_update_property(device_name, property_name, items, state, message, subscribed) {
 	var properties = indigo_devices[device_name];
 	if (properties == null) {
 		return;
@@ -113,10 +120,10 @@ function indigo_on_update_property(device_name, property_name, items, state, mes
 		}
 	}
 	saved_property.message = message;
-	indigo_call_handlers("on_update", device_name, saved_property, true);
+	indigo_call_handlers("on_update", device_name, saved_property, true, subscribed);
 }
 
-function indigo_on_delete_property(device_name, property_name, message) {
+function indigo_on_delete_property(device_name, property_name, message, subscribed) {
 	var properties = indigo_devices[device_name];
 	if (properties == null) {
 		return;
@@ -124,14 +131,14 @@ function indigo_on_delete_property(device_name, property_name, message) {
 		for (property_name in properties) {
 			var property = properties[property_name];
 			property.message = message;
-			indigo_call_handlers("on_delete", device_name, property, true);
+			indigo_call_handlers("on_delete", device_name, property, true, subscribed);
 		}
 		delete indigo_devices[device_name];
 	} else {
 		var property = properties[property_name];
 		if (property) {
 			property.message = message;
-			indigo_call_handlers("on_delete", device_name, property, true);
+			indigo_call_handlers("on_delete", device_name, property, true, subscribed);
 			delete properties[property_name];
 		}
 	}
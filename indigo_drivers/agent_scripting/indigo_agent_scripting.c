@@ -36,6 +36,7 @@
 #include <pthread.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <sys/time.h>
 
 #include <indigo/indigo_bus.h>
 #include <indigo/indigo_io.h>
@@ -50,7 +51,10 @@
 #define MAX_USER_SCRIPT_COUNT											128
 #define MAX_CACHED_PROPERTY_COUNT										126
 #define MAX_TIMER_COUNT														32
+#define MAX_SUBSCRIPTION_COUNT											64
+#define MAX_BYTECODE_CACHE_COUNT										(MAX_USER_SCRIPT_COUNT + 2)
 #define MAX_ITEMS																	128
+#define WORKER_STOP_TIMEOUT												5
 
 #define AGENT_SCRIPTING_RUN_SCRIPT_PROPERTY				(PRIVATE_DATA->agent_run_script_property)
 #define AGENT_SCRIPTING_RUN_SCRIPT_ITEM						(AGENT_SCRIPTING_RUN_SCRIPT_PROPERTY->items+0)
@@ -64,6 +68,7 @@
 #define AGENT_SCRIPTING_DELETE_SCRIPT_NAME_ITEM		(AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY->items+0)
 #define AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY		(PRIVATE_DATA->agent_on_load_script_property)
 #define AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY	(PRIVATE_DATA->agent_on_unload_script_property)
+#define AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY		(PRIVATE_DATA->agent_worker_script_property)
 
 #define AGENT_SCRIPTING_SCRIPT_PROPERTY(i)				(PRIVATE_DATA->agent_scripts_property[i])
 #define AGENT_SCRIPTING_SCRIPT_NAME_ITEM(i)				(AGENT_SCRIPTING_SCRIPT_PROPERTY(i)->items+0)
@@ -76,6 +81,54 @@ static char boot_js[] = {
 	0
 };
 
+typedef enum {
+	ON_DEFINE_PROPERTY_HANDLER,
+	ON_UPDATE_PROPERTY_HANDLER,
+	ON_DELETE_PROPERTY_HANDLER,
+	ON_SEND_MESSAGE_HANDLER,
+	ON_ENUMERATE_PROPERTIES_HANDLER,
+	ON_CHANGE_PROPERTY_HANDLER,
+	TIMER_HANDLER,
+	HANDLER_COUNT
+} handler_index;
+
+static const char *handler_names[HANDLER_COUNT] = {
+	"indigo_on_define_property",
+	"indigo_on_update_property",
+	"indigo_on_delete_property",
+	"indigo_on_send_message",
+	"indigo_on_enumerate_properties",
+	"indigo_on_change_property",
+	"indigo_timer"
+};
+
+typedef struct {
+	unsigned long calls;
+	unsigned long skipped;
+	double total_time;
+	double max_time;
+} handler_stats;
+
+typedef struct {
+	char device[INDIGO_NAME_SIZE];
+	char name[INDIGO_NAME_SIZE];
+	bool watch;
+} subscription;
+
+typedef enum {
+	EVENT_SKIPPED,
+	EVENT_WATCHED,
+	EVENT_SUBSCRIBED
+} event_dispatch;
+
+typedef struct {
+	uint64_t hash;
+	size_t length;
+	char *script;
+	void *bytecode;
+	size_t size;
+} bytecode_cache_entry;
+
 typedef struct {
 	indigo_property *agent_run_script_property;
 	indigo_property *agent_add_script_property;
@@ -83,11 +136,21 @@ typedef struct {
 	indigo_property *agent_delete_script_property;
 	indigo_property *agent_on_load_script_property;
 	indigo_property *agent_on_unload_script_property;
+	indigo_property *agent_worker_script_property;
 	indigo_property *agent_scripts_property[MAX_USER_SCRIPT_COUNT];
 	indigo_property *agent_cached_property[MAX_CACHED_PROPERTY_COUNT];
 	indigo_timer *timers[MAX_TIMER_COUNT];
 	duk_context *ctx;
 	pthread_mutex_t mutex;
+	subscription subscriptions[MAX_SUBSCRIPTION_COUNT];
+	int subscription_count;
+	pthread_mutex_t subscription_mutex;
+	handler_stats stats[HANDLER_COUNT];
+	bytecode_cache_entry bytecode_cache[MAX_BYTECODE_CACHE_COUNT];
+	int bytecode_cache_next;
+	int worker_count;
+	bool abort_workers;
+	pthread_mutex_t bytecode_cache_mutex;
 } agent_private_data;
 
 static agent_private_data *private_data = NULL;
@@ -109,6 +172,7 @@ static void save_config(indigo_device *device) {
 		}
 		indigo_save_property(device, NULL, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY);
 		indigo_save_property(device, NULL, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY);
+		indigo_save_property(device, NULL, AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY);
 		if (DEVICE_CONTEXT->property_save_file_handle) {
 			CONFIG_PROPERTY->state = INDIGO_OK_STATE;
 			close(DEVICE_CONTEXT->property_save_file_handle);
@@ -121,6 +185,65 @@ static void save_config(indigo_device *device) {
 	}
 }
 
+// -------------------------------------------------------------------------------- Subscriptions and handler statistics
+
+static bool pattern_match(const char *pattern, const char *value) {
+	if (*pattern == 0)
+		return true;
+	if (value == NULL)
+		return false;
+	size_t length = strlen(pattern);
+	if (pattern[length - 1] == '*')
+		return strncmp(pattern, value, length - 1) == 0;
+	return strcmp(pattern, value) == 0;
+}
+
+// Without subscriptions all events are dispatched to the script handlers, otherwise only events matching any of them.
+// Events of watched devices (devices of handlers with their own devices list) are passed to boot.js with subscribed
+// argument set to false, so indigo_devices and those handlers stay up to date. Other events don't enter the VM at all.
+
+static event_dispatch event_dispatch_for(const char *device, const char *name, handler_index handler) {
+	event_dispatch result = EVENT_SUBSCRIBED;
+	bool filtered = false, matched = false, watched = false;
+	pthread_mutex_lock(&PRIVATE_DATA->subscription_mutex);
+	for (int i = 0; i < PRIVATE_DATA->subscription_count; i++) {
+		subscription *subscription = PRIVATE_DATA->subscriptions + i;
+		if (subscription->watch) {
+			if (pattern_match(subscription->device, device))
+				watched = true;
+		} else {
+			filtered = true;
+			if (pattern_match(subscription->device, device) && (name == NULL || pattern_match(subscription->name, name)))
+				matched = true;
+		}
+	}
+	if (filtered && !matched) {
+		result = watched ? EVENT_WATCHED : EVENT_SKIPPED;
+		PRIVATE_DATA->stats[handler].skipped++;
+	}
+	pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+	return result;
+}
+
+// Call function with nargs arguments on the stack and account time spent in it, must be called with PRIVATE_DATA->mutex locked
+
+static void call_handler(handler_index handler, int nargs) {
+	struct timeval start, end;
+	gettimeofday(&start, NULL);
+	if (duk_pcall(PRIVATE_DATA->ctx, nargs)) {
+		INDIGO_DRIVER_ERROR(DRIVER_NAME, "%s() call failed (%s)", handler_names[handler], duk_safe_to_string(PRIVATE_DATA->ctx, -1));
+	}
+	gettimeofday(&end, NULL);
+	double time = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+	pthread_mutex_lock(&PRIVATE_DATA->subscription_mutex);
+	handler_stats *stats = PRIVATE_DATA->stats + handler;
+	stats->calls++;
+	stats->total_time += time;
+	if (time > stats->max_time)
+		stats->max_time = time;
+	pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+}
+
 // -------------------------------------------------------------------------------- Duktape bindings
 
 static void push_state(indigo_property_state state) {
@@ -311,8 +434,8 @@ static duk_ret_t save_blob(duk_context *ctx) {
 			INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_populate_blob() failed");
 			return 0;
 		}
-		duk_push_number(PRIVATE_DATA->ctx, item->blob.size);
-		duk_put_prop_string(PRIVATE_DATA->ctx, 1, "size");
+		duk_push_number(ctx, item->blob.size);
+		duk_put_prop_string(ctx, 1, "size");
 	}
 	int handle = open(file_name, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
 	if (handle > 0) {
@@ -336,8 +459,8 @@ static duk_ret_t populate_blob(duk_context *ctx) {
 			INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_populate_blob() failed");
 			return 0;
 		}
-		duk_push_number(PRIVATE_DATA->ctx, item->blob.size);
-		duk_put_prop_string(PRIVATE_DATA->ctx, 0, "size");
+		duk_push_number(ctx, item->blob.size);
+		duk_put_prop_string(ctx, 0, "size");
 	}
 	return 1;
 }
@@ -444,6 +567,29 @@ static duk_ret_t change_switch_property(duk_context *ctx) {
 	return 0;
 }
 
+// Bindings touching agent_cached_property[] are called both from the main context and from workers, so they run
+// with PRIVATE_DATA->mutex locked. The call is protected, so an error thrown inside doesn't leave the mutex locked.
+
+typedef struct {
+	duk_c_function function;
+} locked_binding_data;
+
+static duk_ret_t call_locked_binding(duk_context *ctx, void *udata) {
+	return ((locked_binding_data *)udata)->function(ctx);
+}
+
+static duk_ret_t call_locked(duk_context *ctx, duk_c_function function) {
+	locked_binding_data data = { function };
+	pthread_mutex_lock(&PRIVATE_DATA->mutex);
+	duk_int_t result = duk_safe_call(ctx, call_locked_binding, &data, duk_get_top(ctx), 1);
+	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
+	if (result != DUK_EXEC_SUCCESS)
+		return duk_throw(ctx);
+	return 1;
+}
+
+#define LOCKED_BINDING(function) static duk_ret_t function##_locked(duk_context *ctx) { return call_locked(ctx, function); }
+
 //function indigo_define_text_property(device_name, property_name, property_group, property_label, items, item_defs, state, perm, message)
 
 static void define_property_handler(indigo_device *device, void *data) {
@@ -770,6 +916,16 @@ static duk_ret_t delete_property(duk_context *ctx) {
 	return 0;
 }
 
+LOCKED_BINDING(define_text_property)
+LOCKED_BINDING(define_number_property)
+LOCKED_BINDING(define_switch_property)
+LOCKED_BINDING(define_light_property)
+LOCKED_BINDING(update_text_property)
+LOCKED_BINDING(update_number_property)
+LOCKED_BINDING(update_switch_property)
+LOCKED_BINDING(update_light_property)
+LOCKED_BINDING(delete_property)
+
 // function indigo_set_timer(function, delay);
 
 static void timer_handler(indigo_device *device, void *data) {
@@ -779,14 +935,14 @@ static void timer_handler(indigo_device *device, void *data) {
 	duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_timers");
 	duk_push_number(PRIVATE_DATA->ctx, (double)(index - 1));
 	duk_get_prop(PRIVATE_DATA->ctx, -2);
-	if (duk_pcall(PRIVATE_DATA->ctx, 0)) {
-		INDIGO_DRIVER_ERROR(DRIVER_NAME, "timer call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-	}
+	call_handler(TIMER_HANDLER, 0);
 	duk_pop_3(PRIVATE_DATA->ctx);
 	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
 }
 
 static duk_ret_t set_timer(duk_context *ctx) {
+	if (ctx != PRIVATE_DATA->ctx)
+		return DUK_RET_ERROR;
 	for (uintptr_t index = 0; index < MAX_TIMER_COUNT; index++) {
 		if (PRIVATE_DATA->timers[index] == NULL) {
 			duk_push_global_object(PRIVATE_DATA->ctx);
@@ -808,6 +964,8 @@ static duk_ret_t set_timer(duk_context *ctx) {
 // function indigo_cancel_timer(timer);
 
 static duk_ret_t cancel_timer(duk_context *ctx) {
+	if (ctx != PRIVATE_DATA->ctx)
+		return DUK_RET_ERROR;
 	int i = duk_require_int(ctx, 0);
 	if (PRIVATE_DATA->timers[i]) {
 		if (indigo_cancel_timer(agent_device, PRIVATE_DATA->timers + i)) {
@@ -817,16 +975,289 @@ static duk_ret_t cancel_timer(duk_context *ctx) {
 	return DUK_RET_ERROR;
 }
 
-static bool execute_script(indigo_property *property) {
+static duk_ret_t add_subscription(const char *device, const char *name, bool watch) {
+	pthread_mutex_lock(&PRIVATE_DATA->subscription_mutex);
+	for (int i = 0; i < PRIVATE_DATA->subscription_count; i++) {
+		subscription *subscription = PRIVATE_DATA->subscriptions + i;
+		if (subscription->watch == watch && !strcmp(subscription->device, device) && !strcmp(subscription->name, name)) {
+			pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+			return 0;
+		}
+	}
+	if (PRIVATE_DATA->subscription_count == MAX_SUBSCRIPTION_COUNT) {
+		pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+		return DUK_RET_ERROR;
+	}
+	subscription *subscription = PRIVATE_DATA->subscriptions + PRIVATE_DATA->subscription_count++;
+	indigo_copy_name(subscription->device, device);
+	indigo_copy_name(subscription->name, name);
+	subscription->watch = watch;
+	pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+	return 0;
+}
+
+static void remove_subscription(const char *device, const char *name, bool watch) {
+	pthread_mutex_lock(&PRIVATE_DATA->subscription_mutex);
+	for (int i = 0; i < PRIVATE_DATA->subscription_count; i++) {
+		subscription *subscription = PRIVATE_DATA->subscriptions + i;
+		if (subscription->watch == watch && !strcmp(subscription->device, device) && !strcmp(subscription->name, name)) {
+			memmove(subscription, subscription + 1, (--PRIVATE_DATA->subscription_count - i) * sizeof(*subscription));
+			break;
+		}
+	}
+	pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+}
+
+// function indigo_subscribe(device_name, property_name);
+
+static duk_ret_t subscribe(duk_context *ctx) {
+	const char *device = duk_is_null_or_undefined(ctx, 0) ? "" : duk_require_string(ctx, 0);
+	const char *name = duk_is_null_or_undefined(ctx, 1) ? "" : duk_require_string(ctx, 1);
+	return add_subscription(device, name, false);
+}
+
+// function indigo_unsubscribe(device_name, property_name);
+
+static duk_ret_t unsubscribe(duk_context *ctx) {
+	if (duk_is_undefined(ctx, 0)) {
+		pthread_mutex_lock(&PRIVATE_DATA->subscription_mutex);
+		int count = 0;
+		for (int i = 0; i < PRIVATE_DATA->subscription_count; i++) {
+			if (PRIVATE_DATA->subscriptions[i].watch)
+				PRIVATE_DATA->subscriptions[count++] = PRIVATE_DATA->subscriptions[i];
+		}
+		PRIVATE_DATA->subscription_count = count;
+		pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+	} else {
+		// duk_require_string() throws, so arguments are fetched before the lock is taken
+		const char *device = duk_is_null(ctx, 0) ? "" : duk_require_string(ctx, 0);
+		const char *name = duk_is_null_or_undefined(ctx, 1) ? "" : duk_require_string(ctx, 1);
+		remove_subscription(device, name, false);
+	}
+	return 0;
+}
+
+// function indigo_watch(device_name);
+
+static duk_ret_t watch(duk_context *ctx) {
+	return add_subscription(duk_require_string(ctx, 0), "", true);
+}
+
+// function indigo_unwatch(device_name);
+
+static duk_ret_t unwatch(duk_context *ctx) {
+	remove_subscription(duk_require_string(ctx, 0), "", true);
+	return 0;
+}
+
+// function indigo_handler_statistics();
+
+static duk_ret_t handler_statistics(duk_context *ctx) {
+	duk_push_object(ctx);
+	pthread_mutex_lock(&PRIVATE_DATA->subscription_mutex);
+	for (int i = 0; i < HANDLER_COUNT; i++) {
+		handler_stats *stats = PRIVATE_DATA->stats + i;
+		duk_push_object(ctx);
+		duk_push_number(ctx, stats->calls);
+		duk_put_prop_string(ctx, -2, "calls");
+		duk_push_number(ctx, stats->skipped);
+		duk_put_prop_string(ctx, -2, "skipped");
+		duk_push_number(ctx, stats->total_time);
+		duk_put_prop_string(ctx, -2, "total_time");
+		duk_push_number(ctx, stats->max_time);
+		duk_put_prop_string(ctx, -2, "max_time");
+		duk_put_prop_string(ctx, -2, handler_names[i]);
+	}
+	pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+	return 1;
+}
+
+// -------------------------------------------------------------------------------- Script execution
+
+static uint64_t script_hash(const char *script, size_t length) {
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= (unsigned char)script[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+// Push compiled script on the stack, bytecode of already compiled scripts is loaded from the cache.
+// Hash only speeds up the lookup, cached source is compared before bytecode is reused.
+
+static bool compile_script(duk_context *ctx, const char *script) {
+	size_t length = strlen(script);
+	uint64_t hash = script_hash(script, length);
+	pthread_mutex_lock(&PRIVATE_DATA->bytecode_cache_mutex);
+	for (int i = 0; i < MAX_BYTECODE_CACHE_COUNT; i++) {
+		bytecode_cache_entry *entry = PRIVATE_DATA->bytecode_cache + i;
+		if (entry->bytecode && entry->hash == hash && entry->length == length && !memcmp(entry->script, script, length)) {
+			memcpy(duk_push_fixed_buffer(ctx, entry->size), entry->bytecode, entry->size);
+			pthread_mutex_unlock(&PRIVATE_DATA->bytecode_cache_mutex);
+			duk_load_function(ctx);
+			return true;
+		}
+	}
+	pthread_mutex_unlock(&PRIVATE_DATA->bytecode_cache_mutex);
+	if (duk_pcompile_lstring(ctx, 0, script, length))
+		return false;
+	duk_dup(ctx, -1);
+	duk_dump_function(ctx);
+	duk_size_t size;
+	void *bytecode = duk_get_buffer_data(ctx, -1, &size);
+	pthread_mutex_lock(&PRIVATE_DATA->bytecode_cache_mutex);
+	bytecode_cache_entry *entry = PRIVATE_DATA->bytecode_cache + PRIVATE_DATA->bytecode_cache_next;
+	PRIVATE_DATA->bytecode_cache_next = (PRIVATE_DATA->bytecode_cache_next + 1) % MAX_BYTECODE_CACHE_COUNT;
+	entry->bytecode = indigo_safe_realloc(entry->bytecode, size);
+	memcpy(entry->bytecode, bytecode, size);
+	entry->size = size;
+	entry->script = indigo_safe_realloc(entry->script, length);
+	memcpy(entry->script, script, length);
+	entry->hash = hash;
+	entry->length = length;
+	pthread_mutex_unlock(&PRIVATE_DATA->bytecode_cache_mutex);
+	duk_pop(ctx);
+	return true;
+}
+
+static bool run_script(duk_context *ctx, const char *script, const char *label) {
+	bool result = true;
+	if (!compile_script(ctx, script) || duk_pcall(ctx, 0)) {
+		indigo_send_message(agent_device, "Failed to execute script '%s' (%s)", label, duk_safe_to_string(ctx, -1));
+		result = false;
+	}
+	duk_pop(ctx);
+	return result;
+}
+
+// Called by Duktape from the bytecode executor, udata is NULL for the main context and points to abort flag for workers
+
+duk_bool_t indigo_scripting_interrupt_check(void *udata) {
+	return udata != NULL && __atomic_load_n((bool *)udata, __ATOMIC_RELAXED);
+}
+
+static duk_context *create_context(bool *abort) {
+	duk_context *ctx = duk_create_heap(NULL, NULL, NULL, abort, NULL);
+	if (ctx) {
+		duk_push_c_function(ctx, error_message, 1);
+		duk_put_global_string(ctx, "indigo_error");
+		duk_push_c_function(ctx, log_message, 1);
+		duk_put_global_string(ctx, "indigo_log");
+		duk_push_c_function(ctx, debug_message, 1);
+		duk_put_global_string(ctx, "indigo_debug");
+		duk_push_c_function(ctx, trace_message, 1);
+		duk_put_global_string(ctx, "indigo_trace");
+		duk_push_c_function(ctx, send_message, 1);
+		duk_put_global_string(ctx, "indigo_send_message");
+		duk_push_c_function(ctx, save_blob, 2);
+		duk_put_global_string(ctx, "indigo_save_blob");
+		duk_push_c_function(ctx, populate_blob, 1);
+		duk_put_global_string(ctx, "indigo_populate_blob");
+		duk_push_c_function(ctx, emumerate_properties, 2);
+		duk_put_global_string(ctx, "indigo_enumerate_properties");
+		duk_push_c_function(ctx, enable_blob, 3);
+		duk_put_global_string(ctx, "indigo_enable_blob");
+		duk_push_c_function(ctx, change_text_property, 3);
+		duk_put_global_string(ctx, "indigo_change_text_property");
+		duk_push_c_function(ctx, change_number_property, 3);
+		duk_put_global_string(ctx, "indigo_change_number_property");
+		duk_push_c_function(ctx, change_switch_property, 3);
+		duk_put_global_string(ctx, "indigo_change_switch_property");
+		duk_push_c_function(ctx, define_text_property_locked, 9);
+		duk_put_global_string(ctx, "indigo_define_text_property");
+		duk_push_c_function(ctx, define_number_property_locked, 9);
+		duk_put_global_string(ctx, "indigo_define_number_property");
+		duk_push_c_function(ctx, define_switch_property_locked, 10);
+		duk_put_global_string(ctx, "indigo_define_switch_property");
+		duk_push_c_function(ctx, define_light_property_locked, 8);
+		duk_put_global_string(ctx, "indigo_define_light_property");
+		duk_push_c_function(ctx, update_text_property_locked, 5);
+		duk_put_global_string(ctx, "indigo_update_text_property");
+		duk_push_c_function(ctx, update_number_property_locked, 5);
+		duk_put_global_string(ctx, "indigo_update_number_property");
+		duk_push_c_function(ctx, update_switch_property_locked, 5);
+		duk_put_global_string(ctx, "indigo_update_switch_property");
+		duk_push_c_function(ctx, update_light_property_locked, 5);
+		duk_put_global_string(ctx, "indigo_update_light_property");
+		duk_push_c_function(ctx, delete_property_locked, 3);
+		duk_put_global_string(ctx, "indigo_delete_property");
+		duk_push_c_function(ctx, set_timer, 2);
+		duk_put_global_string(ctx, "indigo_set_timer");
+		duk_push_c_function(ctx, cancel_timer, 1);
+		duk_put_global_string(ctx, "indigo_cancel_timer");
+		duk_push_c_function(ctx, subscribe, 2);
+		duk_put_global_string(ctx, "indigo_subscribe");
+		duk_push_c_function(ctx, unsubscribe, DUK_VARARGS);
+		duk_put_global_string(ctx, "indigo_unsubscribe");
+		duk_push_c_function(ctx, watch, 1);
+		duk_put_global_string(ctx, "indigo_watch");
+		duk_push_c_function(ctx, unwatch, 1);
+		duk_put_global_string(ctx, "indigo_unwatch");
+		duk_push_c_function(ctx, handler_statistics, 0);
+		duk_put_global_string(ctx, "indigo_handler_statistics");
+		if (run_script(ctx, boot_js, "boot.js")) {
+			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "boot.js executed");
+		}
+	}
+	return ctx;
+}
+
+typedef struct {
+	char *script;
+	char label[INDIGO_VALUE_SIZE];
+} worker_data;
+
+// Worker has its own heap with high level API loaded, but it doesn't receive INDIGO events and can't use timers
+
+static void worker(worker_data *data) {
+	duk_context *ctx = create_context(&PRIVATE_DATA->abort_workers);
+	if (ctx) {
+		run_script(ctx, data->script, data->label);
+		duk_destroy_heap(ctx);
+	} else {
+		indigo_send_message(agent_device, "Failed to create worker context for script '%s'", data->label);
+	}
+	free(data->script);
+	free(data);
+	pthread_mutex_lock(&PRIVATE_DATA->bytecode_cache_mutex);
+	PRIVATE_DATA->worker_count--;
+	pthread_mutex_unlock(&PRIVATE_DATA->bytecode_cache_mutex);
+}
+
+static bool is_worker_script(indigo_property *property) {
+	for (int i = 1; i < AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->count; i++) {
+		indigo_item *item = AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->items + i;
+		if (!strcmp(item->name, property->name))
+			return item->sw.value;
+	}
+	return false;
+}
+
+static bool execute_script(indigo_property *property, bool allow_worker) {
 	bool result = true;
 	char *script = indigo_get_text_item_value(property->count == 1 ? property->items : property->items + 1);
 	if (script && *script) {
-		pthread_mutex_lock(&PRIVATE_DATA->mutex);
-		if (duk_peval_string(PRIVATE_DATA->ctx, script)) {
-			indigo_send_message(agent_device, "Failed to execute script '%s' (%s)", property->label, duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-			result = false;
+		if (allow_worker && is_worker_script(property)) {
+			worker_data *data = indigo_safe_malloc(sizeof(worker_data));
+			data->script = strdup(script);
+			indigo_copy_value(data->label, property->label);
+			pthread_mutex_lock(&PRIVATE_DATA->bytecode_cache_mutex);
+			PRIVATE_DATA->worker_count++;
+			pthread_mutex_unlock(&PRIVATE_DATA->bytecode_cache_mutex);
+			if (!INDIGO_ASYNC(worker, data)) {
+				pthread_mutex_lock(&PRIVATE_DATA->bytecode_cache_mutex);
+				PRIVATE_DATA->worker_count--;
+				pthread_mutex_unlock(&PRIVATE_DATA->bytecode_cache_mutex);
+				free(data->script);
+				free(data);
+				result = false;
+			}
+		} else {
+			pthread_mutex_lock(&PRIVATE_DATA->mutex);
+			result = run_script(PRIVATE_DATA->ctx, script, property->label);
+			pthread_mutex_unlock(&PRIVATE_DATA->mutex);
 		}
-		pthread_mutex_unlock(&PRIVATE_DATA->mutex);
 	}
 	return result;
 }
@@ -867,6 +1298,11 @@ static indigo_result agent_device_attach(indigo_device *device) {
 			return INDIGO_FAILED;
 		AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->count = 1;
 		indigo_init_switch_item(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items, AGENT_SCRIPTING_ADD_SCRIPT_PROPERTY_NAME, "New script", false);
+		AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY = indigo_init_switch_property(NULL, device->name, AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY_NAME, AGENT_MAIN_GROUP, "Execute in worker context", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ANY_OF_MANY_RULE, MAX_ITEMS);
+		if (AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY == NULL)
+			return INDIGO_FAILED;
+		AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->count = 1;
+		indigo_init_switch_item(AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->items, AGENT_SCRIPTING_ADD_SCRIPT_PROPERTY_NAME, "New script", false);
 		// --------------------------------------------------------------------------------
 		CONNECTION_PROPERTY->hidden = true;
 		CONFIG_PROPERTY->hidden = true;
@@ -875,61 +1311,11 @@ static indigo_result agent_device_attach(indigo_device *device) {
     pthread_mutexattr_init(&Attr);
     pthread_mutexattr_settype(&Attr, PTHREAD_MUTEX_RECURSIVE);
     pthread_mutex_init(&PRIVATE_DATA->mutex, &Attr);
-		if ((PRIVATE_DATA->ctx = duk_create_heap_default())) {
-      pthread_mutex_lock(&PRIVATE_DATA->mutex);
-			duk_push_c_function(PRIVATE_DATA->ctx, error_message, 1);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_error");
-			duk_push_c_function(PRIVATE_DATA->ctx, log_message, 1);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_log");
-			duk_push_c_function(PRIVATE_DATA->ctx, debug_message, 1);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_debug");
-			duk_push_c_function(PRIVATE_DATA->ctx, trace_message, 1);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_trace");
-			duk_push_c_function(PRIVATE_DATA->ctx, send_message, 1);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_send_message");
-			duk_push_c_function(PRIVATE_DATA->ctx, save_blob, 2);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_save_blob");
-			duk_push_c_function(PRIVATE_DATA->ctx, populate_blob, 1);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_populate_blob");
-			duk_push_c_function(PRIVATE_DATA->ctx, emumerate_properties, 2);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_enumerate_properties");
-			duk_push_c_function(PRIVATE_DATA->ctx, enable_blob, 3);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_enable_blob");
-			duk_push_c_function(PRIVATE_DATA->ctx, change_text_property, 3);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_change_text_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, change_number_property, 3);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_change_number_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, change_switch_property, 3);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_change_switch_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, define_text_property, 9);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_define_text_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, define_number_property, 9);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_define_number_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, define_switch_property, 10);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_define_switch_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, define_light_property, 8);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_define_light_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, update_text_property, 5);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_update_text_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, update_number_property, 5);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_update_number_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, update_switch_property, 5);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_update_switch_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, update_light_property, 5);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_update_light_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, delete_property, 3);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_delete_property");
-			duk_push_c_function(PRIVATE_DATA->ctx, set_timer, 2);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_set_timer");
-			duk_push_c_function(PRIVATE_DATA->ctx, cancel_timer, 1);
-			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_cancel_timer");
-			if (duk_peval_string(PRIVATE_DATA->ctx, boot_js)) {
-				INDIGO_DRIVER_ERROR(DRIVER_NAME, "%s", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-			} else {
-				INDIGO_DRIVER_DEBUG(DRIVER_NAME, "boot.js executed");
-			}
-      pthread_mutex_unlock(&PRIVATE_DATA->mutex);
-		}
+		pthread_mutex_init(&PRIVATE_DATA->subscription_mutex, NULL);
+		pthread_mutex_init(&PRIVATE_DATA->bytecode_cache_mutex, NULL);
+		pthread_mutex_lock(&PRIVATE_DATA->mutex);
+		PRIVATE_DATA->ctx = create_context(NULL);
+		pthread_mutex_unlock(&PRIVATE_DATA->mutex);
 		INDIGO_DEVICE_ATTACH_LOG(DRIVER_NAME, device->name);
 		return agent_enumerate_properties(device, NULL, NULL);
 	}
@@ -949,6 +1335,8 @@ static indigo_result agent_enumerate_properties(indigo_device *device, indigo_cl
 		indigo_define_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
 	if (indigo_property_match(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, property))
 		indigo_define_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
+	if (indigo_property_match(AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, property))
+		indigo_define_property(device, AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, NULL);
 	for (int i = 0; i < MAX_USER_SCRIPT_COUNT; i++) {
 		indigo_property *script_property = AGENT_SCRIPTING_SCRIPT_PROPERTY(i);
 		if (script_property)
@@ -964,9 +1352,7 @@ static indigo_result agent_enumerate_properties(indigo_device *device, indigo_cl
 	if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_on_enumerate_properties")) {
 		duk_push_string(PRIVATE_DATA->ctx, property && *property->device ? property->device : NULL);
 		duk_push_string(PRIVATE_DATA->ctx, property && *property->name ? property->name : NULL);
-		if (duk_pcall(PRIVATE_DATA->ctx, 2)) {
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_enumerate_properties() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-		}
+		call_handler(ON_ENUMERATE_PROPERTIES_HANDLER, 2);
 	}
 	duk_pop_2(PRIVATE_DATA->ctx);
 	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
@@ -989,7 +1375,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 					int j = atoi(item->name + AGENT_SCRIPTING_SCRIPT_PROPERTY_NAME_LENGTH);
 					indigo_property *script_property = AGENT_SCRIPTING_SCRIPT_PROPERTY(j);
 					if (script_property) {
-						execute_script(script_property);
+						execute_script(script_property, true);
 					}
 				}
 			}
@@ -1002,7 +1388,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		indigo_property_copy_values(AGENT_SCRIPTING_RUN_SCRIPT_PROPERTY, property, false);
 		AGENT_SCRIPTING_RUN_SCRIPT_PROPERTY->state = INDIGO_BUSY_STATE;
 		indigo_update_property(device, AGENT_SCRIPTING_RUN_SCRIPT_PROPERTY, NULL);
-		if (execute_script(AGENT_SCRIPTING_RUN_SCRIPT_PROPERTY)) {
+		if (execute_script(AGENT_SCRIPTING_RUN_SCRIPT_PROPERTY, false)) {
 			AGENT_SCRIPTING_RUN_SCRIPT_PROPERTY->state = INDIGO_OK_STATE;
 		} else {
 			AGENT_SCRIPTING_RUN_SCRIPT_PROPERTY->state = INDIGO_ALERT_STATE;
@@ -1045,18 +1431,23 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 			indigo_delete_property(device, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, NULL);
 			indigo_delete_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
 			indigo_delete_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
+			indigo_delete_property(device, AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, NULL);
 			AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->count++;
 			AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->count++;
 			AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->count++;
+			AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->count++;
 			indigo_init_switch_item(AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->items + j, name, AGENT_SCRIPTING_ADD_SCRIPT_NAME_ITEM->text.value, false);
 			indigo_init_switch_item(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + (j + 1), name, AGENT_SCRIPTING_ADD_SCRIPT_NAME_ITEM->text.value, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items->sw.value);
 			indigo_init_switch_item(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + (j + 1), name, AGENT_SCRIPTING_ADD_SCRIPT_NAME_ITEM->text.value, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items->sw.value);
+			indigo_init_switch_item(AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->items + (j + 1), name, AGENT_SCRIPTING_ADD_SCRIPT_NAME_ITEM->text.value, AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->items->sw.value);
 			indigo_property_sort_items(AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, 0);
 			indigo_property_sort_items(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, 1);
 			indigo_property_sort_items(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, 1);
+			indigo_property_sort_items(AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, 1);
 			indigo_define_property(device, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, NULL);
 			indigo_define_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
 			indigo_define_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
+			indigo_define_property(device, AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, NULL);
 		}
 		indigo_set_text_item_value(AGENT_SCRIPTING_ADD_SCRIPT_NAME_ITEM, "");
 		indigo_set_text_item_value(AGENT_SCRIPTING_ADD_SCRIPT_ITEM, "");
@@ -1076,7 +1467,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 				int j = atoi(item->name + AGENT_SCRIPTING_SCRIPT_PROPERTY_NAME_LENGTH);
 				indigo_property *script_property = AGENT_SCRIPTING_SCRIPT_PROPERTY(j);
 				if (script_property) {
-					if (!execute_script(script_property)) {
+					if (!execute_script(script_property, true)) {
 						AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->state = INDIGO_ALERT_STATE;
 						indigo_update_property(device, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, NULL);
 						return INDIGO_OK;
@@ -1102,19 +1493,23 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 				indigo_delete_property(device, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, NULL);
 				indigo_delete_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
 				indigo_delete_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
+				indigo_delete_property(device, AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, NULL);
 				int count = AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->count;
 				if (i + 1 < count) {
 					memmove(AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->items + i, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->items + i + 1, sizeof(indigo_item) * (count - i - 1));
 					memmove(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + (i + 1), AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + i + 2, sizeof(indigo_item) * (count - i - 1));
 					memmove(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + (i + 1), AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + i + 2, sizeof(indigo_item) * (count - i - 1));
+					memmove(AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->items + (i + 1), AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->items + i + 2, sizeof(indigo_item) * (count - i - 1));
 				}
 				AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->count--;
 				AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->count--;
 				AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->count--;
+				AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->count--;
 				AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY->state = INDIGO_OK_STATE;
 				indigo_define_property(device, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, NULL);
 				indigo_define_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
 				indigo_define_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
+				indigo_define_property(device, AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, NULL);
 				break;
 			}
 		}
@@ -1134,6 +1529,13 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		indigo_update_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
 		save_config(device);
 		return INDIGO_OK;
+	} else if (indigo_property_match(AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, property)) {
+		// -------------------------------------------------------------------------------- AGENT_SCRIPTING_WORKER_SCRIPT
+		indigo_property_copy_values(AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, property, false);
+		AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, NULL);
+		save_config(device);
+		return INDIGO_OK;
 	} else {
 		for (int i = 0; i < MAX_USER_SCRIPT_COUNT; i++) {
 			indigo_property *script_property = AGENT_SCRIPTING_SCRIPT_PROPERTY(i);
@@ -1149,15 +1551,19 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 							indigo_delete_property(device, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, NULL);
 							indigo_delete_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
 							indigo_delete_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
+							indigo_delete_property(device, AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, NULL);
 							strcpy(item->label, script_property->label);
 							strcpy(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items[j + 1].label, script_property->label);
 							strcpy(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items[j + 1].label, script_property->label);
+							strcpy(AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY->items[j + 1].label, script_property->label);
 							indigo_property_sort_items(AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, 0);
 							indigo_property_sort_items(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, 1);
 							indigo_property_sort_items(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, 1);
+							indigo_property_sort_items(AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, 1);
 							indigo_define_property(device, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, NULL);
 							indigo_define_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
 							indigo_define_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
+							indigo_define_property(device, AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY, NULL);
 							break;
 						}
 					}
@@ -1178,9 +1584,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
       duk_push_string(PRIVATE_DATA->ctx, property->name);
       push_items(property, true);
       push_state(property->state);
-      if (duk_pcall(PRIVATE_DATA->ctx, 4)) {
-        INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_change_property() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-      }
+      call_handler(ON_CHANGE_PROPERTY_HANDLER, 4);
     }
     duk_pop_2(PRIVATE_DATA->ctx);
     pthread_mutex_unlock(&PRIVATE_DATA->mutex);
@@ -1193,8 +1597,34 @@ static indigo_result agent_enable_blob(indigo_device *device, indigo_client *cli
 	return INDIGO_OK;
 }
 
+// Abort worker scripts and wait for them to stop, timeout <= 0 means wait forever.
+// Worker blocked in native binding sees abort only after the binding returns, so it may not stop in time.
+
+static bool stop_workers(int timeout) {
+	__atomic_store_n(&PRIVATE_DATA->abort_workers, true, __ATOMIC_RELAXED);
+	for (int i = 0; timeout <= 0 || i <= timeout * 10; i++) {
+		pthread_mutex_lock(&PRIVATE_DATA->bytecode_cache_mutex);
+		int worker_count = PRIVATE_DATA->worker_count;
+		pthread_mutex_unlock(&PRIVATE_DATA->bytecode_cache_mutex);
+		if (worker_count == 0)
+			return true;
+		if (timeout > 0 && i == timeout * 10) {
+			// agent stays loaded, let still running workers finish normally
+			__atomic_store_n(&PRIVATE_DATA->abort_workers, false, __ATOMIC_RELAXED);
+			INDIGO_DRIVER_ERROR(DRIVER_NAME, "%d worker script(s) didn't stop in %ds", worker_count, timeout);
+			return false;
+		}
+		if (i % 10 == 0)
+			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Waiting for %d worker script(s) to stop", worker_count);
+		indigo_usleep(ONE_SECOND_DELAY / 10);
+	}
+	return true;
+}
+
 static indigo_result agent_device_detach(indigo_device *device) {
 	assert(device != NULL);
+	// workers were stopped by driver shutdown, but never free state referenced by worker started since then
+	stop_workers(0);
 	if (PRIVATE_DATA->ctx) {
 		AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->state = INDIGO_BUSY_STATE;
 		indigo_update_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, "Executing on-unload scripts");
@@ -1204,7 +1634,7 @@ static indigo_result agent_device_detach(indigo_device *device) {
 				int j = atoi(item->name + AGENT_SCRIPTING_SCRIPT_PROPERTY_NAME_LENGTH);
 				indigo_property *script_property = AGENT_SCRIPTING_SCRIPT_PROPERTY(j);
 				if (script_property) {
-					execute_script(script_property);
+					execute_script(script_property, false);
 				}
 			}
 		}
@@ -1216,9 +1646,23 @@ static indigo_result agent_device_detach(indigo_device *device) {
 		if (PRIVATE_DATA->timers[i])
 			indigo_cancel_timer_sync(agent_device, PRIVATE_DATA->timers + i);
 	}
+	for (int i = 0; i < HANDLER_COUNT; i++) {
+		handler_stats *stats = PRIVATE_DATA->stats + i;
+		if (stats->calls || stats->skipped)
+			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "%s(): %lu calls, %lu skipped, %.3fs total, %.3fs max", handler_names[i], stats->calls, stats->skipped, stats->total_time, stats->max_time);
+	}
 	pthread_mutex_destroy(&PRIVATE_DATA->mutex);
+	pthread_mutex_destroy(&PRIVATE_DATA->subscription_mutex);
+	for (int i = 0; i < MAX_BYTECODE_CACHE_COUNT; i++) {
+		if (PRIVATE_DATA->bytecode_cache[i].bytecode)
+			free(PRIVATE_DATA->bytecode_cache[i].bytecode);
+		if (PRIVATE_DATA->bytecode_cache[i].script)
+			free(PRIVATE_DATA->bytecode_cache[i].script);
+	}
+	pthread_mutex_destroy(&PRIVATE_DATA->bytecode_cache_mutex);
 	indigo_release_property(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY);
 	indigo_release_property(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY);
+	indigo_release_property(AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY);
 	indigo_release_property(AGENT_SCRIPTING_RUN_SCRIPT_PROPERTY);
 	indigo_release_property(AGENT_SCRIPTING_ADD_SCRIPT_PROPERTY);
 	indigo_release_property(AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY);
@@ -1248,6 +1692,9 @@ static indigo_result agent_client_attach(indigo_client *client) {
 }
 
 static indigo_result agent_define_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	event_dispatch dispatch = event_dispatch_for(property->device, property->name, ON_DEFINE_PROPERTY_HANDLER);
+	if (dispatch == EVENT_SKIPPED)
+		return INDIGO_OK;
 	pthread_mutex_lock(&PRIVATE_DATA->mutex);
 	duk_push_global_object(PRIVATE_DATA->ctx);
 	if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_on_define_property")) {
@@ -1258,9 +1705,8 @@ static indigo_result agent_define_property(indigo_client *client, indigo_device
 		push_state(property->state);
 		duk_push_string(PRIVATE_DATA->ctx, property->perm == INDIGO_RW_PERM ? "RW" : property->perm == INDIGO_RO_PERM ? "RO" : "WO");
 		duk_push_string(PRIVATE_DATA->ctx, message);
-		if (duk_pcall(PRIVATE_DATA->ctx, 7)) {
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_define_property() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-		}
+		duk_push_boolean(PRIVATE_DATA->ctx, dispatch == EVENT_SUBSCRIBED);
+		call_handler(ON_DEFINE_PROPERTY_HANDLER, 8);
 	}
 	duk_pop_2(PRIVATE_DATA->ctx);
 	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
@@ -1268,6 +1714,9 @@ static indigo_result agent_define_property(indigo_client *client, indigo_device
 }
 
 static indigo_result agent_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	event_dispatch dispatch = event_dispatch_for(property->device, property->name, ON_UPDATE_PROPERTY_HANDLER);
+	if (dispatch == EVENT_SKIPPED)
+		return INDIGO_OK;
 	pthread_mutex_lock(&PRIVATE_DATA->mutex);
 	duk_push_global_object(PRIVATE_DATA->ctx);
 	if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_on_update_property")) {
@@ -1276,9 +1725,8 @@ static indigo_result agent_update_property(indigo_client *client, indigo_device
 		push_items(property, false);
 		push_state(property->state);
 		duk_push_string(PRIVATE_DATA->ctx, message);
-		if (duk_pcall(PRIVATE_DATA->ctx, 5)) {
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_update_property() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-		}
+		duk_push_boolean(PRIVATE_DATA->ctx, dispatch == EVENT_SUBSCRIBED);
+		call_handler(ON_UPDATE_PROPERTY_HANDLER, 6);
 	}
 	duk_pop_2(PRIVATE_DATA->ctx);
 	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
@@ -1286,15 +1734,16 @@ static indigo_result agent_update_property(indigo_client *client, indigo_device
 }
 
 static indigo_result agent_delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	// delete carries no items and is always passed to boot.js, so stale indigo_devices entries are removed
+	event_dispatch dispatch = event_dispatch_for(property->device, *property->name ? property->name : NULL, ON_DELETE_PROPERTY_HANDLER);
 	pthread_mutex_lock(&PRIVATE_DATA->mutex);
 	duk_push_global_object(PRIVATE_DATA->ctx);
 	if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_on_delete_property")) {
 		duk_push_string(PRIVATE_DATA->ctx, property->device);
 		duk_push_string(PRIVATE_DATA->ctx, property->name);
 		duk_push_string(PRIVATE_DATA->ctx, message);
-		if (duk_pcall(PRIVATE_DATA->ctx, 3)) {
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_delete_property() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-		}
+		duk_push_boolean(PRIVATE_DATA->ctx, dispatch == EVENT_SUBSCRIBED);
+		call_handler(ON_DELETE_PROPERTY_HANDLER, 4);
 	}
 	duk_pop_2(PRIVATE_DATA->ctx);
 	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
@@ -1307,9 +1756,7 @@ static indigo_result agent_send_message(indigo_client *client, indigo_device *de
 	if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_on_send_message")) {
 		duk_push_string(PRIVATE_DATA->ctx, device->name);
 		duk_push_string(PRIVATE_DATA->ctx, message);
-		if (duk_pcall(PRIVATE_DATA->ctx, 2)) {
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_send_message() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-		}
+		call_handler(ON_SEND_MESSAGE_HANDLER, 2);
 	}
 	duk_pop_2(PRIVATE_DATA->ctx);
 	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
@@ -1362,6 +1809,8 @@ indigo_result indigo_agent_scripting(indigo_driver_action action, indigo_driver_
 			break;
 
 		case INDIGO_DRIVER_SHUTDOWN:
+			if (private_data != NULL && !stop_workers(WORKER_STOP_TIMEOUT))
+				return INDIGO_BUSY;
 			last_action = action;
 			if (agent_client != NULL) {
 				indigo_detach_client(agent_client);
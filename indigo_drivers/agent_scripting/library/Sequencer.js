@@ -234,6 +234,7 @@ Sequence.prototype.start = function(imager_agent, mount_agent, guider_agent) {
 	indigo_sequencer.devices[2] = imager_agent == undefined ? "Imager Agent" : imager_agent;
 	indigo_sequencer.devices[3] = mount_agent == undefined ? "Mount Agent" : mount_agent;
 	indigo_sequencer.devices[4] = guider_agent == undefined ? "Guider Agent" : guider_agent;
+	indigo_watch_devices(indigo_sequencer.devices);
 	indigo_sequencer.start(this.sequence);
 };
 
@@ -1260,4 +1261,6 @@ indigo_delete_property("Scripting Agent", "LOOP_7");
 indigo_delete_property("Scripting Agent", "LOOP_8");
 indigo_delete_property("Scripting Agent", "LOOP_9");
 indigo_event_handlers.indigo_sequencer = indigo_sequencer;
+indigo_watch_devices(indigo_sequencer.devices);
+indigo_watch_devices(indigo_flipper.devices);
 indigo_enumerate_properties();
@@ -54,6 +54,8 @@
 
 #define SNOOP_RULES_PROPERTY										(DEVICE_PRIVATE_DATA->rules_property)
 
+#define RULE_INDEX_SIZE													64
+
 typedef struct rule {
 	char source_device_name[INDIGO_NAME_SIZE];
 	char source_property_name[INDIGO_NAME_SIZE];
@@ -64,7 +66,12 @@ typedef struct rule {
 	indigo_device *target_device;
 	indigo_property *target_property;
 	indigo_property_state state;
+	int index;
+	unsigned long forwarded;
 	struct rule *next;
+	struct rule *next_source;
+	struct rule *next_target;
+	struct rule *next_property;
 } rule;
 
 typedef struct {
@@ -74,38 +81,150 @@ typedef struct {
 	indigo_device *device;
 	indigo_client *client;
 	rule *rules;
+	rule *source_index[RULE_INDEX_SIZE];
+	rule *target_index[RULE_INDEX_SIZE];
+	rule *property_index[RULE_INDEX_SIZE];
+	pthread_mutex_t mutex;
 } agent_private_data;
 
 static indigo_result agent_enumerate_properties(indigo_device *device, indigo_client *client, indigo_property *property);
 
-static indigo_result forward_property(indigo_device *device, indigo_client *client, rule *r) {
-	assert(client != NULL);
+static unsigned name_hash(const char *device_name, const char *property_name) {
+	unsigned hash = 5381;
+	while (*device_name)
+		hash = hash * 33 + (unsigned char)*device_name++;
+	while (*property_name)
+		hash = hash * 33 + (unsigned char)*property_name++;
+	return hash % RULE_INDEX_SIZE;
+}
+
+static unsigned property_hash(indigo_property *property) {
+	return (unsigned)(((uintptr_t)property >> 4) % RULE_INDEX_SIZE);
+}
+
+// Rebuild indexes of rules by source and target names and by source property, must be called after any change of rule list or rule source property.
+// Rule list and indexes are guarded by private_data->mutex, it is recursive because the rules property is redefined with it held and clients may call back into the agent.
+
+static void index_rules(agent_private_data *private_data) {
+	memset(private_data->source_index, 0, sizeof(private_data->source_index));
+	memset(private_data->target_index, 0, sizeof(private_data->target_index));
+	memset(private_data->property_index, 0, sizeof(private_data->property_index));
+	int index = 0;
+	for (rule *r = private_data->rules; r; r = r->next) {
+		r->index = index++;
+		unsigned hash = name_hash(r->source_device_name, r->source_property_name);
+		r->next_source = private_data->source_index[hash];
+		private_data->source_index[hash] = r;
+		hash = name_hash(r->target_device_name, r->target_property_name);
+		r->next_target = private_data->target_index[hash];
+		private_data->target_index[hash] = r;
+		if (r->source_property) {
+			hash = property_hash(r->source_property);
+			r->next_property = private_data->property_index[hash];
+			private_data->property_index[hash] = r;
+		} else {
+			r->next_property = NULL;
+		}
+	}
+}
+
+static bool forward_allowed(rule *r) {
+	indigo_property *source_property = r->source_property;
+	if (source_property->rule == INDIGO_AT_MOST_ONE_RULE && r->target_property->rule == INDIGO_ONE_OF_MANY_RULE) {
+		for (int i = 0; i < source_property->count; i++) {
+			if (source_property->items[i].sw.value)
+				return true;
+		}
+		return false;
+	}
+	return true;
+}
+
+// Forwarded changes and rule state updates are collected with the mutex held and dispatched in order after it is released,
+// so target drivers and clients are never called with the rule list locked.
+
+typedef struct pending_update {
+	indigo_device *target_device;
+	indigo_property *property;
+	char message[INDIGO_VALUE_SIZE];
+	struct pending_update *next;
+} pending_update;
+
+typedef struct {
+	pending_update *first;
+	pending_update **last;
+	indigo_property *rules_property;
+} pending_list;
+
+#define PENDING_LIST_INITIALIZER(list) { NULL, &(list).first, NULL }
+
+static pending_update *append_pending(pending_list *list) {
+	pending_update *pending = indigo_safe_malloc(sizeof(pending_update));
+	*list->last = pending;
+	list->last = &pending->next;
+	return pending;
+}
+
+// Queue copy of the source property of the rule renamed to its target
+
+static void queue_forward(pending_list *list, rule *r) {
 	assert(r != NULL);
 	assert(r->source_device != NULL);
 	assert(r->source_property != NULL);
 	assert(r->target_device != NULL);
 	assert(r->target_property != NULL);
-	indigo_property *source_property = r->source_property;
-	indigo_property *target_property = r->target_property;
-	if (source_property->rule == INDIGO_AT_MOST_ONE_RULE && target_property->rule == INDIGO_ONE_OF_MANY_RULE) {
-		bool any_set = false;
-		for (int i = 0; i < source_property->count; i++) {
-			if (source_property->items[i].sw.value) {
-				any_set = true;
-				break;
-			}
+	if (!forward_allowed(r))
+		return;
+	int size = sizeof(indigo_property) + r->source_property->count * sizeof(indigo_item);
+	pending_update *pending = append_pending(list);
+	pending->target_device = r->target_device;
+	pending->property = indigo_safe_malloc(size);
+	memcpy(pending->property, r->source_property, size);
+	indigo_copy_name(pending->property->device, r->target_device_name);
+	indigo_copy_name(pending->property->name, r->target_property_name);
+	r->forwarded++;
+	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Forward: '%s'.%s > '%s'.%s (%lu)", r->source_device_name, r->source_property_name, r->target_device_name, r->target_property_name, r->forwarded);
+}
+
+static void rule_state_changed(indigo_client *client, pending_list *list, rule *r, indigo_property_state state, const char *status) {
+	CLIENT_PRIVATE_DATA->rules_property->items[r->index].light.value = r->state = state;
+	pending_update *pending = append_pending(list);
+	if (status)
+		snprintf(pending->message, sizeof(pending->message), "Rule '%s'.%s > '%s'.%s %s", r->source_device_name, r->source_property_name, r->target_device_name, r->target_property_name, status);
+}
+
+// Must be called with the mutex held, takes snapshot of rules property for queued state updates
+
+static void close_pending(indigo_client *client, pending_list *list) {
+	for (pending_update *pending = list->first; pending; pending = pending->next) {
+		if (pending->target_device == NULL) {
+			list->rules_property = indigo_copy_property(NULL, CLIENT_PRIVATE_DATA->rules_property);
+			break;
 		}
-		if (!any_set)
-			return INDIGO_OK;
 	}
-	int size = sizeof(indigo_property) + source_property->count * sizeof(indigo_item);
-	indigo_property *property = indigo_safe_malloc_copy(size, source_property);
-	indigo_copy_name(property->device, r->target_device_name);
-	indigo_copy_name(property->name, r->target_property_name);
-	indigo_trace_property("Property set by rule", NULL, property, false, true);
-	indigo_result result = r->target_device->last_result = r->target_device->change_property(r->target_device, client, property);
-	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Forward: '%s'.%s > '%s'.%s", r->source_device_name, r->source_property_name, r->target_device_name, r->target_property_name);
-	free(property);
+}
+
+static indigo_result dispatch_pending(indigo_client *client, pending_list *list) {
+	indigo_result result = INDIGO_OK;
+	pending_update *pending = list->first;
+	while (pending) {
+		if (pending->target_device) {
+			indigo_trace_property("Property set by rule", NULL, pending->property, false, true);
+			indigo_result rule_result = pending->target_device->last_result = pending->target_device->change_property(pending->target_device, client, pending->property);
+			if (rule_result != INDIGO_OK)
+				result = rule_result;
+			free(pending->property);
+		} else if (*pending->message) {
+			indigo_update_property(CLIENT_PRIVATE_DATA->device, list->rules_property, "%s", pending->message);
+		} else {
+			indigo_update_property(CLIENT_PRIVATE_DATA->device, list->rules_property, NULL);
+		}
+		pending_update *next = pending->next;
+		free(pending);
+		pending = next;
+	}
+	if (list->rules_property)
+		indigo_release_property(list->rules_property);
 	return result;
 }
 
@@ -115,7 +234,7 @@ static void sync_rules(indigo_device *device) {
 	char name[INDIGO_NAME_SIZE], label[INDIGO_VALUE_SIZE];
 	while (r) {
 		snprintf(name, INDIGO_NAME_SIZE, "RULE_%d", index);
-		snprintf(label, INDIGO_VALUE_SIZE, "%s.%s > %s.%s", r->source_device_name, r->source_property_name, r->target_device_name, r->target_property_name);
+		snprintf(label, INDIGO_VALUE_SIZE, "%s.%s > %s.%s (%lu)", r->source_device_name, r->source_property_name, r->target_device_name, r->target_property_name, r->forwarded);
 		indigo_init_light_item(SNOOP_RULES_PROPERTY->items + index, name, label, r->state);
 		index++;
 		r = r->next;
@@ -177,12 +296,14 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		return INDIGO_OK;
 	if (indigo_property_match(SNOOP_ADD_RULE_PROPERTY, property)) {
 		indigo_property_copy_values(SNOOP_ADD_RULE_PROPERTY, property, false);
+		pthread_mutex_lock(&DEVICE_PRIVATE_DATA->mutex);
 		rule *r = DEVICE_PRIVATE_DATA->rules;
 		while (r) {
 			if (!strcmp(r->source_device_name, SNOOP_ADD_RULE_SOURCE_DEVICE_ITEM->text.value) &&
 				!strcmp(r->source_property_name, SNOOP_ADD_RULE_SOURCE_PROPERTY_ITEM->text.value) &&
 				!strcmp(r->target_device_name, SNOOP_ADD_RULE_TARGET_DEVICE_ITEM->text.value) &&
 				!strcmp(r->target_property_name, SNOOP_ADD_RULE_TARGET_PROPERTY_ITEM->text.value)) {
+					pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->mutex);
 					SNOOP_ADD_RULE_PROPERTY->state = INDIGO_ALERT_STATE;
 					indigo_update_property(device, SNOOP_ADD_RULE_PROPERTY, "Duplicate rule");
 					return INDIGO_OK;
@@ -197,19 +318,22 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		r->state = INDIGO_OK_STATE;
 		r->next = DEVICE_PRIVATE_DATA->rules;
 		DEVICE_PRIVATE_DATA->rules = r;
+		index_rules(DEVICE_PRIVATE_DATA);
 		SNOOP_RULES_PROPERTY = indigo_resize_property(SNOOP_RULES_PROPERTY, SNOOP_RULES_PROPERTY->count + 1);
 		sync_rules(device);
+		pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->mutex);
 		SNOOP_ADD_RULE_PROPERTY->state = INDIGO_OK_STATE;
 		indigo_update_property(device, SNOOP_ADD_RULE_PROPERTY, NULL);
 		indigo_property INDIGO_ALL_PROPERTIES;
 		memset(&INDIGO_ALL_PROPERTIES, 0, sizeof(INDIGO_ALL_PROPERTIES));
 		INDIGO_ALL_PROPERTIES.version = INDIGO_VERSION_CURRENT;
-		strcpy(INDIGO_ALL_PROPERTIES.device, r->source_device_name);
+		indigo_copy_name(INDIGO_ALL_PROPERTIES.device, SNOOP_ADD_RULE_SOURCE_DEVICE_ITEM->text.value);
 		indigo_enumerate_properties(DEVICE_PRIVATE_DATA->client, &INDIGO_ALL_PROPERTIES);
-		strcpy(INDIGO_ALL_PROPERTIES.device, r->target_device_name);
+		indigo_copy_name(INDIGO_ALL_PROPERTIES.device, SNOOP_ADD_RULE_TARGET_DEVICE_ITEM->text.value);
 		indigo_enumerate_properties(DEVICE_PRIVATE_DATA->client, &INDIGO_ALL_PROPERTIES);
 	} else if (indigo_property_match(SNOOP_REMOVE_RULE_PROPERTY, property)) {
 		indigo_property_copy_values(SNOOP_REMOVE_RULE_PROPERTY, property, false);
+		pthread_mutex_lock(&DEVICE_PRIVATE_DATA->mutex);
 		rule *r = DEVICE_PRIVATE_DATA->rules;
 		rule *rr = NULL;
 		while (r) {
@@ -227,11 +351,16 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 				rr->next = r->next;
 			else
 				DEVICE_PRIVATE_DATA->rules = r->next;
+			index_rules(DEVICE_PRIVATE_DATA);
+			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Rule '%s'.%s > '%s'.%s removed after %lu forwarded updates", r->source_device_name, r->source_property_name, r->target_device_name, r->target_property_name, r->forwarded);
+			free(r);
 			SNOOP_RULES_PROPERTY = indigo_resize_property(SNOOP_RULES_PROPERTY, SNOOP_RULES_PROPERTY->count - 1);
 			sync_rules(device);
+			pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->mutex);
 			SNOOP_REMOVE_RULE_PROPERTY->state = INDIGO_OK_STATE;
 			indigo_update_property(device, SNOOP_REMOVE_RULE_PROPERTY, NULL);
 		} else {
+			pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->mutex);
 			SNOOP_REMOVE_RULE_PROPERTY->state = INDIGO_ALERT_STATE;
 			indigo_update_property(device, SNOOP_REMOVE_RULE_PROPERTY, "No such rule");
 		}
@@ -241,8 +370,11 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 
 static indigo_result agent_device_detach(indigo_device *device) {
 	assert(device != NULL);
+	pthread_mutex_lock(&DEVICE_PRIVATE_DATA->mutex);
 	rule *r = DEVICE_PRIVATE_DATA->rules;
 	DEVICE_PRIVATE_DATA->rules = NULL;
+	index_rules(DEVICE_PRIVATE_DATA);
+	pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->mutex);
 	while (r) {
 		rule *rr = r->next;
 		free(r);
@@ -258,33 +390,50 @@ static indigo_result agent_device_detach(indigo_device *device) {
 static indigo_result agent_define_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
 	if (device == CLIENT_PRIVATE_DATA->device)
 		return INDIGO_OK;
-	rule *r = CLIENT_PRIVATE_DATA->rules;
-	int index = 0;
-	while (r) {
-		bool changed = false;
+	unsigned hash = name_hash(property->device, property->name);
+	bool reindex = false;
+	pending_list list = PENDING_LIST_INITIALIZER(list);
+	pthread_mutex_lock(&CLIENT_PRIVATE_DATA->mutex);
+	for (rule *r = CLIENT_PRIVATE_DATA->source_index[hash]; r; r = r->next_source) {
 		if (!strcmp(r->source_device_name, property->device) && !strcmp(r->source_property_name, property->name)) {
-			changed = r->source_device == NULL;
+			bool changed = r->source_device == NULL;
+			reindex = reindex || r->source_property != property;
 			r->source_device = device;
 			r->source_property = property;
-		} else if (!strcmp(r->target_device_name, property->device) && !strcmp(r->target_property_name, property->name)) {
-			changed = r->target_device == NULL;
+			if (changed) {
+				if (r->target_property) {
+					rule_state_changed(client, &list, r, INDIGO_OK_STATE, "is active");
+					if (r->source_property->state != INDIGO_ALERT_STATE)
+						queue_forward(&list, r);
+				} else {
+					rule_state_changed(client, &list, r, INDIGO_BUSY_STATE, NULL);
+				}
+			}
+		}
+	}
+	if (reindex)
+		index_rules(CLIENT_PRIVATE_DATA);
+	for (rule *r = CLIENT_PRIVATE_DATA->target_index[hash]; r; r = r->next_target) {
+		if (!strcmp(r->target_device_name, property->device) && !strcmp(r->target_property_name, property->name)) {
+			if (!strcmp(r->source_device_name, property->device) && !strcmp(r->source_property_name, property->name))
+				continue;
+			bool changed = r->target_device == NULL;
 			r->target_device = device;
 			r->target_property = property;
-		}
-		if (changed) {
-			if (r->source_property && r->target_property) {
-				CLIENT_PRIVATE_DATA->rules_property->items[index].light.value = r->state = INDIGO_OK_STATE;
-				indigo_update_property(CLIENT_PRIVATE_DATA->device, CLIENT_PRIVATE_DATA->rules_property, "Rule '%s'.%s > '%s'.%s is active", r->source_device_name, r->source_property_name, r->target_device_name, r->target_property_name);
-				if (r->source_property->state != INDIGO_ALERT_STATE)
-					forward_property(device, client, r);
-			} else {
-				CLIENT_PRIVATE_DATA->rules_property->items[index].light.value = r->state = INDIGO_BUSY_STATE;
-				indigo_update_property(CLIENT_PRIVATE_DATA->device, CLIENT_PRIVATE_DATA->rules_property, NULL);
+			if (changed) {
+				if (r->source_property) {
+					rule_state_changed(client, &list, r, INDIGO_OK_STATE, "is active");
+					if (r->source_property->state != INDIGO_ALERT_STATE)
+						queue_forward(&list, r);
+				} else {
+					rule_state_changed(client, &list, r, INDIGO_BUSY_STATE, NULL);
+				}
 			}
 		}
-		r = r->next;
-		index++;
 	}
+	close_pending(client, &list);
+	pthread_mutex_unlock(&CLIENT_PRIVATE_DATA->mutex);
+	dispatch_pending(client, &list);
 	return INDIGO_OK;
 }
 
@@ -293,51 +442,41 @@ static indigo_result agent_update_property(indigo_client *client, indigo_device
 		return INDIGO_OK;
 	if (property->state == INDIGO_ALERT_STATE)
 		return INDIGO_OK;
-	rule *r = CLIENT_PRIVATE_DATA->rules;
-	while (r) {
-		if (r->source_property == property) {
-			if (r->target_property) {
-				INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Rule '%s'.%s > '%s'.%s used", r->source_device_name, r->source_property_name, r->target_device_name, r->target_property_name);
-				return forward_property(device, client, r);
-			}
-			break;
-		} else {
-			r = r->next;
+	pending_list list = PENDING_LIST_INITIALIZER(list);
+	pthread_mutex_lock(&CLIENT_PRIVATE_DATA->mutex);
+	for (rule *r = CLIENT_PRIVATE_DATA->property_index[property_hash(property)]; r; r = r->next_property) {
+		if (r->source_property == property && r->target_property) {
+			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Rule '%s'.%s > '%s'.%s used", r->source_device_name, r->source_property_name, r->target_device_name, r->target_property_name);
+			queue_forward(&list, r);
 		}
 	}
-	return INDIGO_OK;
+	pthread_mutex_unlock(&CLIENT_PRIVATE_DATA->mutex);
+	return dispatch_pending(client, &list);
 }
 
 static indigo_result agent_delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
 	if (device == CLIENT_PRIVATE_DATA->device)
 		return INDIGO_OK;
-	rule *r = CLIENT_PRIVATE_DATA->rules;
-	int index = 0;
-	while (r) {
-		if (!strcmp(r->source_device_name, property->device) && !strcmp(r->source_property_name, property->name)) {
+	bool reindex = false;
+	pending_list list = PENDING_LIST_INITIALIZER(list);
+	pthread_mutex_lock(&CLIENT_PRIVATE_DATA->mutex);
+	for (rule *r = CLIENT_PRIVATE_DATA->rules; r; r = r->next) {
+		if (!strcmp(r->source_device_name, property->device) && (*property->name == 0 || !strcmp(r->source_property_name, property->name))) {
+			reindex = reindex || r->source_property != NULL;
 			r->source_device = NULL;
 			r->source_property = NULL;
-			if (r->target_property) {
-				CLIENT_PRIVATE_DATA->rules_property->items[index].light.value = r->state = INDIGO_BUSY_STATE;
-				indigo_update_property(CLIENT_PRIVATE_DATA->device, CLIENT_PRIVATE_DATA->rules_property, "Rule '%s'.%s > '%s'.%s isn't active", r->source_device_name, r->source_property_name, r->target_device_name, r->target_property_name);
-			} else {
-				CLIENT_PRIVATE_DATA->rules_property->items[index].light.value = r->state = INDIGO_OK_STATE;
-				indigo_update_property(CLIENT_PRIVATE_DATA->device, CLIENT_PRIVATE_DATA->rules_property, NULL);
-			}
-		} else if (!strcmp(r->target_device_name, property->device) && !strcmp(r->target_property_name, property->name)) {
+			rule_state_changed(client, &list, r, r->target_property ? INDIGO_BUSY_STATE : INDIGO_OK_STATE, r->target_property ? "isn't active" : NULL);
+		} else if (!strcmp(r->target_device_name, property->device) && (*property->name == 0 || !strcmp(r->target_property_name, property->name))) {
 			r->target_device = NULL;
 			r->target_property = NULL;
-			if (r->source_property) {
-				CLIENT_PRIVATE_DATA->rules_property->items[index].light.value = r->state = INDIGO_BUSY_STATE;
-				indigo_update_property(CLIENT_PRIVATE_DATA->device, CLIENT_PRIVATE_DATA->rules_property, "Rule '%s'.%s > '%s'.%s isn't active", r->source_device_name, r->source_property_name, r->target_device_name, r->target_property_name);
-			} else {
-				CLIENT_PRIVATE_DATA->rules_property->items[index].light.value = r->state = INDIGO_OK_STATE;
-				indigo_update_property(CLIENT_PRIVATE_DATA->device, CLIENT_PRIVATE_DATA->rules_property, NULL);
-			}
+			rule_state_changed(client, &list, r, r->source_property ? INDIGO_BUSY_STATE : INDIGO_OK_STATE, r->source_property ? "isn't active" : NULL);
 		}
-		r = r->next;
-		index++;
 	}
+	if (reindex)
+		index_rules(CLIENT_PRIVATE_DATA);
+	close_pending(client, &list);
+	pthread_mutex_unlock(&CLIENT_PRIVATE_DATA->mutex);
+	dispatch_pending(client, &list);
 	return INDIGO_OK;
 }
 
@@ -379,6 +518,11 @@ indigo_result indigo_agent_snoop(indigo_driver_action action, indigo_driver_info
 		case INDIGO_DRIVER_INIT:
 			last_action = action;
 			private_data = indigo_safe_malloc(sizeof(agent_private_data));
+			pthread_mutexattr_t attr;
+			pthread_mutexattr_init(&attr);
+			pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+			pthread_mutex_init(&private_data->mutex, &attr);
+			pthread_mutexattr_destroy(&attr);
 			agent_device = indigo_safe_malloc_copy(sizeof(indigo_device), &agent_device_template);
 			private_data->device = agent_device;
 			agent_device->private_data = private_data;
@@ -402,6 +546,8 @@ indigo_result indigo_agent_snoop(indigo_driver_action action, indigo_driver_info
 				agent_client = NULL;
 			}
 			if (private_data != NULL) {
+				// mutex is used by both agent device and agent client, destroy it after both are detached
+				pthread_mutex_destroy(&private_data->mutex);
 				free(private_data);
 				private_data = NULL;
 			}
@@ -355,7 +355,7 @@ static bool apogee_open(indigo_device *device) {
 
 	if (PRIVATE_DATA->buffer == NULL) {
 		PRIVATE_DATA->buffer_size = image_height * image_width * 2 + FITS_HEADER_SIZE;
-		PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_blob_buffer(PRIVATE_DATA->buffer_size);
+		PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_frame_buffer(PRIVATE_DATA->buffer_size);
 	}
 
 	pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
@@ -592,7 +592,7 @@ static void apogee_close(indigo_device *device) {
 	}
 	indigo_global_unlock(device);
 	if (PRIVATE_DATA->buffer != NULL) {
-		free(PRIVATE_DATA->buffer);
+		indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 		PRIVATE_DATA->buffer = NULL;
 	}
 	pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
@@ -1468,7 +1468,7 @@ static void remove_all_devices() {
 			continue;
 		indigo_detach_device(*device);
 		if (((apogee_private_data *)(*device)->private_data)->buffer)
-			free(((apogee_private_data *)(*device)->private_data)->buffer);
+			indigo_free_frame_buffer(((apogee_private_data *)(*device)->private_data)->buffer);
 		free((*device)->private_data);
 		free(*device);
 		*device = NULL;
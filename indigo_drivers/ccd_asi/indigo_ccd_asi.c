@@ -51,6 +51,8 @@
 #include <libusb-1.0/libusb.h>
 #endif
 
+#include <indigo/indigo_usb_utils.h>
+
 #include "ASICamera2.h"
 
 #define ASI_DEFAULT_BANDWIDTH      45
@@ -284,7 +286,7 @@ static bool asi_open(indigo_device *device) {
 			else
 				PRIVATE_DATA->buffer_size = PRIVATE_DATA->info.MaxHeight*PRIVATE_DATA->info.MaxWidth*2 + FITS_HEADER_SIZE;
 
-			PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_blob_buffer(PRIVATE_DATA->buffer_size);
+			PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_frame_buffer(PRIVATE_DATA->buffer_size);
 		}
 	}
 	PRIVATE_DATA->is_asi120 = strstr(PRIVATE_DATA->info.Name, "ASI120M") != NULL;
@@ -508,7 +510,7 @@ static void asi_close(indigo_device *device) {
 		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "ASICloseCamera(%d, ASI_COOLER_POWER_PERC)", PRIVATE_DATA->dev_id);
 		indigo_global_unlock(device);
 		if (PRIVATE_DATA->buffer != NULL) {
-			free(PRIVATE_DATA->buffer);
+			indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 		}
 	}
@@ -558,21 +560,36 @@ static void exposure_timer_callback(indigo_device *device) {
 	PRIVATE_DATA->in_exposure_callback = false;
 }
 
-static void streaming_timer_callback(indigo_device *device) {
-	if (!CONNECTION_CONNECTED_ITEM->sw.value) return;
-
+static void streaming_frame_callback(indigo_device *device, void *data, int width, int height, int bpp) {
 	char *color_string = get_bayer_string(device);
 	indigo_fits_keyword keywords[] = {
 		{ INDIGO_FITS_STRING, "BAYERPAT", .string = color_string, "Bayer color pattern" },
 		{ 0 }
 	};
+	if ((color_string) &&   /* if colour (bayer) image but not RGB */
+	    (bpp != 24) &&
+	    (bpp != 48)) {
+		indigo_process_image(device, data, width, height, bpp, true, false, keywords, true);
+	} else {
+		indigo_process_image(device, data, width, height, bpp, true, false, NULL, true);
+	}
+}
+
+static void streaming_timer_callback(indigo_device *device) {
+	if (!CONNECTION_CONNECTED_ITEM->sw.value) return;
+
 	int id = PRIVATE_DATA->dev_id;
 	int timeout = 1000 * (CCD_STREAMING_EXPOSURE_ITEM->number.value * 2 + 500);
 	ASI_ERROR_CODE res;
 	PRIVATE_DATA->can_check_temperature = false;
 	if (asi_setup_exposure(device, CCD_STREAMING_EXPOSURE_ITEM->number.value, CCD_FRAME_LEFT_ITEM->number.value, CCD_FRAME_TOP_ITEM->number.value, CCD_FRAME_WIDTH_ITEM->number.value, CCD_FRAME_HEIGHT_ITEM->number.value, CCD_BIN_HORIZONTAL_ITEM->number.value, CCD_BIN_VERTICAL_ITEM->number.value)) {
+		int frame_width = (int)(PRIVATE_DATA->exp_frame_width / PRIVATE_DATA->exp_bin_x);
+		int frame_height = (int)(PRIVATE_DATA->exp_frame_height / PRIVATE_DATA->exp_bin_y);
+		long frame_size = (long)frame_width * frame_height * PRIVATE_DATA->exp_bpp / 8;
+		/* frames are processed on frame ring thread, so SDK is asked for the next frame immediately */
+		indigo_frame_ring *ring = indigo_frame_ring_create(device, INDIGO_FRAME_RING_SIZE, frame_size + FITS_HEADER_SIZE, streaming_frame_callback);
 		pthread_mutex_lock(&PRIVATE_DATA->usb_mutex);
-		res = ASIStartVideoCapture(id);
+		res = ring ? ASIStartVideoCapture(id) : ASI_ERROR_GENERAL_ERROR;
 		pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
 		if (res) {
 			INDIGO_DRIVER_ERROR(DRIVER_NAME, "ASIStartVideoCapture(%d) = %d", id, res);
@@ -588,8 +605,9 @@ static void streaming_timer_callback(indigo_device *device) {
 					indigo_usleep(ONE_SECOND_DELAY);
 					indigo_update_property(device, CCD_STREAMING_PROPERTY, NULL);
 				}
+				unsigned char *buffer = indigo_frame_ring_acquire(ring);
 				pthread_mutex_lock(&PRIVATE_DATA->usb_mutex);
-				res = ASIGetVideoData(id, PRIVATE_DATA->buffer + FITS_HEADER_SIZE, PRIVATE_DATA->buffer_size - FITS_HEADER_SIZE, timeout);
+				res = ASIGetVideoData(id, buffer + FITS_HEADER_SIZE, frame_size, timeout);
 				pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
 				if (res) {
 					INDIGO_DRIVER_ERROR(DRIVER_NAME, "ASIGetVideoData((%d) = %d", id, res);
@@ -598,22 +616,13 @@ static void streaming_timer_callback(indigo_device *device) {
 				INDIGO_DRIVER_DEBUG(DRIVER_NAME, "ASIGetVideoData((%d) = %d", id, res);
 
 				CCD_STREAMING_EXPOSURE_ITEM->number.value = 0;
-				indigo_update_property(device, CCD_STREAMING_PROPERTY, NULL);
-
-				if ((color_string) &&   /* if colour (bayer) image but not RGB */
-				    (PRIVATE_DATA->exp_bpp != 24) &&
-				    (PRIVATE_DATA->exp_bpp != 48)) {
-					indigo_process_image(device, PRIVATE_DATA->buffer, (int)(PRIVATE_DATA->exp_frame_width / PRIVATE_DATA->exp_bin_x), (int)(PRIVATE_DATA->exp_frame_height / PRIVATE_DATA->exp_bin_y), PRIVATE_DATA->exp_bpp, true, false, keywords, true);
-				} else {
-					indigo_process_image(device, PRIVATE_DATA->buffer, (int)(PRIVATE_DATA->exp_frame_width / PRIVATE_DATA->exp_bin_x), (int)(PRIVATE_DATA->exp_frame_height / PRIVATE_DATA->exp_bin_y), PRIVATE_DATA->exp_bpp, true, false, NULL, true);
-				}
+				indigo_frame_ring_commit(ring, frame_width, frame_height, PRIVATE_DATA->exp_bpp);
 				if (CCD_STREAMING_COUNT_ITEM->number.value > 0) {
 					CCD_STREAMING_COUNT_ITEM->number.value -= 1;
 				}
 				if (CCD_ABORT_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
 					break;
 				}
-				indigo_update_property(device, CCD_STREAMING_PROPERTY, NULL);
 			}
 			pthread_mutex_lock(&PRIVATE_DATA->usb_mutex);
 			res = ASIStopVideoCapture(id);
@@ -624,6 +633,7 @@ static void streaming_timer_callback(indigo_device *device) {
 				INDIGO_DRIVER_DEBUG(DRIVER_NAME, "ASIStopVideoCapture(%d) = %d", id, res);
 		}
 		pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
+		indigo_frame_ring_delete(ring, CCD_ABORT_EXPOSURE_PROPERTY->state != INDIGO_BUSY_STATE);
 	} else {
 		res = ASI_ERROR_GENERAL_ERROR;
 	}
@@ -812,6 +822,7 @@ static indigo_result ccd_attach(indigo_device *device) {
 		CCD_MODE_PROPERTY->count = mode_count;
 		// -------------------------------------------------------------------------------- CCD_STREAMING
 		CCD_STREAMING_PROPERTY->hidden = false;
+		CCD_STREAMING_STATISTICS_PROPERTY->hidden = false;
 		CCD_IMAGE_FORMAT_PROPERTY->count = 7;
 		CCD_STREAMING_EXPOSURE_ITEM->number.max = 5.0;
 
@@ -1957,7 +1968,7 @@ static void process_unplug_event(indigo_device *unused) {
 		if (private_data) {
 			ASICloseCamera(id);
 			if (private_data->buffer != NULL) {
-				free(private_data->buffer);
+				indigo_free_frame_buffer(private_data->buffer);
 				private_data->buffer = NULL;
 			}
 			free(private_data);
@@ -1970,27 +1981,6 @@ static void process_unplug_event(indigo_device *unused) {
 	pthread_mutex_unlock(&device_mutex);
 }
 
-static int hotplug_callback(libusb_context *ctx, libusb_device *dev, libusb_hotplug_event event, void *user_data) {
-	struct libusb_device_descriptor descriptor;
-	switch (event) {
-		case LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED: {
-			libusb_get_device_descriptor(dev, &descriptor);
-			for (int i = 0; i < asi_id_count; i++) {
-				if (descriptor.idVendor != ASI_VENDOR_ID || asi_products[i] != descriptor.idProduct)
-					continue;
-				indigo_set_timer(NULL, 2.0, process_plug_event, NULL);
-			}
-			break;
-		}
-		case LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT: {
-			indigo_set_timer(NULL, 0.5, process_unplug_event, NULL);
-			break;
-		}
-	}
-	return 0;
-};
-
-
 static void remove_all_devices() {
 	int i;
 	asi_private_data *pds[ASICAMERA_ID_MAX] = {NULL};
@@ -2009,7 +1999,7 @@ static void remove_all_devices() {
 		if (pds[i]) {
 			if (pds[i]->buffer != NULL) {
 				ASICloseCamera(pds[i]->dev_id);
-				free(pds[i]->buffer);
+				indigo_free_frame_buffer(pds[i]->buffer);
 				pds[i]->buffer = NULL;
 			}
 			free(pds[i]);
@@ -2021,7 +2011,7 @@ static void remove_all_devices() {
 }
 
 
-static libusb_hotplug_callback_handle callback_handle;
+static int hotplug_handle = -1;
 
 indigo_result indigo_ccd_asi(indigo_driver_action action, indigo_driver_info *info) {
 	static indigo_driver_action last_action = INDIGO_DRIVER_SHUTDOWN;
@@ -2043,10 +2033,8 @@ indigo_result indigo_ccd_asi(indigo_driver_action action, indigo_driver_info *in
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Can not get the list of supported product IDs.");
 				return INDIGO_FAILED;
 			}
-			indigo_start_usb_event_handler();
-			int rc = libusb_hotplug_register_callback(NULL, LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT, LIBUSB_HOTPLUG_ENUMERATE, ASI_VENDOR_ID, LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY, hotplug_callback, NULL, &callback_handle);
-			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "libusb_hotplug_register_callback ->  %s", rc < 0 ? libusb_error_name(rc) : "OK");
-			return rc >= 0 ? INDIGO_OK : INDIGO_FAILED;
+			hotplug_handle = indigo_usb_hotplug_register(DRIVER_NAME, ASI_VENDOR_ID, asi_id_count, asi_products, 2.0, process_plug_event, process_unplug_event);
+			return hotplug_handle >= 0 ? INDIGO_OK : INDIGO_FAILED;
 
 		case INDIGO_DRIVER_SHUTDOWN:
 			for (int i = 0; i < MAX_DEVICES; i++) {
@@ -2055,8 +2043,8 @@ indigo_result indigo_ccd_asi(indigo_driver_action action, indigo_driver_info *in
 				//if (devices[i] && devices[i]->is_connected > 0) return INDIGO_BUSY;
 			}
 			last_action = action;
-			libusb_hotplug_deregister_callback(NULL, callback_handle);
-			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "libusb_hotplug_deregister_callback");
+			indigo_usb_hotplug_deregister(hotplug_handle);
+			hotplug_handle = -1;
 			remove_all_devices();
 			break;
 
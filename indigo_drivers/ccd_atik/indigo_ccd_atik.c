@@ -184,7 +184,7 @@ static void ccd_connect_callback(indigo_device *device) {
 					indigo_init_switch_item(CCD_MODE_ITEM + (i - 1), name, label, i == 1);
 					pw *= 2;
 				}
-				PRIVATE_DATA->buffer = indigo_alloc_blob_buffer(2 * CCD_INFO_WIDTH_ITEM->number.value * CCD_INFO_HEIGHT_ITEM->number.value + FITS_HEADER_SIZE);
+				PRIVATE_DATA->buffer = indigo_alloc_frame_buffer(2 * CCD_INFO_WIDTH_ITEM->number.value * CCD_INFO_HEIGHT_ITEM->number.value + FITS_HEADER_SIZE);
 				assert(PRIVATE_DATA->buffer != NULL);
 				CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
 // Temporary workaround for SDK_2020_06_23 +++++
@@ -271,7 +271,7 @@ static void ccd_connect_callback(indigo_device *device) {
 		}
 		if (PRIVATE_DATA->handle == NULL) {
 			if (PRIVATE_DATA->buffer != NULL) {
-				free(PRIVATE_DATA->buffer);
+				indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 				PRIVATE_DATA->buffer = NULL;
 			}
 			PRIVATE_DATA->device_count--;
@@ -293,7 +293,7 @@ static void ccd_connect_callback(indigo_device *device) {
 		}
 		indigo_cancel_timer_sync(device, &PRIVATE_DATA->temperature_timer);
 		if (PRIVATE_DATA->buffer != NULL) {
-			free(PRIVATE_DATA->buffer);
+			indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 		}
 		if (--PRIVATE_DATA->device_count == 0) {
@@ -612,7 +612,7 @@ static void guider_connect_callback(indigo_device *device) {
 	} else {
 		indigo_cancel_timer_sync(device, &PRIVATE_DATA->guider_timer);
 		if (PRIVATE_DATA->buffer != NULL) {
-			free(PRIVATE_DATA->buffer);
+			indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 		}
 		if (--PRIVATE_DATA->device_count == 0) {
@@ -956,7 +956,7 @@ static void unplug_handler(indigo_device *device) {
 			indigo_detach_device(device);
 			if (PRIVATE_DATA) {
 				if (PRIVATE_DATA->buffer)
-					free(PRIVATE_DATA->buffer);
+					indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 				free(PRIVATE_DATA);
 			}
 			free(device);
@@ -1027,7 +1027,7 @@ indigo_result indigo_ccd_atik(indigo_driver_action action, indigo_driver_info *i
 					indigo_detach_device(device);
 					if (PRIVATE_DATA) {
 						if (PRIVATE_DATA->buffer)
-						free(PRIVATE_DATA->buffer);
+						indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 						free(PRIVATE_DATA);
 					}
 					free(device);
@@ -193,7 +193,7 @@ static bool fli_open(indigo_device *device) {
 
 	if (PRIVATE_DATA->buffer == NULL) {
 		PRIVATE_DATA->buffer_size = width * height * 2 + FITS_HEADER_SIZE;
-		PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_blob_buffer(PRIVATE_DATA->buffer_size);
+		PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_frame_buffer(PRIVATE_DATA->buffer_size);
 	}
 
 	pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
@@ -390,7 +390,7 @@ static void fli_close(indigo_device *device) {
 	}
 	indigo_global_unlock(device);
 	if (PRIVATE_DATA->buffer != NULL) {
-		free(PRIVATE_DATA->buffer);
+		indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 		PRIVATE_DATA->buffer = NULL;
 	}
 }
@@ -1026,7 +1026,7 @@ static void process_unplug_event(indigo_device *unused) {
 		}
 		indigo_detach_device(*device);
 		fli_private_data *private_data = (*device)->private_data;
-		if (private_data->buffer) free(private_data->buffer);
+		if (private_data->buffer) indigo_free_frame_buffer(private_data->buffer);
 		free((*device)->private_data);
 		free(*device);
 		*device = NULL;
@@ -1066,7 +1066,7 @@ static void remove_all_devices() {
 			continue;
 		indigo_detach_device(*device);
 		fli_private_data *private_data = (*device)->private_data;
-		if (private_data->buffer) free(private_data->buffer);
+		if (private_data->buffer) indigo_free_frame_buffer(private_data->buffer);
 		free((*device)->private_data);
 		free(*device);
 		*device = NULL;
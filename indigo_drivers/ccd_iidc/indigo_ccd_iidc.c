@@ -441,7 +441,7 @@ static indigo_result ccd_attach(indigo_device *device) {
 
 static void ccd_connect_callback(indigo_device *device) {
 	if (CONNECTION_CONNECTED_ITEM->sw.value) {
-		PRIVATE_DATA->buffer = indigo_alloc_blob_buffer(FITS_HEADER_SIZE + 2 * 3 * (CCD_INFO_WIDTH_ITEM->number.value + 8) * (CCD_INFO_HEIGHT_ITEM->number.value + 8));
+		PRIVATE_DATA->buffer = indigo_alloc_frame_buffer(FITS_HEADER_SIZE + 2 * 3 * (CCD_INFO_WIDTH_ITEM->number.value + 8) * (CCD_INFO_HEIGHT_ITEM->number.value + 8));
 		assert(PRIVATE_DATA->buffer != NULL);
 		if (PRIVATE_DATA->temperature_is_present) {
 			indigo_set_timer(device, 0, ccd_temperature_callback, &PRIVATE_DATA->temperture_timer);
@@ -456,7 +456,7 @@ static void ccd_connect_callback(indigo_device *device) {
 		indigo_cancel_timer_sync(device, &PRIVATE_DATA->temperture_timer);
 		stop_camera(device);
 		if (PRIVATE_DATA->buffer != NULL) {
-			free(PRIVATE_DATA->buffer);
+			indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 		}
 	}
@@ -744,7 +744,7 @@ static void process_unplug_event(libusb_device *dev) {
 				indigo_detach_device(device);
 				dc1394_camera_free(private_data->camera);
 				if (private_data->buffer)
-					free(private_data->buffer);
+					indigo_free_frame_buffer(private_data->buffer);
 				free(private_data);
 				free(device);
 				devices[j] = NULL;
@@ -900,7 +900,7 @@ indigo_result indigo_ccd_iidc(indigo_driver_action action, indigo_driver_info *i
 			if (device != NULL) {
 				if (PRIVATE_DATA != NULL) {
 					if (PRIVATE_DATA->buffer)
-						free(PRIVATE_DATA->buffer);
+						indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 					free(PRIVATE_DATA);
 				}
 				indigo_detach_device(device);
@@ -302,7 +302,7 @@ static void ccd_connect_callback(indigo_device *device) {
 				}
 			}
 
-			PRIVATE_DATA->buffer = indigo_alloc_blob_buffer(2 * CCD_INFO_WIDTH_ITEM->number.value * CCD_INFO_HEIGHT_ITEM->number.value + FITS_HEADER_SIZE);
+			PRIVATE_DATA->buffer = indigo_alloc_frame_buffer(2 * CCD_INFO_WIDTH_ITEM->number.value * CCD_INFO_HEIGHT_ITEM->number.value + FITS_HEADER_SIZE);
 			assert(PRIVATE_DATA->buffer != NULL);
 			CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
 			PRIVATE_DATA->downloading = false;
@@ -331,7 +331,7 @@ static void ccd_connect_callback(indigo_device *device) {
 		}
 		PRIVATE_DATA->downloading = false;
 		if (PRIVATE_DATA->buffer != NULL) {
-			free(PRIVATE_DATA->buffer);
+			indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 		}
 		if (--PRIVATE_DATA->device_count == 0) {
@@ -839,7 +839,7 @@ static void process_unplug_event(libusb_device *dev) {
 			if (device->master_device == device) {
 				mi_private_data *private_data = PRIVATE_DATA;
 				if (private_data->buffer != NULL)
-					free(private_data->buffer);
+					indigo_free_frame_buffer(private_data->buffer);
 				free(private_data);
 			}
 			free(device);
@@ -898,7 +898,7 @@ indigo_result indigo_ccd_mi(indigo_driver_action action, indigo_driver_info *inf
 					if (device->master_device == device) {
 						mi_private_data *private_data = PRIVATE_DATA;
 						if (private_data->buffer != NULL)
-							free(private_data->buffer);
+							indigo_free_frame_buffer(private_data->buffer);
 						free(private_data);
 					}
 					free(device);
@@ -234,7 +234,7 @@ static bool playerone_open(indigo_device *device) {
 				PRIVATE_DATA->buffer_size = PRIVATE_DATA->property.maxHeight * PRIVATE_DATA->property.maxWidth * 3 + FITS_HEADER_SIZE + 1024;
 			else
 				PRIVATE_DATA->buffer_size = PRIVATE_DATA->property.maxHeight * PRIVATE_DATA->property.maxWidth * 2 + FITS_HEADER_SIZE + 1024;
-			PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_blob_buffer(PRIVATE_DATA->buffer_size);
+			PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_frame_buffer(PRIVATE_DATA->buffer_size);
 		}
 	}
 	pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
@@ -408,7 +408,7 @@ static void playerone_close(indigo_device *device) {
 		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "POACloseCamera(%d)", PRIVATE_DATA->dev_id);
 		indigo_global_unlock(device);
 		if (PRIVATE_DATA->buffer != NULL) {
-			free(PRIVATE_DATA->buffer);
+			indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 		}
 	}
@@ -2080,7 +2080,7 @@ static void process_unplug_event(indigo_device *unused) {
 		if (private_data) {
 			POACloseCamera(id);
 			if (private_data->buffer != NULL) {
-				free(private_data->buffer);
+				indigo_free_frame_buffer(private_data->buffer);
 				private_data->buffer = NULL;
 			}
 			free(private_data);
@@ -2129,7 +2129,7 @@ static void remove_all_devices() {
 		if (pds[i]) {
 			if (pds[i]->buffer != NULL) {
 				POACloseCamera(pds[i]->dev_id);
-				free(pds[i]->buffer);
+				indigo_free_frame_buffer(pds[i]->buffer);
 				pds[i]->buffer = NULL;
 			}
 			free(pds[i]);
@@ -71,6 +71,7 @@ static indigo_result ccd_attach(indigo_device *device) {
 		CCD_INFO_PIXEL_WIDTH_ITEM->number.value = CCD_INFO_PIXEL_HEIGHT_ITEM->number.value =  CCD_INFO_PIXEL_SIZE_ITEM->number.value = PRIVATE_DATA->model.pixel_size;
 		CCD_INFO_BITS_PER_PIXEL_ITEM->number.value = 16;
 		CCD_JPEG_SETTINGS_PROPERTY->hidden = true;
+		CCD_DSLR_RAW_MODE_PROPERTY->hidden = false;
 		if (PRIVATE_DATA->vendor == NIKON_VID || PRIVATE_DATA->vendor == CANON_VID) {
 			CCD_UPLOAD_MODE_PROPERTY->count = 4; // enable NONE item
 		}
@@ -234,10 +235,7 @@ static void handle_connection(indigo_device *device) {
 			indigo_release_property(PRIVATE_DATA->properties[i].property);
 		}
 		memset(PRIVATE_DATA->properties, 0, sizeof(PRIVATE_DATA->properties));
-		if (PRIVATE_DATA->image_buffer) {
-			free(PRIVATE_DATA->image_buffer);
-			PRIVATE_DATA->image_buffer = NULL;
-		}
+		ptp_release_image_buffers(device);
 		indigo_global_unlock(device);
 		CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
 	}
@@ -1225,6 +1225,153 @@ bool ptp_open(indigo_device *device) {
 	return rc >= 0;
 }
 
+// Buffers returned by ptp_transaction() hold at least data size + PTP_DOWNLOAD_RESERVE bytes, so the capacity of a buffer
+// handed back by ptp_set_image_buffer() is known from its data size and no pointer to it has to be kept meanwhile.
+
+static unsigned char *ptp_download_buffer(indigo_device *device, size_t size) {
+	if (size <= PTP_ASYNC_TRANSFER_SIZE)
+		return indigo_safe_malloc(size);
+	unsigned char *buffer = PRIVATE_DATA->spare_buffer;
+	size_t buffer_size = PRIVATE_DATA->spare_buffer_size;
+	PRIVATE_DATA->spare_buffer = NULL;
+	PRIVATE_DATA->spare_buffer_size = 0;
+	if (buffer == NULL || buffer_size < size) {
+		indigo_safe_free(buffer);
+		buffer = indigo_safe_malloc(size);
+	}
+	return buffer;
+}
+
+static void ptp_discard_download_buffer(indigo_device *device, unsigned char *buffer, size_t size) {
+	if (size > PTP_ASYNC_TRANSFER_SIZE && PRIVATE_DATA->spare_buffer == NULL) {
+		PRIVATE_DATA->spare_buffer = buffer;
+		PRIVATE_DATA->spare_buffer_size = size;
+	} else {
+		free(buffer);
+	}
+}
+
+static void ptp_download_progress(indigo_device *device, int received, int total, int *reported) {
+	int percent = (int)(100.0 * received / total);
+	if (percent / 10 != *reported / 10 && CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
+		*reported = percent;
+		indigo_update_property(device, CCD_EXPOSURE_PROPERTY, "Downloading image (%d%%)", percent);
+	}
+}
+
+static void LIBUSB_CALL ptp_bulk_read_callback(struct libusb_transfer *transfer) {
+	*(int *)transfer->user_data = 1;
+}
+
+static void LIBUSB_CALL ptp_bulk_read_orphan_callback(struct libusb_transfer *transfer) {
+	libusb_free_transfer(transfer);
+}
+
+static int ptp_bulk_read_status(struct libusb_transfer *transfer) {
+	switch (transfer->status) {
+		case LIBUSB_TRANSFER_COMPLETED:
+			return LIBUSB_SUCCESS;
+		case LIBUSB_TRANSFER_TIMED_OUT:
+			return LIBUSB_ERROR_TIMEOUT;
+		case LIBUSB_TRANSFER_STALL:
+			return LIBUSB_ERROR_PIPE;
+		case LIBUSB_TRANSFER_NO_DEVICE:
+			return LIBUSB_ERROR_NO_DEVICE;
+		case LIBUSB_TRANSFER_OVERFLOW:
+			return LIBUSB_ERROR_OVERFLOW;
+		default:
+			return LIBUSB_ERROR_IO;
+	}
+}
+
+// Reads the rest of data phase into buffer with up to PTP_ASYNC_TRANSFER_COUNT transfers in flight, so the camera never waits for the next request.
+// All transfers but the last one are multiples of max packet size, a short one can only terminate the data phase.
+
+static int ptp_bulk_read_async(indigo_device *device, unsigned char *buffer, int offset, int total) {
+	struct libusb_transfer *transfers[PTP_ASYNC_TRANSFER_COUNT] = { NULL };
+	int completed[PTP_ASYNC_TRANSFER_COUNT] = { 0 };
+	bool pending[PTP_ASYNC_TRANSFER_COUNT] = { false };
+	int submitted = offset, received = offset, reported = 0, head = 0, rc = LIBUSB_SUCCESS;
+	bool report = total >= PTP_PROGRESS_SIZE;
+	for (int i = 0; i < PTP_ASYNC_TRANSFER_COUNT && rc == LIBUSB_SUCCESS; i++) {
+		if ((transfers[i] = libusb_alloc_transfer(0)) == NULL)
+			rc = LIBUSB_ERROR_NO_MEM;
+	}
+	for (int i = 0; i < PTP_ASYNC_TRANSFER_COUNT && rc == LIBUSB_SUCCESS && submitted < total; i++) {
+		int length = total - submitted > PTP_ASYNC_TRANSFER_SIZE ? PTP_ASYNC_TRANSFER_SIZE : total - submitted + PTP_DOWNLOAD_RESERVE;
+		libusb_fill_bulk_transfer(transfers[i], PRIVATE_DATA->handle, PRIVATE_DATA->ep_in, buffer + submitted, length, ptp_bulk_read_callback, completed + i, PTP_TIMEOUT);
+		if ((rc = libusb_submit_transfer(transfers[i])) == LIBUSB_SUCCESS) {
+			pending[i] = true;
+			submitted += length;
+		}
+	}
+	while (rc == LIBUSB_SUCCESS && pending[head]) {
+		struct libusb_transfer *transfer = transfers[head];
+		while (!completed[head]) {
+			struct timeval tv = { 1, 0 };
+			int result = libusb_handle_events_timeout_completed(NULL, &tv, completed + head);
+			if (result < 0 && result != LIBUSB_ERROR_INTERRUPTED) {
+				rc = result;
+				break;
+			}
+		}
+		if (rc < 0)
+			break;
+		completed[head] = 0;
+		pending[head] = false;
+		if ((rc = ptp_bulk_read_status(transfer)) < 0)
+			break;
+		received += transfer->actual_length;
+		if (transfer->actual_length < transfer->length) {
+			if (received < total) {
+				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Short transfer (%d of %d bytes) at offset %d", transfer->actual_length, transfer->length, received - transfer->actual_length);
+				rc = LIBUSB_ERROR_IO;
+			}
+			break;
+		}
+		if (report)
+			ptp_download_progress(device, received, total, &reported);
+		if (submitted < total) {
+			int length = total - submitted > PTP_ASYNC_TRANSFER_SIZE ? PTP_ASYNC_TRANSFER_SIZE : total - submitted + PTP_DOWNLOAD_RESERVE;
+			transfer->buffer = buffer + submitted;
+			transfer->length = length;
+			if ((rc = libusb_submit_transfer(transfer)) < 0)
+				break;
+			pending[head] = true;
+			submitted += length;
+		}
+		head = (head + 1) % PTP_ASYNC_TRANSFER_COUNT;
+	}
+	for (int i = 0; i < PTP_ASYNC_TRANSFER_COUNT; i++) {
+		if (pending[i] && !completed[i])
+			libusb_cancel_transfer(transfers[i]);
+	}
+	// cancelled transfers are waited for at most PTP_TIMEOUT in total, a transfer still in flight is left to free itself on completion
+	int waits = PTP_TIMEOUT / 1000;
+	for (int i = 0; i < PTP_ASYNC_TRANSFER_COUNT; i++) {
+		while (pending[i] && !completed[i] && waits > 0) {
+			struct timeval tv = { 1, 0 };
+			int result = libusb_handle_events_timeout_completed(NULL, &tv, completed + i);
+			if (result < 0 && result != LIBUSB_ERROR_INTERRUPTED)
+				break;
+			waits--;
+		}
+		if (pending[i] && !completed[i]) {
+			INDIGO_DRIVER_ERROR(DRIVER_NAME, "Cancelled transfer %d didn't complete", i);
+			transfers[i]->callback = ptp_bulk_read_orphan_callback;
+			transfers[i]->user_data = NULL;
+			transfers[i] = NULL;
+		}
+	}
+	for (int i = 0; i < PTP_ASYNC_TRANSFER_COUNT; i++) {
+		if (transfers[i])
+			libusb_free_transfer(transfers[i]);
+	}
+	if (rc == LIBUSB_SUCCESS && received < total)
+		rc = LIBUSB_ERROR_IO;
+	return rc < 0 ? rc : received;
+}
+
 bool ptp_transaction(indigo_device *device, uint16_t code, int count, uint32_t out_1, uint32_t out_2, uint32_t out_3, uint32_t out_4, uint32_t out_5, void *data_out, uint32_t data_out_size, uint32_t *in_1, uint32_t *in_2, uint32_t *in_3, uint32_t *in_4, uint32_t *in_5, void **data_in, uint32_t *data_in_size) {
 	pthread_mutex_lock(&PRIVATE_DATA->usb_mutex);
 	if (PRIVATE_DATA->handle == NULL)
@@ -1297,25 +1444,38 @@ bool ptp_transaction(indigo_device *device, uint16_t code, int count, uint32_t o
 	if (response.type == ptp_container_data) {
 		length -= PTP_CONTAINER_HDR_SIZE;
 		int total = response.length - PTP_CONTAINER_HDR_SIZE;
-		unsigned char *buffer = indigo_safe_malloc(total + 1024); // 1024 added to avoid mysterious LIBUSB_ERROR_OVERFLOWs
+		size_t buffer_size = total + PTP_DOWNLOAD_RESERVE; // reserve added to avoid mysterious LIBUSB_ERROR_OVERFLOWs
+		unsigned char *buffer = ptp_download_buffer(device, buffer_size);
 		memcpy(buffer, &response.payload, length);
 		int offset = length;
 		if (data_in_size)
 			*data_in_size = total;
-		total -= length;
-		while (total > 0) {
-			rc = libusb_bulk_transfer(PRIVATE_DATA->handle, PRIVATE_DATA->ep_in, buffer + offset, total + 1024 > PTP_MAX_BULK_TRANSFER_SIZE ? PTP_MAX_BULK_TRANSFER_SIZE : total + 1024, &length, PTP_TIMEOUT);
-			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "libusb_bulk_transfer() -> %s, %d", rc < 0 ? libusb_error_name(rc) : "OK", length);
+		if (total - length > PTP_ASYNC_TRANSFER_SIZE) {
+			rc = ptp_bulk_read_async(device, buffer, offset, total);
+			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "ptp_bulk_read_async(%d) -> %s", total - offset, rc < 0 ? libusb_error_name(rc) : "OK");
 			if (rc < 0) {
-				free(buffer);
+				ptp_discard_download_buffer(device, buffer, buffer_size);
 				pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
 				return false;
 			}
-			offset += length;
+		} else {
 			total -= length;
+			while (total > 0) {
+				rc = libusb_bulk_transfer(PRIVATE_DATA->handle, PRIVATE_DATA->ep_in, buffer + offset, total + PTP_DOWNLOAD_RESERVE > PTP_MAX_BULK_TRANSFER_SIZE ? PTP_MAX_BULK_TRANSFER_SIZE : total + PTP_DOWNLOAD_RESERVE, &length, PTP_TIMEOUT);
+				INDIGO_DRIVER_DEBUG(DRIVER_NAME, "libusb_bulk_transfer() -> %s, %d", rc < 0 ? libusb_error_name(rc) : "OK", length);
+				if (rc < 0) {
+					ptp_discard_download_buffer(device, buffer, buffer_size);
+					pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
+					return false;
+				}
+				offset += length;
+				total -= length;
+			}
 		}
 		if (data_in)
 			*data_in = buffer;
+		else
+			ptp_discard_download_buffer(device, buffer, buffer_size);
 		while (true) {
 			memset(&response, 0, sizeof(response));
 			length = 0;
@@ -1643,7 +1803,7 @@ bool ptp_handle_event(indigo_device *device, ptp_event_code code, uint32_t *para
 					INDIGO_DRIVER_LOG(DRIVER_NAME, "ptp_event_ObjectAdded: handle = %08x, size = %u, name = '%s' skipped", params[0], size, filename);
 				} else {
 					INDIGO_DRIVER_LOG(DRIVER_NAME, "ptp_event_ObjectAdded: handle = %08x, size = %u, name = '%s' downloading", params[0], size, filename);
-					if (size && ptp_transaction_1_0_i(device, ptp_operation_GetObject, params[0], &buffer, NULL)) {
+					if (size && ptp_transaction_1_0_i(device, ptp_operation_GetObject, params[0], &buffer, &size)) {
 						const char *ext = strchr(filename, '.');
 						if (PRIVATE_DATA->check_dual_compression != NULL && PRIVATE_DATA->check_dual_compression(device) && ptp_check_jpeg_ext(ext)) {
 							if (CCD_PREVIEW_ENABLED_ITEM->sw.value) {
@@ -1651,9 +1811,7 @@ bool ptp_handle_event(indigo_device *device, ptp_event_code code, uint32_t *para
 							}
 						} else {
 							indigo_process_dslr_image(device, buffer, size, ext, false);
-							if (PRIVATE_DATA->image_buffer)
-								free(PRIVATE_DATA->image_buffer);
-							PRIVATE_DATA->image_buffer = buffer;
+							ptp_set_image_buffer(device, buffer, size);
 							buffer = NULL;
 						}
 						if (DSLR_DELETE_IMAGE_ON_ITEM->sw.value)
@@ -1782,3 +1940,28 @@ void ptp_blob_exposure_timer(indigo_device *device) {
 	CCD_EXPOSURE_ITEM->number.value = 0;
 	indigo_update_property(device, CCD_EXPOSURE_PROPERTY, NULL);
 }
+
+void ptp_set_image_buffer(indigo_device *device, void *buffer, uint32_t size) {
+	pthread_mutex_lock(&PRIVATE_DATA->usb_mutex);
+	if (PRIVATE_DATA->image_buffer) {
+		if (PRIVATE_DATA->image_buffer_size > PTP_ASYNC_TRANSFER_SIZE) {
+			indigo_safe_free(PRIVATE_DATA->spare_buffer);
+			PRIVATE_DATA->spare_buffer = PRIVATE_DATA->image_buffer;
+			PRIVATE_DATA->spare_buffer_size = PRIVATE_DATA->image_buffer_size;
+		} else {
+			free(PRIVATE_DATA->image_buffer);
+		}
+	}
+	PRIVATE_DATA->image_buffer = buffer;
+	PRIVATE_DATA->image_buffer_size = buffer != NULL && size > 0 ? (size_t)size + PTP_DOWNLOAD_RESERVE : 0;
+	pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
+}
+
+void ptp_release_image_buffers(indigo_device *device) {
+	pthread_mutex_lock(&PRIVATE_DATA->usb_mutex);
+	indigo_safe_free(PRIVATE_DATA->image_buffer);
+	indigo_safe_free(PRIVATE_DATA->spare_buffer);
+	PRIVATE_DATA->image_buffer = PRIVATE_DATA->spare_buffer = NULL;
+	PRIVATE_DATA->image_buffer_size = PRIVATE_DATA->spare_buffer_size = 0;
+	pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
+}
@@ -38,6 +38,10 @@
 
 #define PTP_TIMEOUT                 10000
 #define PTP_MAX_BULK_TRANSFER_SIZE  8388608
+#define PTP_ASYNC_TRANSFER_SIZE     1048576
+#define PTP_ASYNC_TRANSFER_COUNT    4
+#define PTP_PROGRESS_SIZE           4194304
+#define PTP_DOWNLOAD_RESERVE        1024
 
 typedef enum {
 	ptp_container_command =	0x0001,
@@ -406,6 +410,9 @@ typedef struct {
 	bool image_added;
 	uint32_t last_error;
 	void *image_buffer;
+	size_t image_buffer_size;
+	void *spare_buffer;
+	size_t spare_buffer_size;
 } ptp_private_data;
 
 extern void ptp_dump_container(int line, const char *function, indigo_device *device, ptp_container *container);
@@ -462,6 +469,9 @@ extern bool ptp_set_host_time(indigo_device *device);
 extern bool ptp_check_jpeg_ext(const char *ext);
 
 extern void ptp_blob_exposure_timer(indigo_device *device);
+// Keep buffer returned by ptp_transaction() as the current image, size is data size it returned (0 if unknown), the previous image buffer is kept for reuse by the next download.
+extern void ptp_set_image_buffer(indigo_device *device, void *buffer, uint32_t size);
+extern void ptp_release_image_buffers(indigo_device *device);
 
 #define ptp_transaction_0_0(device, code) ptp_transaction(device, code, 0, 0, 0, 0, 0, 0, NULL, 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL)
 #define ptp_transaction_1_0(device, code, out_1) ptp_transaction(device, code, 1, out_1, 0, 0, 0, 0, NULL, 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL)
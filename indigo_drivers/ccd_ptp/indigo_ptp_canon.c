@@ -1160,9 +1160,7 @@ static void ptp_canon_get_event(indigo_device *device) {
 								}
 							} else {
 								indigo_process_dslr_image(device, buffer, (int)length, ext, false);
-								if (PRIVATE_DATA->image_buffer)
-									free(PRIVATE_DATA->image_buffer);
-								PRIVATE_DATA->image_buffer = buffer;
+								ptp_set_image_buffer(device, buffer, length);
 								buffer = NULL;
 							}
 							if (DSLR_DELETE_IMAGE_ON_ITEM->sw.value)
@@ -1511,9 +1509,7 @@ bool ptp_canon_liveview(indigo_device *device) {
 						}
 						if (!CCD_UPLOAD_MODE_NONE_ITEM->sw.value) {
 							indigo_process_dslr_image(device, source, length, ".jpeg", true);
-							if (PRIVATE_DATA->image_buffer)
-								free(PRIVATE_DATA->image_buffer);
-							PRIVATE_DATA->image_buffer = buffer;
+							ptp_set_image_buffer(device, buffer, buffer_size);
 							buffer = NULL;
 						}
 						CCD_STREAMING_COUNT_ITEM->number.value--;
@@ -378,7 +378,7 @@ static void ptp_fuji_get_event(indigo_device *device) {
 						free(image_buffer);
 						image_buffer = NULL;
 						INDIGO_DRIVER_LOG(DRIVER_NAME, "ptp_event_ObjectAdded: handle = %08x, size = %u, name = '%s'", handle, image_size, filename);
-						if (size && ptp_transaction_1_0_i(device, ptp_operation_GetObject, handle, &image_buffer, NULL)) {
+						if (size && ptp_transaction_1_0_i(device, ptp_operation_GetObject, handle, &image_buffer, &image_size)) {
 							const char *ext = strchr(filename, '.');
 							if (PRIVATE_DATA->check_dual_compression(device) && ptp_check_jpeg_ext(ext)) {
 								if (CCD_PREVIEW_ENABLED_ITEM->sw.value) {
@@ -386,9 +386,7 @@ static void ptp_fuji_get_event(indigo_device *device) {
 								}
 							} else {
 								indigo_process_dslr_image(device, image_buffer, image_size, ext, false);
-								if (PRIVATE_DATA->image_buffer)
-									free(PRIVATE_DATA->image_buffer);
-								PRIVATE_DATA->image_buffer = image_buffer;
+								ptp_set_image_buffer(device, image_buffer, image_size);
 								image_buffer = NULL;
 							}
 							if (ptp_transaction_1_0(device, ptp_operation_DeleteObject, handle)) {
@@ -711,9 +709,7 @@ bool ptp_fuji_liveview(indigo_device *device) {
 					indigo_update_property(device, CCD_IMAGE_PROPERTY, NULL);
 				}
 				indigo_process_dslr_image(device, buffer, size, ".jpeg", true);
-				if (PRIVATE_DATA->image_buffer)
-					free(PRIVATE_DATA->image_buffer);
-				PRIVATE_DATA->image_buffer = buffer;
+				ptp_set_image_buffer(device, buffer, size);
 				buffer = NULL;
 				ptp_transaction_1_0(device, ptp_operation_DeleteObject, handle);
 				CCD_STREAMING_COUNT_ITEM->number.value--;
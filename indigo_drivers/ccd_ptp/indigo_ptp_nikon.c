@@ -1213,9 +1213,7 @@ bool ptp_nikon_liveview(indigo_device *device) {
 					}
 					if (!CCD_UPLOAD_MODE_NONE_ITEM->sw.value) {
 						indigo_process_dslr_image(device, (void *)buffer + 64, size - 64, ".jpeg", true);
-						if (PRIVATE_DATA->image_buffer)
-							free(PRIVATE_DATA->image_buffer);
-						PRIVATE_DATA->image_buffer = buffer;
+						ptp_set_image_buffer(device, buffer, size);
 						buffer = NULL;
 					}
 					CCD_STREAMING_COUNT_ITEM->number.value--;
@@ -1233,9 +1231,7 @@ bool ptp_nikon_liveview(indigo_device *device) {
 					}
 					if (!CCD_UPLOAD_MODE_NONE_ITEM->sw.value) {
 						indigo_process_dslr_image(device, (void *)buffer + 128, size - 128, ".jpeg", true);
-						if (PRIVATE_DATA->image_buffer)
-							free(PRIVATE_DATA->image_buffer);
-						PRIVATE_DATA->image_buffer = buffer;
+						ptp_set_image_buffer(device, buffer, size);
 						buffer = NULL;
 					}
 					CCD_STREAMING_COUNT_ITEM->number.value--;
@@ -1253,9 +1249,7 @@ bool ptp_nikon_liveview(indigo_device *device) {
 					}
 					if (!CCD_UPLOAD_MODE_NONE_ITEM->sw.value) {
 						indigo_process_dslr_image(device, (void *)buffer + 384, size - 384, ".jpeg", true);
-						if (PRIVATE_DATA->image_buffer)
-							free(PRIVATE_DATA->image_buffer);
-						PRIVATE_DATA->image_buffer = buffer;
+						ptp_set_image_buffer(device, buffer, size);
 						buffer = NULL;
 					}
 					CCD_STREAMING_COUNT_ITEM->number.value--;
@@ -1421,7 +1421,7 @@ bool ptp_sony_handle_event(indigo_device *device, ptp_event_code code, uint32_t
 				free(buffer);
 				buffer = NULL;
 				INDIGO_DRIVER_LOG(DRIVER_NAME, "ptp_event_ObjectAdded: handle = %08x, size = %u, name = '%s'", params[0], size, filename);
-				if (size && ptp_transaction_1_0_i(device, ptp_operation_GetObject, params[0], &buffer, NULL)) {
+				if (size && ptp_transaction_1_0_i(device, ptp_operation_GetObject, params[0], &buffer, &size)) {
 					const char *ext = strchr(filename, '.');
 					if (PRIVATE_DATA->check_dual_compression(device) && ptp_check_jpeg_ext(ext)) {
 						if (CCD_PREVIEW_ENABLED_ITEM->sw.value) {
@@ -1430,9 +1430,7 @@ bool ptp_sony_handle_event(indigo_device *device, ptp_event_code code, uint32_t
 						ptp_sony_handle_event(device, code, params);
 					} else {
 						indigo_process_dslr_image(device, buffer, size, ext, false);
-						if (PRIVATE_DATA->image_buffer)
-							free(PRIVATE_DATA->image_buffer);
-						PRIVATE_DATA->image_buffer = buffer;
+						ptp_set_image_buffer(device, buffer, size);
 						buffer = NULL;
 					}
 				}
@@ -1642,9 +1640,7 @@ bool ptp_sony_liveview(indigo_device *device) {
 								indigo_update_property(device, CCD_IMAGE_PROPERTY, NULL);
 							}
 							indigo_process_dslr_image(device, start, (int)(end - start), ".jpeg", true);
-							if (PRIVATE_DATA->image_buffer)
-								free(PRIVATE_DATA->image_buffer);
-							PRIVATE_DATA->image_buffer = buffer;
+							ptp_set_image_buffer(device, buffer, 0);
 							buffer = NULL;
 							CCD_STREAMING_COUNT_ITEM->number.value--;
 							if (CCD_STREAMING_COUNT_ITEM->number.value < 0)
@@ -287,7 +287,7 @@ static bool qhy_open(indigo_device *device) {
 
 		if (PRIVATE_DATA->buffer == NULL) {
 			PRIVATE_DATA->buffer_size = /* PRIVATE_DATA->frame_height * PRIVATE_DATA->frame_width * 2 */ 128 * 1024 * 1024 + FITS_HEADER_SIZE;
-			PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_blob_buffer(PRIVATE_DATA->buffer_size);
+			PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_frame_buffer(PRIVATE_DATA->buffer_size);
 		}
 	}
 	pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
@@ -380,7 +380,7 @@ static bool qhy_start_exposure(indigo_device *device, double exposure, bool dark
 	return true;
 }
 
-static bool qhy_read_pixels(indigo_device *device, bool live) {
+static bool qhy_read_pixels(indigo_device *device, bool live, unsigned char *buffer) {
 	int res;
 	uint32_t channels;
 	if (!live) {
@@ -402,7 +402,7 @@ static bool qhy_read_pixels(indigo_device *device, bool live) {
 		 &PRIVATE_DATA->ci_params.height,
 		 &PRIVATE_DATA->ci_params.bpp,
 		 &channels,
-		 PRIVATE_DATA->buffer + FITS_HEADER_SIZE
+		 buffer + FITS_HEADER_SIZE
 		 )
 	: GetQHYCCDSingleFrame(
 		PRIVATE_DATA->handle,
@@ -410,7 +410,7 @@ static bool qhy_read_pixels(indigo_device *device, bool live) {
 		&PRIVATE_DATA->ci_params.height,
 		&PRIVATE_DATA->ci_params.bpp,
 		&channels,
-		PRIVATE_DATA->buffer + FITS_HEADER_SIZE
+		buffer + FITS_HEADER_SIZE
 	);
 	pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
 	if (res != QHYCCD_SUCCESS) {
@@ -476,7 +476,7 @@ static void qhy_close(indigo_device *device) {
 		}
 		indigo_global_unlock(device);
 		if (PRIVATE_DATA->buffer != NULL) {
-			free(PRIVATE_DATA->buffer);
+			indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 		}
 	}
@@ -492,7 +492,7 @@ static void exposure_timer_callback(indigo_device *device) {
 	if (CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
 		CCD_EXPOSURE_ITEM->number.value = 0;
 		indigo_update_property(device, CCD_EXPOSURE_PROPERTY, NULL);
-		if (qhy_read_pixels(device, false)) {
+		if (qhy_read_pixels(device, false, PRIVATE_DATA->buffer)) {
 			char *color_string = get_bayer_string(device);
 			CCD_FRAME_BITS_PER_PIXEL_ITEM->number.value = PIXEL_FORMAT_PROPERTY->items[0].sw.value ? 8 : 16;
 			if (color_string) {
@@ -524,9 +524,7 @@ static void exposure_timer_callback(indigo_device *device) {
 	PRIVATE_DATA->can_check_temperature = true;
 }
 
-static void streaming_timer_callback(indigo_device *device) {
-	if (!CONNECTION_CONNECTED_ITEM->sw.value)
-		return;
+static void streaming_frame_callback(indigo_device *device, void *data, int width, int height, int bpp) {
 	char *color_string = get_bayer_string(device);
 	indigo_fits_keyword keywords[] = {
 		{ .type = INDIGO_FITS_STRING, .name = "BAYERPAT", {.string = color_string }, .comment = "Bayer color pattern" },
@@ -534,22 +532,34 @@ static void streaming_timer_callback(indigo_device *device) {
 		{ .type = INDIGO_FITS_NUMBER, .name = "YBAYROFF", {.number = 0 }, .comment = "Y offset of Bayer array" },
 		{ .type = (indigo_fits_keyword_type)0 }
 	};
+	if (color_string) {
+		indigo_process_image(device, data, width, height, bpp, true, true, keywords, true);
+	} else {
+		indigo_process_image(device, data, width, height, bpp, true, true, NULL, true);
+	}
+}
+
+static void streaming_timer_callback(indigo_device *device) {
+	if (!CONNECTION_CONNECTED_ITEM->sw.value)
+		return;
 	PRIVATE_DATA->can_check_temperature = false;
 	if (qhy_start_exposure(device, CCD_STREAMING_EXPOSURE_ITEM->number.value, (CCD_FRAME_TYPE_DARK_ITEM->sw.value || CCD_FRAME_TYPE_DARKFLAT_ITEM->sw.value || CCD_FRAME_TYPE_BIAS_ITEM->sw.value), CCD_FRAME_LEFT_ITEM->number.value, CCD_FRAME_TOP_ITEM->number.value, CCD_FRAME_WIDTH_ITEM->number.value, CCD_FRAME_HEIGHT_ITEM->number.value, CCD_BIN_HORIZONTAL_ITEM->number.value, CCD_BIN_VERTICAL_ITEM->number.value, true)) {
-		while (CCD_STREAMING_COUNT_ITEM->number.value != 0) {
-			if (qhy_read_pixels(device, true)) {
-				if (color_string) {
-					indigo_process_image(device, PRIVATE_DATA->buffer, PRIVATE_DATA->ci_params.width, PRIVATE_DATA->ci_params.height, PRIVATE_DATA->ci_params.bpp, true, true, keywords, true);
-				} else {
-					indigo_process_image(device, PRIVATE_DATA->buffer, PRIVATE_DATA->ci_params.width, PRIVATE_DATA->ci_params.height, PRIVATE_DATA->ci_params.bpp, true, true, NULL, true);
-				}
+		pthread_mutex_lock(&PRIVATE_DATA->usb_mutex);
+		long frame_size = GetQHYCCDMemLength(PRIVATE_DATA->handle);
+		pthread_mutex_unlock(&PRIVATE_DATA->usb_mutex);
+		if (frame_size <= 0 || frame_size > PRIVATE_DATA->buffer_size - FITS_HEADER_SIZE)
+			frame_size = PRIVATE_DATA->buffer_size - FITS_HEADER_SIZE;
+		/* frames are processed on frame ring thread, so the next live frame is read immediately */
+		indigo_frame_ring *ring = indigo_frame_ring_create(device, INDIGO_FRAME_RING_SIZE, frame_size + FITS_HEADER_SIZE, streaming_frame_callback);
+		while (ring && CCD_STREAMING_COUNT_ITEM->number.value != 0) {
+			if (qhy_read_pixels(device, true, (unsigned char *)indigo_frame_ring_acquire(ring))) {
+				indigo_frame_ring_commit(ring, PRIVATE_DATA->ci_params.width, PRIVATE_DATA->ci_params.height, PRIVATE_DATA->ci_params.bpp);
 				if (CCD_STREAMING_COUNT_ITEM->number.value > 0)
 					CCD_STREAMING_COUNT_ITEM->number.value -= 1;
-				CCD_STREAMING_PROPERTY->state = INDIGO_BUSY_STATE;
-				indigo_update_property(device, CCD_STREAMING_PROPERTY, NULL);
 			}
 		}
 		qhy_abort_exposure(device, true);
+		indigo_frame_ring_delete(ring, CCD_ABORT_EXPOSURE_PROPERTY->state != INDIGO_BUSY_STATE);
 	}
 	PRIVATE_DATA->can_check_temperature = true;
 	indigo_finalize_video_stream(device);
@@ -661,6 +671,7 @@ static indigo_result ccd_attach(indigo_device *device) {
 		pthread_mutex_init(&PRIVATE_DATA->usb_mutex, NULL);
 		// -------------------------------------------------------------------------------- CCD_STREAMING
 		CCD_STREAMING_PROPERTY->hidden = false;
+		CCD_STREAMING_STATISTICS_PROPERTY->hidden = false;
 		CCD_STREAMING_EXPOSURE_ITEM->number.max = 4.0;
 		CCD_IMAGE_FORMAT_PROPERTY->count = 7;
 		// --------------------------------------------------------------------------------- PIXEL_FORMAT
@@ -397,7 +397,7 @@ static void ccd_connect_callback(indigo_device *device) {
 			cam.get_PixelSizeX(&pixelWidth);
 			cam.get_PixelSizeY(&pixelHeight);
 			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Resolution %ld x %ld, pixel size  %g x %g", width, height, pixelWidth, pixelHeight);
-			PRIVATE_DATA->buffer = (unsigned short *)indigo_alloc_blob_buffer(2 * width * height + FITS_HEADER_SIZE);
+			PRIVATE_DATA->buffer = (unsigned short *)indigo_alloc_frame_buffer(2 * width * height + FITS_HEADER_SIZE);
 			assert(PRIVATE_DATA->buffer != NULL);
 			cam.get_CanSetCCDTemperature(&canSetTemp);
 			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "%s set temperature", canSetTemp ? "Can" : "Can't");
@@ -602,7 +602,7 @@ static void ccd_connect_callback(indigo_device *device) {
 				}
 			}
 			cam.put_Connected(false);
-			free(PRIVATE_DATA->buffer);
+			indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 			CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
 		} catch (std::runtime_error err) {
@@ -948,7 +948,7 @@ static void remove_all_devices() {
 			continue;
 		indigo_detach_device(*device);
 		if (((qsi_private_data *)(*device)->private_data)->buffer)
-			free(((qsi_private_data *)(*device)->private_data)->buffer);
+			indigo_free_frame_buffer(((qsi_private_data *)(*device)->private_data)->buffer);
 		free((*device)->private_data);
 		free(*device);
 		*device = NULL;
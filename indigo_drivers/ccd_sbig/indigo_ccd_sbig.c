@@ -1138,7 +1138,7 @@ static void ccd_connect_callback(indigo_device *device) {
 					CCD_COOLER_POWER_PROPERTY->hidden = false;
 					CCD_COOLER_POWER_PROPERTY->perm = INDIGO_RO_PERM;
 
-					PRIVATE_DATA->imager_buffer = indigo_alloc_blob_buffer(2 * CCD_INFO_WIDTH_ITEM->number.value * CCD_INFO_HEIGHT_ITEM->number.value + FITS_HEADER_SIZE);
+					PRIVATE_DATA->imager_buffer = indigo_alloc_frame_buffer(2 * CCD_INFO_WIDTH_ITEM->number.value * CCD_INFO_HEIGHT_ITEM->number.value + FITS_HEADER_SIZE);
 					assert(PRIVATE_DATA->imager_buffer != NULL);
 
 					indigo_set_timer(device, 0, imager_ccd_temperature_callback, &PRIVATE_DATA->imager_ccd_temperature_timer);
@@ -1237,7 +1237,7 @@ static void ccd_connect_callback(indigo_device *device) {
 
 					CCD_COOLER_POWER_PROPERTY->hidden = true;
 
-					PRIVATE_DATA->guider_buffer = indigo_alloc_blob_buffer(2 * CCD_INFO_WIDTH_ITEM->number.value * CCD_INFO_HEIGHT_ITEM->number.value + FITS_HEADER_SIZE);
+					PRIVATE_DATA->guider_buffer = indigo_alloc_frame_buffer(2 * CCD_INFO_WIDTH_ITEM->number.value * CCD_INFO_HEIGHT_ITEM->number.value + FITS_HEADER_SIZE);
 					assert(PRIVATE_DATA->guider_buffer != NULL);
 
 					indigo_set_timer(device, 0, guider_ccd_temperature_callback, &PRIVATE_DATA->guider_ccd_temperature_timer);
@@ -1258,14 +1258,14 @@ static void ccd_connect_callback(indigo_device *device) {
 				indigo_delete_property(device, SBIG_FREEZE_TEC_PROPERTY, NULL);
 				indigo_delete_property(device, SBIG_ABG_PROPERTY, NULL);
 				if (PRIVATE_DATA->imager_buffer != NULL) {
-					free(PRIVATE_DATA->imager_buffer);
+					indigo_free_frame_buffer(PRIVATE_DATA->imager_buffer);
 					PRIVATE_DATA->imager_buffer = NULL;
 				}
 			} else { /* Secondary CCD */
 				PRIVATE_DATA->guider_no_check_temperature = false;
 				indigo_cancel_timer_sync(device, &PRIVATE_DATA->guider_ccd_temperature_timer);
 				if (PRIVATE_DATA->guider_buffer != NULL) {
-					free(PRIVATE_DATA->guider_buffer);
+					indigo_free_frame_buffer(PRIVATE_DATA->guider_buffer);
 					PRIVATE_DATA->guider_buffer = NULL;
 				}
 			}
@@ -2539,8 +2539,8 @@ static int hotplug_callback(libusb_context *ctx, libusb_device *dev, libusb_hotp
 
 				if (private_data) {
 					/* close driver and device here */
-					if (private_data->imager_buffer) free(private_data->imager_buffer);
-					if (private_data->guider_buffer) free(private_data->guider_buffer);
+					if (private_data->imager_buffer) indigo_free_frame_buffer(private_data->imager_buffer);
+					if (private_data->guider_buffer) indigo_free_frame_buffer(private_data->guider_buffer);
 					free(private_data);
 					private_data = NULL;
 				}
@@ -2576,8 +2576,8 @@ static void remove_usb_devices() {
 	for(i = 0; i < MAX_USB_DEVICES; i++) {
 		if (pds[i]) {
 			sbig_private_data *private_data = (sbig_private_data*)pds[i];
-			if (private_data->imager_buffer) free(private_data->imager_buffer);
-			if (private_data->guider_buffer) free(private_data->guider_buffer);
+			if (private_data->imager_buffer) indigo_free_frame_buffer(private_data->imager_buffer);
+			if (private_data->guider_buffer) indigo_free_frame_buffer(private_data->guider_buffer);
 			free(pds[i]);
 		}
 	}
@@ -2600,8 +2600,8 @@ static void remove_eth_devices() {
 		devices[i] = NULL;
 	}
 	if (private_data) {
-		if (private_data->imager_buffer) free(private_data->imager_buffer);
-		if (private_data->guider_buffer) free(private_data->guider_buffer);
+		if (private_data->imager_buffer) indigo_free_frame_buffer(private_data->imager_buffer);
+		if (private_data->guider_buffer) indigo_free_frame_buffer(private_data->guider_buffer);
 		free(private_data);
 	}
 }
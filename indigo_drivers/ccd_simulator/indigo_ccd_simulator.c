@@ -53,6 +53,7 @@
 // can be changed
 #define GUIDER_MAX_MAG					8
 #define GUIDER_MAX_STARS				400
+#define GUIDER_MAX_CANDIDATES		4096
 #define GUIDER_FOV							7
 #define GUIDER_MAX_HOTPIXELS		1500
 
@@ -176,19 +177,29 @@ static void search_stars(indigo_device *device) {
 		double ppr_cos = ppr * cos(angle);
 		double ppr_sin = ppr * sin(angle);
 		PRIVATE_DATA->star_count = 0;
-		for (indigocat_star_entry *star_data = indigocat_get_star_data(); star_data->hip; star_data++) {
-			if (star_data->mag > GUIDER_MAX_MAG)
-				continue;
-			double ra = (GUIDER_IMAGE_EPOCH_ITEM->number.target != 0 ? star_data->ra : star_data->ra_now) * h2r;
-			double dec = (GUIDER_IMAGE_EPOCH_ITEM->number.target != 0 ? star_data->dec : star_data->dec_now) * d2r;
+		indigocat_star_entry *stars[GUIDER_MAX_CANDIDATES];
+		int count = indigocat_search_stars(mount_ra / h2r, mount_dec / d2r, radius / d2r, GUIDER_MAX_MAG, GUIDER_IMAGE_EPOCH_ITEM->number.target != 2000, stars, GUIDER_MAX_CANDIDATES);
+		// candidates are precessed from J2000 to the image epoch at once
+		double *star_ra = indigo_safe_malloc(2 * count * sizeof(double) + 1);
+		double *star_dec = star_ra + count;
+		for (int i = 0; i < count; i++) {
+			star_ra[i] = stars[i]->ra;
+			star_dec[i] = stars[i]->dec;
+		}
+		if (GUIDER_IMAGE_EPOCH_ITEM->number.target != 2000) {
+			indigo_transform_context transform;
+			indigo_init_transform_context(&transform, GUIDER_IMAGE_EPOCH_ITEM->number.target, NULL, GUIDER_IMAGE_LAT_ITEM->number.target, GUIDER_IMAGE_LONG_ITEM->number.target);
+			indigo_j2k_to_eq_batch(&transform, star_ra, star_dec, count);
+		}
+		for (int i = 0; i < count && PRIVATE_DATA->star_count < GUIDER_MAX_STARS; i++) {
+			indigocat_star_entry *star_data = stars[i];
+			double ra = star_ra[i] * h2r;
+			double dec = star_dec[i] * d2r;
 			double cos_dec = cos(dec);
 			double sin_dec = sin(dec);
 			double sin_dec_dec = sin_mount_dec * sin_dec;
 			double cos_dec_dec = cos_mount_dec * cos_dec;
 			double cos_ra_ra = cos(ra - mount_ra);
-			double distance = acos(sin_dec_dec + cos_dec_dec * cos_ra_ra);
-			if (distance > radius)
-				continue;
 			double sin_ra_ra = sin(ra - mount_ra);
 			double ccc_ss = cos_dec_dec * cos_ra_ra + sin_dec_dec;
 			double sx = cos_dec * sin_ra_ra / ccc_ss;
@@ -199,13 +210,11 @@ static void search_stars(indigo_device *device) {
 				//printf("HIP%5d %6.4f %+7.4f %6.1f %6.1f\n", star_data->hip, star_data->ra, star_data->dec, x, y);
 				PRIVATE_DATA->star_x[PRIVATE_DATA->star_count] = x;
 				PRIVATE_DATA->star_y[PRIVATE_DATA->star_count] = y;
-				PRIVATE_DATA->star_a[PRIVATE_DATA->star_count] = mags[(int)star_data->mag];
-				if (PRIVATE_DATA->star_count++ == GUIDER_MAX_STARS)
-					break;
-			} else {
-				continue;
+				PRIVATE_DATA->star_a[PRIVATE_DATA->star_count] = mags[star_data->mag < 0 ? 0 : (int)star_data->mag];
+				PRIVATE_DATA->star_count++;
 			}
 		}
+		free(star_ra);
 		PRIVATE_DATA->ra = GUIDER_IMAGE_RA_ITEM->number.target;
 		PRIVATE_DATA->dec = GUIDER_IMAGE_DEC_ITEM->number.target;
 		PRIVATE_DATA->lat = GUIDER_IMAGE_LAT_ITEM->number.target;
@@ -878,8 +887,8 @@ static void ccd_connect_callback(indigo_device *device) {
 						CCD_FRAME_BITS_PER_PIXEL_ITEM->number.value = 48;
 						break;
 				}
-				PRIVATE_DATA->raw_file_image = indigo_alloc_blob_buffer(size + FITS_HEADER_SIZE);
-				PRIVATE_DATA->file_image = indigo_alloc_blob_buffer(size + FITS_HEADER_SIZE);
+				PRIVATE_DATA->raw_file_image = indigo_alloc_frame_buffer(size + FITS_HEADER_SIZE);
+				PRIVATE_DATA->file_image = indigo_alloc_frame_buffer(size + FITS_HEADER_SIZE);
 				if (!indigo_read(fd, (char *)PRIVATE_DATA->raw_file_image + FITS_HEADER_SIZE, size)) {
 					goto failure;
 				}
@@ -895,11 +904,11 @@ static void ccd_connect_callback(indigo_device *device) {
 				indigo_cancel_timer_sync(device, &PRIVATE_DATA->imager_exposure_timer);
 			} else if (device == PRIVATE_DATA->file) {
 				if (PRIVATE_DATA->file_image) {
-					free(PRIVATE_DATA->file_image);
+					indigo_free_frame_buffer(PRIVATE_DATA->file_image);
 					PRIVATE_DATA->file_image = NULL;
 				}
 				if (PRIVATE_DATA->raw_file_image) {
-					free(PRIVATE_DATA->raw_file_image);
+					indigo_free_frame_buffer(PRIVATE_DATA->raw_file_image);
 					PRIVATE_DATA->raw_file_image = NULL;
 				}
 			} else if (device == PRIVATE_DATA->guider) {
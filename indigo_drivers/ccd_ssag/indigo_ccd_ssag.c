@@ -267,7 +267,8 @@ static bool ssag_guide(indigo_device *device, guide_direction direction, int dur
 static void ssag_close(indigo_device *device) {
 	libusb_close(PRIVATE_DATA->handle);
 	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "libusb_close");
-	free(PRIVATE_DATA->buffer);
+	indigo_free_frame_buffer(PRIVATE_DATA->buffer);
+	PRIVATE_DATA->buffer = NULL;
 }
 
 // -------------------------------------------------------------------------------- INDIGO CCD device implementation
@@ -351,7 +352,7 @@ static void ccd_connect_callback(indigo_device *device) {
 			result = ssag_open(device);
 		}
 		if (result) {
-			PRIVATE_DATA->buffer = (unsigned char *)indigo_alloc_blob_buffer(FITS_HEADER_SIZE + BUFFER_SIZE);
+			PRIVATE_DATA->buffer = (unsigned char *)indigo_alloc_frame_buffer(FITS_HEADER_SIZE + BUFFER_SIZE);
 			assert(PRIVATE_DATA->buffer != NULL);
 			CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
 		} else {
@@ -364,7 +365,7 @@ static void ccd_connect_callback(indigo_device *device) {
 				ssag_abort_exposure(device);
 		}
 		if (PRIVATE_DATA->buffer != NULL) {
-			free(PRIVATE_DATA->buffer);
+			indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 		}
 		if (--PRIVATE_DATA->device_count == 0) {
@@ -650,7 +651,7 @@ static void process_unplug_event(libusb_device *dev) {
 	if (private_data != NULL) {
 		libusb_unref_device(dev);
 		if (private_data->buffer)
-			free(private_data->buffer);
+			indigo_free_frame_buffer(private_data->buffer);
 		free(private_data);
 	}
 	pthread_mutex_unlock(&device_mutex);
@@ -235,7 +235,7 @@ static bool svb_open(indigo_device *device) {
 				PRIVATE_DATA->buffer_size = PRIVATE_DATA->property.MaxHeight * PRIVATE_DATA->property.MaxWidth * 3 + FITS_HEADER_SIZE + 1024;
 			else
 				PRIVATE_DATA->buffer_size = PRIVATE_DATA->property.MaxHeight * PRIVATE_DATA->property.MaxWidth * 2 + FITS_HEADER_SIZE + 1024;
-			PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_blob_buffer(PRIVATE_DATA->buffer_size);
+			PRIVATE_DATA->buffer = (unsigned char*)indigo_alloc_frame_buffer(PRIVATE_DATA->buffer_size);
 		}
 		if (PRIVATE_DATA->property.IsTriggerCam) {
 			res = SVBSetCameraMode(id, SVB_MODE_TRIG_SOFT);
@@ -432,7 +432,7 @@ static void svb_close(indigo_device *device) {
 		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "SVBCloseCamera(%d)", PRIVATE_DATA->dev_id);
 		indigo_global_unlock(device);
 		if (PRIVATE_DATA->buffer != NULL) {
-			free(PRIVATE_DATA->buffer);
+			indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 		}
 	}
@@ -1781,7 +1781,7 @@ static void process_unplug_event(indigo_device *unused) {
 		if (private_data) {
 			SVBCloseCamera(id);
 			if (private_data->buffer != NULL) {
-				free(private_data->buffer);
+				indigo_free_frame_buffer(private_data->buffer);
 				private_data->buffer = NULL;
 			}
 			free(private_data);
@@ -1830,7 +1830,7 @@ static void remove_all_devices() {
 		if (pds[i]) {
 			if (pds[i]->buffer != NULL) {
 				SVBCloseCamera(pds[i]->dev_id);
-				free(pds[i]->buffer);
+				indigo_free_frame_buffer(pds[i]->buffer);
 				pds[i]->buffer = NULL;
 			}
 			free(pds[i]);
@@ -270,7 +270,7 @@ static bool sx_open(indigo_device *device) {
 					PRIVATE_DATA->ccd_height *= 2;
 					PRIVATE_DATA->pix_height /= 2;
 				}
-				PRIVATE_DATA->buffer = indigo_alloc_blob_buffer(2 * PRIVATE_DATA->ccd_width * PRIVATE_DATA->ccd_height + FITS_HEADER_SIZE + 512);
+				PRIVATE_DATA->buffer = indigo_alloc_frame_buffer(2 * PRIVATE_DATA->ccd_width * PRIVATE_DATA->ccd_height + FITS_HEADER_SIZE + 512);
 				assert(PRIVATE_DATA->buffer != NULL);
 				if (PRIVATE_DATA->is_interlaced) {
 					PRIVATE_DATA->even = indigo_safe_malloc(PRIVATE_DATA->ccd_width * PRIVATE_DATA->ccd_height + 512);
@@ -668,7 +668,7 @@ static void sx_close(indigo_device *device) {
 	pthread_mutex_lock(&PRIVATE_DATA->usb_mutex);
 	libusb_close(PRIVATE_DATA->handle);
 	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "libusb_close");
-	free(PRIVATE_DATA->buffer);
+	indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 	PRIVATE_DATA->buffer = NULL;
 	if (PRIVATE_DATA->is_interlaced) {
 		free(PRIVATE_DATA->even);
@@ -1187,7 +1187,7 @@ static void process_unplug_event(libusb_device *dev) {
 	if (private_data != NULL) {
 		libusb_unref_device(dev);
 		if (private_data->buffer != NULL)
-			free(private_data->buffer);
+			indigo_free_frame_buffer(private_data->buffer);
 		if (private_data->even != NULL)
 			free(private_data->even);
 		if (private_data->odd != NULL)
@@ -221,6 +221,7 @@ typedef struct {
 	indigo_timer *exposure_watchdog_timer, *temperature_timer, *guider_timer_ra, *guider_timer_dec;
 	double current_temperature;
 	unsigned char *buffer;
+	indigo_frame_ring *frame_ring;
 	unsigned bin_mode;
 	int bits;
 	int mode;
@@ -390,6 +391,26 @@ static void pull_callback_dummy(unsigned event, void* callbackCtx) {
 	}
 }
 
+static void streaming_frame_callback(indigo_device *device, void *data, int width, int height, int bpp) {
+	indigo_fits_keyword keywords[] = {
+		{ INDIGO_FITS_STRING, "BAYERPAT", .string = PRIVATE_DATA->bayer_pattern, "Bayer color pattern" },
+		{ 0 }
+	};
+	indigo_fits_keyword *fits_keywords = NULL;
+	if (PRIVATE_DATA->bayer_pattern[0] != '\0' && bpp != 24 && bpp != 48) {
+		fits_keywords = keywords;
+	}
+	indigo_process_image(device, data, width, height, bpp, true, true, fits_keywords, true);
+}
+
+static void stop_frame_ring(indigo_device *device, bool flush) {
+	pthread_mutex_lock(&PRIVATE_DATA->mutex);
+	indigo_frame_ring *ring = PRIVATE_DATA->frame_ring;
+	PRIVATE_DATA->frame_ring = NULL;
+	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
+	indigo_frame_ring_delete(ring, flush);
+}
+
 static void pull_callback(unsigned event, void* callbackCtx) {
 	SDK_TYPE(FrameInfoV2) frameInfo = { 0 };
 	HRESULT result;
@@ -411,11 +432,18 @@ static void pull_callback(unsigned event, void* callbackCtx) {
 	switch (event) {
 		case SDK_DEF(EVENT_IMAGE): {
 			pthread_mutex_lock(&PRIVATE_DATA->mutex);
-			result = SDK_CALL(PullImageV2)(PRIVATE_DATA->handle, PRIVATE_DATA->buffer + FITS_HEADER_SIZE, PRIVATE_DATA->bits, &frameInfo);
+			/* streamed frames are pulled to frame ring and processed on its thread, mutex is held until the frame is
+			   committed, so stop_frame_ring() can't delete the ring in the meantime */
+			indigo_frame_ring *ring = CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE ? NULL : PRIVATE_DATA->frame_ring;
+			unsigned char *buffer = ring ? indigo_frame_ring_acquire(ring) : PRIVATE_DATA->buffer;
+			result = SDK_CALL(PullImageV2)(PRIVATE_DATA->handle, buffer + FITS_HEADER_SIZE, PRIVATE_DATA->bits, &frameInfo);
+			if (result >= 0 && ring && !PRIVATE_DATA->aborting && CCD_STREAMING_PROPERTY->state == INDIGO_BUSY_STATE)
+				indigo_frame_ring_commit(ring, frameInfo.width, frameInfo.height, PRIVATE_DATA->bits > 8 && PRIVATE_DATA->bits <= 16 ? 16 : PRIVATE_DATA->bits);
 			pthread_mutex_unlock(&PRIVATE_DATA->mutex);
 			if (result >= 0) {
 				INDIGO_DRIVER_DEBUG(DRIVER_NAME, "PullImageV2(%d, ->[%d x %d, %x, %d]) -> %08x", PRIVATE_DATA->bits, frameInfo.width, frameInfo.height, frameInfo.flag, frameInfo.seq, result);
 				if (PRIVATE_DATA->aborting) {
+					stop_frame_ring(device, false);
 					indigo_finalize_video_stream(device);
 				} else {
 					if (CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
@@ -423,8 +451,10 @@ static void pull_callback(unsigned event, void* callbackCtx) {
 						CCD_EXPOSURE_ITEM->number.value = 0;
 						indigo_set_timer(device, 0, fnish_exposure_async, NULL);
 					} else if (CCD_STREAMING_PROPERTY->state == INDIGO_BUSY_STATE) {
-						indigo_process_image(device, PRIVATE_DATA->buffer, frameInfo.width, frameInfo.height, PRIVATE_DATA->bits > 8 && PRIVATE_DATA->bits <= 16 ? 16 : PRIVATE_DATA->bits, true, true, fits_keywords, true);
+						if (ring == NULL)
+							indigo_process_image(device, PRIVATE_DATA->buffer, frameInfo.width, frameInfo.height, PRIVATE_DATA->bits > 8 && PRIVATE_DATA->bits <= 16 ? 16 : PRIVATE_DATA->bits, true, true, fits_keywords, true);
 						if (--CCD_STREAMING_COUNT_ITEM->number.value == 0) {
+							stop_frame_ring(device, true);
 							indigo_finalize_video_stream(device);
 							indigo_set_timer(device, 0, finish_streaming_async, NULL);
 						} else if (CCD_STREAMING_COUNT_ITEM->number.value < -1) {
@@ -440,6 +470,7 @@ static void pull_callback(unsigned event, void* callbackCtx) {
 					CCD_EXPOSURE_PROPERTY->state = INDIGO_ALERT_STATE;
 					indigo_update_property(device, CCD_EXPOSURE_PROPERTY, NULL);
 				} else if (CCD_STREAMING_PROPERTY->state == INDIGO_BUSY_STATE) {
+					stop_frame_ring(device, false);
 					indigo_finalize_video_stream(device);
 					CCD_STREAMING_PROPERTY->state = INDIGO_ALERT_STATE;
 					indigo_update_property(device, CCD_STREAMING_PROPERTY, NULL);
@@ -717,6 +748,7 @@ static indigo_result ccd_attach(indigo_device *device) {
 			}
 		}
 		CCD_STREAMING_PROPERTY->hidden = ((flags & SDK_DEF(FLAG_TRIGGER_SINGLE)) != 0);
+		CCD_STREAMING_STATISTICS_PROPERTY->hidden = CCD_STREAMING_PROPERTY->hidden;
 		CCD_IMAGE_FORMAT_PROPERTY->count = CCD_STREAMING_PROPERTY->hidden ? 5 : 6;
 		CCD_GAIN_PROPERTY->hidden = false;
 
@@ -816,7 +848,7 @@ static void ccd_connect_callback(indigo_device *device) {
 		}
 		device->gp_bits = 1;
 		if (PRIVATE_DATA->handle) {
-			PRIVATE_DATA->buffer = (unsigned char *)indigo_alloc_blob_buffer(3 * CCD_INFO_WIDTH_ITEM->number.value * CCD_INFO_HEIGHT_ITEM->number.value + FITS_HEADER_SIZE);
+			PRIVATE_DATA->buffer = (unsigned char *)indigo_alloc_frame_buffer(3 * CCD_INFO_WIDTH_ITEM->number.value * CCD_INFO_HEIGHT_ITEM->number.value + FITS_HEADER_SIZE);
 			if (PRIVATE_DATA->cam.model->flag & SDK_DEF(FLAG_GETTEMPERATURE)) {
 				if (CCD_TEMPERATURE_PROPERTY->perm == INDIGO_RW_PERM) {
 					int value;
@@ -983,8 +1015,9 @@ static void ccd_connect_callback(indigo_device *device) {
 		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Stop() -> %08x", result);
 		indigo_cancel_timer_sync(device, &PRIVATE_DATA->temperature_timer);
 		indigo_cancel_timer_sync(device, &PRIVATE_DATA->exposure_watchdog_timer);
+		stop_frame_ring(device, false);
 		if (PRIVATE_DATA->buffer != NULL) {
-			free(PRIVATE_DATA->buffer);
+			indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 		}
 		if (X_CCD_ADVANCED_PROPERTY)
@@ -1170,8 +1203,11 @@ static indigo_result ccd_change_property(indigo_device *device, indigo_client *c
 		}
 		CCD_STREAMING_PROPERTY->state = INDIGO_BUSY_STATE;
 		indigo_update_property(device, CCD_STREAMING_PROPERTY, NULL);
+		stop_frame_ring(device, false);
 		pthread_mutex_lock(&PRIVATE_DATA->mutex);
 		setup_exposure(device);
+		/* pulled frames may have up to full sensor size */
+		PRIVATE_DATA->frame_ring = indigo_frame_ring_create(device, INDIGO_FRAME_RING_SIZE, (long)CCD_INFO_WIDTH_ITEM->number.value * CCD_INFO_HEIGHT_ITEM->number.value * ((PRIVATE_DATA->bits + 7) / 8) + FITS_HEADER_SIZE, streaming_frame_callback);
 		result = SDK_CALL(put_ExpoTime)(PRIVATE_DATA->handle, (unsigned)(CCD_STREAMING_EXPOSURE_ITEM->number.target * 1000000));
 		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "put_ExpoTime(%u) -> %08x", (unsigned)(CCD_STREAMING_EXPOSURE_ITEM->number.target * 1000000), result);
 		PRIVATE_DATA->aborting = false;
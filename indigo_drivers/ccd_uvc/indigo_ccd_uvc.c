@@ -311,7 +311,7 @@ static void ccd_connect_callback(indigo_device *device) {
 					if (res == UVC_SUCCESS)
 						CCD_GAMMA_ITEM->number.max = value_16;
 				}
-				PRIVATE_DATA->buffer = indigo_alloc_blob_buffer(FITS_HEADER_SIZE + (int)CCD_INFO_WIDTH_ITEM->number.value * (int)CCD_INFO_HEIGHT_ITEM->number.value * 6);
+				PRIVATE_DATA->buffer = indigo_alloc_frame_buffer(FITS_HEADER_SIZE + (int)CCD_INFO_WIDTH_ITEM->number.value * (int)CCD_INFO_HEIGHT_ITEM->number.value * 6);
 				CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
 			}
 		}
@@ -321,7 +321,7 @@ static void ccd_connect_callback(indigo_device *device) {
 			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "uvc_close()");
 			PRIVATE_DATA->handle = 0;
 			if (PRIVATE_DATA->buffer)
-				free(PRIVATE_DATA->buffer);
+				indigo_free_frame_buffer(PRIVATE_DATA->buffer);
 			PRIVATE_DATA->buffer = NULL;
 		}
 		CONNECTION_PROPERTY->state = INDIGO_OK_STATE;
@@ -49,6 +49,8 @@
 #include <libusb-1.0/libusb.h>
 #endif
 
+#include <indigo/indigo_usb_utils.h>
+
 #include "USB2ST4_Conv.h"
 
 #define ASI_VENDOR_ID              0x03c3
@@ -440,27 +442,6 @@ static void process_unplug_event(indigo_device *unused) {
 	pthread_mutex_unlock(&device_mutex);
 }
 
-static int hotplug_callback(libusb_context *ctx, libusb_device *dev, libusb_hotplug_event event, void *user_data) {
-	struct libusb_device_descriptor descriptor;
-	switch (event) {
-		case LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED: {
-			libusb_get_device_descriptor(dev, &descriptor);
-			for (int i = 0; i < asi_id_count; i++) {
-				if (descriptor.idVendor != ASI_VENDOR_ID || asi_products[i] != descriptor.idProduct)
-					continue;
-				indigo_set_timer(NULL, 0.5, process_plug_event, NULL);
-			}
-			break;
-		}
-		case LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT: {
-			indigo_set_timer(NULL, 0.5, process_unplug_event, NULL);
-			break;
-		}
-	}
-	return 0;
-}
-
-
 static void remove_all_devices() {
 	int i;
 	asi_private_data *pds[USB2ST4_ID_MAX] = { NULL };
@@ -480,7 +461,7 @@ static void remove_all_devices() {
 		connected_ids[i] = false;
 }
 
-static libusb_hotplug_callback_handle callback_handle;
+static int hotplug_handle = -1;
 
 indigo_result indigo_guider_asi(indigo_driver_action action, indigo_driver_info *info) {
 	static indigo_driver_action last_action = INDIGO_DRIVER_SHUTDOWN;
@@ -498,17 +479,15 @@ indigo_result indigo_guider_asi(indigo_driver_action action, indigo_driver_info
 				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Can not get the list of supported IDs.");
 				return INDIGO_FAILED;
 			}
-			indigo_start_usb_event_handler();
-			int rc = libusb_hotplug_register_callback(NULL, LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT, LIBUSB_HOTPLUG_ENUMERATE, ASI_VENDOR_ID, LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY, hotplug_callback, NULL, &callback_handle);
-			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "libusb_hotplug_register_callback ->  %s", rc < 0 ? libusb_error_name(rc) : "OK");
-			return rc >= 0 ? INDIGO_OK : INDIGO_FAILED;
+			hotplug_handle = indigo_usb_hotplug_register(DRIVER_NAME, ASI_VENDOR_ID, asi_id_count, asi_products, 0.5, process_plug_event, process_unplug_event);
+			return hotplug_handle >= 0 ? INDIGO_OK : INDIGO_FAILED;
 
 		case INDIGO_DRIVER_SHUTDOWN:
 			for (int i = 0; i < MAX_DEVICES; i++)
 				VERIFY_NOT_CONNECTED(devices[i]);
 			last_action = action;
-			libusb_hotplug_deregister_callback(NULL, callback_handle);
-			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "libusb_hotplug_deregister_callback");
+			indigo_usb_hotplug_deregister(hotplug_handle);
+			hotplug_handle = -1;
 			remove_all_devices();
 			break;
 
@@ -186,6 +186,38 @@ extern void indigo_radec_to_altaz(const double ra, const double dec, const time_
  */
 extern void indigo_equatorial_to_hotizontal(const indigo_spherical_point_t *eq_point, const double latitude, indigo_spherical_point_t *h_point);
 
+/** Precomputed transformation for batch conversions
+ */
+typedef struct {
+	double precession[3][3];		///< J2000 to target equinox rotation matrix
+	double lst;									///< local sidereal time (hours)
+	double sin_lat, cos_lat;		///< site latitude sine and cosine
+} indigo_transform_context;
+
+/** Initialize batch transformation context
+
+	eq - 0 for JNow or target equinox
+	utc - time or NULL for current time, used for both JNow equinox and LST
+	latitude, longitude - site coordinates (degrees)
+ */
+extern void indigo_init_transform_context(indigo_transform_context *context, const double eq, const time_t *utc, const double latitude, const double longitude);
+
+/** Batch version of indigo_j2k_to_eq(...) for equinox in context
+
+	ra - array of Right Ascensions (hours)
+	dec - array of Declinations (degrees)
+	count - number of coordinates converted in place
+ */
+extern void indigo_j2k_to_eq_batch(const indigo_transform_context *context, double *ra, double *dec, int count);
+
+/** Batch version of indigo_radec_to_altaz(...) for site and time in context
+
+	ra, dec - arrays of Right Ascensions (hours) and Declinations (degrees)
+	alt, az - arrays for Altitudes and Azimuths (degrees)
+	count - number of coordinates
+ */
+extern void indigo_radec_to_altaz_batch(const indigo_transform_context *context, const double *ra, const double *dec, double *alt, double *az, int count);
+
 /** convert spherical to cartesian coordinates
  */
 extern indigo_cartesian_point_t indigo_spherical_to_cartesian(const indigo_spherical_point_t *spoint);
@@ -40,11 +40,23 @@
 #define H_GWAVI
 
 #include <stddef.h>
+#include <stdint.h>
+
+#include <indigo/indigo_recorder.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* maximal size of RIFF chunk (first RIFF AVI and AVIX extensions) */
+#define GWAVI_RIFF_SIZE							(1024L * 1024L * 1024L)
+
+/* number of entries in a single ix00 standard index chunk */
+#define GWAVI_STANDARD_INDEX_SIZE		4096
+
+/* number of entries reserved for indx super index in the header */
+#define GWAVI_SUPER_INDEX_SIZE			1024
+
 struct gwavi_header_t {
 	unsigned int time_delay;	/* dwMicroSecPerFrame */
 	unsigned int data_rate;		/* dwMaxBytesPerSec */
@@ -94,17 +106,42 @@ struct gwavi_stream_format_t {
 	unsigned int palette_count;
 };
 
+struct gwavi_index_entry_t {
+	unsigned int offset;	/* dwOffset (relative to qwBaseOffset) */
+	unsigned int size;	/* dwSize */
+};
+
+struct gwavi_super_index_entry_t {
+	uint64_t offset;	/* qwOffset */
+	unsigned int size;	/* dwSize */
+	unsigned int duration;	/* dwDuration */
+};
+
+struct gwavi_riff_t {
+	uint64_t riff;		/* offset of RIFF chunk */
+	uint64_t movi;		/* offset of movi LIST */
+	uint64_t movi_end;	/* end of movi LIST */
+	uint64_t end;		/* end of RIFF chunk */
+	unsigned int frames;	/* number of frames */
+};
+
 struct gwavi_t {
 	int handle;
 	struct gwavi_header_t avi_header;
 	struct gwavi_stream_header_t stream_header;
 	struct gwavi_stream_format_t stream_format;
-	long marker;
-	int offsets_ptr;
+	uint64_t position;	/* offset of the next byte queued to recorder */
+	struct gwavi_riff_t *riffs;
+	int riff_count;
+	struct gwavi_index_entry_t *offsets;	/* idx1 entries of the first RIFF (offset relative to 'movi' form type) */
 	int offsets_len;
-	long offsets_start;
-	unsigned int *offsets;
 	int offset_count;
+	struct gwavi_index_entry_t *index; /* pending ix00 entries */
+	int index_count;
+	struct gwavi_super_index_entry_t *super_index;
+	int super_index_count;
+	unsigned int total_frames;
+	indigo_recorder *recorder;
 };
 
 extern struct gwavi_t *gwavi_open(const char *filename, unsigned int width, unsigned int height, const char *fourcc, unsigned int fps);
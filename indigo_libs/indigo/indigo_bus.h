@@ -361,6 +361,7 @@ typedef struct {
 	int input;													///< input handle
 	int output;													///< output handle
 	bool web_socket;										///< connection over WebSocket (RFC6455)
+	bool web_socket_deflate;						///< permessage-deflate negotiated for WebSocket (RFC7692)
 	char url_prefix[INDIGO_NAME_SIZE];	///< server url prefix (for BLOB download)
 } indigo_adapter_context;
 
@@ -373,6 +374,7 @@ typedef struct {
 	long size;              						///< BLOB size
 	char format[INDIGO_NAME_SIZE];  		///< BLOB format, known file type suffix like ".fits" or ".jpeg"
 	pthread_mutex_t mutext;							///< BLOB mutex
+	unsigned long version;							///< BLOB content version (served as HTTP ETag)
 } indigo_blob_entry;
 
 /** Last diagnostic messages.
@@ -399,6 +401,36 @@ extern void indigo_log_base(indigo_log_levels level, const char *format, va_list
  */
 extern void indigo_log_message(const char *format, va_list args);
 
+/** Size of per-thread ring buffer used by asynchronous log (power of 2).
+ */
+#define INDIGO_LOG_RING_SIZE				(256 * 1024)
+
+/** Interval in ms in which asynchronous log is written.
+ */
+#define INDIGO_LOG_FLUSH_INTERVAL		50
+
+/** Maximal size of log file, if exceeded, log files are rotated.
+ */
+#define INDIGO_LOG_FILE_SIZE				(64L * 1024L * 1024L)
+
+/** Number of kept log files (including the current one).
+ */
+#define INDIGO_LOG_FILE_COUNT				5
+
+/** Start asynchronous log. Messages are queued to per-thread ring buffers without locking and written in batches by background thread,
+ if file_name is not NULL, log is written to rotated files instead of stderr. If ring buffer is full, message is dropped and reported later.
+ If asynchronous log is already running, a different file_name restarts it with the new file.
+ */
+extern bool indigo_start_async_log(const char *file_name);
+
+/** Stop asynchronous log and write all queued messages.
+ */
+extern void indigo_stop_async_log(void);
+
+/** Get number of messages dropped by asynchronous log.
+ */
+extern unsigned long indigo_get_log_dropped(void);
+
 /** Print diagnostic messages on trace level, wrap calls to INDIGO_TRACE() macro.
  */
 extern void indigo_trace(const char *format, ...);
@@ -472,6 +504,16 @@ extern indigo_result indigo_delete_property(indigo_device *device, indigo_proper
  */
 extern indigo_result indigo_send_message(indigo_device *device, const char *format, ...);
 
+/** Get bus event counter, it is incremented whenever property is defined, updated or deleted.
+ */
+extern unsigned long indigo_bus_event_count(void);
+
+/** Wait until bus event counter differs from *event, i.e. until any property is defined, updated or deleted after the counter was sampled.
+ Counter is stored back to *event. If timeout is not NULL, wait at most *timeout seconds and decrement *timeout by the time spent. Returns false on timeout.
+ Typical use is to sample the counter, test condition and wait, instead of polling the condition with indigo_usleep().
+ */
+extern bool indigo_wait_for_bus_event(unsigned long *event, double *timeout);
+
 /** Broadcast property enumeration request.
  */
 extern indigo_result indigo_enumerate_properties(indigo_client *client, indigo_property *property);
@@ -557,6 +599,10 @@ extern void indigo_init_blob_item(indigo_item *item, const char *name, const cha
  */
 extern bool indigo_populate_http_blob_item(indigo_item *blob_item);
 
+/** start background download of BLOB item if url is given and prefetch is enabled, indigo_populate_http_blob_item() uses prefetched content.
+ */
+extern void indigo_prefetch_http_blob_item(indigo_item *blob_item);
+
 /** upload BLOB item if url is given.
  */
 extern bool indigo_upload_http_blob_item(indigo_item *blob_item);
@@ -788,6 +834,10 @@ extern bool indigo_use_blob_caching;
  */
 extern bool indigo_proxy_blob;
 
+/** Prefetch BLOB content from remote servers as soon as URL is received
+ */
+extern bool indigo_use_blob_prefetch;
+
 /** Use recursive locks for dispaching all bus messages
  */
 extern bool indigo_use_strict_locking;
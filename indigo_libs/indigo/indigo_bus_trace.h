@@ -0,0 +1,154 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+/** INDIGO binary bus trace
+ \file indigo_bus_trace.h
+ */
+
+#ifndef indigo_bus_trace_h
+#define indigo_bus_trace_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <indigo/indigo_bus.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Trace file signature.
+ */
+#define INDIGO_BUS_TRACE_MAGIC				"INDIGOBT"
+
+/** Trace file format version.
+ */
+#define INDIGO_BUS_TRACE_VERSION			1
+
+/** Trace file is extended and remapped in this increments.
+ */
+#define INDIGO_BUS_TRACE_CHUNK_SIZE		(16L * 1024L * 1024L)
+
+/** Recorded bus events.
+ */
+typedef enum {
+	INDIGO_BUS_TRACE_DEFINE = 1,		///< indigo_define_property()
+	INDIGO_BUS_TRACE_UPDATE,				///< indigo_update_property()
+	INDIGO_BUS_TRACE_DELETE,				///< indigo_delete_property()
+	INDIGO_BUS_TRACE_CHANGE,				///< indigo_change_property()
+	INDIGO_BUS_TRACE_ENUMERATE			///< indigo_enumerate_properties()
+} indigo_bus_trace_event;
+
+/** Record flag, event was issued by remote client.
+ */
+#define INDIGO_BUS_TRACE_REMOTE				0x01
+
+/** Trace file header, values are stored in host byte order.
+ */
+typedef struct {
+	char magic[8];								///< INDIGO_BUS_TRACE_MAGIC
+	uint32_t version;							///< INDIGO_BUS_TRACE_VERSION
+	uint32_t header_size;					///< size of this header
+	uint64_t start_time;					///< trace start time (ns since epoch)
+	uint64_t length;							///< size of recorded data following the header
+	uint64_t count;								///< number of recorded events
+	uint64_t dropped;							///< number of events not recorded because file couldn't be extended
+} indigo_bus_trace_header;
+
+/** Trace record header, followed by zero terminated device and property names and items.
+ Each item starts with length byte and zero terminated name followed by value - text: 32-bit length and zero terminated text,
+ number: value and target as doubles, switch and light: single byte, BLOB: 64-bit size (content is not recorded).
+ */
+typedef struct {
+	uint32_t size;								///< record size including this header (multiple of 8)
+	uint8_t event;								///< indigo_bus_trace_event
+	uint8_t type;									///< indigo_property_type or 0 for enumerate request
+	uint8_t state;								///< indigo_property_state
+	uint8_t flags;								///< INDIGO_BUS_TRACE_REMOTE
+	uint64_t time;								///< event time (ns since start_time)
+	uint64_t payload;							///< size of item values in bytes (including BLOB content)
+	uint16_t count;								///< number of items
+	uint8_t device_length;				///< device name length
+	uint8_t name_length;					///< property name length
+	uint32_t reserved;
+} indigo_bus_trace_record;
+
+#if defined(INDIGO_WINDOWS)
+
+#define indigo_bus_trace_enabled false
+#define indigo_bus_trace_property(event, client, property)
+
+#else
+
+/** Set when trace recording is active, checked by bus before recording.
+ */
+extern bool indigo_bus_trace_enabled;
+
+/** Start recording of bus events to memory-mapped file.
+ */
+extern bool indigo_start_bus_trace(const char *file_name);
+
+/** Stop recording and truncate file to recorded length.
+ */
+extern void indigo_stop_bus_trace(void);
+
+/** Record bus event, called by bus if indigo_bus_trace_enabled is set.
+ */
+extern void indigo_bus_trace_property(indigo_bus_trace_event event, indigo_client *client, indigo_property *property);
+
+/** Read-only mapping of recorded trace.
+ */
+typedef struct {
+	int handle;										///< file handle
+	unsigned char *data;					///< mapped file
+	size_t size;									///< mapped size
+	size_t length;								///< end of recorded data
+	size_t position;							///< offset of the next record
+	indigo_bus_trace_header *header;	///< file header
+} indigo_bus_trace_reader;
+
+/** Open recorded trace for reading.
+ */
+extern indigo_bus_trace_reader *indigo_bus_trace_open(const char *file_name);
+
+/** Get next record or NULL at the end of trace.
+ */
+extern indigo_bus_trace_record *indigo_bus_trace_next(indigo_bus_trace_reader *reader);
+
+/** Get device and property name of the record.
+ */
+extern void indigo_bus_trace_names(indigo_bus_trace_record *record, const char **device, const char **name);
+
+/** Create property from the record (BLOB items are created with given size but without content), release it with indigo_release_property().
+ */
+extern indigo_property *indigo_bus_trace_decode(indigo_bus_trace_record *record);
+
+/** Close trace opened by indigo_bus_trace_open().
+ */
+extern void indigo_bus_trace_close(indigo_bus_trace_reader *reader);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* indigo_bus_trace_h */
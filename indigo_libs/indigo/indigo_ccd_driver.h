@@ -26,9 +26,12 @@
 #ifndef indigo_ccd_h
 #define indigo_ccd_h
 
+#include <sys/time.h>
+
 #include <indigo/indigo_bus.h>
 #include <indigo/indigo_driver.h>
 #include <indigo/indigo_fits.h>
+#include <indigo/indigo_frame_pool.h>
 
 typedef enum {
 	CCD_JPEG_STRETCH_SLIGHT = 0,
@@ -192,6 +195,22 @@ extern "C" {
  */
 #define CCD_STREAMING_COUNT_ITEM          (CCD_STREAMING_PROPERTY->items+1)
 
+/** CCD_STREAMING_STATISTICS property pointer, property is optional, read-only property updated by frame ring at most once per second.
+ */
+#define CCD_STREAMING_STATISTICS_PROPERTY (CCD_CONTEXT->ccd_streaming_statistics_property)
+
+/** CCD_STREAMING_STATISTICS.DELIVERED property item pointer (frames processed by frame ring).
+ */
+#define CCD_STREAMING_STATISTICS_DELIVERED_ITEM (CCD_STREAMING_STATISTICS_PROPERTY->items+0)
+
+/** CCD_STREAMING_STATISTICS.DROPPED property item pointer (frames dropped by frame ring).
+ */
+#define CCD_STREAMING_STATISTICS_DROPPED_ITEM (CCD_STREAMING_STATISTICS_PROPERTY->items+1)
+
+/** CCD_STREAMING_STATISTICS.FPS property item pointer (achieved frame rate).
+ */
+#define CCD_STREAMING_STATISTICS_FPS_ITEM (CCD_STREAMING_STATISTICS_PROPERTY->items+2)
+
 /** CCD_ABORT property pointer, property is mandatory, property change request handler should set property items and state and call indigo_ccd_change_property().
  */
 #define CCD_ABORT_EXPOSURE_PROPERTY       (CCD_CONTEXT->ccd_abort_exposure_property)
@@ -362,6 +381,42 @@ extern "C" {
  */
 #define CCD_IMAGE_FILE_ITEM               (CCD_IMAGE_FILE_PROPERTY->items+0)
 
+/** CCD_RECORDER_STATISTICS property pointer, property is mandatory, read-only property.
+ */
+#define CCD_RECORDER_STATISTICS_PROPERTY  (CCD_CONTEXT->ccd_recorder_statistics_property)
+
+/** CCD_RECORDER_STATISTICS.RATE property item pointer (write rate in MB/s).
+ */
+#define CCD_RECORDER_STATISTICS_RATE_ITEM (CCD_RECORDER_STATISTICS_PROPERTY->items+0)
+
+/** CCD_RECORDER_STATISTICS.QUEUE property item pointer (frames buffered and not written yet).
+ */
+#define CCD_RECORDER_STATISTICS_QUEUE_ITEM (CCD_RECORDER_STATISTICS_PROPERTY->items+1)
+
+/** CCD_RECORDER_STATISTICS.FRAMES property item pointer (frames recorded).
+ */
+#define CCD_RECORDER_STATISTICS_FRAMES_ITEM (CCD_RECORDER_STATISTICS_PROPERTY->items+2)
+
+/** CCD_RECORDER_STATISTICS.DROPPED property item pointer (frames dropped because of slow storage).
+ */
+#define CCD_RECORDER_STATISTICS_DROPPED_ITEM (CCD_RECORDER_STATISTICS_PROPERTY->items+3)
+
+/** CCD_DSLR_RAW_MODE property pointer, property is optional (used by DSLR drivers), read-write property, property change request is fully handled by indigo_ccd_change_property().
+ */
+#define CCD_DSLR_RAW_MODE_PROPERTY        (CCD_CONTEXT->ccd_dslr_raw_mode_property)
+
+/** CCD_DSLR_RAW_MODE.FULL property item pointer (full resolution CFA data).
+ */
+#define CCD_DSLR_RAW_MODE_FULL_ITEM       (CCD_DSLR_RAW_MODE_PROPERTY->items+0)
+
+/** CCD_DSLR_RAW_MODE.BIN_2X2 property item pointer (each 2x2 CFA cell averaged to single monochrome pixel).
+ */
+#define CCD_DSLR_RAW_MODE_BIN_2X2_ITEM    (CCD_DSLR_RAW_MODE_PROPERTY->items+1)
+
+/** CCD_DSLR_RAW_MODE.THUMBNAIL property item pointer (embedded JPEG preview only).
+ */
+#define CCD_DSLR_RAW_MODE_THUMBNAIL_ITEM  (CCD_DSLR_RAW_MODE_PROPERTY->items+2)
+
 /** CCD_IMAGE property pointer, property is mandatory, read-only property.
  */
 #define CCD_IMAGE_PROPERTY                (CCD_CONTEXT->ccd_image_property)
@@ -447,6 +502,7 @@ extern "C" {
 #define MAX_FITS_LOGICAL_RECORDS	3
 
 /** FITS header size, it should be added to image buffer size, raw data should start at this offset.
+ Image buffers allocated with indigo_alloc_frame_buffer() may be reused from another frame or device and are not zeroed, so drivers must not rely on cleared padding or unread areas.
  */
 #define FITS_HEADER_SIZE  (MAX_FITS_LOGICAL_RECORDS * FITS_LOGICAL_RECORD_LENGTH)
 
@@ -523,6 +579,7 @@ typedef struct {
 	void *preview_histogram;											///< preview histogram buffer
 	unsigned long preview_histogram_size;					///< preview histogram buffer size
 	void *video_stream;														///< video stream control structure
+	struct timeval frame_timestamp;								///< capture time of the frame processed by frame ring (cleared otherwise)
 	indigo_property *ccd_info_property;           ///< CCD_INFO property pointer
 	indigo_property *ccd_lens_property;						///< CCD_LENS property pointer
 	indigo_property *ccd_upload_mode_property;    ///< CCD_UPLOAD_MODE property pointer
@@ -545,6 +602,9 @@ typedef struct {
 	indigo_property *ccd_preview_image_property;  ///< CCD_PREVIEW_IMAGE property pointer
 	indigo_property *ccd_preview_histogram_property;  ///< CCD_PREVIEW_HISTOGRAM property pointer
 	indigo_property *ccd_image_file_property;     ///< CCD_IMAGE_FILE property pointer
+	indigo_property *ccd_recorder_statistics_property; ///< CCD_RECORDER_STATISTICS property pointer
+	indigo_property *ccd_streaming_statistics_property; ///< CCD_STREAMING_STATISTICS property pointer
+	indigo_property *ccd_dslr_raw_mode_property;  ///< CCD_DSLR_RAW_MODE property pointer
 	indigo_property *ccd_temperature_property;    ///< CCD_TEMPERATURE property pointer
 	indigo_property *ccd_cooler_property;         ///< CCD_COOLER property pointer
 	indigo_property *ccd_cooler_power_property;   ///< CCD_COOLER_POWER property pointer
@@ -557,6 +617,60 @@ typedef struct {
 	indigo_property *ccd_rbi_flush_property;			///< CCD_RBI_FLUSH property pointer
 } indigo_ccd_context;
 
+/** Default number of buffers in video frame ring.
+ */
+#define INDIGO_FRAME_RING_SIZE						4
+
+/** Maximal memory allocated by video frame ring, buffer count is reduced for large frames (but at least 2 buffers are used).
+ */
+#define INDIGO_FRAME_RING_MEMORY_LIMIT		(256L * 1024L * 1024L)
+
+/** Video frame ring, decouples frame download in streaming loop from image processing.
+ Producer (streaming loop) gets buffer with indigo_frame_ring_acquire(), reads frame into it (at FITS_HEADER_SIZE offset) and queues it with indigo_frame_ring_commit().
+ Queued frames are processed on ring thread, if all buffers are in use the oldest queued frame is dropped.
+ */
+typedef struct {
+	indigo_device *device;																			///< owner device
+	void (*process)(indigo_device *device, void *data, int width, int height, int bpp); ///< frame processing callback
+	int count;																									///< number of buffers
+	long size;																									///< size of each buffer
+	void **buffers;																							///< buffers
+	int *width;																									///< frame width per buffer
+	int *height;																								///< frame height per buffer
+	int *bpp;																										///< frame bpp per buffer
+	struct timeval *timestamp;																	///< frame capture time per buffer
+	int *queue;																									///< queued buffer indices
+	int queue_head;																							///< index of the oldest queued buffer in queue
+	int queue_count;																						///< number of queued buffers
+	int writing;																								///< buffer filled by producer or -1
+	int processing;																							///< buffer processed by consumer or -1
+	long delivered;																							///< number of processed frames
+	long dropped;																								///< number of dropped frames
+	double start_time;																					///< time of ring creation
+	double statistics_time;																			///< time of the last CCD_STREAMING_STATISTICS update
+	bool running;																								///< consumer is running
+	bool flush;																									///< process queued frames before stop
+	pthread_t thread;																						///< consumer thread
+	pthread_mutex_t mutex;																			///< ring mutex
+	pthread_cond_t cond;																				///< ring condition
+} indigo_frame_ring;
+
+/** Create video frame ring with count buffers of given size (including FITS_HEADER_SIZE) and start processing thread, resets CCD_STREAMING_STATISTICS.
+ */
+extern indigo_frame_ring *indigo_frame_ring_create(indigo_device *device, int count, long size, void (*process)(indigo_device *device, void *data, int width, int height, int bpp));
+
+/** Get buffer for next frame, if all buffers are used the oldest queued frame is dropped.
+ */
+extern void *indigo_frame_ring_acquire(indigo_frame_ring *ring);
+
+/** Queue frame read to the buffer returned by the last indigo_frame_ring_acquire() call, the frame is timestamped at commit (used by SER recorder).
+ */
+extern void indigo_frame_ring_commit(indigo_frame_ring *ring, int width, int height, int bpp);
+
+/** Stop processing thread and free ring, if flush is set, queued frames are processed first, otherwise they are dropped.
+ */
+extern void indigo_frame_ring_delete(indigo_frame_ring *ring, bool flush);
+
 /** Suspend countdown.
  */
 extern void indigo_ccd_suspend_countdown(indigo_device *device);
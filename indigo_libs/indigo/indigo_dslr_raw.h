@@ -68,6 +68,12 @@ extern "C" {
 int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_raw_image_s *output_image);
 int indigo_dslr_raw_image_info(void *buffer, size_t buffer_size, indigo_dslr_raw_image_info_s *image_info);
 
+/* Open RAW file only once to get image info (if image_info is not NULL) and CFA data, if binning is requested, each 2x2 CFA cell is averaged to single monochrome pixel. */
+int indigo_dslr_raw_process_image_with_info(void *buffer, size_t buffer_size, bool binning, indigo_dslr_raw_image_s *output_image, indigo_dslr_raw_image_info_s *image_info);
+
+/* Extract embedded JPEG preview without unpacking RAW data, returned buffer must be freed by caller. */
+int indigo_dslr_raw_thumbnail(void *buffer, size_t buffer_size, void **thumbnail, size_t *thumbnail_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,111 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+
+/** INDIGO frame buffer pool
+ \file indigo_frame_pool.h
+ */
+
+#ifndef indigo_frame_pool_h
+#define indigo_frame_pool_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <indigo/indigo_bus.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Smaller buffers are allocated from heap and not pooled.
+ */
+#define INDIGO_FRAME_POOL_MIN_SIZE			(256L * 1024L)
+
+/** Default limit of memory kept in pool for reuse.
+ */
+#define INDIGO_FRAME_POOL_LIMIT					(1024L * 1024L * 1024L)
+
+/** Huge page size used for rounding of huge page backed buffers.
+ */
+#define INDIGO_FRAME_POOL_HUGEPAGE_SIZE	(2L * 1024L * 1024L)
+
+/** Huge page usage.
+ */
+typedef enum {
+	INDIGO_FRAME_POOL_NO_HUGEPAGES = 0,			///< regular pages only
+	INDIGO_FRAME_POOL_TRANSPARENT_HUGEPAGES,	///< request transparent huge pages (Linux only)
+	INDIGO_FRAME_POOL_EXPLICIT_HUGEPAGES			///< map from hugetlbfs pool, falls back to transparent huge pages (Linux only)
+} indigo_frame_pool_hugepages_mode;
+
+/** Pool usage statistics.
+ */
+typedef struct {
+	uint64_t mapped;																						///< bytes mapped by pool (in use and cached)
+	uint64_t used;																							///< bytes handed out to callers
+	uint64_t cached;																						///< bytes kept for reuse
+	uint64_t hugepages;																					///< bytes mapped from explicit huge pages
+	uint64_t hits;																							///< allocations served from cache
+	uint64_t misses;																						///< allocations requiring new mapping
+	int buffers;																								///< number of buffers in use
+} indigo_frame_pool_stats;
+
+#if defined(INDIGO_WINDOWS)
+
+#define indigo_alloc_frame_buffer(size) indigo_alloc_blob_buffer(size)
+#define indigo_free_frame_buffer(buffer) indigo_safe_free(buffer)
+
+static inline void indigo_frame_pool_statistics(indigo_frame_pool_stats *stats) {
+	memset(stats, 0, sizeof(indigo_frame_pool_stats));
+}
+
+#else
+
+/** Huge page usage for newly mapped buffers, set before the first allocation.
+ */
+extern indigo_frame_pool_hugepages_mode indigo_frame_pool_hugepages;
+
+/** Maximal number of bytes kept in pool for reuse, released buffers over the limit are unmapped.
+ */
+extern long indigo_frame_pool_limit;
+
+/** Allocate frame buffer of at least size bytes, extended and rounded to FITS block size like indigo_alloc_blob_buffer().
+ Buffers are shared by all devices in the process and grouped in size classes (4 per power of two), so a buffer released by one camera can be reused by another.
+ New buffers are zeroed and pre-faulted, content of reused buffers is undefined. Buffer must be released with indigo_free_frame_buffer().
+ Like indigo_alloc_blob_buffer() it never returns NULL, allocation failure is fatal (assert).
+ */
+extern void *indigo_alloc_frame_buffer(long size);
+
+/** Return frame buffer to the pool, NULL is ignored.
+ */
+extern void indigo_free_frame_buffer(void *buffer);
+
+/** Get current pool usage.
+ */
+extern void indigo_frame_pool_statistics(indigo_frame_pool_stats *stats);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* indigo_frame_pool_h */
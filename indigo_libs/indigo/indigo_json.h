@@ -43,6 +43,26 @@ extern "C" {
 #define ntohll(x) ((1==ntohl(1)) ? (x) : ((uint64_t)ntohl((x) & 0xFFFFFFFF) << 32) | ntohl((x) >> 32))
 #endif
 
+/** WebSocket (RFC6455) frame header bits and opcodes.
+ */
+#define WS_FIN										0x80
+#define WS_RSV1										0x40
+#define WS_MASK										0x80
+#define WS_OPCODE_CONTINUATION		0x00
+#define WS_OPCODE_TEXT						0x01
+#define WS_OPCODE_BINARY					0x02
+#define WS_OPCODE_CLOSE						0x08
+#define WS_OPCODE_PING						0x09
+#define WS_OPCODE_PONG						0x0A
+
+/** Minimal message size compressed with permessage-deflate (RFC7692).
+ */
+#define WS_DEFLATE_THRESHOLD			256
+
+/** Send WebSocket control frame (e.g. PONG echoing PING payload, at most 125 bytes), serialized with JSON adapter output.
+ */
+extern bool indigo_json_ws_control(int handle, uint8_t opcode, const char *payload, long length);
+
 /** JSON wire protocol parser.
  */
 extern void indigo_json_parse(indigo_device *device, indigo_client *client);
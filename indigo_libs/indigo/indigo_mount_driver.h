@@ -479,7 +479,15 @@ extern "C" {
 /** Max number of alignment points.
  */
 
-#define MOUNT_MAX_ALIGNMENT_POINTS										100
+#define MOUNT_MAX_ALIGNMENT_POINTS										10000
+
+/** Initial number of alignment points allocated, storage is doubled when it is exhausted.
+ */
+#define MOUNT_ALIGNMENT_POINTS_CHUNK									100
+
+/** Number of nearest alignment points interpolated in multi point mode.
+ */
+#define MOUNT_INTERPOLATED_ALIGNMENT_POINTS						3
 
 //------------------------------------------------
 /** Definition of side of pier
@@ -505,7 +513,7 @@ typedef struct {
 typedef struct {
 	indigo_device_context device_context;										///< device context base
 	int alignment_point_count;															///< number of defined alignment points
-	indigo_alignment_point alignment_points[MOUNT_MAX_ALIGNMENT_POINTS]; ///< alignment points
+	indigo_alignment_point *alignment_points;								///< alignment points (see indigo_mount_reserve_alignment_points())
 	indigo_property *mount_geographic_coordinates_property;	///< MOUNT_GEOGRAPHIC_COORDINATES property pointer
 	indigo_property *mount_info_property;                   ///< MOUNT_INFO property pointer
 	indigo_property *mount_lst_time_property;								///< MOUNT_LST_TIME property pointer
@@ -539,6 +547,11 @@ typedef struct {
 	indigo_property *mount_pec_property;										///< MOUNT_PEC property pointer
 	indigo_property *mount_pec_training_property;						///< MOUNT_PEC_TRAINING property pointer
 	indigo_property *mount_alignment_reset_property;					///< MOUNT_ALIGNMENT_RESET property pointer
+	int alignment_cache_count;															///< number of alignment points in the cache
+	indigo_alignment_point *alignment_cache_points;					///< copy of alignment points the cache was built from
+	double (*alignment_cache_vectors[2])[3];								///< HA/Dec unit vectors of translated and raw alignment point positions
+	pthread_mutex_t alignment_mutex;												///< recursive mutex guarding alignment points and the cache
+	int alignment_point_capacity;														///< number of alignment points allocated
 } indigo_mount_context;
 
 /** Attach callback function.
@@ -590,6 +603,17 @@ extern void indigo_mount_save_alignment_points(indigo_device *device);
 
 extern void indigo_mount_update_alignment_points(indigo_device *device);
 
+/** Make room for at least count alignment points (and items of MOUNT_ALIGNMENT_SELECT_POINTS and MOUNT_ALIGNMENT_DELETE_POINTS properties).
+ Must be called with alignment_mutex locked, returns false if count exceeds MOUNT_MAX_ALIGNMENT_POINTS.
+ */
+extern bool indigo_mount_reserve_alignment_points(indigo_device *device, int count);
+
+/** Rebuild cache of alignment point unit vectors used by nearest and multi point alignment.
+ With at most MOUNT_MAX_ALIGNMENT_POINTS points the lookup is a linear scan of dot products, the cache only saves the trigonometry per point.
+ */
+
+extern void indigo_mount_update_alignment_cache(indigo_device *device);
+
 /** Get host UTC offset
  */
 
@@ -398,6 +398,22 @@
  */
 #define CCD_STREAMING_COUNT_ITEM_NAME         "COUNT"
 
+/** CCD_STREAMING_STATISTICS property name.
+ */
+#define CCD_STREAMING_STATISTICS_PROPERTY_NAME "CCD_STREAMING_STATISTICS"
+
+/** CCD_STREAMING_STATISTICS.DELIVERED property item name.
+ */
+#define CCD_STREAMING_STATISTICS_DELIVERED_ITEM_NAME "DELIVERED"
+
+/** CCD_STREAMING_STATISTICS.DROPPED property item name.
+ */
+#define CCD_STREAMING_STATISTICS_DROPPED_ITEM_NAME "DROPPED"
+
+/** CCD_STREAMING_STATISTICS.FPS property item name.
+ */
+#define CCD_STREAMING_STATISTICS_FPS_ITEM_NAME "FPS"
+
 //----------------------------------------------------------------------
 /** CCD_ABORT_EXPOSURE property name.
  */
@@ -575,6 +591,42 @@
  */
 #define CCD_IMAGE_FILE_ITEM_NAME              "FILE"
 
+/** CCD_RECORDER_STATISTICS property name.
+ */
+#define CCD_RECORDER_STATISTICS_PROPERTY_NAME "CCD_RECORDER_STATISTICS"
+
+/** CCD_RECORDER_STATISTICS.RATE property item name.
+ */
+#define CCD_RECORDER_STATISTICS_RATE_ITEM_NAME "RATE"
+
+/** CCD_RECORDER_STATISTICS.QUEUE property item name.
+ */
+#define CCD_RECORDER_STATISTICS_QUEUE_ITEM_NAME "QUEUE"
+
+/** CCD_RECORDER_STATISTICS.FRAMES property item name.
+ */
+#define CCD_RECORDER_STATISTICS_FRAMES_ITEM_NAME "FRAMES"
+
+/** CCD_RECORDER_STATISTICS.DROPPED property item name.
+ */
+#define CCD_RECORDER_STATISTICS_DROPPED_ITEM_NAME "DROPPED"
+
+/** CCD_DSLR_RAW_MODE property name.
+ */
+#define CCD_DSLR_RAW_MODE_PROPERTY_NAME       "CCD_DSLR_RAW_MODE"
+
+/** CCD_DSLR_RAW_MODE.FULL property item name.
+ */
+#define CCD_DSLR_RAW_MODE_FULL_ITEM_NAME      "FULL"
+
+/** CCD_DSLR_RAW_MODE.BIN_2X2 property item name.
+ */
+#define CCD_DSLR_RAW_MODE_BIN_2X2_ITEM_NAME   "BIN_2X2"
+
+/** CCD_DSLR_RAW_MODE.THUMBNAIL property item name.
+ */
+#define CCD_DSLR_RAW_MODE_THUMBNAIL_ITEM_NAME "THUMBNAIL"
+
 /** CCD_IMAGE property name.
  */
 #define CCD_IMAGE_PROPERTY_NAME               "CCD_IMAGE"
@@ -2832,6 +2884,7 @@ enum {
 
 #define AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY_NAME	"AGENT_SCRIPTING_ON_LOAD_SCRIPT"
 #define AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY_NAME	"AGENT_SCRIPTING_ON_UNLOAD_SCRIPT"
+#define AGENT_SCRIPTING_WORKER_SCRIPT_PROPERTY_NAME	"AGENT_SCRIPTING_WORKER_SCRIPT"
 
 #define AGENT_SCRIPTING_SCRIPT_PROPERTY_NAME					"AGENT_SCRIPTING_SCRIPT_%d"
 #define AGENT_SCRIPTING_SCRIPT_NAME_ITEM_NAME					"NAME"
@@ -2851,6 +2904,10 @@ enum {
 
 #define AGENT_ASTROMETRY_INDEX_42XX_PROPERTY_NAME			"AGENT_ASTROMETRY_INDEX_42XX"
 
+#define AGENT_ASTROMETRY_EXTRACTION_PROPERTY_NAME			"AGENT_ASTROMETRY_EXTRACTION"
+#define AGENT_ASTROMETRY_EXTRACTION_IMAGE2XY_ITEM_NAME	"IMAGE2XY"
+#define AGENT_ASTROMETRY_EXTRACTION_INDIGO_ITEM_NAME		"INDIGO"
+
 #define AGENT_ASTAP_INDEX_PROPERTY_NAME								"AGENT_ASTAP_INDEX"
 
 
@@ -2898,6 +2955,8 @@ typedef enum {
 #define AGENT_PLATESOLVER_WCS_SCALE_ITEM_NAME					"SCALE"
 #define AGENT_PLATESOLVER_WCS_PARITY_ITEM_NAME				"PARITY"
 #define AGENT_PLATESOLVER_WCS_INDEX_ITEM_NAME					"INDEX"
+#define AGENT_PLATESOLVER_WCS_SOLVE_TIME_ITEM_NAME		"SOLVE_TIME"
+#define AGENT_PLATESOLVER_WCS_AVERAGE_SOLVE_TIME_ITEM_NAME	"AVERAGE_SOLVE_TIME"
 
 #define AGENT_PLATESOLVER_GOTO_SETTINGS_PROPERTY_NAME	"AGENT_PLATESOLVER_GOTO_SETTINGS"
 #define AGENT_PLATESOLVER_GOTO_SETTINGS_RA_ITEM_NAME	"RA"
@@ -3037,6 +3096,15 @@ typedef enum {
 #define SERVER_CTRL_PANEL_ITEM_NAME										"CTRL_PANEL"
 #define SERVER_WEB_APPS_ITEM_NAME											"WEB_APPS"
 
+#define SERVER_FRAME_POOL_PROPERTY_NAME								"FRAME_POOL"
+#define SERVER_FRAME_POOL_MAPPED_ITEM_NAME						"MAPPED"
+#define SERVER_FRAME_POOL_USED_ITEM_NAME							"USED"
+#define SERVER_FRAME_POOL_CACHED_ITEM_NAME						"CACHED"
+#define SERVER_FRAME_POOL_HUGEPAGES_ITEM_NAME					"HUGEPAGES"
+#define SERVER_FRAME_POOL_BUFFERS_ITEM_NAME						"BUFFERS"
+#define SERVER_FRAME_POOL_HITS_ITEM_NAME							"HITS"
+#define SERVER_FRAME_POOL_MISSES_ITEM_NAME						"MISSES"
+
 #define SERVER_WIFI_COUNTRY_CODE_PROPERTY_NAME							"WIFI_COUNTRY_CODE"
 #define SERVER_WIFI_COUNTRY_CODE_ITEM_NAME								"COUNTRY_CODE"
 
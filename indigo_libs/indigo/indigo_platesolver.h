@@ -64,6 +64,8 @@ extern "C" {
 #define AGENT_PLATESOLVER_WCS_SCALE_ITEM    	(AGENT_PLATESOLVER_WCS_PROPERTY->items+7)
 #define AGENT_PLATESOLVER_WCS_PARITY_ITEM    	(AGENT_PLATESOLVER_WCS_PROPERTY->items+8)
 #define AGENT_PLATESOLVER_WCS_INDEX_ITEM    	(AGENT_PLATESOLVER_WCS_PROPERTY->items+9)
+#define AGENT_PLATESOLVER_WCS_SOLVE_TIME_ITEM	(AGENT_PLATESOLVER_WCS_PROPERTY->items+10)
+#define AGENT_PLATESOLVER_WCS_AVERAGE_SOLVE_TIME_ITEM	(AGENT_PLATESOLVER_WCS_PROPERTY->items+11)
 
 #define AGENT_PLATESOLVER_SYNC_PROPERTY				(INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->sync_mode_property)
 #define AGENT_PLATESOLVER_SYNC_DISABLED_ITEM	(AGENT_PLATESOLVER_SYNC_PROPERTY->items+0)
@@ -116,6 +118,19 @@ extern "C" {
 #define AGENT_PLATESOLVER_IMAGE_PROPERTY			(INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->image_property)
 #define AGENT_PLATESOLVER_IMAGE_ITEM					(AGENT_PLATESOLVER_IMAGE_PROPERTY->items+0)
 
+/** Number of persistent solver worker processes per agent.
+ */
+#define INDIGO_PLATESOLVER_POOL_SIZE	2
+
+/** Solver worker process structure.
+ */
+typedef struct {
+	pid_t pid;
+	int request;
+	FILE *output;
+	bool busy;
+} indigo_platesolver_worker;
+
 /** Plate solver  structure.
  */
 typedef struct {
@@ -155,8 +170,16 @@ typedef struct {
 	void (*save_config)(indigo_device *);
 	bool (*solve)(indigo_device *, void *image, unsigned long size);
 	void (*abort)(indigo_device *);
+	void (*map_indexes)(indigo_device *);
 	pthread_mutex_t mutex;
+	indigo_platesolver_worker pool[INDIGO_PLATESOLVER_POOL_SIZE];
+	pthread_mutex_t pool_mutex;
+	pthread_cond_t pool_cond;
+	bool pool_unavailable;
 	double pixel_scale;
+	double solve_start;
+	double solve_time_total;
+	int solve_count;
 	bool failed;
 	bool abort_process_requested;
 	int saved_sync_mode;
@@ -167,6 +190,22 @@ extern bool indigo_platesolver_validate_executable(const char *executable);
 extern void indigo_platesolver_save_config(indigo_device *device);
 extern void indigo_platesolver_sync(indigo_device *device);
 
+/** Update solve time statistics in WCS property, should be called by solver before final WCS update.
+ Last solve time is always updated, average solve time includes successful solves only.
+ */
+extern void indigo_platesolver_update_solve_time(indigo_device *device);
+
+/** Execute shell command in idle solver worker process, pass output lines to handler and keep process group ID of the job in pid while it is running (for abort).
+ If the worker helper can't be started, the command is spawned directly from the agent.
+ */
+extern bool indigo_platesolver_execute(indigo_device *device, const char *command, pid_t *pid, bool (*handler)(indigo_device *device, char *line));
+
+/** Replace set of index files kept memory mapped by solver worker pool, so repeated solves don't reload them from disk.
+ Files are mapped in the given order until their total size reaches half of physical memory, the rest is skipped.
+ Pool workers are indigo_solver_worker helper processes, looked up next to the main executable or in PATH.
+ */
+extern bool indigo_platesolver_map_files(indigo_device *device, int count, char **paths);
+
 /** Device attach callback function.
  */
 extern indigo_result indigo_platesolver_device_attach(indigo_device *device, const char* driver_name, unsigned version, indigo_device_interface device_interface);
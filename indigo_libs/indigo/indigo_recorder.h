@@ -0,0 +1,110 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+/** INDIGO asynchronous video recorder
+ \file indigo_recorder.h
+ */
+
+#ifndef indigo_recorder_h
+#define indigo_recorder_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Block size, writes (and buffer) are aligned to it.
+ */
+#define INDIGO_RECORDER_BLOCK_SIZE			4096
+
+/** Minimal size of a single write while recording is in progress.
+ */
+#define INDIGO_RECORDER_BATCH_SIZE			(4L * 1024L * 1024L)
+
+/** Default size of recorder buffer (it is extended to hold at least 4 frames).
+ */
+#define INDIGO_RECORDER_BUFFER_SIZE			(128L * 1024L * 1024L)
+
+/** File space is preallocated ahead of written data in this increments.
+ */
+#define INDIGO_RECORDER_PREALLOCATION		(256L * 1024L * 1024L)
+
+/** Bypass page cache when writing video files (O_DIRECT on Linux, F_NOCACHE on macOS).
+ */
+extern bool indigo_use_direct_io;
+
+/** Asynchronous recorder, appends frames written by a container writer (SER, AVI) to the file on dedicated writer thread.
+ Frames are copied to a circular buffer and written in large block aligned batches, if the buffer is full the frame is dropped.
+ The file handle is owned by caller, it may be used again after indigo_recorder_close().
+ */
+typedef struct {
+	int handle;																									///< file handle
+	bool direct;																								///< page cache is bypassed
+	unsigned char *buffer;																			///< circular buffer
+	size_t size;																								///< circular buffer size
+	off_t base;																									///< file offset of the first buffered byte
+	off_t allocated;																						///< preallocated file size
+	uint64_t head;																							///< number of bytes queued
+	uint64_t tail;																							///< number of bytes written
+	pthread_t thread;																						///< writer thread
+	pthread_mutex_t mutex;																			///< buffer mutex
+	pthread_cond_t cond;																				///< writer condition
+	pthread_cond_t space;																				///< buffer space condition
+	bool closing;																								///< flush remaining data and stop writer
+	int error;																									///< errno of failed write or 0
+	long frames;																								///< number of queued frames
+	long dropped;																								///< number of dropped frames
+	size_t frame_size;																					///< size of the last queued frame
+	double start_time;																					///< time of recorder creation
+	double rate_time;																						///< time of the last rate calculation
+	uint64_t rate_tail;																					///< written bytes at the last rate calculation
+	double rate;																								///< write rate in MB/s
+} indigo_recorder;
+
+/** Create recorder appending to file from current position, frame_size is used to extend buffer for huge frames.
+ */
+extern indigo_recorder *indigo_recorder_open(int handle, size_t frame_size);
+
+/** Queue frame composed of count parts, returns false if frame was dropped or writer failed (errno is set to error code in such case).
+ */
+extern bool indigo_recorder_append(indigo_recorder *recorder, int count, const void **parts, const size_t *lengths);
+
+/** Queue container data (headers, indexes), waits for buffer space instead of dropping it, returns false if writer failed.
+ */
+extern bool indigo_recorder_write(indigo_recorder *recorder, const void *data, size_t length);
+
+/** Get current statistics (write rate in MB/s and number of buffered frames), returns true if rate was recalculated (at most once per second).
+ */
+extern bool indigo_recorder_statistics(indigo_recorder *recorder, double *rate, int *queue);
+
+/** Write remaining data, stop writer thread, truncate preallocated space, set file position after the last frame and release recorder.
+ */
+extern bool indigo_recorder_close(indigo_recorder *recorder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* indigo_recorder_h */
@@ -23,6 +23,10 @@
 #define indigo_ser_h
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+#include <indigo/indigo_recorder.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -31,10 +35,13 @@ extern "C" {
 typedef struct {
 	int handle;
 	int count;
+	indigo_recorder *recorder;
+	uint64_t *timestamps;
+	int timestamps_size;
 } indigo_ser;
 
 extern indigo_ser *indigo_ser_open(const char *filename, void *buffer);
-extern bool indigo_ser_add_frame(indigo_ser *ser, void *buffer, size_t len);
+extern bool indigo_ser_add_frame(indigo_ser *ser, void *buffer, size_t len, const struct timeval *timestamp);
 extern bool indigo_ser_close(indigo_ser *ser);
 
 #ifdef __cplusplus
@@ -42,7 +42,36 @@
 extern "C" {
 #endif
 
+/** Maximal number of registered hotplug handlers.
+ */
+#define INDIGO_USB_HOTPLUG_MAX_HANDLERS		64
+
+/** Maximal number of product IDs matched by a hotplug handler.
+ */
+#define INDIGO_USB_HOTPLUG_MAX_PRODUCTS		128
+
+/** Events are coalesced at most for this time (in seconds), even if the burst continues.
+ */
+#define INDIGO_USB_HOTPLUG_MAX_DELAY			5.0
+
+/** Hotplug handler prototype (device is always NULL, it has the same signature as timer callback used for plug/unplug processing before).
+ Handler gets no libusb_device, so dispatcher suits only drivers which rescan devices with vendor SDK (ASI drivers use it now), drivers which open
+ the device passed to their libusb hotplug callback (e.g. SX, MI, PTP or UVC) have to keep their own callback.
+ */
+typedef void (*indigo_usb_hotplug_callback)(indigo_device *device);
+
 extern indigo_result indigo_get_usb_path(libusb_device* handle, char *path);
+
+/** Register hotplug handlers for devices with given vendor ID (or LIBUSB_HOTPLUG_MATCH_ANY) and one of product IDs (all products if product_count is 0).
+ Matching arrivals and removals are coalesced until no other matching event comes for delay seconds, then unplug handler is called once (it is expected to detect all removed devices) and plug handler once for each arrived device.
+ Handlers run on their own threads, handlers of the same registration never overlap. Devices already connected are reported as arrived.
+ Returns handle or -1 if handler can't be registered.
+ */
+extern int indigo_usb_hotplug_register(const char *name, int vendor_id, int product_count, const int *product_ids, double delay, indigo_usb_hotplug_callback plug, indigo_usb_hotplug_callback unplug);
+
+/** Deregister hotplug handlers, waits for running handler to finish.
+ */
+extern void indigo_usb_hotplug_deregister(int handle);
 	
 #ifdef __cplusplus
 }
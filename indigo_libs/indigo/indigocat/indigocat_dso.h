@@ -27,6 +27,8 @@
 #ifndef indigocat_dso_h
 #define indigocat_dso_h
 
+#include <stdbool.h>
+
 typedef enum {
 	GALAXY,
 	GALAXY_PAIR,
@@ -58,4 +60,9 @@ extern char *indigocat_dso_type_description[];
 
 extern indigocat_dso_entry *indigocat_get_dso_data(void);
 
+/** Find DSOs within radius (degrees) around ra (hours), dec (degrees) in J2000 or JNow coordinates, not fainter than max_mag.
+ Up to max_count brightest DSOs are stored to result sorted by magnitude, number of DSOs found is returned.
+ */
+extern int indigocat_search_dsos(double ra, double dec, double radius, float max_mag, bool jnow, indigocat_dso_entry **result, int max_count);
+
 #endif /* indigocat_dso_h */
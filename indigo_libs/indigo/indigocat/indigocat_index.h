@@ -0,0 +1,67 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+/** INDIGO catalog declination zone index
+ \file indigocat_index.h
+ */
+
+#ifndef indigocat_index_h
+#define indigocat_index_h
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Zone height in degrees.
+ */
+#define INDIGOCAT_ZONE_HEIGHT	1
+
+/** Number of declination zones.
+ */
+#define INDIGOCAT_ZONE_COUNT	(180 / INDIGOCAT_ZONE_HEIGHT)
+
+/** Declination zone index over RA sorted catalog table.
+ Table is described by entry size and offsets of double ra, dec, ra_now, dec_now and float mag fields, the index is built on the first search.
+ */
+typedef struct {
+	void *data;																///< catalog table
+	int count;																///< number of entries
+	size_t size;															///< entry size
+	size_t ra, dec, ra_now, dec_now, mag;			///< field offsets
+	bool built;																///< index is built
+	double margin;														///< maximal J2000/JNow distance in degrees
+	int *zones[INDIGOCAT_ZONE_COUNT];					///< entry indexes per zone, sorted by RA
+	int zone_size[INDIGOCAT_ZONE_COUNT];			///< number of entries per zone
+} indigocat_zone_index;
+
+/** Search index for entries within radius (degrees) around ra (hours), dec (degrees) in J2000 or JNow coordinates, not fainter than max_mag.
+ Up to max_count brightest entries are stored to result sorted by magnitude, number of stored entries is returned.
+ */
+extern int indigocat_search_zone_index(indigocat_zone_index *index, double ra, double dec, double radius, float max_mag, bool jnow, void **result, int max_count);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* indigocat_index_h */
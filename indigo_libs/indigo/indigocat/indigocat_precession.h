@@ -27,6 +27,9 @@ extern equatorial_coords_s indigocat_apply_proper_motion(const equatorial_coords
 extern void indigocat_j2k_to_jnow_pm(double *ra, double *dec, double pmra, double pmdec);
 extern void indigocat_jnow_to_j2k(double *ra, double *dec);
 
+/* Batch version of indigocat_j2k_to_jnow_pm(...), precession matrix is computed once for all coordinates, pmra and pmdec may be NULL */
+extern void indigocat_j2k_to_jnow_pm_batch(double *ra, double *dec, const float *pmra, const float *pmdec, int count);
+
 #ifdef __cplusplus
 };
 #endif
@@ -27,6 +27,8 @@
 #ifndef indigocat_ss_h
 #define indigocat_ss_h
 
+#include <stdbool.h>
+
 typedef enum {
 	MERCURY = 1,
 	VENUS,
@@ -48,7 +50,17 @@ typedef struct {
 	double ra_now, dec_now;
 } indigocat_ss_entry;
 
+/** Get J2000 position (RA in hours, Dec in degrees) of solar system body at given Julian date.
+ Position is interpolated from Chebyshev series fitted over one day window, series are cached and refitted when the date leaves the window.
+ */
+extern bool indigocat_get_ss_position(indigocat_ss_id id, double jd, double *ra, double *dec);
 
+/** Get solar system data for given Julian date.
+ */
+extern indigocat_ss_entry *indigocat_get_ss_data_jd(double jd);
+
+/** Get solar system data for current time.
+ */
 extern indigocat_ss_entry *indigocat_get_ss_data(void);
 
 #endif /* indigocat_dso_h */
@@ -27,6 +27,8 @@
 #ifndef indigocat_star_h
 #define indigocat_star_h
 
+#include <stdbool.h>
+
 typedef struct {
 	int hip;
 	double ra, dec;
@@ -37,4 +39,9 @@ typedef struct {
 
 extern indigocat_star_entry *indigocat_get_star_data(void);
 
+/** Find stars within radius (degrees) around ra (hours), dec (degrees) in J2000 or JNow coordinates, not fainter than max_mag.
+ Up to max_count brightest stars are stored to result sorted by magnitude, number of stars found is returned.
+ */
+extern int indigocat_search_stars(double ra, double dec, double radius, float max_mag, bool jnow, indigocat_star_entry **result, int max_count);
+
 #endif /* indigocat_star_h */
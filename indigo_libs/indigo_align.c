@@ -37,8 +37,12 @@ const double RAD2DEG = 180.0 / M_PI;
 
 /* Convenience wrappers for indigo_precess(...) */
 
+static double jnow_at(const time_t utc) {
+	return 2000 + ((utc / 86400.0 + 2440587.5 - 0.477677 / 86400.0) - 2451545.0) / 365.25;
+}
+
 static double jnow(void) {
-	return 2000 + ((time(NULL) / 86400.0 + 2440587.5 - 0.477677 / 86400.0) - 2451545.0) / 365.25;
+	return jnow_at(time(NULL));
 }
 
 void indigo_jnow_to_j2k(double *ra, double *dec) {
@@ -225,17 +229,7 @@ void indigo_radec_to_altaz(const double ra, const double dec, const time_t *utc,
 	*alt = h_point.d *RAD2DEG;
 }
 
-/* Precesses c0 from eq0 to eq1 */
-indigo_spherical_point_t indigo_precess(const indigo_spherical_point_t *c0, const double eq0, const double eq1) {
-	double rot[3][3];
-	indigo_spherical_point_t c1 = {0, 0, 1};
-
-	double cosd = cos(c0->d);
-
-	double x0 = cosd * cos(c0->a);
-	double y0 = cosd * sin(c0->a);
-	double z0 = sin(c0->d);
-
+static void precession_matrix(const double eq0, const double eq1, double rot[3][3]) {
 	double ST = (eq0 - 2000.0) * 0.001;
 	double T = (eq1 - eq0) * 0.001;
 
@@ -262,6 +256,20 @@ indigo_spherical_point_t indigo_precess(const indigo_spherical_point_t *c0, cons
 	rot[2][0] = cosA * sinC;
 	rot[2][1] = (-1) * sinA * sinC;
 	rot[2][2] = cosC;
+}
+
+/* Precesses c0 from eq0 to eq1 */
+indigo_spherical_point_t indigo_precess(const indigo_spherical_point_t *c0, const double eq0, const double eq1) {
+	double rot[3][3];
+	indigo_spherical_point_t c1 = {0, 0, 1};
+
+	double cosd = cos(c0->d);
+
+	double x0 = cosd * cos(c0->a);
+	double y0 = cosd * sin(c0->a);
+	double z0 = sin(c0->d);
+
+	precession_matrix(eq0, eq1, rot);
 
 	double x1 = rot[0][0] * x0 + rot[0][1] * y0 + rot[0][2] * z0;
 	double y1 = rot[1][0] * x0 + rot[1][1] * y0 + rot[1][2] * z0;
@@ -285,6 +293,52 @@ indigo_spherical_point_t indigo_precess(const indigo_spherical_point_t *c0, cons
 	return c1;
 }
 
+void indigo_init_transform_context(indigo_transform_context *context, const double eq, const time_t *utc, const double latitude, const double longitude) {
+	precession_matrix(2000.0, eq != 0 ? eq : jnow_at(utc ? *utc : time(NULL)), context->precession);
+	context->lst = indigo_lst(utc, longitude);
+	context->sin_lat = sin(latitude * DEG2RAD);
+	context->cos_lat = cos(latitude * DEG2RAD);
+}
+
+/* batch conversions use plain loops over separate arrays without calls or branches in the body, so the compiler can vectorize them */
+
+void indigo_j2k_to_eq_batch(const indigo_transform_context *context, double *ra, double *dec, int count) {
+	double r00 = context->precession[0][0], r01 = context->precession[0][1], r02 = context->precession[0][2];
+	double r10 = context->precession[1][0], r11 = context->precession[1][1], r12 = context->precession[1][2];
+	double r20 = context->precession[2][0], r21 = context->precession[2][1], r22 = context->precession[2][2];
+	for (int i = 0; i < count; i++) {
+		double a = ra[i] * 15 * DEG2RAD;
+		double d = dec[i] * DEG2RAD;
+		double cosd = cos(d);
+		double x0 = cosd * cos(a);
+		double y0 = cosd * sin(a);
+		double z0 = sin(d);
+		double x1 = r00 * x0 + r01 * y0 + r02 * z0;
+		double y1 = r10 * x0 + r11 * y0 + r12 * z0;
+		double z1 = r20 * x0 + r21 * y0 + r22 * z0;
+		a = atan2(y1, x1) * RAD2DEG / 15;
+		ra[i] = a < 0 ? a + 24 : a;
+		dec[i] = atan2(z1, sqrt(x1 * x1 + y1 * y1)) * RAD2DEG;
+	}
+}
+
+void indigo_radec_to_altaz_batch(const indigo_transform_context *context, const double *ra, const double *dec, double *alt, double *az, int count) {
+	double lst = context->lst * 15 * DEG2RAD;
+	double sin_lat = context->sin_lat;
+	double cos_lat = context->cos_lat;
+	for (int i = 0; i < count; i++) {
+		double ha = lst - ra[i] * 15 * DEG2RAD;
+		double d = dec[i] * DEG2RAD;
+		double sin_ha = sin(ha);
+		double cos_ha = cos(ha);
+		double sin_dec = sin(d);
+		double cos_dec = cos(d);
+		double a = atan2(-cos_dec * sin_ha, cos_lat * sin_dec - sin_lat * cos_dec * cos_ha) * RAD2DEG;
+		az[i] = a < 0 ? a + 360 : a;
+		alt[i] = asin(sin_dec * sin_lat + cos_dec * cos_lat * cos_ha) * RAD2DEG;
+	}
+}
+
 /* convert spherical to cartesian coordinates */
 indigo_cartesian_point_t indigo_spherical_to_cartesian(const indigo_spherical_point_t *spoint) {
 	indigo_cartesian_point_t cpoint = {0,0,0};
@@ -46,17 +46,32 @@
 #include <string.h>
 #include <stdbool.h>
 #include <fcntl.h>
+#include <errno.h>
 
 #include <indigo/indigo_bus.h>
 #include <indigo/indigo_io.h>
 #include <indigo/indigo_avi.h>
 
-static bool write_int(int handle, uint32_t n) {
-	unsigned char buffer[4];
+static void put_short(unsigned char *buffer, uint16_t n) {
+	buffer[0] = n;
+	buffer[1] = n >> 8;
+}
+
+static void put_int(unsigned char *buffer, uint32_t n) {
 	buffer[0] = n;
 	buffer[1] = n >> 8;
 	buffer[2] = n >> 16;
 	buffer[3] = n >> 24;
+}
+
+static void put_long(unsigned char *buffer, uint64_t n) {
+	put_int(buffer, (uint32_t)n);
+	put_int(buffer + 4, (uint32_t)(n >> 32));
+}
+
+static bool write_int(int handle, uint32_t n) {
+	unsigned char buffer[4];
+	put_int(buffer, n);
 	return indigo_write(handle, (const char *)buffer, 4);
 }
 
@@ -67,11 +82,6 @@ static bool write_short(int handle, uint16_t n) {
 	return indigo_write(handle, (const char *)buffer, 2);
 }
 
-static bool write_chars(int handle, const char *s) {
-	int count = (int)strlen(s);
-	return indigo_write(handle, s, count);
-}
-
 static bool write_chars_bin(int handle, const char *s, int count) {
 	return indigo_write(handle, s, count);
 }
@@ -80,8 +90,8 @@ static bool tell(int handle, long *offset) {
 	return (*offset = lseek(handle, 0, SEEK_CUR)) != -1;
 }
 
-static bool seek(int handle, long offset) {
-	return lseek(handle, offset, SEEK_SET);
+static bool seek(int handle, off_t offset) {
+	return lseek(handle, offset, SEEK_SET) != -1;
 }
 
 static bool write_avi_header(int handle, struct gwavi_header_t *avi_header) {
@@ -159,6 +169,32 @@ static bool write_stream_format(int handle, struct gwavi_stream_format_t *stream
 		seek(handle, t);
 }
 
+static bool write_super_index(int handle, struct gwavi_t *gwavi) {
+	unsigned char buffer[32 + 16 * GWAVI_SUPER_INDEX_SIZE] = { 'i', 'n', 'd', 'x' };
+	put_int(buffer + 4, sizeof(buffer) - 8);
+	put_short(buffer + 8, 4); /* wLongsPerEntry */
+	buffer[10] = 0; /* bIndexSubType */
+	buffer[11] = 0; /* bIndexType = AVI_INDEX_OF_INDEXES */
+	put_int(buffer + 12, gwavi->super_index_count);
+	memcpy(buffer + 16, "00dc", 4);
+	for (int i = 0; i < gwavi->super_index_count; i++) {
+		unsigned char *entry = buffer + 32 + 16 * i;
+		put_long(entry, gwavi->super_index[i].offset);
+		put_int(entry + 8, gwavi->super_index[i].size);
+		put_int(entry + 12, gwavi->super_index[i].duration);
+	}
+	return write_chars_bin(handle, (const char *)buffer, sizeof(buffer));
+}
+
+static bool write_odml_header(int handle, struct gwavi_t *gwavi) {
+	unsigned char buffer[12 + 8 + 248] = { 'L', 'I', 'S', 'T' };
+	put_int(buffer + 4, sizeof(buffer) - 8);
+	memcpy(buffer + 8, "odmldmlh", 8);
+	put_int(buffer + 16, 248);
+	put_int(buffer + 20, gwavi->total_frames); /* dwTotalFrames */
+	return write_chars_bin(handle, (const char *)buffer, sizeof(buffer));
+}
+
 static bool write_avi_header_chunk(struct gwavi_t *gwavi) {
 	long marker, sub_marker, t;
 	int handle = gwavi->handle;
@@ -174,41 +210,115 @@ static bool write_avi_header_chunk(struct gwavi_t *gwavi) {
 		write_chars_bin(handle, "strl", 4) &&
 		write_stream_header(handle, &gwavi->stream_header) &&
 		write_stream_format(handle, &gwavi->stream_format) &&
+		write_super_index(handle, gwavi) &&
 		tell(handle, &t) &&
 		seek(handle, sub_marker) &&
 		write_int(handle, (unsigned int)(t - sub_marker - 4)) &&
 		seek(handle, t) &&
+		write_odml_header(handle, gwavi) &&
 		tell(handle, &t) &&
 		seek(handle, marker) &&
 		write_int(handle, (unsigned int)(t - marker - 4)) &&
 		seek(handle, t);
 }
 
-static bool write_index(int handle, int count, unsigned int *offsets) {
-	long marker = 0, t;
-	unsigned int offset = 4;
-	bool result = (offsets != 0) &&
-		write_chars_bin(handle, "idx1", 4) &&
-		tell(handle, &marker) &&
-		write_int(handle, 0);
-	if (!result)
+/* chunks inside of movi LIST are queued to recorder */
+
+static bool queue_data(struct gwavi_t *gwavi, const void *data, size_t len) {
+	if (!indigo_recorder_write(gwavi->recorder, data, len))
 		return false;
-	for (t = 0; t < count; t++) {
-		if ((offsets[t] & 0x80000000) == 0) {
-			result = write_chars(handle, "00dc");
-		} else {
-			result = write_chars(handle, "01wb");
-			offsets[t] &= 0x7fffffff;
-		}
-		result = result && write_int(handle, 0x10) && write_int(handle, offset) && write_int(handle, offsets[t]);
-		if (!result)
-			return false;
-		offset = offset + offsets[t] + 8;
+	gwavi->position += len;
+	return true;
+}
+
+static bool queue_standard_index(struct gwavi_t *gwavi) {
+	if (gwavi->index_count == 0)
+		return true;
+	if (gwavi->super_index_count == GWAVI_SUPER_INDEX_SIZE) {
+		INDIGO_ERROR(indigo_error("gwavi_add_frame: super index is full"));
+		errno = EFBIG;
+		return false;
+	}
+	struct gwavi_riff_t *riff = gwavi->riffs + gwavi->riff_count - 1;
+	size_t size = 32 + 8 * (size_t)gwavi->index_count;
+	unsigned char *buffer = indigo_safe_malloc(size);
+	memcpy(buffer, "ix00", 4);
+	put_int(buffer + 4, (uint32_t)(size - 8));
+	put_short(buffer + 8, 2); /* wLongsPerEntry */
+	buffer[10] = 0; /* bIndexSubType */
+	buffer[11] = 1; /* bIndexType = AVI_INDEX_OF_CHUNKS */
+	put_int(buffer + 12, gwavi->index_count);
+	memcpy(buffer + 16, "00dc", 4);
+	put_long(buffer + 20, riff->movi); /* qwBaseOffset */
+	for (int i = 0; i < gwavi->index_count; i++) {
+		put_int(buffer + 32 + 8 * i, gwavi->index[i].offset);
+		put_int(buffer + 36 + 8 * i, gwavi->index[i].size);
+	}
+	struct gwavi_super_index_entry_t *entry = gwavi->super_index + gwavi->super_index_count;
+	entry->offset = gwavi->position;
+	entry->size = (unsigned int)size;
+	entry->duration = gwavi->index_count;
+	bool result = queue_data(gwavi, buffer, size);
+	free(buffer);
+	if (result) {
+		gwavi->super_index_count++;
+		gwavi->index_count = 0;
+	}
+	return result;
+}
+
+static bool queue_legacy_index(struct gwavi_t *gwavi) {
+	size_t size = 8 + 16 * (size_t)gwavi->offset_count;
+	unsigned char *buffer = indigo_safe_malloc(size);
+	memcpy(buffer, "idx1", 4);
+	put_int(buffer + 4, (uint32_t)(size - 8));
+	for (int i = 0; i < gwavi->offset_count; i++) {
+		unsigned char *entry = buffer + 8 + 16 * i;
+		memcpy(entry, "00dc", 4);
+		put_int(entry + 4, 0x10);
+		put_int(entry + 8, gwavi->offsets[i].offset);
+		put_int(entry + 12, gwavi->offsets[i].size);
 	}
-	result = tell(handle, &t) && seek(handle, marker) && write_int(handle, (unsigned int)(t - marker - 4)) && seek(handle, t);
+	bool result = queue_data(gwavi, buffer, size);
+	free(buffer);
+	free(gwavi->offsets);
+	gwavi->offsets = NULL;
 	return result;
 }
 
+static bool end_riff(struct gwavi_t *gwavi) {
+	struct gwavi_riff_t *riff = gwavi->riffs + gwavi->riff_count - 1;
+	if (!queue_standard_index(gwavi))
+		return false;
+	riff->movi_end = gwavi->position;
+	if (gwavi->riff_count == 1 && !queue_legacy_index(gwavi))
+		return false;
+	riff->end = gwavi->position;
+	return true;
+}
+
+static bool start_riff(struct gwavi_t *gwavi) {
+	unsigned char buffer[24] = { 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'A', 'V', 'I', 'X', 'L', 'I', 'S', 'T', 0, 0, 0, 0, 'm', 'o', 'v', 'i' };
+	gwavi->riffs = indigo_safe_realloc(gwavi->riffs, (gwavi->riff_count + 1) * sizeof(struct gwavi_riff_t));
+	struct gwavi_riff_t *riff = gwavi->riffs + gwavi->riff_count;
+	memset(riff, 0, sizeof(struct gwavi_riff_t));
+	riff->riff = gwavi->position;
+	riff->movi = gwavi->position + 12;
+	gwavi->riff_count++;
+	return queue_data(gwavi, buffer, sizeof(buffer));
+}
+
+static bool patch_riff_sizes(struct gwavi_t *gwavi) {
+	for (int i = 0; i < gwavi->riff_count; i++) {
+		struct gwavi_riff_t *riff = gwavi->riffs + i;
+		if (!seek(gwavi->handle, riff->riff + 4) || !write_int(gwavi->handle, (uint32_t)(riff->end - riff->riff - 8)))
+			return false;
+		if (!seek(gwavi->handle, riff->movi + 4) || !write_int(gwavi->handle, (uint32_t)(riff->movi_end - riff->movi - 8)))
+			return false;
+	}
+	return true;
+}
+
 /**
  * This is the first function you should call when using gwavi library.
  * It allocates memory for a gwavi_t structure and returns it and takes care of
@@ -236,7 +346,7 @@ static bool write_index(int handle, int count, unsigned int *offsets) {
 struct gwavi_t *gwavi_open(const char *filename, unsigned int width, unsigned int height, const char *fourcc, unsigned int fps) {
 	struct gwavi_t *gwavi = NULL;
 	int handle;
-	if ((handle = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1) {
+	if ((handle = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644)) == -1) {
 		INDIGO_ERROR(indigo_error("gwavi_open: failed to open file for writing"));
 		goto failure;
 	}
@@ -279,26 +389,33 @@ struct gwavi_t *gwavi_open(const char *filename, unsigned int width, unsigned in
 	gwavi->stream_format.colors_important = 0;
 	gwavi->stream_format.palette = 0;
 	gwavi->stream_format.palette_count = 0;
+	gwavi->offsets_len = 1024;
+	gwavi->offsets = indigo_safe_malloc((size_t)gwavi->offsets_len * sizeof(struct gwavi_index_entry_t));
+	gwavi->index = indigo_safe_malloc(GWAVI_STANDARD_INDEX_SIZE * sizeof(struct gwavi_index_entry_t));
+	gwavi->super_index = indigo_safe_malloc(GWAVI_SUPER_INDEX_SIZE * sizeof(struct gwavi_super_index_entry_t));
+	gwavi->riffs = indigo_safe_malloc(sizeof(struct gwavi_riff_t));
+	gwavi->riff_count = 1;
+	long marker;
 	if (!write_chars_bin(handle, "RIFF", 4) || !write_int(handle, 0))
 		goto failure;
 	if (!write_chars_bin(handle, "AVI ", 4) ||  !write_avi_header_chunk(gwavi))
 		goto failure;
-	if (!write_chars_bin(handle, "LIST", 4) || !tell(handle, &gwavi->marker) || !write_int(handle, 0) || !write_chars_bin(handle, "movi", 4))
+	if (!tell(handle, &marker) || !write_chars_bin(handle, "LIST", 4) || !write_int(handle, 0) || !write_chars_bin(handle, "movi", 4))
 		goto failure;
-	gwavi->offsets_len = 1024;
-	if ((gwavi->offsets = (unsigned int *)malloc((size_t)gwavi->offsets_len * sizeof(unsigned int))) == NULL) {
-		INDIGO_ERROR(indigo_error("gwavi_open: could not allocate memory for gwavi offsets table"));
+	gwavi->riffs[0].movi = marker;
+	gwavi->position = marker + 12;
+	if ((gwavi->recorder = indigo_recorder_open(handle, (size_t)width * height * 3)) == NULL)
 		goto failure;
-	}
-	gwavi->offsets_ptr = 0;
 	return gwavi;
 failure:
 	if (handle != -1) {
 		close(handle);
 	}
 	if (gwavi) {
-		if (gwavi->offsets)
-			free(gwavi->offsets);
+		indigo_safe_free(gwavi->offsets);
+		indigo_safe_free(gwavi->index);
+		indigo_safe_free(gwavi->super_index);
+		indigo_safe_free(gwavi->riffs);
 		free(gwavi);
 	}
 	return NULL;
@@ -314,26 +431,51 @@ failure:
  * @return true on success, false on error.
  */
 bool gwavi_add_frame(struct gwavi_t *gwavi, unsigned char *buffer, size_t len) {
+	static unsigned char zero[4] = { 0 };
 	size_t maxi_pad;  /* if your frame is raggin, give it some paddin' */
-	size_t t;
-	char zero = 0;
+	unsigned char chunk_header[8] = { '0', '0', 'd', 'c' };
 	if (!gwavi || !buffer || len < 256)
 		return false;
-	gwavi->offset_count++;
-	gwavi->stream_header.data_length++;
 	maxi_pad = len % 4;
 	if (maxi_pad > 0)
 		maxi_pad = 4 - maxi_pad;
-	if (gwavi->offset_count >= gwavi->offsets_len) {
-		gwavi->offsets_len += 1024;
-		gwavi->offsets = (unsigned int *)realloc(gwavi->offsets, (size_t)gwavi->offsets_len * sizeof(unsigned int));
+	unsigned int size = (unsigned int)(len + maxi_pad);
+	struct gwavi_riff_t *riff = gwavi->riffs + gwavi->riff_count - 1;
+	/* space for frame, its standard index entry and legacy index entry in the first RIFF */
+	uint64_t end = gwavi->position + 8 + size + 32 + 8 * (gwavi->index_count + 1);
+	if (gwavi->riff_count == 1)
+		end += 8 + 16 * (gwavi->offset_count + 1);
+	if (end - riff->riff > GWAVI_RIFF_SIZE && riff->frames > 0) {
+		if (!end_riff(gwavi) || !start_riff(gwavi))
+			return false;
+		riff = gwavi->riffs + gwavi->riff_count - 1;
 	}
-	gwavi->offsets[gwavi->offsets_ptr++] = (unsigned int)(len + maxi_pad);
-	if (!write_chars_bin(gwavi->handle, "00dc", 4) || !write_int(gwavi->handle, (unsigned int)(len + maxi_pad)) || !indigo_write(gwavi->handle, (const char *)buffer, len))
+	if (gwavi->index_count == GWAVI_STANDARD_INDEX_SIZE && !queue_standard_index(gwavi))
 		return false;
-	for (t = 0; t < maxi_pad; t++) {
-		if (!indigo_write(gwavi->handle, &zero, 1))
-			return false;
+	put_int(chunk_header + 4, size);
+	const void *parts[] = { chunk_header, buffer, zero };
+	size_t lengths[] = { 8, len, maxi_pad };
+	if (!indigo_recorder_append(gwavi->recorder, 3, parts, lengths)) {
+		/* dropped frame is not an error, it is reported in recorder statistics */
+		return errno == 0;
+	}
+	uint64_t chunk = gwavi->position;
+	gwavi->index[gwavi->index_count].offset = (unsigned int)(chunk + 8 - riff->movi);
+	gwavi->index[gwavi->index_count].size = size;
+	gwavi->index_count++;
+	gwavi->position += 8 + size;
+	riff->frames++;
+	gwavi->total_frames++;
+	gwavi->stream_header.data_length++;
+	if (gwavi->riff_count == 1) {
+		if (gwavi->offset_count >= gwavi->offsets_len) {
+			gwavi->offsets_len += 1024;
+			gwavi->offsets = indigo_safe_realloc(gwavi->offsets, (size_t)gwavi->offsets_len * sizeof(struct gwavi_index_entry_t));
+		}
+		/* real chunk offset, ix00 chunks may be interleaved with frames */
+		gwavi->offsets[gwavi->offset_count].offset = (unsigned int)(chunk - riff->movi - 8);
+		gwavi->offsets[gwavi->offset_count++].size = size;
+		gwavi->avi_header.number_of_frames++;
 	}
 	return true;
 }
@@ -345,31 +487,21 @@ bool gwavi_add_frame(struct gwavi_t *gwavi, unsigned char *buffer, size_t len) {
  *
  * @param gwavi Main gwavi structure initialized with gwavi_open()-
  *
- * @return 0 on success, -1 on error.
+ * @return true on success, false on error.
  */
 bool gwavi_close(struct gwavi_t *gwavi) {
-	long t;
 	if (!gwavi)
 		return false;
 	int handle = gwavi->handle;
-	if (!tell(handle, &t) || !seek(handle, gwavi->marker) || !write_int(handle, (unsigned int)(t - gwavi->marker - 4)))
-		goto failure;
-	if (!seek(handle, t) || !write_index(handle, gwavi->offset_count, gwavi->offsets))
-		goto failure;
-	free(gwavi->offsets);
-	gwavi->offsets = NULL;
-	gwavi->avi_header.number_of_frames = gwavi->stream_header.data_length;
-	if (!tell(handle, &t) || !seek(handle, 12) || !write_avi_header_chunk(gwavi) || !seek(handle, t))
-		goto failure;
-	if (!seek(handle, 4) || !write_int(handle, (unsigned int)(t - 8)))
-		goto failure;
-	close(handle);
-	free(gwavi);
-	return true;
-failure:
-	if (gwavi->offsets)
-		free(gwavi->offsets);
+	bool result = end_riff(gwavi);
+	result = indigo_recorder_close(gwavi->recorder) && result;
+	result = result && patch_riff_sizes(gwavi);
+	result = result && seek(handle, 12) && write_avi_header_chunk(gwavi);
 	close(handle);
+	indigo_safe_free(gwavi->offsets);
+	free(gwavi->index);
+	free(gwavi->super_index);
+	free(gwavi->riffs);
 	free(gwavi);
-	return false;
+	return result;
 }
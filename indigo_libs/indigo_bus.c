@@ -35,6 +35,8 @@
 #include <math.h>
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <pthread.h>
 #if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
 #include <sys/time.h>
@@ -53,6 +55,7 @@
 #include <indigo/indigo_names.h>
 #include <indigo/indigo_io.h>
 #include <indigo/indigo_token.h>
+#include <indigo/indigo_bus_trace.h>
 
 #define MAX_DEVICES 256
 #define MAX_CLIENTS 256
@@ -63,11 +66,17 @@
 static indigo_device *devices[MAX_DEVICES];
 static indigo_client *clients[MAX_CLIENTS];
 static indigo_blob_entry *blobs[MAX_BLOBS];
+static unsigned long blob_version = 0;
 
 static pthread_mutex_t bus_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
 #define client_mutex bus_mutex
 #define device_mutex bus_mutex
 
+static pthread_mutex_t bus_event_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t bus_event_cond;
+static pthread_once_t bus_event_once = PTHREAD_ONCE_INIT;
+static unsigned long bus_event_count = 0;
+
 bool indigo_use_strict_locking = true;
 
 static pthread_mutex_t blob_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -169,16 +178,62 @@ int clock_gettime(clockid_t clk_id, struct timespec *ts) {
 }
 #endif
 
-void indigo_log_base(indigo_log_levels level, const char *format, va_list args) {
+static void log_init_name() {
+	if (indigo_log_name[0] == '\0') {
+		if (indigo_main_argc == 0) {
+			strncpy(indigo_log_name, "Application", sizeof(indigo_log_name));
+		} else {
+#if defined(INDIGO_WINDOWS)
+			char *name = strrchr(indigo_main_argv[0], '\\');
+#else
+			char *name = strrchr(indigo_main_argv[0], '/');
+#endif
+			if (name != NULL) {
+				name++;
+			} else {
+				name = (char *)indigo_main_argv[0];
+			}
+			strncpy(indigo_log_name, name, sizeof(indigo_log_name));
+		}
+	}
+}
 
-	static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
-	pthread_mutex_lock(&log_mutex);
-	if (indigo_last_message == NULL) {
-		indigo_last_message = indigo_safe_malloc(LOG_MESSAGE_SIZE);
-		atexit(free_log_buffers);
+static void log_format_timestamp(struct timeval *tmnow, char *timestamp, bool batch) {
+	/* asynchronous log flusher is the only user of cached value */
+	static time_t cached_sec = 0;
+	static char cached_time[9];
+	if (batch && tmnow->tv_sec == cached_sec) {
+		memcpy(timestamp, cached_time, 8);
+	} else {
+#if defined(INDIGO_WINDOWS)
+		struct tm *lt;
+		time_t rawtime;
+		lt = localtime((const time_t *) &(tmnow->tv_sec));
+		if (lt == NULL) {
+			time(&rawtime);
+			lt = localtime(&rawtime);
+		}
+		strftime (timestamp, 9, "%H:%M:%S", lt);
+#else
+		struct tm lt;
+		strftime (timestamp, 9, "%H:%M:%S", localtime_r((const time_t *) &tmnow->tv_sec, &lt));
+#endif
+		if (batch) {
+			cached_sec = tmnow->tv_sec;
+			memcpy(cached_time, timestamp, 8);
+		}
 	}
-	vsnprintf(indigo_last_message, LOG_MESSAGE_SIZE, format, args);
-	char *line = indigo_last_message;
+
+#ifdef INDIGO_MACOS
+	snprintf(timestamp + 8, 16 - 8, ".%06d", tmnow->tv_usec);
+#else
+	snprintf(timestamp + 8, 16 - 8, ".%06ld", tmnow->tv_usec);
+#endif
+}
+
+static void log_write_line(indigo_log_levels level, const char *timestamp, const char *prefix, const char *line, bool batch);
+
+static void log_output(indigo_log_levels level, struct timeval *tmnow, char *line, bool batch) {
 	char prefix[16] = { 0 };
 	char *arrow = strstr(line, " -> ");
 	if (arrow && arrow - line < 16) {
@@ -199,80 +254,407 @@ void indigo_log_base(indigo_log_levels level, const char *format, va_list args)
 	}
 #endif
 	char timestamp[16];
-	struct timeval tmnow;
-	gettimeofday(&tmnow, NULL);
-#if defined(INDIGO_WINDOWS)
-	struct tm *lt;
-	time_t rawtime;
-	lt = localtime((const time_t *) &(tmnow.tv_sec));
-	if (lt == NULL) {
-		time(&rawtime);
-		lt = localtime(&rawtime);
-	}
-	strftime (timestamp, 9, "%H:%M:%S", lt);
-#else
-	strftime (timestamp, 9, "%H:%M:%S", localtime((const time_t *) &tmnow.tv_sec));
-#endif
-
-#ifdef INDIGO_MACOS
-	snprintf(timestamp + 8, sizeof(timestamp) - 8, ".%06d", tmnow.tv_usec);
-#else
-	snprintf(timestamp + 8, sizeof(timestamp) - 8, ".%06ld", tmnow.tv_usec);
-#endif
-	if (indigo_log_name[0] == '\0') {
-		if (indigo_main_argc == 0) {
-			strncpy(indigo_log_name, "Application", sizeof(indigo_log_name));
-		} else {
-#if defined(INDIGO_WINDOWS)
-			char *name = strrchr(indigo_main_argv[0], '\\');
-#else
-			char *name = strrchr(indigo_main_argv[0], '/');
-#endif
-			if (name != NULL) {
-				name++;
-			} else {
-				name = (char *)indigo_main_argv[0];
-			}
-			strncpy(indigo_log_name, name, sizeof(indigo_log_name));
-		}
-	}
+	log_format_timestamp(tmnow, timestamp, batch);
+	log_init_name();
 	bool first_line = true;
-	static char tmp[128];
 	while (line) {
 		char *eol = strchr(line, '\n');
 		if (eol)
 			*eol = 0;
 		if (*line) {
-			if (first_line || *prefix == 0) {
-				if (indigo_log_message_handler != NULL) {
-					indigo_log_message_handler(level, line);
-#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
-				} else if (indigo_use_syslog) {
-					syslog(LOG_NOTICE, "%s", line);
-#endif
-				} else {
-					fprintf(stderr, "%s %s: %s\n", timestamp, indigo_log_name, line);
-				}
-				first_line = false;
-			} else {
-				if (indigo_log_message_handler != NULL) {
-					snprintf(tmp, sizeof(tmp), "%s%s", prefix, line);
-					indigo_log_message_handler(level, tmp);
-#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
-				} else if (indigo_use_syslog) {
-					snprintf(tmp, sizeof(tmp), "%s%s", prefix, line);
-					syslog(LOG_NOTICE, "%s", line);
-#endif
-				} else {
-					fprintf(stderr, "%s %s: %s%s\n", timestamp, indigo_log_name, prefix, line);
-				}
-			}
+			log_write_line(level, timestamp, first_line ? "" : prefix, line, batch);
+			first_line = false;
 		}
 		if (eol)
 			line = eol + 1;
 		else
 			line = NULL;
 	}
+}
+
+// -------------------------------------------------------------------------------- Asynchronous log
+
+/* Each logging thread owns a ring buffer with formatted messages, the only shared state between the producer and
+ the flusher thread are head and tail counters, so logging thread never waits for a lock or output. Timestamp formatting,
+ line splitting and output is done on the flusher thread. */
+
+typedef struct log_ring {
+	struct log_ring *next;
+	char *buffer;
+	uint64_t head;
+	uint64_t tail;
+	bool abandoned;
+} log_ring;
+
+typedef struct {
+	uint32_t size;
+	int32_t level;
+	int64_t sec;
+	int64_t usec;
+} log_record;
+
+#define LOG_RECORD_SKIP		-1
+#define LOG_RECORD_ALIGN(size)	(((size) + 7) & ~7)
+#define LOG_RECORD_MAX_SIZE	(INDIGO_LOG_RING_SIZE / 4)
+#define LOG_BATCH_SIZE	(64 * 1024)
+#define LOG_FREE_RING_COUNT	16
+
+static bool async_log = false;
+static bool async_log_stop = false;
+static pthread_t async_log_thread;
+static pthread_key_t log_ring_key;
+static pthread_once_t log_ring_key_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t log_rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t log_rings_cond = PTHREAD_COND_INITIALIZER;
+static log_ring *log_rings = NULL;
+static log_ring *log_free_rings = NULL;
+static int log_free_ring_count = 0;
+static unsigned long log_dropped = 0;
+static bool log_flush_requested = false;
+static unsigned long log_reported_dropped = 0;
+static char log_file_name[PATH_MAX] = { 0 };
+static int log_handle = -1;
+static long log_file_size = 0;
+static char log_batch[LOG_BATCH_SIZE];
+static int log_batch_size = 0;
+static bool log_flusher_logging = false;
+static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void log_last_message_alloc() {
+	if (indigo_last_message == NULL) {
+		indigo_last_message = indigo_safe_malloc(LOG_MESSAGE_SIZE);
+		atexit(free_log_buffers);
+	}
+}
+
+static void log_ring_release(void *data) {
+	__atomic_store_n(&((log_ring *)data)->abandoned, true, __ATOMIC_RELEASE);
+}
+
+static void log_ring_key_create() {
+	pthread_key_create(&log_ring_key, log_ring_release);
+}
+
+static log_ring *log_thread_ring() {
+	log_ring *ring = pthread_getspecific(log_ring_key);
+	if (ring == NULL) {
+		/* rings of exited threads are reused, short living threads don't allocate a new buffer each time */
+		pthread_mutex_lock(&log_rings_mutex);
+		ring = log_free_rings;
+		if (ring) {
+			log_free_rings = ring->next;
+			log_free_ring_count--;
+		}
+		pthread_mutex_unlock(&log_rings_mutex);
+		if (ring) {
+			ring->head = ring->tail = 0;
+			ring->abandoned = false;
+		} else {
+			ring = indigo_safe_malloc(sizeof(log_ring));
+			ring->buffer = indigo_safe_malloc(INDIGO_LOG_RING_SIZE);
+		}
+		pthread_mutex_lock(&log_rings_mutex);
+		ring->next = log_rings;
+		log_rings = ring;
+		pthread_mutex_unlock(&log_rings_mutex);
+		pthread_setspecific(log_ring_key, ring);
+	}
+	return ring;
+}
+
+static bool log_ring_put(indigo_log_levels level, const char *format, va_list args) {
+	log_ring *ring = log_thread_ring();
+	uint64_t head = ring->head;
+	uint64_t free = INDIGO_LOG_RING_SIZE - (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE));
+	size_t offset = head % INDIGO_LOG_RING_SIZE;
+	size_t contiguous = INDIGO_LOG_RING_SIZE - offset;
+	size_t available = contiguous < free ? contiguous : free;
+	if (available > LOG_RECORD_MAX_SIZE)
+		available = LOG_RECORD_MAX_SIZE;
+	int length = -1;
+	if (available > sizeof(log_record)) {
+		va_list copy;
+		va_copy(copy, args);
+		length = vsnprintf(ring->buffer + offset + sizeof(log_record), available - sizeof(log_record), format, copy);
+		va_end(copy);
+		if (length < 0)
+			return false;
+	}
+	if (length < 0 || sizeof(log_record) + length + 1 > available) {
+		size_t wrapped = free > contiguous ? free - contiguous : 0;
+		if (wrapped > LOG_RECORD_MAX_SIZE)
+			wrapped = LOG_RECORD_MAX_SIZE;
+		if (wrapped > available && contiguous < free) {
+			/* skip the rest of the buffer and format message from its beginning */
+			log_record *skip = (log_record *)(ring->buffer + offset);
+			skip->size = (uint32_t)contiguous;
+			skip->level = LOG_RECORD_SKIP;
+			head += contiguous;
+			offset = 0;
+			available = wrapped;
+			length = vsnprintf(ring->buffer + sizeof(log_record), available - sizeof(log_record), format, args);
+			if (length < 0)
+				return false;
+		}
+		if (available <= sizeof(log_record) + 64) {
+			__atomic_add_fetch(&log_dropped, 1, __ATOMIC_RELAXED);
+			return true;
+		}
+		/* message is truncated */
+		if (sizeof(log_record) + length + 1 > available)
+			length = (int)(available - sizeof(log_record) - 1);
+	}
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	log_record *record = (log_record *)(ring->buffer + offset);
+	record->size = (uint32_t)LOG_RECORD_ALIGN(sizeof(log_record) + length + 1);
+	record->level = level;
+	record->sec = now.tv_sec;
+	record->usec = now.tv_usec;
+	/* indigo_last_message is updated here, the message itself is written later by the flusher */
+	pthread_mutex_lock(&log_mutex);
+	log_last_message_alloc();
+	memcpy(indigo_last_message, ring->buffer + offset + sizeof(log_record), length);
+	indigo_last_message[length] = 0;
+	pthread_mutex_unlock(&log_mutex);
+	__atomic_store_n(&ring->head, head + record->size, __ATOMIC_RELEASE);
+	if (free - record->size < INDIGO_LOG_RING_SIZE / 2 && !__atomic_exchange_n(&log_flush_requested, true, __ATOMIC_ACQ_REL)) {
+		/* wake up flusher before the next interval, missed wakeup is not a problem */
+		pthread_cond_signal(&log_rings_cond);
+	}
+	return true;
+}
+
+static void log_flush_batch() {
+	if (log_batch_size > 0) {
+		/* write error is logged to the batch again, so it is emptied first */
+		int handle = log_handle == -1 ? 2 : log_handle;
+		int size = log_batch_size;
+		log_batch_size = 0;
+		log_file_size += size;
+		indigo_write(handle, log_batch, size);
+	}
+	if (log_handle != -1 && log_file_size >= INDIGO_LOG_FILE_SIZE) {
+		char old_name[PATH_MAX + 8], new_name[PATH_MAX + 8];
+		close(log_handle);
+		for (int i = INDIGO_LOG_FILE_COUNT - 1; i > 0; i--) {
+			if (i == 1)
+				snprintf(old_name, sizeof(old_name), "%s", log_file_name);
+			else
+				snprintf(old_name, sizeof(old_name), "%s.%d", log_file_name, i - 1);
+			snprintf(new_name, sizeof(new_name), "%s.%d", log_file_name, i);
+			rename(old_name, new_name);
+		}
+		log_handle = open(log_file_name, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+		log_file_size = 0;
+	}
+}
+
+static void log_write_line(indigo_log_levels level, const char *timestamp, const char *prefix, const char *line, bool batch) {
+	if (indigo_log_message_handler != NULL) {
+		if (*prefix) {
+			char tmp[128];
+			snprintf(tmp, sizeof(tmp), "%s%s", prefix, line);
+			indigo_log_message_handler(level, tmp);
+		} else {
+			indigo_log_message_handler(level, line);
+		}
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+	} else if (indigo_use_syslog) {
+		syslog(LOG_NOTICE, "%s", line);
+#endif
+	} else if (batch) {
+		int length = snprintf(log_batch + log_batch_size, LOG_BATCH_SIZE - log_batch_size, "%s %s: %s%s\n", timestamp, indigo_log_name, prefix, line);
+		if (log_batch_size + length >= LOG_BATCH_SIZE && log_batch_size > 0) {
+			log_flush_batch();
+			length = snprintf(log_batch, LOG_BATCH_SIZE, "%s %s: %s%s\n", timestamp, indigo_log_name, prefix, line);
+		}
+		if (length < LOG_BATCH_SIZE) {
+			log_batch_size += length;
+		} else {
+			int handle = log_handle == -1 ? 2 : log_handle;
+			log_batch_size = snprintf(log_batch, LOG_BATCH_SIZE, "%s %s: %s", timestamp, indigo_log_name, prefix);
+			indigo_write(handle, log_batch, log_batch_size);
+			indigo_write(handle, line, strlen(line));
+			indigo_write(handle, "\n", 1);
+			log_file_size += length;
+			log_batch_size = 0;
+		}
+	} else {
+		fprintf(stderr, "%s %s: %s%s\n", timestamp, indigo_log_name, prefix, line);
+	}
+}
+
+static bool log_flush_rings() {
+	bool flushed = false;
+	/* rings of exited threads are recycled under the lock, the output itself is done without it, so threads logging
+	   for the first time are not blocked by file writes or rotation; new rings are added to the list head and only
+	   this thread unlinks them, so the list captured here can be walked unlocked */
+	pthread_mutex_lock(&log_rings_mutex);
+	log_ring **link = &log_rings;
+	while (*link) {
+		log_ring *ring = *link;
+		if (__atomic_load_n(&ring->abandoned, __ATOMIC_ACQUIRE) && ring->tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+			*link = ring->next;
+			if (log_free_ring_count < LOG_FREE_RING_COUNT) {
+				ring->next = log_free_rings;
+				log_free_rings = ring;
+				log_free_ring_count++;
+			} else {
+				free(ring->buffer);
+				free(ring);
+			}
+			continue;
+		}
+		link = &ring->next;
+	}
+	log_ring *rings = log_rings;
+	pthread_mutex_unlock(&log_rings_mutex);
+	while (true) {
+		/* merge messages from all threads in time order */
+		log_ring *oldest = NULL;
+		log_record *oldest_record = NULL;
+		for (log_ring *ring = rings; ring; ring = ring->next) {
+			uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+			log_record *record = NULL;
+			while (ring->tail < head) {
+				record = (log_record *)(ring->buffer + ring->tail % INDIGO_LOG_RING_SIZE);
+				if (record->level != LOG_RECORD_SKIP)
+					break;
+				__atomic_store_n(&ring->tail, ring->tail + record->size, __ATOMIC_RELEASE);
+				record = NULL;
+			}
+			if (record && (oldest_record == NULL || record->sec < oldest_record->sec || (record->sec == oldest_record->sec && record->usec < oldest_record->usec))) {
+				oldest = ring;
+				oldest_record = record;
+			}
+		}
+		if (oldest == NULL)
+			break;
+		struct timeval time;
+		time.tv_sec = (time_t)oldest_record->sec;
+		time.tv_usec = (long)oldest_record->usec;
+		log_output(oldest_record->level, &time, (char *)(oldest_record + 1), true);
+		__atomic_store_n(&oldest->tail, oldest->tail + oldest_record->size, __ATOMIC_RELEASE);
+		flushed = true;
+	}
+	unsigned long dropped = __atomic_load_n(&log_dropped, __ATOMIC_RELAXED);
+	if (dropped != log_reported_dropped) {
+		char message[64];
+		struct timeval now;
+		gettimeofday(&now, NULL);
+		snprintf(message, sizeof(message), "%lu log messages dropped", dropped - log_reported_dropped);
+		log_output(INDIGO_LOG_ERROR, &now, message, true);
+		log_reported_dropped = dropped;
+	}
+	log_flush_batch();
+	return flushed;
+}
+
+static void *async_log_flusher(void *data) {
+	pthread_mutex_lock(&log_rings_mutex);
+	while (!async_log_stop) {
+		struct timespec timeout;
+		struct timeval now;
+		gettimeofday(&now, NULL);
+		timeout.tv_sec = now.tv_sec;
+		timeout.tv_nsec = now.tv_usec * 1000 + INDIGO_LOG_FLUSH_INTERVAL * 1000000L;
+		if (timeout.tv_nsec >= 1000000000L) {
+			timeout.tv_sec++;
+			timeout.tv_nsec -= 1000000000L;
+		}
+		if (!__atomic_load_n(&log_flush_requested, __ATOMIC_ACQUIRE))
+			pthread_cond_timedwait(&log_rings_cond, &log_rings_mutex, &timeout);
+		__atomic_store_n(&log_flush_requested, false, __ATOMIC_RELEASE);
+		pthread_mutex_unlock(&log_rings_mutex);
+		log_flush_rings();
+		pthread_mutex_lock(&log_rings_mutex);
+	}
+	pthread_mutex_unlock(&log_rings_mutex);
+	/* the final flush is done here, so its own messages still go to the log file */
+	log_flush_rings();
+	return NULL;
+}
+
+bool indigo_start_async_log(const char *file_name) {
+	static bool registered = false;
+	if (async_log) {
+		/* log file requested later (e.g. -A followed by -L) replaces stderr or the previous file */
+		if (file_name == NULL || *file_name == 0 || !strcmp(file_name, log_file_name))
+			return true;
+		indigo_stop_async_log();
+	}
+	pthread_once(&log_ring_key_once, log_ring_key_create);
+	if (file_name && *file_name) {
+		strncpy(log_file_name, file_name, sizeof(log_file_name) - 1);
+		log_handle = open(log_file_name, O_WRONLY | O_CREAT | O_APPEND, 0644);
+		if (log_handle == -1) {
+			indigo_error("Can't open log file %s (%s)", log_file_name, strerror(errno));
+			return false;
+		}
+		log_file_size = lseek(log_handle, 0, SEEK_END);
+	}
+	async_log_stop = false;
+	if (pthread_create(&async_log_thread, NULL, async_log_flusher, NULL)) {
+		if (log_handle != -1) {
+			close(log_handle);
+			log_handle = -1;
+		}
+		return false;
+	}
+	async_log = true;
+	if (!registered) {
+		atexit(indigo_stop_async_log);
+		registered = true;
+	}
+	return true;
+}
+
+void indigo_stop_async_log() {
+	if (!async_log)
+		return;
+	pthread_mutex_lock(&log_rings_mutex);
+	async_log_stop = true;
+	pthread_cond_signal(&log_rings_cond);
+	pthread_mutex_unlock(&log_rings_mutex);
+	pthread_join(async_log_thread, NULL);
+	async_log = false;
+	if (log_handle != -1) {
+		close(log_handle);
+		log_handle = -1;
+	}
+	log_file_name[0] = 0;
+	log_file_size = 0;
+}
+
+unsigned long indigo_get_log_dropped() {
+	return __atomic_load_n(&log_dropped, __ATOMIC_RELAXED);
+}
+
+// -------------------------------------------------------------------------------- Log
+
+void indigo_log_base(indigo_log_levels level, const char *format, va_list args) {
+	if (async_log && pthread_equal(pthread_self(), async_log_thread)) {
+		if (log_handle != -1 && !log_flusher_logging) {
+			/* flusher's own messages (e.g. write errors) go to the log file batch, not to stderr */
+			static char message[LOG_MESSAGE_SIZE];
+			struct timeval tmnow;
+			log_flusher_logging = true;
+			vsnprintf(message, sizeof(message), format, args);
+			gettimeofday(&tmnow, NULL);
+			log_output(level, &tmnow, message, true);
+			log_flusher_logging = false;
+			return;
+		}
+	} else if (async_log && !async_log_stop && log_ring_put(level, format, args)) {
+		return;
+	}
+	pthread_mutex_lock(&log_mutex);
+	log_last_message_alloc();
+	vsnprintf(indigo_last_message, LOG_MESSAGE_SIZE, format, args);
+	struct timeval tmnow;
+	gettimeofday(&tmnow, NULL);
+	log_output(level, &tmnow, indigo_last_message, false);
 	pthread_mutex_unlock(&log_mutex);
 }
 
@@ -528,6 +910,8 @@ indigo_result indigo_enumerate_properties(indigo_client *client, indigo_property
 	if (indigo_use_strict_locking)
 		pthread_mutex_lock(&device_mutex);
 	INDIGO_TRACE(indigo_trace_property("Enumerate", client, property, false, false));
+	if (indigo_bus_trace_enabled)
+		indigo_bus_trace_property(INDIGO_BUS_TRACE_ENUMERATE, client, property);
 	for (int i = 0; i < MAX_DEVICES; i++) {
 		indigo_device *device = devices[i];
 		if (device != NULL && device->enumerate_properties != NULL) {
@@ -550,6 +934,8 @@ indigo_result indigo_change_property(indigo_client *client, indigo_property *pro
 	if (indigo_use_strict_locking)
 		pthread_mutex_lock(&device_mutex);
 	INDIGO_TRACE(indigo_trace_property("Change", client, property, false, true));
+	if (indigo_bus_trace_enabled)
+		indigo_bus_trace_property(INDIGO_BUS_TRACE_CHANGE, client, property);
 	for (int i = 0; i < MAX_DEVICES; i++) {
 		indigo_device *device = devices[i];
 		if (device != NULL && device->change_property != NULL) {
@@ -593,6 +979,95 @@ indigo_result indigo_enable_blob(indigo_client *client, indigo_property *propert
 	return INDIGO_OK;
 }
 
+// Timed waits must not be affected by wall clock changes (NTP, GPS time sync), so the condition uses CLOCK_MONOTONIC
+// where pthread_condattr_setclock() is available and a relative wait on macOS.
+
+static void bus_event_init() {
+#if defined(INDIGO_LINUX)
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&bus_event_cond, &attr);
+	pthread_condattr_destroy(&attr);
+#else
+	pthread_cond_init(&bus_event_cond, NULL);
+#endif
+}
+
+static void notify_bus_event() {
+	pthread_once(&bus_event_once, bus_event_init);
+	pthread_mutex_lock(&bus_event_mutex);
+	bus_event_count++;
+	pthread_cond_broadcast(&bus_event_cond);
+	pthread_mutex_unlock(&bus_event_mutex);
+}
+
+unsigned long indigo_bus_event_count() {
+	pthread_mutex_lock(&bus_event_mutex);
+	unsigned long count = bus_event_count;
+	pthread_mutex_unlock(&bus_event_mutex);
+	return count;
+}
+
+static int bus_event_timedwait(struct timespec *start, double timeout) {
+#if defined(INDIGO_MACOS)
+	struct timespec now, delay;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	double remaining = timeout - ((now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1000000000.0);
+	if (remaining <= 0)
+		return ETIMEDOUT;
+	delay.tv_sec = (time_t)remaining;
+	delay.tv_nsec = (long)(1000000000 * (remaining - (time_t)remaining));
+	return pthread_cond_timedwait_relative_np(&bus_event_cond, &bus_event_mutex, &delay);
+#else
+	struct timespec end;
+#if defined(INDIGO_LINUX)
+	end = *start;
+#else
+	clock_gettime(CLOCK_REALTIME, &end);
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	timeout -= (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1000000000.0;
+	if (timeout <= 0)
+		return ETIMEDOUT;
+#endif
+	end.tv_sec += (time_t)timeout;
+	end.tv_nsec += (long)(1000000000 * (timeout - (time_t)timeout));
+	if (end.tv_nsec >= 1000000000) {
+		end.tv_nsec -= 1000000000;
+		end.tv_sec++;
+	}
+	return pthread_cond_timedwait(&bus_event_cond, &bus_event_mutex, &end);
+#endif
+}
+
+bool indigo_wait_for_bus_event(unsigned long *event, double *timeout) {
+	bool result = true;
+	struct timespec start;
+	pthread_once(&bus_event_once, bus_event_init);
+	if (timeout != NULL)
+		clock_gettime(CLOCK_MONOTONIC, &start);
+	pthread_mutex_lock(&bus_event_mutex);
+	while (bus_event_count == *event) {
+		if (timeout == NULL) {
+			pthread_cond_wait(&bus_event_cond, &bus_event_mutex);
+		} else if (*timeout <= 0 || bus_event_timedwait(&start, *timeout) == ETIMEDOUT) {
+			result = bus_event_count != *event;
+			break;
+		}
+	}
+	*event = bus_event_count;
+	pthread_mutex_unlock(&bus_event_mutex);
+	if (timeout != NULL && *timeout > 0) {
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		*timeout -= (now.tv_sec - start.tv_sec) + (now.tv_nsec - start.tv_nsec) / 1000000000.0;
+		if (*timeout < 0)
+			*timeout = 0;
+	}
+	return result;
+}
+
 indigo_result indigo_define_property(indigo_device *device, indigo_property *property, const char *format, ...) {
 	if ((!is_started) || (property == NULL))
 		return INDIGO_FAILED;
@@ -600,6 +1075,8 @@ indigo_result indigo_define_property(indigo_device *device, indigo_property *pro
 		pthread_mutex_lock(&client_mutex);
 	if (!property->hidden) {
 		INDIGO_TRACE(indigo_trace_property("Define", NULL, property, true, true));
+		if (indigo_bus_trace_enabled)
+			indigo_bus_trace_property(INDIGO_BUS_TRACE_DEFINE, NULL, property);
 		property->defined = true;
 		char message[INDIGO_VALUE_SIZE];
 		if (format != NULL) {
@@ -649,6 +1126,7 @@ indigo_result indigo_define_property(indigo_device *device, indigo_property *pro
 	}
 	if (indigo_use_strict_locking)
 		pthread_mutex_unlock(&client_mutex);
+	notify_bus_event();
 	return INDIGO_OK;
 }
 
@@ -663,6 +1141,8 @@ indigo_result indigo_update_property(indigo_device *device, indigo_property *pro
 		if (property->perm == INDIGO_WO_PERM)
 			property->count = 0;
 		INDIGO_TRACE(indigo_trace_property("Update", NULL, property, false, true));
+		if (indigo_bus_trace_enabled)
+			indigo_bus_trace_property(INDIGO_BUS_TRACE_UPDATE, NULL, property);
 		if (format != NULL) {
 			va_list args;
 			va_start(args, format);
@@ -694,6 +1174,9 @@ indigo_result indigo_update_property(indigo_device *device, indigo_property *pro
 				}
 				if (entry) {
 					pthread_mutex_lock(&entry->mutext);
+					if (blob_version == 0)
+						blob_version = (unsigned long)time(NULL) << 16;
+					entry->version = ++blob_version;
 					if (item->blob.size) {
 						entry->content = indigo_safe_realloc(entry->content, entry->size = item->blob.size);
 						memcpy(entry->content, item->blob.value, entry->size);
@@ -723,6 +1206,7 @@ indigo_result indigo_update_property(indigo_device *device, indigo_property *pro
 	}
 	if (indigo_use_strict_locking)
 		pthread_mutex_unlock(&client_mutex);
+	notify_bus_event();
 	return INDIGO_OK;
 }
 
@@ -733,6 +1217,8 @@ indigo_result indigo_delete_property(indigo_device *device, indigo_property *pro
 		pthread_mutex_lock(&client_mutex);
 	if (!property->hidden) {
 		INDIGO_TRACE(indigo_trace_property("Remove", NULL, property, false, false));
+		if (indigo_bus_trace_enabled)
+			indigo_bus_trace_property(INDIGO_BUS_TRACE_DELETE, NULL, property);
 		property->defined = false;
 		char message[INDIGO_VALUE_SIZE];
 		if (format != NULL) {
@@ -749,6 +1235,7 @@ indigo_result indigo_delete_property(indigo_device *device, indigo_property *pro
 	}
 	if (indigo_use_strict_locking)
 		pthread_mutex_unlock(&client_mutex);
+	notify_bus_event();
 	return INDIGO_OK;
 }
 
@@ -1101,131 +1588,394 @@ void *indigo_alloc_blob_buffer(long size) {
 	return indigo_safe_malloc(size);
 }
 
-bool indigo_populate_http_blob_item(indigo_item *blob_item) {
-	char *host = indigo_safe_malloc(BUFFER_SIZE);
-	int port = 80;
-	char *file = indigo_safe_malloc(BUFFER_SIZE);
-	char *request = indigo_safe_malloc(BUFFER_SIZE);
-	char *http_line = indigo_safe_malloc(BUFFER_SIZE);
-	char *http_response = indigo_safe_malloc(BUFFER_SIZE);
-	long content_len = 0;
-	long uncompressed_content_len = 0;
-	int http_result = 0;
-	char *image_type;
-	int socket = -1;
-	int res = false;
+#define HTTP_CONNECTION_POOL_SIZE	8
+#define HTTP_PREFETCH_SLOTS				8
+#define HTTP_RANGE_CHUNK_SIZE			(4 * 1024 * 1024)
+#define HTTP_RANGE_CHUNKS					4
+#define HTTP_PREFETCH_TIMEOUT			60
 
-	if ((blob_item->blob.url[0] == '\0') || strcmp(blob_item->name, CCD_IMAGE_ITEM_NAME)) {
-		indigo_error("%s: url == \"\" or item != \"%s\"", __FUNCTION__, CCD_IMAGE_ITEM_NAME);
-		goto clean_return;
-	}
+typedef struct {
+	char host[INDIGO_NAME_SIZE];
+	int port;
+	int socket;
+} http_connection;
 
-	sscanf(blob_item->blob.url, "http://%255[^:]:%5d/%256[^\n]", host, &port, file);
-	socket = indigo_open_tcp(host, port);
-	if (socket < 0)
-		goto clean_return;
+typedef struct {
+	int http_result;
+	long content_len;
+	long uncompressed_content_len;
+	long range_start;
+	long range_total;
+	bool use_gzip;
+	bool keep_alive;
+	char etag[64];
+} http_response;
 
-	INDIGO_TRACE(indigo_trace("%d <- // open for '%s:%d'", socket, host, port));
+typedef struct {
+	char host[INDIGO_NAME_SIZE];
+	int port;
+	char file[INDIGO_VALUE_SIZE];
+	char *buffer;
+	long start;
+	long end;
+	long total;
+	const char *etag;
+	bool ok;
+} http_range_request;
+
+typedef enum {
+	HTTP_PREFETCH_EMPTY,
+	HTTP_PREFETCH_LOADING,
+	HTTP_PREFETCH_READY,
+	HTTP_PREFETCH_FAILED
+} http_prefetch_state;
+
+typedef struct {
+	char url[INDIGO_VALUE_SIZE];
+	http_prefetch_state state;
+	unsigned generation;
+	void *value;
+	long size;
+	char format[INDIGO_NAME_SIZE];
+	time_t timestamp;
+} http_prefetch_slot;
+
+typedef struct {
+	int slot;
+	unsigned generation;
+	char url[INDIGO_VALUE_SIZE];
+} http_prefetch_request;
+
+bool indigo_use_blob_prefetch = false;
 
+static http_connection http_connection_pool[HTTP_CONNECTION_POOL_SIZE];
+static pthread_mutex_t http_connection_mutex = PTHREAD_MUTEX_INITIALIZER;
+static http_prefetch_slot http_prefetch_slots[HTTP_PREFETCH_SLOTS];
+static pthread_mutex_t http_prefetch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t http_prefetch_cond = PTHREAD_COND_INITIALIZER;
+
+static void http_close(int socket) {
 #if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
-	snprintf(request, BUFFER_SIZE, "GET /%s HTTP/1.1\r\nAccept-Encoding: gzip\r\n\r\n", file);
-#else
-	snprintf(request, BUFFER_SIZE, "GET /%s HTTP/1.1\r\n\r\n", file);
+	shutdown(socket, SHUT_RDWR);
+	close(socket);
 #endif
-	INDIGO_TRACE(indigo_trace("%d <- %s", socket, request));
-	res = indigo_write(socket, request, strlen(request));
-	if (res == false)
-		goto clean_return;
-
-	res = indigo_read_line(socket, http_line, BUFFER_SIZE);
+#if defined(INDIGO_WINDOWS)
+	shutdown(socket, SD_BOTH);
+	closesocket(socket);
+#endif
+}
 
-	if (res < 0) {
-		res = false;
-		goto clean_return;
+static int http_open(const char *host, int port, bool *reused) {
+	pthread_mutex_lock(&http_connection_mutex);
+	for (int i = 0; i < HTTP_CONNECTION_POOL_SIZE; i++) {
+		http_connection *connection = http_connection_pool + i;
+		if (connection->socket > 0 && connection->port == port && !strcmp(connection->host, host)) {
+			int socket = connection->socket;
+			connection->socket = 0;
+			pthread_mutex_unlock(&http_connection_mutex);
+			INDIGO_TRACE(indigo_trace("%d <- // reused for '%s:%d'", socket, host, port));
+			*reused = true;
+			return socket;
+		}
 	}
-	INDIGO_TRACE(indigo_trace("%d -> %s", socket, http_line));
-
-	int count = sscanf(http_line, "HTTP/1.1 %d %255[^\n]", &http_result, http_response);
-	if ((count != 2) || (http_result != 200)) {
-		goto clean_return;
+	pthread_mutex_unlock(&http_connection_mutex);
+	*reused = false;
+	int socket = indigo_open_tcp(host, port);
+	if (socket >= 0) {
+		/* On Raspberry Pi blob compression may take longer. Make sure we do not timeout prematurely */
+		struct timeval timeout;
+		timeout.tv_sec = 15;
+		timeout.tv_usec = 0;
+		setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (char *)&timeout, sizeof(timeout));
+		INDIGO_TRACE(indigo_trace("%d <- // open for '%s:%d'", socket, host, port));
+	}
+	return socket;
+}
+
+static void http_release(const char *host, int port, int socket, bool keep_alive) {
+	if (keep_alive) {
+		pthread_mutex_lock(&http_connection_mutex);
+		for (int i = 0; i < HTTP_CONNECTION_POOL_SIZE; i++) {
+			http_connection *connection = http_connection_pool + i;
+			if (connection->socket <= 0) {
+				indigo_copy_name(connection->host, host);
+				connection->port = port;
+				connection->socket = socket;
+				pthread_mutex_unlock(&http_connection_mutex);
+				return;
+			}
+		}
+		pthread_mutex_unlock(&http_connection_mutex);
 	}
-	
-	bool use_gzip = false;
-
-	/* On Raspberry Pi blob compression may take longer. Make sure we do not timeout prematurely */
-	struct timeval timeout;
-	timeout.tv_sec = 15;
-	timeout.tv_usec = 0;
-	setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (char *)&timeout, sizeof(timeout));
+	http_close(socket);
+}
 
+static bool http_get(int socket, const char *file, long range_start, long range_end, const char *if_range, bool accept_gzip, http_response *response) {
+	char request[BUFFER_SIZE], http_line[BUFFER_SIZE];
+	int length = snprintf(request, BUFFER_SIZE, "GET /%s HTTP/1.1\r\nConnection: keep-alive\r\n", file);
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+	if (accept_gzip)
+		length += snprintf(request + length, BUFFER_SIZE - length, "Accept-Encoding: gzip\r\n");
+#endif
+	if (range_end > 0)
+		length += snprintf(request + length, BUFFER_SIZE - length, "Range: bytes=%ld-%ld\r\n", range_start, range_end);
+	if (if_range)
+		length += snprintf(request + length, BUFFER_SIZE - length, "If-Range: \"%s\"\r\n", if_range);
+	length += snprintf(request + length, BUFFER_SIZE - length, "\r\n");
+	INDIGO_TRACE(indigo_trace("%d <- %s", socket, request));
+	if (!indigo_write(socket, request, length))
+		return false;
+	if (indigo_read_line(socket, http_line, BUFFER_SIZE) < 0)
+		return false;
+	INDIGO_TRACE(indigo_trace("%d -> %s", socket, http_line));
+	memset(response, 0, sizeof(http_response));
+	if (sscanf(http_line, "HTTP/1.1 %d", &response->http_result) != 1)
+		return false;
 	do {
-		res = indigo_read_line(socket, http_line, BUFFER_SIZE);
-		if (res < 0) {
-			res = false;
-			goto clean_return;
-		}
+		if (indigo_read_line(socket, http_line, BUFFER_SIZE) < 0)
+			return false;
 		INDIGO_TRACE(indigo_trace("%d -> %s", socket, http_line));
-#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
-		if (!strncasecmp(http_line, "Content-Encoding: gzip", 22)) {
-			use_gzip = true;
+		if (!strncasecmp(http_line, "Content-Encoding: gzip", 22))
+			response->use_gzip = true;
+		else if (!strncasecmp(http_line, "Connection: keep-alive", 22))
+			response->keep_alive = true;
+		else if (sscanf(http_line, "Content-Length: %20ld", &response->content_len) == 1)
 			continue;
-		}
-#endif
-		if (sscanf(http_line, "Content-Length: %20ld[^\n]", &content_len) == 1)
+		else if (sscanf(http_line, "X-Uncompressed-Content-Length: %20ld", &response->uncompressed_content_len) == 1)
+			continue;
+		else if (sscanf(http_line, "Content-Range: bytes %20ld-%*[0-9]/%20ld", &response->range_start, &response->range_total) == 2)
 			continue;
-		if (sscanf(http_line, "X-Uncompressed-Content-Length: %20ld[^\n]", &uncompressed_content_len) == 1)
+		else if (!strncasecmp(http_line, "ETag:", 5) && sscanf(http_line + 5, " \"%62[^\"]\"", response->etag) == 1)
 			continue;
 	} while (http_line[0] != '\0');
+	return true;
+}
 
-	if (content_len) {
-		image_type = strrchr(file, '.');
+static void *http_get_range(http_range_request *request) {
+	bool reused = false;
+	for (int attempt = 0; attempt < 2 && !request->ok; attempt++) {
+		int socket = http_open(request->host, request->port, &reused);
+		if (socket < 0)
+			break;
+		http_response response;
+		// the range must come from the same BLOB version as the first chunk, otherwise the image would be stitched from different frames
+		if (http_get(socket, request->file, request->start, request->end, request->etag, false, &response) && response.http_result == 206 && response.range_start == request->start && response.range_total == request->total && response.content_len == request->end - request->start + 1 && !strcmp(response.etag, request->etag)) {
+			request->ok = indigo_read(socket, request->buffer + request->start, response.content_len) > 0;
+			http_release(request->host, request->port, socket, request->ok && response.keep_alive);
+			break;
+		}
+		http_close(socket);
+		if (!reused)
+			break;
+	}
+	return NULL;
+}
+
+static bool http_download(const char *url, void **value, long *size, char *format) {
+	char host[INDIGO_NAME_SIZE] = "", file[INDIGO_VALUE_SIZE] = "";
+	int port = 80;
+	bool reused = false;
+	bool res = false;
+	// ranges are used for the first attempt only, whole BLOB is requested in a single response if they fail
+	bool use_ranges = true;
+	if (sscanf(url, "http://%255[^:]:%5d/%255[^\n]", host, &port, file) != 3)
+		return false;
+	for (int attempt = 0; attempt < 3; attempt++) {
+		int socket = http_open(host, port, &reused);
+		if (socket < 0)
+			return false;
+		http_response response;
+		// ask for the first chunk only, servers without range support or with compression enabled return whole BLOB
+		if (!http_get(socket, file, 0, use_ranges ? HTTP_RANGE_CHUNK_SIZE - 1 : 0, NULL, true, &response)) {
+			http_close(socket);
+			if (reused)
+				continue;
+			return false;
+		}
+		if ((response.http_result != 200 && response.http_result != 206) || response.content_len <= 0) {
+			http_close(socket);
+			return false;
+		}
+		char *image_type = strrchr(file, '.');
 		if (image_type)
-			indigo_copy_name(blob_item->blob.format, image_type);
+			indigo_copy_name(format, image_type);
 #if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
-		if (use_gzip) {
-			blob_item->blob.size = uncompressed_content_len;
-			blob_item->blob.value = indigo_safe_realloc(blob_item->blob.value, blob_item->blob.size);
-			char *compressed_buffer = indigo_safe_malloc(content_len);
-			res = (indigo_read(socket, compressed_buffer, content_len) >= 0) ? true : false;
+		if (response.use_gzip) {
+			*size = response.uncompressed_content_len;
+			*value = indigo_safe_realloc(*value, *size);
+			char *compressed_buffer = indigo_safe_malloc(response.content_len);
+			res = indigo_read(socket, compressed_buffer, response.content_len) > 0;
 			if (res) {
-				unsigned out_size = (unsigned)uncompressed_content_len;
-				indigo_decompress(compressed_buffer, (unsigned)content_len, blob_item->blob.value, &out_size);
+				unsigned out_size = (unsigned)response.uncompressed_content_len;
+				indigo_decompress(compressed_buffer, (unsigned)response.content_len, *value, &out_size);
 			}
 			free(compressed_buffer);
-		} else {
-			blob_item->blob.size = content_len;
-			blob_item->blob.value = indigo_safe_realloc(blob_item->blob.value, blob_item->blob.size);
-			INDIGO_TRACE(indigo_trace("%d -> // %d bytes", socket, blob_item->blob.size));
-			res = (indigo_read(socket, blob_item->blob.value, blob_item->blob.size) >= 0) ? true : false;
+			http_release(host, port, socket, res && response.keep_alive);
+			return res;
 		}
-#else
-		blob_item->blob.size = content_len;
-		blob_item->blob.value = indigo_safe_realloc(blob_item->blob.value, blob_item->blob.size);
-		INDIGO_TRACE(indigo_trace("%d -> // %d bytes", socket, blob_item->blob.size));
-		res = (indigo_read(socket, blob_item->blob.value, blob_item->blob.size) >= 0) ? true : false;
 #endif
-	} else {
-		res = false;
+		if (response.http_result == 206 && response.range_start == 0 && response.range_total > response.content_len) {
+			if (*response.etag == 0) {
+				// without validator the ranges can't be pinned to one BLOB version
+				http_close(socket);
+				use_ranges = false;
+				continue;
+			}
+			*size = response.range_total;
+			*value = indigo_safe_realloc(*value, *size);
+			res = indigo_read(socket, *value, response.content_len) > 0;
+			http_release(host, port, socket, res && response.keep_alive);
+			if (!res)
+				return false;
+			// fetch the rest in parallel ranges over separate connections
+			long start = response.content_len;
+			long chunk = (*size - start + HTTP_RANGE_CHUNKS - 1) / HTTP_RANGE_CHUNKS;
+			http_range_request requests[HTTP_RANGE_CHUNKS];
+			pthread_t threads[HTTP_RANGE_CHUNKS];
+			bool started[HTTP_RANGE_CHUNKS] = { false };
+			int count = 0;
+			while (start < *size && count < HTTP_RANGE_CHUNKS) {
+				http_range_request *request = requests + count;
+				indigo_copy_name(request->host, host);
+				request->port = port;
+				indigo_copy_value(request->file, file);
+				request->buffer = *value;
+				request->start = start;
+				request->end = start + chunk < *size ? start + chunk - 1 : *size - 1;
+				request->total = *size;
+				request->etag = response.etag;
+				request->ok = false;
+				start = request->end + 1;
+				started[count] = pthread_create(threads + count, NULL, (void *(*)(void *))http_get_range, request) == 0;
+				if (!started[count])
+					http_get_range(request);
+				count++;
+			}
+			for (int i = 0; i < count; i++) {
+				if (started[i])
+					pthread_join(threads[i], NULL);
+				res = res && requests[i].ok;
+			}
+			if (res) {
+				INDIGO_TRACE(indigo_trace("// %ld bytes of '%s' version %s in %d ranges", *size, url, response.etag, count + 1));
+				return true;
+			}
+			// BLOB changed or ranges failed, download it again in one piece
+			INDIGO_TRACE(indigo_trace("// ranges of '%s' inconsistent, retrying", url));
+			use_ranges = false;
+			continue;
+		}
+		*size = response.content_len;
+		*value = indigo_safe_realloc(*value, *size);
+		INDIGO_TRACE(indigo_trace("%d -> // %ld bytes", socket, *size));
+		res = indigo_read(socket, *value, *size) > 0;
+		http_release(host, port, socket, res && response.keep_alive);
+		return res;
 	}
+	return res;
+}
 
-clean_return:
-	if (!res || socket < 0)
-		INDIGO_TRACE(indigo_trace("%d -> // %s", socket, strerror(errno)));
-	if (socket >= 0) {
-#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
-		shutdown(socket, SHUT_RDWR);
-		close(socket);
-#endif
-#if defined(INDIGO_WINDOWS)
-		shutdown(socket, SD_BOTH);
-		closesocket(socket);
-#endif
+static void *http_prefetch(http_prefetch_request *request) {
+	void *value = NULL;
+	long size = 0;
+	char format[INDIGO_NAME_SIZE] = "";
+	bool res = http_download(request->url, &value, &size, format);
+	pthread_mutex_lock(&http_prefetch_mutex);
+	http_prefetch_slot *slot = http_prefetch_slots + request->slot;
+	if (slot->generation == request->generation && !strcmp(slot->url, request->url)) {
+		indigo_safe_free(slot->value);
+		slot->value = res ? value : NULL;
+		slot->size = res ? size : 0;
+		indigo_copy_name(slot->format, format);
+		slot->state = res ? HTTP_PREFETCH_READY : HTTP_PREFETCH_FAILED;
+		slot->timestamp = time(NULL);
+		value = NULL;
+		pthread_cond_broadcast(&http_prefetch_cond);
+	}
+	pthread_mutex_unlock(&http_prefetch_mutex);
+	indigo_safe_free(value);
+	free(request);
+	return NULL;
+}
+
+void indigo_prefetch_http_blob_item(indigo_item *blob_item) {
+	if (!indigo_use_blob_prefetch || blob_item->blob.url[0] == '\0' || strcmp(blob_item->name, CCD_IMAGE_ITEM_NAME))
+		return;
+	pthread_mutex_lock(&http_prefetch_mutex);
+	int index = 0;
+	for (int i = 0; i < HTTP_PREFETCH_SLOTS; i++) {
+		http_prefetch_slot *slot = http_prefetch_slots + i;
+		if (!strcmp(slot->url, blob_item->blob.url)) {
+			index = i;
+			break;
+		}
+		if (slot->timestamp < http_prefetch_slots[index].timestamp)
+			index = i;
+	}
+	http_prefetch_slot *slot = http_prefetch_slots + index;
+	// new BLOB version invalidates the slot immediately, the previous content is never served for it
+	indigo_safe_free(slot->value);
+	slot->value = NULL;
+	slot->size = 0;
+	indigo_copy_value(slot->url, blob_item->blob.url);
+	slot->state = HTTP_PREFETCH_LOADING;
+	slot->timestamp = time(NULL);
+	http_prefetch_request *request = indigo_safe_malloc(sizeof(http_prefetch_request));
+	request->slot = index;
+	request->generation = ++slot->generation;
+	indigo_copy_value(request->url, blob_item->blob.url);
+	pthread_mutex_unlock(&http_prefetch_mutex);
+	if (!indigo_async((void *(*)(void *))http_prefetch, request)) {
+		pthread_mutex_lock(&http_prefetch_mutex);
+		if (slot->generation == request->generation) {
+			slot->state = HTTP_PREFETCH_FAILED;
+			pthread_cond_broadcast(&http_prefetch_cond);
+		}
+		pthread_mutex_unlock(&http_prefetch_mutex);
+		free(request);
 	}
-	indigo_safe_free(host);
-	indigo_safe_free(file);
-	indigo_safe_free(request);
-	indigo_safe_free(http_line);
-	indigo_safe_free(http_response);
+}
+
+bool indigo_populate_http_blob_item(indigo_item *blob_item) {
+	if ((blob_item->blob.url[0] == '\0') || strcmp(blob_item->name, CCD_IMAGE_ITEM_NAME)) {
+		indigo_error("%s: url == \"\" or item != \"%s\"", __FUNCTION__, CCD_IMAGE_ITEM_NAME);
+		return false;
+	}
+	if (indigo_use_blob_prefetch) {
+		pthread_mutex_lock(&http_prefetch_mutex);
+		for (int i = 0; i < HTTP_PREFETCH_SLOTS; i++) {
+			http_prefetch_slot *slot = http_prefetch_slots + i;
+			if (!strcmp(slot->url, blob_item->blob.url)) {
+				while (slot->state == HTTP_PREFETCH_LOADING)
+					pthread_cond_wait(&http_prefetch_cond, &http_prefetch_mutex);
+				if (slot->state == HTTP_PREFETCH_READY && !strcmp(slot->url, blob_item->blob.url) && time(NULL) - slot->timestamp < HTTP_PREFETCH_TIMEOUT) {
+					// prefetched content is handed over to the item and the slot is released
+					indigo_safe_free(blob_item->blob.value);
+					blob_item->blob.value = slot->value;
+					blob_item->blob.size = slot->size;
+					indigo_copy_name(blob_item->blob.format, slot->format);
+					slot->value = NULL;
+					slot->size = 0;
+					slot->url[0] = 0;
+					slot->state = HTTP_PREFETCH_EMPTY;
+					slot->timestamp = 0;
+					pthread_mutex_unlock(&http_prefetch_mutex);
+					INDIGO_TRACE(indigo_trace("// %ld bytes of '%s' prefetched", blob_item->blob.size, blob_item->blob.url));
+					return true;
+				}
+				indigo_safe_free(slot->value);
+				slot->value = NULL;
+				slot->size = 0;
+				slot->url[0] = 0;
+				slot->state = HTTP_PREFETCH_EMPTY;
+				break;
+			}
+		}
+		pthread_mutex_unlock(&http_prefetch_mutex);
+	}
+	bool res = http_download(blob_item->blob.url, &blob_item->blob.value, &blob_item->blob.size, blob_item->blob.format);
+	if (!res)
+		INDIGO_TRACE(indigo_trace("'%s' -> // %s", blob_item->blob.url, strerror(errno)));
 	return res;
 }
 
@@ -0,0 +1,355 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+/** INDIGO binary bus trace
+ \file indigo_bus_trace.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_bus_trace.h>
+
+#define RECORD_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+bool indigo_bus_trace_enabled = false;
+
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int trace_handle = -1;
+static unsigned char *trace_data = NULL;
+static size_t trace_size = 0;
+
+static uint64_t trace_time() {
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static bool trace_map(size_t size) {
+	// extend file first, old mapping is kept if anything fails
+#if defined(INDIGO_LINUX)
+	int result = posix_fallocate(trace_handle, 0, size);
+	if (result) {
+		errno = result;
+		return false;
+	}
+#else
+	if (ftruncate(trace_handle, size) < 0)
+		return false;
+#endif
+	unsigned char *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, trace_handle, 0);
+	if (data == MAP_FAILED)
+		return false;
+	if (trace_data != NULL)
+		munmap(trace_data, trace_size);
+	trace_data = data;
+	trace_size = size;
+	return true;
+}
+
+bool indigo_start_bus_trace(const char *file_name) {
+	pthread_mutex_lock(&trace_mutex);
+	if (trace_data != NULL) {
+		pthread_mutex_unlock(&trace_mutex);
+		indigo_error("Bus trace is already recorded");
+		return false;
+	}
+	trace_handle = open(file_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (trace_handle < 0) {
+		pthread_mutex_unlock(&trace_mutex);
+		indigo_error("Can't create %s (%s)", file_name, strerror(errno));
+		return false;
+	}
+	if (!trace_map(INDIGO_BUS_TRACE_CHUNK_SIZE)) {
+		indigo_error("Can't map %s (%s)", file_name, strerror(errno));
+		close(trace_handle);
+		trace_handle = -1;
+		pthread_mutex_unlock(&trace_mutex);
+		return false;
+	}
+	indigo_bus_trace_header *header = (indigo_bus_trace_header *)trace_data;
+	memset(header, 0, sizeof(indigo_bus_trace_header));
+	memcpy(header->magic, INDIGO_BUS_TRACE_MAGIC, sizeof(header->magic));
+	header->version = INDIGO_BUS_TRACE_VERSION;
+	header->header_size = sizeof(indigo_bus_trace_header);
+	header->start_time = trace_time();
+	indigo_bus_trace_enabled = true;
+	static bool registered = false;
+	if (!registered) {
+		atexit(indigo_stop_bus_trace);
+		registered = true;
+	}
+	pthread_mutex_unlock(&trace_mutex);
+	indigo_log("Bus trace is recorded to %s", file_name);
+	return true;
+}
+
+void indigo_stop_bus_trace(void) {
+	pthread_mutex_lock(&trace_mutex);
+	indigo_bus_trace_enabled = false;
+	if (trace_data != NULL) {
+		indigo_bus_trace_header *header = (indigo_bus_trace_header *)trace_data;
+		off_t length = header->header_size + header->length;
+		indigo_log("Bus trace stopped, %llu events recorded, %llu dropped", (unsigned long long)header->count, (unsigned long long)header->dropped);
+		msync(trace_data, trace_size, MS_SYNC);
+		munmap(trace_data, trace_size);
+		trace_data = NULL;
+		trace_size = 0;
+		if (ftruncate(trace_handle, length) < 0)
+			indigo_error("Can't truncate bus trace (%s)", strerror(errno));
+		close(trace_handle);
+		trace_handle = -1;
+	}
+	pthread_mutex_unlock(&trace_mutex);
+}
+
+static inline unsigned char *put(unsigned char *pnt, const void *data, size_t length) {
+	memcpy(pnt, data, length);
+	return pnt + length;
+}
+
+static inline unsigned char *put_name(unsigned char *pnt, const char *name, size_t length) {
+	*pnt++ = (uint8_t)length;
+	pnt = put(pnt, name, length);
+	*pnt++ = 0;
+	return pnt;
+}
+
+void indigo_bus_trace_property(indigo_bus_trace_event event, indigo_client *client, indigo_property *property) {
+	uint64_t time = trace_time();
+	size_t device_length = strnlen(property->device, INDIGO_NAME_SIZE - 1);
+	size_t name_length = strnlen(property->name, INDIGO_NAME_SIZE - 1);
+	size_t size = sizeof(indigo_bus_trace_record) + device_length + 1 + name_length + 1;
+	uint64_t payload = 0;
+	for (int i = 0; i < property->count; i++) {
+		indigo_item *item = property->items + i;
+		size += strnlen(item->name, INDIGO_NAME_SIZE - 1) + 2;
+		switch (property->type) {
+			case INDIGO_TEXT_VECTOR: {
+				size_t length = strlen(indigo_get_text_item_value(item));
+				size += sizeof(uint32_t) + length + 1;
+				payload += length;
+				break;
+			}
+			case INDIGO_NUMBER_VECTOR:
+				size += 2 * sizeof(double);
+				payload += sizeof(double);
+				break;
+			case INDIGO_SWITCH_VECTOR:
+			case INDIGO_LIGHT_VECTOR:
+				size += 1;
+				payload += 1;
+				break;
+			case INDIGO_BLOB_VECTOR:
+				size += sizeof(uint64_t);
+				payload += item->blob.size;
+				break;
+		}
+	}
+	size = RECORD_ALIGN(size);
+	pthread_mutex_lock(&trace_mutex);
+	if (trace_data == NULL) {
+		pthread_mutex_unlock(&trace_mutex);
+		return;
+	}
+	indigo_bus_trace_header *header = (indigo_bus_trace_header *)trace_data;
+	size_t position = header->header_size + header->length;
+	if (position + size > trace_size) {
+		size_t new_size = trace_size + INDIGO_BUS_TRACE_CHUNK_SIZE;
+		while (position + size > new_size)
+			new_size += INDIGO_BUS_TRACE_CHUNK_SIZE;
+		if (!trace_map(new_size)) {
+			((indigo_bus_trace_header *)trace_data)->dropped++;
+			pthread_mutex_unlock(&trace_mutex);
+			return;
+		}
+		header = (indigo_bus_trace_header *)trace_data;
+	}
+	indigo_bus_trace_record *record = (indigo_bus_trace_record *)(trace_data + position);
+	record->size = (uint32_t)size;
+	record->event = (uint8_t)event;
+	record->type = (uint8_t)property->type;
+	record->state = (uint8_t)property->state;
+	record->flags = client != NULL && client->is_remote ? INDIGO_BUS_TRACE_REMOTE : 0;
+	record->time = time > header->start_time ? time - header->start_time : 0;
+	record->payload = payload;
+	record->count = (uint16_t)property->count;
+	record->device_length = (uint8_t)device_length;
+	record->name_length = (uint8_t)name_length;
+	record->reserved = 0;
+	unsigned char *pnt = (unsigned char *)(record + 1);
+	pnt = put(pnt, property->device, device_length);
+	*pnt++ = 0;
+	pnt = put(pnt, property->name, name_length);
+	*pnt++ = 0;
+	for (int i = 0; i < property->count; i++) {
+		indigo_item *item = property->items + i;
+		pnt = put_name(pnt, item->name, strnlen(item->name, INDIGO_NAME_SIZE - 1));
+		switch (property->type) {
+			case INDIGO_TEXT_VECTOR: {
+				char *value = indigo_get_text_item_value(item);
+				uint32_t length = (uint32_t)strlen(value);
+				pnt = put(pnt, &length, sizeof(length));
+				pnt = put(pnt, value, length + 1);
+				break;
+			}
+			case INDIGO_NUMBER_VECTOR:
+				pnt = put(pnt, &item->number.value, sizeof(double));
+				pnt = put(pnt, &item->number.target, sizeof(double));
+				break;
+			case INDIGO_SWITCH_VECTOR:
+				*pnt++ = item->sw.value;
+				break;
+			case INDIGO_LIGHT_VECTOR:
+				*pnt++ = (uint8_t)item->light.value;
+				break;
+			case INDIGO_BLOB_VECTOR: {
+				uint64_t blob_size = item->blob.size;
+				pnt = put(pnt, &blob_size, sizeof(blob_size));
+				break;
+			}
+		}
+	}
+	memset(pnt, 0, (unsigned char *)record + size - pnt);
+	header->length += size;
+	header->count++;
+	pthread_mutex_unlock(&trace_mutex);
+}
+
+// -------------------------------------------------------------------------------- reader
+
+indigo_bus_trace_reader *indigo_bus_trace_open(const char *file_name) {
+	int handle = open(file_name, O_RDONLY);
+	if (handle < 0)
+		return NULL;
+	struct stat st;
+	if (fstat(handle, &st) < 0 || (size_t)st.st_size < sizeof(indigo_bus_trace_header)) {
+		close(handle);
+		errno = EINVAL;
+		return NULL;
+	}
+	unsigned char *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, handle, 0);
+	if (data == MAP_FAILED) {
+		close(handle);
+		return NULL;
+	}
+	indigo_bus_trace_header *header = (indigo_bus_trace_header *)data;
+	if (memcmp(header->magic, INDIGO_BUS_TRACE_MAGIC, sizeof(header->magic)) || header->version != INDIGO_BUS_TRACE_VERSION || header->header_size < sizeof(indigo_bus_trace_header) || header->header_size > (uint64_t)st.st_size) {
+		munmap(data, st.st_size);
+		close(handle);
+		errno = EINVAL;
+		return NULL;
+	}
+	indigo_bus_trace_reader *reader = indigo_safe_malloc(sizeof(indigo_bus_trace_reader));
+	reader->handle = handle;
+	reader->data = data;
+	reader->size = st.st_size;
+	reader->position = header->header_size;
+	reader->header = header;
+	// file of trace which wasn't stopped properly is longer than recorded data
+	reader->length = header->header_size + header->length < reader->size ? header->header_size + header->length : reader->size;
+	return reader;
+}
+
+indigo_bus_trace_record *indigo_bus_trace_next(indigo_bus_trace_reader *reader) {
+	if (reader->position + sizeof(indigo_bus_trace_record) > reader->length)
+		return NULL;
+	indigo_bus_trace_record *record = (indigo_bus_trace_record *)(reader->data + reader->position);
+	if (record->size < sizeof(indigo_bus_trace_record) || reader->position + record->size > reader->length)
+		return NULL;
+	reader->position += record->size;
+	return record;
+}
+
+void indigo_bus_trace_names(indigo_bus_trace_record *record, const char **device, const char **name) {
+	const char *pnt = (const char *)(record + 1);
+	*device = pnt;
+	*name = pnt + record->device_length + 1;
+}
+
+indigo_property *indigo_bus_trace_decode(indigo_bus_trace_record *record) {
+	const char *device, *name;
+	indigo_bus_trace_names(record, &device, &name);
+	indigo_property *property = indigo_safe_malloc(sizeof(indigo_property) + record->count * sizeof(indigo_item));
+	indigo_copy_name(property->device, device);
+	indigo_copy_name(property->name, name);
+	property->type = record->type;
+	property->state = record->state;
+	property->perm = INDIGO_RW_PERM;
+	property->version = INDIGO_VERSION_CURRENT;
+	property->allocated_count = property->count = record->count;
+	const unsigned char *pnt = (const unsigned char *)name + record->name_length + 1;
+	const unsigned char *end = (const unsigned char *)record + record->size;
+	for (int i = 0; i < record->count; i++) {
+		indigo_item *item = property->items + i;
+		if (pnt >= end)
+			break;
+		int length = *pnt++;
+		indigo_copy_name(item->name, (const char *)pnt);
+		pnt += length + 1;
+		switch (record->type) {
+			case INDIGO_TEXT_VECTOR: {
+				uint32_t length;
+				memcpy(&length, pnt, sizeof(length));
+				pnt += sizeof(length);
+				indigo_set_text_item_value(item, (const char *)pnt);
+				pnt += length + 1;
+				break;
+			}
+			case INDIGO_NUMBER_VECTOR:
+				memcpy(&item->number.value, pnt, sizeof(double));
+				memcpy(&item->number.target, pnt + sizeof(double), sizeof(double));
+				pnt += 2 * sizeof(double);
+				break;
+			case INDIGO_SWITCH_VECTOR:
+				item->sw.value = *pnt++;
+				break;
+			case INDIGO_LIGHT_VECTOR:
+				item->light.value = *pnt++;
+				break;
+			case INDIGO_BLOB_VECTOR: {
+				uint64_t size;
+				memcpy(&size, pnt, sizeof(size));
+				pnt += sizeof(size);
+				item->blob.size = (long)size;
+				break;
+			}
+		}
+	}
+	return property;
+}
+
+void indigo_bus_trace_close(indigo_bus_trace_reader *reader) {
+	if (reader == NULL)
+		return;
+	munmap(reader->data, reader->size);
+	close(reader->handle);
+	indigo_safe_free(reader);
+}
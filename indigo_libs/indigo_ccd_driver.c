@@ -206,6 +206,15 @@ indigo_result indigo_ccd_attach(indigo_device *device, const char* driver_name,
 			indigo_init_number_item(CCD_STREAMING_COUNT_ITEM, CCD_STREAMING_COUNT_ITEM_NAME, "Frame count", -1, 100000, 1, -1);
 			strcpy(CCD_EXPOSURE_ITEM->number.format, "%g");
 			CCD_STREAMING_PROPERTY->hidden = true;
+			// -------------------------------------------------------------------------------- CCD_STREAMING_STATISTICS
+			CCD_STREAMING_STATISTICS_PROPERTY = indigo_init_number_property(NULL, device->name, CCD_STREAMING_STATISTICS_PROPERTY_NAME, CCD_MAIN_GROUP, "Streaming statistics", INDIGO_OK_STATE, INDIGO_RO_PERM, 3);
+			if (CCD_STREAMING_STATISTICS_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			indigo_init_number_item(CCD_STREAMING_STATISTICS_DELIVERED_ITEM, CCD_STREAMING_STATISTICS_DELIVERED_ITEM_NAME, "Delivered frames", 0, LONG_MAX, 0, 0);
+			indigo_init_number_item(CCD_STREAMING_STATISTICS_DROPPED_ITEM, CCD_STREAMING_STATISTICS_DROPPED_ITEM_NAME, "Dropped frames", 0, LONG_MAX, 0, 0);
+			indigo_init_number_item(CCD_STREAMING_STATISTICS_FPS_ITEM, CCD_STREAMING_STATISTICS_FPS_ITEM_NAME, "Frame rate (fps)", 0, 10000, 0, 0);
+			strcpy(CCD_STREAMING_STATISTICS_FPS_ITEM->number.format, "%.1f");
+			CCD_STREAMING_STATISTICS_PROPERTY->hidden = true;
 			// -------------------------------------------------------------------------------- CCD_ABORT_EXPOSURE
 			CCD_ABORT_EXPOSURE_PROPERTY = indigo_init_switch_property(NULL, device->name, CCD_ABORT_EXPOSURE_PROPERTY_NAME, CCD_MAIN_GROUP, "Abort exposure", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_AT_MOST_ONE_RULE, 1);
 			if (CCD_ABORT_EXPOSURE_PROPERTY == NULL)
@@ -293,6 +302,22 @@ indigo_result indigo_ccd_attach(indigo_device *device, const char* driver_name,
 			if (CCD_IMAGE_FILE_PROPERTY == NULL)
 				return INDIGO_FAILED;
 			indigo_init_text_item(CCD_IMAGE_FILE_ITEM, CCD_IMAGE_FILE_ITEM_NAME, "Filename", "None");
+			// -------------------------------------------------------------------------------- CCD_RECORDER_STATISTICS
+			CCD_RECORDER_STATISTICS_PROPERTY = indigo_init_number_property(NULL, device->name, CCD_RECORDER_STATISTICS_PROPERTY_NAME, CCD_IMAGE_GROUP, "Video recorder statistics", INDIGO_OK_STATE, INDIGO_RO_PERM, 4);
+			if (CCD_RECORDER_STATISTICS_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			indigo_init_number_item(CCD_RECORDER_STATISTICS_RATE_ITEM, CCD_RECORDER_STATISTICS_RATE_ITEM_NAME, "Write rate (MB/s)", 0, 100000, 0, 0);
+			indigo_init_number_item(CCD_RECORDER_STATISTICS_QUEUE_ITEM, CCD_RECORDER_STATISTICS_QUEUE_ITEM_NAME, "Queued frames", 0, 100000, 0, 0);
+			indigo_init_number_item(CCD_RECORDER_STATISTICS_FRAMES_ITEM, CCD_RECORDER_STATISTICS_FRAMES_ITEM_NAME, "Recorded frames", 0, 1e9, 0, 0);
+			indigo_init_number_item(CCD_RECORDER_STATISTICS_DROPPED_ITEM, CCD_RECORDER_STATISTICS_DROPPED_ITEM_NAME, "Dropped frames", 0, 1e9, 0, 0);
+			// -------------------------------------------------------------------------------- CCD_DSLR_RAW_MODE
+			CCD_DSLR_RAW_MODE_PROPERTY = indigo_init_switch_property(NULL, device->name, CCD_DSLR_RAW_MODE_PROPERTY_NAME, CCD_IMAGE_GROUP, "RAW conversion", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 3);
+			if (CCD_DSLR_RAW_MODE_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			CCD_DSLR_RAW_MODE_PROPERTY->hidden = true;
+			indigo_init_switch_item(CCD_DSLR_RAW_MODE_FULL_ITEM, CCD_DSLR_RAW_MODE_FULL_ITEM_NAME, "Full resolution", true);
+			indigo_init_switch_item(CCD_DSLR_RAW_MODE_BIN_2X2_ITEM, CCD_DSLR_RAW_MODE_BIN_2X2_ITEM_NAME, "2x2 binned preview", false);
+			indigo_init_switch_item(CCD_DSLR_RAW_MODE_THUMBNAIL_ITEM, CCD_DSLR_RAW_MODE_THUMBNAIL_ITEM_NAME, "Embedded JPEG preview", false);
 			// -------------------------------------------------------------------------------- CCD_COOLER
 			CCD_COOLER_PROPERTY = indigo_init_switch_property(NULL, device->name, CCD_COOLER_PROPERTY_NAME, CCD_COOLER_GROUP, "Cooler status", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 2);
 			if (CCD_COOLER_PROPERTY == NULL)
@@ -379,6 +404,12 @@ indigo_result indigo_ccd_enumerate_properties(indigo_device *device, indigo_clie
 			indigo_define_property(device, CCD_LOCAL_MODE_PROPERTY, NULL);
 		if (indigo_property_match(CCD_IMAGE_FILE_PROPERTY, property))
 			indigo_define_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
+		if (indigo_property_match(CCD_RECORDER_STATISTICS_PROPERTY, property))
+			indigo_define_property(device, CCD_RECORDER_STATISTICS_PROPERTY, NULL);
+		if (indigo_property_match(CCD_STREAMING_STATISTICS_PROPERTY, property))
+			indigo_define_property(device, CCD_STREAMING_STATISTICS_PROPERTY, NULL);
+		if (indigo_property_match(CCD_DSLR_RAW_MODE_PROPERTY, property))
+			indigo_define_property(device, CCD_DSLR_RAW_MODE_PROPERTY, NULL);
 		if (indigo_property_match(CCD_MODE_PROPERTY, property))
 			indigo_define_property(device, CCD_MODE_PROPERTY, NULL);
 		if (indigo_property_match(CCD_READ_MODE_PROPERTY, property))
@@ -513,6 +544,9 @@ indigo_result indigo_ccd_change_property(indigo_device *device, indigo_client *c
 			indigo_define_property(device, CCD_FRAME_TYPE_PROPERTY, NULL);
 			indigo_define_property(device, CCD_IMAGE_FORMAT_PROPERTY, NULL);
 			indigo_define_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
+			indigo_define_property(device, CCD_RECORDER_STATISTICS_PROPERTY, NULL);
+			indigo_define_property(device, CCD_STREAMING_STATISTICS_PROPERTY, NULL);
+			indigo_define_property(device, CCD_DSLR_RAW_MODE_PROPERTY, NULL);
 			indigo_define_property(device, CCD_IMAGE_PROPERTY, NULL);
 			indigo_define_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
 			indigo_define_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
@@ -557,6 +591,9 @@ indigo_result indigo_ccd_change_property(indigo_device *device, indigo_client *c
 			indigo_delete_property(device, CCD_FRAME_TYPE_PROPERTY, NULL);
 			indigo_delete_property(device, CCD_IMAGE_FORMAT_PROPERTY, NULL);
 			indigo_delete_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
+			indigo_delete_property(device, CCD_RECORDER_STATISTICS_PROPERTY, NULL);
+			indigo_delete_property(device, CCD_STREAMING_STATISTICS_PROPERTY, NULL);
+			indigo_delete_property(device, CCD_DSLR_RAW_MODE_PROPERTY, NULL);
 			indigo_delete_property(device, CCD_IMAGE_PROPERTY, NULL);
 			indigo_delete_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
 			indigo_delete_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
@@ -723,6 +760,12 @@ indigo_result indigo_ccd_change_property(indigo_device *device, indigo_client *c
 		CCD_IMAGE_FORMAT_PROPERTY->state = INDIGO_OK_STATE;
 		indigo_update_property(device, CCD_IMAGE_FORMAT_PROPERTY, NULL);
 		return INDIGO_OK;
+	} else if (indigo_property_match_changeable(CCD_DSLR_RAW_MODE_PROPERTY, property)) {
+		// -------------------------------------------------------------------------------- CCD_DSLR_RAW_MODE
+		indigo_property_copy_values(CCD_DSLR_RAW_MODE_PROPERTY, property, false);
+		CCD_DSLR_RAW_MODE_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_DSLR_RAW_MODE_PROPERTY, NULL);
+		return INDIGO_OK;
 	} else if (indigo_property_match_changeable(CCD_UPLOAD_MODE_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- CCD_IMAGE_UPLOAD_MODE
 		indigo_property_copy_values(CCD_UPLOAD_MODE_PROPERTY, property, false);
@@ -938,6 +981,9 @@ indigo_result indigo_ccd_detach(indigo_device *device) {
 	indigo_release_property(CCD_FRAME_TYPE_PROPERTY);
 	indigo_release_property(CCD_IMAGE_FORMAT_PROPERTY);
 	indigo_release_property(CCD_IMAGE_FILE_PROPERTY);
+	indigo_release_property(CCD_RECORDER_STATISTICS_PROPERTY);
+	indigo_release_property(CCD_STREAMING_STATISTICS_PROPERTY);
+	indigo_release_property(CCD_DSLR_RAW_MODE_PROPERTY);
 	indigo_release_property(CCD_IMAGE_PROPERTY);
 	indigo_release_property(CCD_PREVIEW_IMAGE_PROPERTY);
 	indigo_release_property(CCD_PREVIEW_HISTOGRAM_PROPERTY);
@@ -962,7 +1008,7 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 	INDIGO_DEBUG(clock_t start = clock());
 	size_t size_in = frame_width * frame_height;
 	int sample_by = frame_width < STRECH_SAMPLE_SIZE ? 1 : frame_width / STRECH_SAMPLE_SIZE;
-	void *copy = indigo_safe_malloc(3 * size_in * bpp / 8);
+	void *copy = indigo_alloc_frame_buffer(3 * size_in * bpp / 8);
 	unsigned char *mem = NULL;
 	unsigned long mem_size = 0;
 	unsigned long *histo[3] = { NULL, NULL, NULL }, totals[3] = { 0, 0, 0 };
@@ -975,7 +1021,7 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 	/* Jump here in case of a decmpression error */
 	if (setjmp(cinfo.jpeg_error)) {
 		jpeg_destroy_compress(&cinfo.pub);
-		indigo_safe_free(copy);
+		indigo_free_frame_buffer(copy);
 		indigo_safe_free(histo[0]);
 		indigo_safe_free(histo[1]);
 		indigo_safe_free(histo[2]);
@@ -1081,7 +1127,7 @@ void indigo_raw_to_jpeg(indigo_device *device, void *data_in, int frame_width, i
 	jpeg_destroy_compress(&cinfo.pub);
 	*data_out = mem;
 	*size_out = mem_size;
-	indigo_safe_free(copy);
+	indigo_free_frame_buffer(copy);
 	if (histogram_data != NULL) {
 		uint8_t raw[128 * 256 * 3];
 		memset(raw, 0, sizeof(raw));
@@ -1510,11 +1556,42 @@ int mkpath(const char *path) {
 	return 0;
 }
 
+static void update_recorder_statistics(indigo_device *device, indigo_recorder *recorder, bool final) {
+	double rate;
+	int queue;
+	if (recorder == NULL)
+		return;
+	if (final) {
+		double elapsed = get_time_hd() - recorder->start_time;
+		rate = elapsed > 0 ? recorder->head / elapsed / (1024.0 * 1024.0) : 0;
+		queue = 0;
+	} else if (!indigo_recorder_statistics(recorder, &rate, &queue)) {
+		return;
+	}
+	CCD_RECORDER_STATISTICS_RATE_ITEM->number.value = round(rate * 10) / 10;
+	CCD_RECORDER_STATISTICS_QUEUE_ITEM->number.value = queue;
+	CCD_RECORDER_STATISTICS_FRAMES_ITEM->number.value = recorder->frames;
+	CCD_RECORDER_STATISTICS_DROPPED_ITEM->number.value = recorder->dropped;
+	CCD_RECORDER_STATISTICS_PROPERTY->state = recorder->error ? INDIGO_ALERT_STATE : final ? INDIGO_OK_STATE : INDIGO_BUSY_STATE;
+	indigo_update_property(device, CCD_RECORDER_STATISTICS_PROPERTY, NULL);
+}
+
+static void reset_recorder_statistics(indigo_device *device) {
+	for (int i = 0; i < CCD_RECORDER_STATISTICS_PROPERTY->count; i++)
+		CCD_RECORDER_STATISTICS_PROPERTY->items[i].number.value = 0;
+	CCD_RECORDER_STATISTICS_PROPERTY->state = INDIGO_BUSY_STATE;
+	indigo_update_property(device, CCD_RECORDER_STATISTICS_PROPERTY, NULL);
+}
+
 void indigo_process_image(indigo_device *device, void *data, int frame_width, int frame_height, int bpp, bool little_endian, bool byte_order_rgb, indigo_fits_keyword *keywords, bool streaming) {
 	assert(device != NULL);
 	assert(data != NULL);
 
 	INDIGO_DEBUG(clock_t start = clock());
+	// frames from frame ring carry the time of their commit, otherwise the frame is stamped now
+	struct timeval timestamp = CCD_CONTEXT->frame_timestamp;
+	if (!timerisset(&timestamp))
+		gettimeofday(&timestamp, NULL);
 	int horizontal_bin = CCD_BIN_HORIZONTAL_ITEM->number.value;
 	int vertical_bin = CCD_BIN_VERTICAL_ITEM->number.value;
 	int byte_per_pixel = bpp / 8;
@@ -1774,7 +1851,7 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 				*raw++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
 			}
 		} else if (byte_per_pixel == 1 && naxis == 3) {
-			unsigned char *raw = indigo_safe_malloc(3 * size);
+			unsigned char *raw = indigo_alloc_frame_buffer(3 * size);
 			unsigned char *red = raw;
 			unsigned char *green = raw + size;
 			unsigned char *blue = raw + 2 * size;
@@ -1785,9 +1862,9 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 				*blue++ = *tmp++;
 			}
 			memcpy(data + FITS_HEADER_SIZE, raw, 3 * size);
-			free(raw);
+			indigo_free_frame_buffer(raw);
 		} else if (byte_per_pixel == 2 && naxis == 3) {
-			uint16_t *raw = indigo_safe_malloc(6 * size);
+			uint16_t *raw = indigo_alloc_frame_buffer(6 * size);
 			uint16_t *red = raw;
 			uint16_t *green = raw + size;
 			uint16_t *blue = raw + 2 * size;
@@ -1801,7 +1878,7 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 				*blue++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
 			}
 			memcpy(data + FITS_HEADER_SIZE, raw, 6 * size);
-			free(raw);
+			indigo_free_frame_buffer(raw);
 		}
 		int mod2880 = blobsize % 2880;
 		if (mod2880) {
@@ -2017,8 +2094,10 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 					CCD_IMAGE_FILE_PROPERTY->state = INDIGO_OK_STATE;
 					if (use_avi) {
 						CCD_CONTEXT->video_stream = gwavi_open(file_name, frame_width, frame_height, "MJPG", 5);
+						reset_recorder_statistics(device);
 					} else if (use_ser) {
 						CCD_CONTEXT->video_stream = indigo_ser_open(file_name, data + FITS_HEADER_SIZE - sizeof(indigo_raw_header));
+						reset_recorder_statistics(device);
 					} else {
 						handle = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
 					}
@@ -2037,11 +2116,13 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 					CCD_IMAGE_FILE_PROPERTY->state = INDIGO_ALERT_STATE;
 					message = strerror(errno);
 				}
+				update_recorder_statistics(device, ((struct gwavi_t *)(CCD_CONTEXT->video_stream))->recorder, false);
 			} else if (use_ser) {
-				if (!indigo_ser_add_frame((indigo_ser *)(CCD_CONTEXT->video_stream), data + FITS_HEADER_SIZE - sizeof(indigo_raw_header), blobsize + sizeof(indigo_raw_header))) {
+				if (!indigo_ser_add_frame((indigo_ser *)(CCD_CONTEXT->video_stream), data + FITS_HEADER_SIZE - sizeof(indigo_raw_header), blobsize + sizeof(indigo_raw_header), &timestamp)) {
 					CCD_IMAGE_FILE_PROPERTY->state = INDIGO_ALERT_STATE;
 					message = strerror(errno);
 				}
+				update_recorder_statistics(device, ((indigo_ser *)(CCD_CONTEXT->video_stream))->recorder, false);
 			}
 		} else if (handle > 0) {
 			if (!indigo_write(handle, blob_value, blob_size)) {
@@ -2083,6 +2164,47 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		free(histogram_data);
 }
 
+static bool process_dslr_thumbnail(indigo_device *device, void *data, int data_size, bool streaming) {
+	void *thumbnail = NULL;
+	size_t thumbnail_size = 0;
+	if (indigo_dslr_raw_thumbnail(data, data_size, &thumbnail, &thumbnail_size) != LIBRAW_SUCCESS) {
+		INDIGO_ERROR(indigo_error("Embedded thumbnail can't be extracted, full RAW conversion is used"));
+		return false;
+	}
+	void * volatile image = NULL;
+	struct indigo_jpeg_decompress_struct cinfo;
+	struct jpeg_error_mgr jerr;
+	cinfo.pub.err = jpeg_std_error(&jerr);
+	jerr.error_exit = jpeg_decompress_error_callback;
+	if (setjmp(cinfo.jpeg_error)) {
+		jpeg_destroy_decompress(&cinfo.pub);
+		indigo_free_frame_buffer(image);
+		free(thumbnail);
+		INDIGO_ERROR(indigo_error("Embedded thumbnail decompression failed, full RAW conversion is used"));
+		return false;
+	}
+	jpeg_create_decompress(&cinfo.pub);
+	jpeg_mem_src(&cinfo.pub, thumbnail, thumbnail_size);
+	jpeg_read_header(&cinfo.pub, TRUE);
+	jpeg_start_decompress(&cinfo.pub);
+	int components = cinfo.pub.output_components;
+	int frame_width = cinfo.pub.output_width;
+	int frame_height = cinfo.pub.output_height;
+	int row_stride = frame_width * components;
+	image = indigo_alloc_frame_buffer(frame_height * row_stride + FITS_HEADER_SIZE);
+	while (cinfo.pub.output_scanline < cinfo.pub.output_height) {
+		unsigned char *buffer_array[1];
+		buffer_array[0] = (unsigned char *)image + FITS_HEADER_SIZE + (cinfo.pub.output_scanline) * row_stride;
+		jpeg_read_scanlines(&cinfo.pub, buffer_array, 1);
+	}
+	jpeg_finish_decompress(&cinfo.pub);
+	jpeg_destroy_decompress(&cinfo.pub);
+	free(thumbnail);
+	indigo_process_image(device, image, frame_width, frame_height, components * 8, true, true, NULL, streaming);
+	indigo_free_frame_buffer(image);
+	return true;
+}
+
 void indigo_process_dslr_image(indigo_device *device, void *data, int data_size, const char *suffix, bool streaming) {
 	assert(device != NULL);
 	assert(data != NULL);
@@ -2093,6 +2215,10 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 		*pnt = tolower(*pnt);
 	if (!strcmp(standard_suffix, ".jpg"))
 		strcpy(standard_suffix, ".jpeg");
+	if (CCD_DSLR_RAW_MODE_THUMBNAIL_ITEM->sw.value && strcmp(standard_suffix, ".jpeg") && (CCD_IMAGE_FORMAT_FITS_ITEM->sw.value || CCD_IMAGE_FORMAT_XISF_ITEM->sw.value || CCD_IMAGE_FORMAT_RAW_ITEM->sw.value)) {
+		if (process_dslr_thumbnail(device, data, data_size, streaming))
+			return;
+	}
 	if (CCD_IMAGE_FORMAT_RAW_ITEM->sw.value && !strcmp(standard_suffix, ".jpeg")) {
 		void *image = NULL;
 		struct indigo_jpeg_decompress_struct cinfo;
@@ -2103,7 +2229,7 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 		/* Jump here in case of a decmpression error */
 		if (setjmp(cinfo.jpeg_error)) {
 			if (image) {
-				free(image);
+				indigo_free_frame_buffer(image);
 				image = NULL;
 			}
 			jpeg_destroy_decompress(&cinfo.pub);
@@ -2121,7 +2247,7 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 			int frame_height = cinfo.pub.output_height;
 			int row_stride = frame_width * components;
 			int image_size = frame_height * row_stride;
-			image = indigo_safe_malloc(image_size + FITS_HEADER_SIZE);
+			image = indigo_alloc_frame_buffer(image_size + FITS_HEADER_SIZE);
 			while (cinfo.pub.output_scanline < cinfo.pub.output_height) {
 				unsigned char *buffer_array[1];
 				buffer_array[0] = image + FITS_HEADER_SIZE + (cinfo.pub.output_scanline) * row_stride;
@@ -2175,7 +2301,7 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 				indigo_update_property(device, CCD_IMAGE_PROPERTY, NULL);
 				INDIGO_DEBUG(indigo_debug("Client upload in %gs", (clock() - start) / (double)CLOCKS_PER_SEC));
 			}
-			free(image);
+			indigo_free_frame_buffer(image);
 			return;
 		}
 	} else if (CCD_IMAGE_FORMAT_FITS_ITEM->sw.value || CCD_IMAGE_FORMAT_XISF_ITEM->sw.value || CCD_IMAGE_FORMAT_RAW_ITEM->sw.value) {
@@ -2183,10 +2309,7 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 		indigo_dslr_raw_image_s output_image = {0};
 		indigo_dslr_raw_image_info_s image_info;
 		int rc;
-		rc = indigo_dslr_raw_image_info((void *)data, data_size, &image_info);
-		if (rc == LIBRAW_SUCCESS) {
-			rc = indigo_dslr_raw_process_image((void *)data, data_size, &output_image);
-		}
+		rc = indigo_dslr_raw_process_image_with_info((void *)data, data_size, CCD_DSLR_RAW_MODE_BIN_2X2_ITEM->sw.value, &output_image, &image_info);
 		if (rc != LIBRAW_SUCCESS) {
 			if (output_image.data != NULL) free(output_image.data);
 			INDIGO_ERROR(indigo_error("Selected source format cannot be converted"));
@@ -2194,21 +2317,21 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 			indigo_update_property(device, CCD_IMAGE_PROPERTY, "Selected source format cannot be converted, please use camera RAW as a source");
 			return;
 		}
-		indigo_fits_keyword keywords[] = {
-			{ INDIGO_FITS_STRING, "BAYERPAT", .string = output_image.bayer_pattern, "Bayer color pattern" },
-			{ INDIGO_FITS_NUMBER, "ISOSPEED", .number = image_info.iso_speed, "ISO camera setting" },
-			{ 0 }, //Placeholder for trmerature
-			{ 0 }
-		};
-		int index = 1;
+		indigo_fits_keyword keywords[4] = { 0 };
+		int index = 0;
+		// binned image is monochrome
+		if (*output_image.bayer_pattern) {
+			keywords[index++] = (indigo_fits_keyword) { INDIGO_FITS_STRING, "BAYERPAT", .string = output_image.bayer_pattern, "Bayer color pattern" };
+		}
+		keywords[index++] = (indigo_fits_keyword) { INDIGO_FITS_NUMBER, "ISOSPEED", .number = image_info.iso_speed, "ISO camera setting" };
 		if (image_info.temperature > -273.15f) {
 			keywords[index++] = (indigo_fits_keyword) { INDIGO_FITS_NUMBER, "CCD-TEMP", .number = image_info.temperature, "CCD temperature [celcius]"};
 		}
-		image = indigo_alloc_blob_buffer(output_image.size + FITS_HEADER_SIZE);
+		image = indigo_alloc_frame_buffer(output_image.size + FITS_HEADER_SIZE);
 		memcpy(image + FITS_HEADER_SIZE, output_image.data, output_image.size);
 		free(output_image.data);
 		indigo_process_image(device, image, output_image.width, output_image.height, output_image.bits, true, true, keywords, streaming);
-		free(image);
+		indigo_free_frame_buffer(image);
 		return;
 	}
 	if (CCD_UPLOAD_MODE_LOCAL_ITEM->sw.value || CCD_UPLOAD_MODE_BOTH_ITEM->sw.value) {
@@ -2244,6 +2367,7 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 						jpeg_read_header(&cinfo.pub, TRUE);
 						jpeg_destroy_decompress(&cinfo.pub);
 						CCD_CONTEXT->video_stream = gwavi_open(file_name, cinfo.pub.image_width, cinfo.pub.image_height, "MJPG", 5);
+						reset_recorder_statistics(device);
 					} else {
 						handle = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
 					}
@@ -2262,6 +2386,7 @@ void indigo_process_dslr_image(indigo_device *device, void *data, int data_size,
 					CCD_IMAGE_FILE_PROPERTY->state = INDIGO_ALERT_STATE;
 					message = strerror(errno);
 				}
+				update_recorder_statistics(device, ((struct gwavi_t *)(CCD_CONTEXT->video_stream))->recorder, false);
 			}
 		} else if (handle > 0) {
 			if (!indigo_write(handle, data, data_size)) {
@@ -2309,14 +2434,16 @@ void indigo_process_dslr_preview_image(indigo_device *device, void *data, int bl
 void indigo_finalize_video_stream(indigo_device *device) {
 	if (CCD_CONTEXT->video_stream) {
 		if (CCD_IMAGE_FORMAT_JPEG_AVI_ITEM->sw.value) {
-			gwavi_close((struct gwavi_t *)(CCD_CONTEXT->video_stream));
+			struct gwavi_t *gwavi = (struct gwavi_t *)(CCD_CONTEXT->video_stream);
+			update_recorder_statistics(device, gwavi->recorder, true);
+			CCD_IMAGE_FILE_PROPERTY->state = gwavi_close(gwavi) ? INDIGO_OK_STATE : INDIGO_ALERT_STATE;
 			CCD_CONTEXT->video_stream = NULL;
-			CCD_IMAGE_FILE_PROPERTY->state = INDIGO_OK_STATE;
 			indigo_update_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
 		} else if (CCD_IMAGE_FORMAT_RAW_SER_ITEM->sw.value) {
-			indigo_ser_close((indigo_ser *)(CCD_CONTEXT->video_stream));
+			indigo_ser *ser = (indigo_ser *)(CCD_CONTEXT->video_stream);
+			update_recorder_statistics(device, ser->recorder, true);
+			CCD_IMAGE_FILE_PROPERTY->state = indigo_ser_close(ser) ? INDIGO_OK_STATE : INDIGO_ALERT_STATE;
 			CCD_CONTEXT->video_stream = NULL;
-			CCD_IMAGE_FILE_PROPERTY->state = INDIGO_OK_STATE;
 			indigo_update_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
 		}
 	}
@@ -2325,14 +2452,173 @@ void indigo_finalize_video_stream(indigo_device *device) {
 void indigo_finalize_dslr_video_stream(indigo_device *device) {
 	if (CCD_CONTEXT->video_stream) {
 		if (CCD_IMAGE_FORMAT_NATIVE_AVI_ITEM->sw.value) {
-			gwavi_close((struct gwavi_t *)(CCD_CONTEXT->video_stream));
+			struct gwavi_t *gwavi = (struct gwavi_t *)(CCD_CONTEXT->video_stream);
+			update_recorder_statistics(device, gwavi->recorder, true);
+			CCD_IMAGE_FILE_PROPERTY->state = gwavi_close(gwavi) ? INDIGO_OK_STATE : INDIGO_ALERT_STATE;
 			CCD_CONTEXT->video_stream = NULL;
-			CCD_IMAGE_FILE_PROPERTY->state = INDIGO_OK_STATE;
 			indigo_update_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
 		}
 	}
 }
 
+// -------------------------------------------------------------------------------- Video frame ring
+
+// must be called with ring mutex locked, unless final is set the property is updated at most once per second
+
+static bool update_streaming_statistics(indigo_frame_ring *ring, bool final) {
+	indigo_device *device = ring->device;
+	double now = get_time_hd();
+	if (!final && now - ring->statistics_time < 1)
+		return false;
+	ring->statistics_time = now;
+	double elapsed = now - ring->start_time;
+	CCD_STREAMING_STATISTICS_DELIVERED_ITEM->number.value = ring->delivered;
+	CCD_STREAMING_STATISTICS_DROPPED_ITEM->number.value = ring->dropped;
+	CCD_STREAMING_STATISTICS_FPS_ITEM->number.value = elapsed > 0 ? ring->delivered / elapsed : 0;
+	CCD_STREAMING_STATISTICS_PROPERTY->state = final ? INDIGO_OK_STATE : INDIGO_BUSY_STATE;
+	return true;
+}
+
+static void *frame_ring_process(indigo_frame_ring *ring) {
+	indigo_device *device = ring->device;
+	pthread_mutex_lock(&ring->mutex);
+	while (true) {
+		while (ring->running && ring->queue_count == 0)
+			pthread_cond_wait(&ring->cond, &ring->mutex);
+		if (ring->queue_count == 0 || (!ring->running && !ring->flush))
+			break;
+		int index = ring->queue[ring->queue_head];
+		ring->queue_head = (ring->queue_head + 1) % ring->count;
+		ring->queue_count--;
+		ring->processing = index;
+		CCD_CONTEXT->frame_timestamp = ring->timestamp[index];
+		pthread_mutex_unlock(&ring->mutex);
+		ring->process(device, ring->buffers[index], ring->width[index], ring->height[index], ring->bpp[index]);
+		pthread_mutex_lock(&ring->mutex);
+		timerclear(&CCD_CONTEXT->frame_timestamp);
+		ring->processing = -1;
+		ring->delivered++;
+		bool update = update_streaming_statistics(ring, false);
+		pthread_cond_broadcast(&ring->cond);
+		pthread_mutex_unlock(&ring->mutex);
+		if (update)
+			indigo_update_property(device, CCD_STREAMING_STATISTICS_PROPERTY, NULL);
+		pthread_mutex_lock(&ring->mutex);
+	}
+	ring->dropped += ring->queue_count;
+	ring->queue_count = 0;
+	update_streaming_statistics(ring, true);
+	pthread_mutex_unlock(&ring->mutex);
+	indigo_update_property(device, CCD_STREAMING_STATISTICS_PROPERTY, NULL);
+	return NULL;
+}
+
+indigo_frame_ring *indigo_frame_ring_create(indigo_device *device, int count, long size, void (*process)(indigo_device *device, void *data, int width, int height, int bpp)) {
+	if (count * size > INDIGO_FRAME_RING_MEMORY_LIMIT)
+		count = (int)(INDIGO_FRAME_RING_MEMORY_LIMIT / size);
+	if (count < 2)
+		count = 2;
+	indigo_frame_ring *ring = indigo_safe_malloc(sizeof(indigo_frame_ring));
+	ring->device = device;
+	ring->process = process;
+	ring->count = count;
+	ring->size = size;
+	ring->buffers = indigo_safe_malloc(count * sizeof(void *));
+	for (int i = 0; i < count; i++)
+		ring->buffers[i] = indigo_alloc_frame_buffer(size);
+	ring->width = indigo_safe_malloc(count * sizeof(int));
+	ring->height = indigo_safe_malloc(count * sizeof(int));
+	ring->bpp = indigo_safe_malloc(count * sizeof(int));
+	ring->timestamp = indigo_safe_malloc(count * sizeof(struct timeval));
+	ring->queue = indigo_safe_malloc(count * sizeof(int));
+	ring->writing = ring->processing = -1;
+	ring->start_time = get_time_hd();
+	ring->running = true;
+	pthread_mutex_init(&ring->mutex, NULL);
+	pthread_cond_init(&ring->cond, NULL);
+	ring->statistics_time = ring->start_time;
+	CCD_STREAMING_STATISTICS_DELIVERED_ITEM->number.value = 0;
+	CCD_STREAMING_STATISTICS_DROPPED_ITEM->number.value = 0;
+	CCD_STREAMING_STATISTICS_FPS_ITEM->number.value = 0;
+	CCD_STREAMING_STATISTICS_PROPERTY->state = INDIGO_BUSY_STATE;
+	indigo_update_property(device, CCD_STREAMING_STATISTICS_PROPERTY, NULL);
+	if (pthread_create(&ring->thread, NULL, (void *(*)(void *))frame_ring_process, ring)) {
+		ring->running = false;
+		indigo_frame_ring_delete(ring, false);
+		return NULL;
+	}
+	INDIGO_DEBUG(indigo_debug("%s: frame ring with %d buffers of %ld bytes created", device->name, count, size));
+	return ring;
+}
+
+void *indigo_frame_ring_acquire(indigo_frame_ring *ring) {
+	pthread_mutex_lock(&ring->mutex);
+	int index = -1;
+	for (int i = 0; i < ring->count && index < 0; i++) {
+		if (i == ring->processing)
+			continue;
+		index = i;
+		for (int j = 0; j < ring->queue_count; j++) {
+			if (ring->queue[(ring->queue_head + j) % ring->count] == i) {
+				index = -1;
+				break;
+			}
+		}
+	}
+	if (index < 0) {
+		// all buffers are queued or processed, drop the oldest queued frame and reuse its buffer
+		index = ring->queue[ring->queue_head];
+		ring->queue_head = (ring->queue_head + 1) % ring->count;
+		ring->queue_count--;
+		ring->dropped++;
+	}
+	ring->writing = index;
+	pthread_mutex_unlock(&ring->mutex);
+	return ring->buffers[index];
+}
+
+void indigo_frame_ring_commit(indigo_frame_ring *ring, int width, int height, int bpp) {
+	pthread_mutex_lock(&ring->mutex);
+	int index = ring->writing;
+	if (index >= 0) {
+		ring->width[index] = width;
+		ring->height[index] = height;
+		ring->bpp[index] = bpp;
+		gettimeofday(&ring->timestamp[index], NULL);
+		ring->queue[(ring->queue_head + ring->queue_count) % ring->count] = index;
+		ring->queue_count++;
+		ring->writing = -1;
+		pthread_cond_broadcast(&ring->cond);
+	}
+	pthread_mutex_unlock(&ring->mutex);
+}
+
+void indigo_frame_ring_delete(indigo_frame_ring *ring, bool flush) {
+	if (ring == NULL)
+		return;
+	pthread_mutex_lock(&ring->mutex);
+	bool joinable = ring->running;
+	ring->running = false;
+	ring->flush = flush;
+	pthread_cond_broadcast(&ring->cond);
+	pthread_mutex_unlock(&ring->mutex);
+	if (joinable)
+		pthread_join(ring->thread, NULL);
+	indigo_device *device = ring->device;
+	INDIGO_DEBUG(indigo_debug("%s: frame ring deleted, %ld frames delivered, %ld frames dropped", device->name, ring->delivered, ring->dropped));
+	for (int i = 0; i < ring->count; i++)
+		indigo_free_frame_buffer(ring->buffers[i]);
+	indigo_safe_free(ring->buffers);
+	indigo_safe_free(ring->width);
+	indigo_safe_free(ring->height);
+	indigo_safe_free(ring->bpp);
+	indigo_safe_free(ring->timestamp);
+	indigo_safe_free(ring->queue);
+	pthread_cond_destroy(&ring->cond);
+	pthread_mutex_destroy(&ring->mutex);
+	indigo_safe_free(ring);
+}
+
 // use formats like this:
 //	..., "%%20d", int_value);
 //	..., "%%20f", double_value);
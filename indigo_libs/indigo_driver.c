@@ -947,11 +947,14 @@ static void *hotplug_thread(void *arg) {
 
 void indigo_start_usb_event_handler() {
 	static bool thread_started = false;
+	static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+	pthread_mutex_lock(&mutex);
 	if (!thread_started) {
 		libusb_init(NULL);
 		indigo_async(hotplug_thread, NULL);
 		thread_started = true;
 	}
+	pthread_mutex_unlock(&mutex);
 }
 
 /* TO BE REMOVED!
@@ -29,10 +29,13 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <errno.h>
 #include <pthread.h>
 #include <assert.h>
 #include <stdint.h>
 #include <arpa/inet.h>
+#include <sys/uio.h>
+#include <zlib.h>
 
 
 #include <indigo/indigo_json.h>
@@ -43,24 +46,98 @@
 
 static pthread_mutex_t json_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-static bool ws_write(int handle, const char *buffer, long length) {
-	uint8_t header[10] = { 0x81 };
-	bool result;
+static z_stream *deflater = NULL;
+static unsigned char *deflate_buffer = NULL;
+static unsigned long deflate_buffer_size = 0;
+
+static long ws_deflate(const char *buffer, long length) {
+	if (deflater == NULL) {
+		deflater = indigo_safe_malloc(sizeof(z_stream));
+		if (deflateInit2(deflater, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+			indigo_error("JSON Adapter: failed to initialize permessage-deflate");
+			free(deflater);
+			deflater = NULL;
+			return -1;
+		}
+	} else {
+		deflateReset(deflater);
+	}
+	unsigned long bound = deflateBound(deflater, length) + 16;
+	if (bound > deflate_buffer_size) {
+		deflate_buffer = indigo_safe_realloc(deflate_buffer, deflate_buffer_size = bound);
+	}
+	deflater->next_in = (Bytef *)buffer;
+	deflater->avail_in = (uInt)length;
+	deflater->next_out = deflate_buffer;
+	deflater->avail_out = (uInt)deflate_buffer_size;
+	if (deflate(deflater, Z_SYNC_FLUSH) != Z_OK || deflater->avail_in > 0) {
+		return -1;
+	}
+	// RFC7692 7.2.1 - remove 0x00 0x00 0xFF 0xFF tail of the sync flush
+	return deflate_buffer_size - deflater->avail_out - 4;
+}
+
+static bool ws_writev(int handle, struct iovec *iov, int count) {
+	while (count > 0) {
+		ssize_t bytes_written = writev(handle, iov, count);
+		if (bytes_written < 0) {
+			if (errno == EINTR)
+				continue;
+			INDIGO_ERROR(indigo_error("%d <- // %s", handle, strerror(errno)));
+			return false;
+		}
+		while (count > 0 && bytes_written >= (ssize_t)iov->iov_len) {
+			bytes_written -= iov->iov_len;
+			iov++;
+			count--;
+		}
+		if (count > 0) {
+			iov->iov_base = (char *)iov->iov_base + bytes_written;
+			iov->iov_len -= bytes_written;
+		}
+	}
+	return true;
+}
+
+static bool ws_write(indigo_adapter_context *client_context, const char *buffer, long length) {
+	uint8_t header[10] = { WS_FIN | WS_OPCODE_TEXT };
+	if (client_context->web_socket_deflate && length >= WS_DEFLATE_THRESHOLD) {
+		long compressed_length = ws_deflate(buffer, length);
+		if (compressed_length > 0 && compressed_length < length) {
+			header[0] |= WS_RSV1;
+			buffer = (const char *)deflate_buffer;
+			length = compressed_length;
+		}
+	}
+	struct iovec iov[2];
+	iov[0].iov_base = header;
 	if (length <= 0x7D) {
 		header[1] = length;
-		result = indigo_write(handle, (char *)header, 2);
+		iov[0].iov_len = 2;
 	} else if (length <= 0xFFFF) {
 		header[1] = 0x7E;
 		uint16_t payloadLength = htons(length);
 		memcpy(header+2, &payloadLength, 2);
-		result = indigo_write(handle, (char *)header, 4);
+		iov[0].iov_len = 4;
 	} else {
 		header[1] = 0x7F;
 		uint64_t payloadLength = htonll(length);
 		memcpy(header+2, &payloadLength, 8);
-		result = indigo_write(handle, (char *)header, 10);
+		iov[0].iov_len = 10;
 	}
-	result = result && indigo_write(handle, buffer, length);
+	iov[1].iov_base = (void *)buffer;
+	iov[1].iov_len = length;
+	return ws_writev(client_context->output, iov, 2);
+}
+
+bool indigo_json_ws_control(int handle, uint8_t opcode, const char *payload, long length) {
+	if (length > 0x7D)
+		return false;
+	uint8_t header[2] = { WS_FIN | opcode, length };
+	struct iovec iov[2] = { { header, 2 }, { (void *)payload, length } };
+	pthread_mutex_lock(&json_mutex);
+	bool result = ws_writev(handle, iov, length > 0 ? 2 : 1);
+	pthread_mutex_unlock(&json_mutex);
 	return result;
 }
 
@@ -190,7 +267,7 @@ static indigo_result json_define_property(indigo_client *client, indigo_device *
 			size += pnt - output_buffer;
 			break;
 	}
-	if (client_context->web_socket ? ws_write(handle, output_buffer, size) : indigo_write(handle, output_buffer, size)) {
+	if (client_context->web_socket ? ws_write(client_context, output_buffer, size) : indigo_write(handle, output_buffer, size)) {
 		INDIGO_TRACE_PROTOCOL(indigo_trace("%d <- %s\n", handle, output_buffer));
 	} else {
 		INDIGO_TRACE_PROTOCOL(indigo_trace("%d <- FAILED\n", handle));
@@ -308,7 +385,7 @@ static indigo_result json_update_property(indigo_client *client, indigo_device *
 			size += pnt - output_buffer;
 			break;
 	}
-	if (client_context->web_socket ? ws_write(handle, output_buffer, size) : indigo_write(handle, output_buffer, size)) {
+	if (client_context->web_socket ? ws_write(client_context, output_buffer, size) : indigo_write(handle, output_buffer, size)) {
 		INDIGO_TRACE_PROTOCOL(indigo_trace("%d <- %s\n", handle, output_buffer));
 	} else {
 		INDIGO_TRACE_PROTOCOL(indigo_trace("%d <- FAILED\n", handle));
@@ -351,11 +428,7 @@ static indigo_result json_delete_property(indigo_client *client, indigo_device *
 		size = sprintf(pnt, " } }");
 	}
 	size += pnt - output_buffer;
-	if (client_context->web_socket)
-		ws_write(handle, output_buffer, size);
-	else
-		indigo_write(handle, output_buffer, size);
-	if (client_context->web_socket ? ws_write(handle, output_buffer, size) : indigo_write(handle, output_buffer, size)) {
+	if (client_context->web_socket ? ws_write(client_context, output_buffer, size) : indigo_write(handle, output_buffer, size)) {
 		INDIGO_TRACE_PROTOCOL(indigo_trace("%d <- %s\n", handle, output_buffer));
 	} else {
 		INDIGO_TRACE_PROTOCOL(indigo_trace("%d <- FAILED\n", handle));
@@ -384,7 +457,7 @@ static indigo_result json_message_property(indigo_client *client, indigo_device
 	char *output_buffer = indigo_safe_malloc(JSON_BUFFER_SIZE);
 	char *pnt = output_buffer;
 	long size = sprintf(pnt, "{ \"message\": \"%s\" }", message);
-	if (client_context->web_socket ? ws_write(handle, output_buffer, size) : indigo_write(handle, output_buffer, size)) {
+	if (client_context->web_socket ? ws_write(client_context, output_buffer, size) : indigo_write(handle, output_buffer, size)) {
 		INDIGO_TRACE_PROTOCOL(indigo_trace("%d <- %s\n", handle, output_buffer));
 	} else {
 		INDIGO_TRACE_PROTOCOL(indigo_trace("%d <- FAILED\n", handle));
@@ -24,9 +24,103 @@
 #include <unistd.h>
 #include <stdbool.h>
 #include <errno.h>
+#include <pthread.h>
 #include <indigo/indigo_bus.h>
 #include <indigo/indigo_dslr_raw.h>
 
+#define MAX_COPY_THREADS	8
+#define MIN_THREAD_PIXELS	(1024 * 1024)
+
+static pthread_key_t context_key;
+static pthread_once_t context_key_once = PTHREAD_ONCE_INIT;
+
+static void context_destructor(void *raw_data) {
+	libraw_close((libraw_data_t *)raw_data);
+}
+
+static void context_key_init(void) {
+	pthread_key_create(&context_key, context_destructor);
+}
+
+/* LibRaw context is expensive to create (it allocates several MB), so it is created once per thread and recycled after each use */
+static libraw_data_t *get_context(void) {
+	pthread_once(&context_key_once, context_key_init);
+	libraw_data_t *raw_data = pthread_getspecific(context_key);
+	if (raw_data == NULL) {
+		raw_data = libraw_init(0);
+		if (raw_data != NULL)
+			pthread_setspecific(context_key, raw_data);
+	}
+	return raw_data;
+}
+
+static void release_context(libraw_data_t *raw_data) {
+	libraw_free_image(raw_data);
+	libraw_recycle(raw_data);
+}
+
+static void get_image_info(libraw_data_t *raw_data, indigo_dslr_raw_image_info_s *image_info) {
+	strncpy(image_info->camera_make, raw_data->idata.make, sizeof(image_info->camera_make));
+	strncpy(image_info->camera_model, raw_data->idata.model, sizeof(image_info->camera_model));
+	strncpy(image_info->normalized_camera_make, raw_data->idata.normalized_make, sizeof(image_info->normalized_camera_make));
+	strncpy(image_info->normalized_camera_model, raw_data->idata.normalized_model, sizeof(image_info->normalized_camera_model));
+	strncpy(image_info->lens, raw_data->lens.Lens, sizeof(image_info->lens));
+	strncpy(image_info->lens_make, raw_data->lens.LensMake, sizeof(image_info->lens_make));
+	image_info->raw_height = raw_data->sizes.raw_height;
+	image_info->raw_width = raw_data->sizes.raw_width;
+	image_info->iheight = raw_data->sizes.iheight;
+	image_info->iwidth = raw_data->sizes.iwidth;
+	image_info->top_margin = raw_data->sizes.top_margin;
+	image_info->left_margin = raw_data->sizes.left_margin;
+	image_info->iso_speed = raw_data->other.iso_speed;
+	image_info->shutter = raw_data->other.shutter;
+	image_info->aperture = raw_data->other.aperture;
+	image_info->focal_len = raw_data->other.focal_len;
+	image_info->timestamp = raw_data->other.timestamp;
+	image_info->temperature = -273.15f;
+	if (raw_data->makernotes.common.SensorTemperature > -273.15f) {
+		 image_info->temperature = raw_data->makernotes.common.SensorTemperature;
+	} else if (raw_data->makernotes.common.CameraTemperature > -273.15f) {
+		 image_info->temperature = raw_data->makernotes.common.CameraTemperature;
+	}
+	strncpy(image_info->desc, raw_data->other.desc, sizeof(image_info->desc));
+	strncpy(image_info->artist, raw_data->other.artist, sizeof(image_info->artist));
+}
+
+typedef struct {
+	const uint16_t *source;
+	uint16_t *destination;
+	int raw_width;
+	int width;
+	int first_row;
+	int last_row;
+	int height;
+	bool binning;
+} copy_task;
+
+static void *copy_rows(copy_task *task) {
+	const uint16_t *source = task->source;
+	int raw_width = task->raw_width;
+	int width = task->width;
+	for (int row = task->first_row; row < task->last_row; row++) {
+#ifdef FIT_FORMAT_AMATEUR_CCD
+		uint16_t *destination = task->destination + (size_t)row * width;
+#else
+		uint16_t *destination = task->destination + (size_t)(task->height - 1 - row) * width;
+#endif
+		if (task->binning) {
+			/* each output pixel is the mean of one 2x2 CFA cell */
+			const uint16_t *line_0 = source + (size_t)(2 * row) * raw_width;
+			const uint16_t *line_1 = line_0 + raw_width;
+			for (int col = 0; col < width; col++)
+				destination[col] = (line_0[2 * col] + line_0[2 * col + 1] + line_1[2 * col] + line_1[2 * col + 1]) / 4;
+		} else {
+			memcpy(destination, source + (size_t)row * raw_width, width * sizeof(uint16_t));
+		}
+	}
+	return NULL;
+}
+
 static int image_debayered_data(libraw_data_t *raw_data, indigo_dslr_raw_image_s *outout_image) {
 	int rc;
 	libraw_processed_image_t *processed_image = NULL;
@@ -91,11 +185,8 @@ cleanup:
 
 static int image_bayered_data(libraw_data_t *raw_data, indigo_dslr_raw_image_s *outout_image, const bool binning) {
 	uint16_t *data;
-	uint16_t width, height, raw_width;
-	uint32_t npixels;
-	uint32_t offset;
+	uint16_t width, height;
 	size_t size;
-	uint32_t i = 0;
 
 	if (raw_data->sizes.iheight > raw_data->sizes.raw_height) {
 		indigo_error("Images with raw_height < image_height are not supported");
@@ -103,46 +194,54 @@ static int image_bayered_data(libraw_data_t *raw_data, indigo_dslr_raw_image_s *
 	}
 
 	if (binning) {
-		width = raw_data->sizes.iwidth % 2 == 0 ? raw_data->sizes.iwidth : raw_data->sizes.iwidth - 1;
-		height = raw_data->sizes.iheight % 2 == 0 ? raw_data->sizes.iheight : raw_data->sizes.iheight - 1;
+		width = raw_data->sizes.iwidth / 2;
+		height = raw_data->sizes.iheight / 2;
 	} else {
 		width = raw_data->sizes.iwidth;
 		height = raw_data->sizes.iheight;
 	}
-	raw_width = raw_data->sizes.raw_width;
-	npixels = width * height;
-	offset = raw_width * raw_data->rawdata.sizes.top_margin +
-		raw_data->rawdata.sizes.left_margin;
-	size = binning ? npixels / 4 * sizeof(uint16_t) : npixels * sizeof(uint16_t);
+	size = (size_t)width * height * sizeof(uint16_t);
 
-	data = (uint16_t *)calloc(1, size);
+	data = (uint16_t *)malloc(size);
 	if (!data) {
 		indigo_error("%s", strerror(errno));
 		return -errno;
 	}
-	outout_image->width = binning ? width / 2 : width;
-	outout_image->height = binning ? height / 2 : height;
+	outout_image->width = width;
+	outout_image->height = height;
 	outout_image->size = size;
 
-	int c = binning ? 2 : 1;
-#ifdef FIT_FORMAT_AMATEUR_CCD
-	for (int row = 0; row < height; row += c) {
-#else
-	for (int row = height - 1; row >= 0; row -= c) {
-#endif
-		for (int col = 0; col < width; col += c) {
-			if (binning) {
-				data[i++] = (
-					raw_data->rawdata.raw_image[offset + col + 0 + (raw_width * row)] +     /* R */
-					raw_data->rawdata.raw_image[offset + col + 1 + (raw_width * row)] +     /* G */
-					raw_data->rawdata.raw_image[offset + col + 2 + (raw_width * row)] +     /* G */
-					raw_data->rawdata.raw_image[offset + col + 3 + (raw_width * row)]       /* B */
-				) / 4;
-			} else {
-				data[i++] = raw_data->rawdata.raw_image[offset + col + (raw_width * row)];
-			}
-		}
+	copy_task tasks[MAX_COPY_THREADS];
+	pthread_t threads[MAX_COPY_THREADS];
+	int count = (int)(((size_t)raw_data->sizes.iwidth * raw_data->sizes.iheight) / MIN_THREAD_PIXELS);
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count > cpus)
+		count = (int)cpus;
+	if (count > MAX_COPY_THREADS)
+		count = MAX_COPY_THREADS;
+	if (count < 1)
+		count = 1;
+	for (int i = 0; i < count; i++) {
+		tasks[i].source = raw_data->rawdata.raw_image + raw_data->sizes.raw_width * raw_data->rawdata.sizes.top_margin + raw_data->rawdata.sizes.left_margin;
+		tasks[i].destination = data;
+		tasks[i].raw_width = raw_data->sizes.raw_width;
+		tasks[i].width = width;
+		tasks[i].height = height;
+		tasks[i].first_row = height * i / count;
+		tasks[i].last_row = height * (i + 1) / count;
+		tasks[i].binning = binning;
+	}
+	/* rows are split between threads, the last part is copied on the calling thread */
+	int started = 0;
+	for (int i = 0; i < count - 1; i++) {
+		if (pthread_create(&threads[i], NULL, (void *(*)(void *))copy_rows, &tasks[i]))
+			break;
+		started++;
 	}
+	for (int i = started; i < count; i++)
+		copy_rows(&tasks[i]);
+	for (int i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
 
 	outout_image->data = data;
 	outout_image->colors = 1;
@@ -150,7 +249,7 @@ static int image_bayered_data(libraw_data_t *raw_data, indigo_dslr_raw_image_s *
 	return 0;
 }
 
-int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_raw_image_s *outout_image) {
+int indigo_dslr_raw_process_image_with_info(void *buffer, size_t buffer_size, bool binning, indigo_dslr_raw_image_s *outout_image, indigo_dslr_raw_image_info_s *image_info) {
 	int rc;
 	libraw_data_t *raw_data;
 
@@ -167,7 +266,11 @@ int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_
 	clock_t start = clock();
 #endif
 
-	raw_data = libraw_init(0);
+	raw_data = get_context();
+	if (raw_data == NULL) {
+		indigo_error("libraw_init failed");
+		return LIBRAW_UNSPECIFIED_ERROR;
+	}
 
 	/* These work fine for astro - change with caution */
 	/* Linear 16-bit output. */
@@ -195,16 +298,21 @@ int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_
 		goto cleanup;
 	}
 
+	if (image_info != NULL)
+		get_image_info(raw_data, image_info);
+
 	rc = libraw_unpack(raw_data);
 	if (rc != LIBRAW_SUCCESS) {
 		indigo_error( "[rc:%d] libraw_unpack failed: '%s'", rc, libraw_strerror(rc));
 		goto cleanup;
 	}
 
-	outout_image->bayer_pattern[0] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 2, 2)];
-	outout_image->bayer_pattern[1] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 2, 3)];
-	outout_image->bayer_pattern[2] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 3, 2)];
-	outout_image->bayer_pattern[3] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 3, 3)];
+	if (!binning) {
+		outout_image->bayer_pattern[0] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 2, 2)];
+		outout_image->bayer_pattern[1] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 2, 3)];
+		outout_image->bayer_pattern[2] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 3, 2)];
+		outout_image->bayer_pattern[3] = raw_data->idata.cdesc[libraw_COLOR(raw_data, 3, 3)];
+	}
 
 	indigo_debug("Maker       : %s, Model      : %s", raw_data->idata.make, raw_data->idata.model);
 	indigo_debug("Norm Maker  : %s, Norm Model : %s", raw_data->idata.normalized_make, raw_data->idata.normalized_model);
@@ -214,8 +322,8 @@ int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_
 	indigo_debug("left_margin = %d, top_margin = %d", raw_data->sizes.left_margin, raw_data->sizes.top_margin);
 	indigo_debug("bayerpat    : %s, cdesc      : %s", outout_image->bayer_pattern, raw_data->idata.cdesc);
 
-	if (raw_data->params.user_qual > 20) {
-		rc = image_bayered_data(raw_data, outout_image, false);
+	if (raw_data->params.user_qual > 20 || binning) {
+		rc = image_bayered_data(raw_data, outout_image, binning);
 		if (rc) goto cleanup;
 		outout_image->debayered = false;
 	} else {
@@ -241,13 +349,15 @@ int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_
 #endif
 
 cleanup:
-	libraw_free_image(raw_data);
-	libraw_recycle(raw_data);
-	libraw_close(raw_data);
+	release_context(raw_data);
 
 	return rc;
 }
 
+int indigo_dslr_raw_process_image(void *buffer, size_t buffer_size, indigo_dslr_raw_image_s *outout_image) {
+	return indigo_dslr_raw_process_image_with_info(buffer, buffer_size, false, outout_image, NULL);
+}
+
 int indigo_dslr_raw_image_info(void *buffer, size_t buffer_size, indigo_dslr_raw_image_info_s *image_info) {
 	int rc;
 	libraw_data_t *raw_data;
@@ -260,7 +370,11 @@ int indigo_dslr_raw_image_info(void *buffer, size_t buffer_size, indigo_dslr_raw
 #if !defined(INDIGO_WINDOWS)
 	clock_t start = clock();
 #endif
-	raw_data = libraw_init(0);
+	raw_data = get_context();
+	if (raw_data == NULL) {
+		indigo_error("libraw_init failed");
+		return LIBRAW_UNSPECIFIED_ERROR;
+	}
 
 	rc = libraw_open_buffer(raw_data, buffer, buffer_size);
 	if (rc != LIBRAW_SUCCESS) {
@@ -268,31 +382,7 @@ int indigo_dslr_raw_image_info(void *buffer, size_t buffer_size, indigo_dslr_raw
 		goto cleanup;
 	}
 
-	strncpy(image_info->camera_make, raw_data->idata.make, sizeof(image_info->camera_make));
-	strncpy(image_info->camera_model, raw_data->idata.model, sizeof(image_info->camera_model));
-	strncpy(image_info->normalized_camera_make, raw_data->idata.normalized_make, sizeof(image_info->normalized_camera_make));
-	strncpy(image_info->normalized_camera_model, raw_data->idata.normalized_model, sizeof(image_info->normalized_camera_model));
-	strncpy(image_info->lens, raw_data->lens.Lens, sizeof(image_info->lens));
-	strncpy(image_info->lens_make, raw_data->lens.LensMake, sizeof(image_info->lens_make));
-	image_info->raw_height = raw_data->sizes.raw_height;
-	image_info->raw_width = raw_data->sizes.raw_width;
-	image_info->iheight = raw_data->sizes.iheight;
-	image_info->iwidth = raw_data->sizes.iwidth;
-	image_info->top_margin = raw_data->sizes.top_margin;
-	image_info->left_margin = raw_data->sizes.left_margin;
-	image_info->iso_speed = raw_data->other.iso_speed;
-	image_info->shutter = raw_data->other.shutter;
-	image_info->aperture = raw_data->other.aperture;
-	image_info->focal_len = raw_data->other.focal_len;
-	image_info->timestamp = raw_data->other.timestamp;
-	image_info->temperature = -273.15f;
-	if (raw_data->makernotes.common.SensorTemperature > -273.15f) {
-		 image_info->temperature = raw_data->makernotes.common.SensorTemperature;
-	} else if (raw_data->makernotes.common.CameraTemperature > -273.15f) {
-		 image_info->temperature = raw_data->makernotes.common.CameraTemperature;
-	}
-	strncpy(image_info->desc, raw_data->other.desc, sizeof(image_info->desc));
-	strncpy(image_info->artist, raw_data->other.artist, sizeof(image_info->artist));
+	get_image_info(raw_data, image_info);
 
 #if !defined(INDIGO_WINDOWS)
 	indigo_debug(
@@ -302,9 +392,64 @@ int indigo_dslr_raw_image_info(void *buffer, size_t buffer_size, indigo_dslr_raw
 #endif
 
 cleanup:
-	libraw_free_image(raw_data);
-	libraw_recycle(raw_data);
-	libraw_close(raw_data);
+	release_context(raw_data);
+
+	return rc;
+}
+
+int indigo_dslr_raw_thumbnail(void *buffer, size_t buffer_size, void **thumbnail, size_t *thumbnail_size) {
+	int rc;
+	libraw_data_t *raw_data;
+
+	*thumbnail = NULL;
+	*thumbnail_size = 0;
+
+#if !defined(INDIGO_WINDOWS)
+	clock_t start = clock();
+#endif
+	raw_data = get_context();
+	if (raw_data == NULL) {
+		indigo_error("libraw_init failed");
+		return LIBRAW_UNSPECIFIED_ERROR;
+	}
+
+	rc = libraw_open_buffer(raw_data, buffer, buffer_size);
+	if (rc != LIBRAW_SUCCESS) {
+		indigo_error("[rc:%d] libraw_open_buffer failed: '%s'", rc, libraw_strerror(rc));
+		goto cleanup;
+	}
+
+	rc = libraw_unpack_thumb(raw_data);
+	if (rc != LIBRAW_SUCCESS) {
+		indigo_error("[rc:%d] libraw_unpack_thumb failed: '%s'", rc, libraw_strerror(rc));
+		goto cleanup;
+	}
+
+	if (raw_data->thumbnail.tformat != LIBRAW_THUMBNAIL_JPEG || raw_data->thumbnail.thumb == NULL || raw_data->thumbnail.tlength == 0) {
+		indigo_error("Embedded thumbnail is not JPEG");
+		rc = LIBRAW_UNSPECIFIED_ERROR;
+		goto cleanup;
+	}
+
+	*thumbnail = malloc(raw_data->thumbnail.tlength);
+	if (*thumbnail == NULL) {
+		indigo_error("%s", strerror(errno));
+		rc = errno;
+		goto cleanup;
+	}
+	memcpy(*thumbnail, raw_data->thumbnail.thumb, raw_data->thumbnail.tlength);
+	*thumbnail_size = raw_data->thumbnail.tlength;
+
+#if !defined(INDIGO_WINDOWS)
+	indigo_debug(
+		"libraw extracted %dx%d thumbnail (%d bytes) in %g sec",
+		raw_data->thumbnail.twidth, raw_data->thumbnail.theight, raw_data->thumbnail.tlength,
+		(clock() - start) / (double)CLOCKS_PER_SEC
+	);
+#endif
+
+cleanup:
+	release_context(raw_data);
 
 	return rc;
 }
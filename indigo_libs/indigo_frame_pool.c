@@ -0,0 +1,186 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+
+/** INDIGO frame buffer pool
+ \file indigo_frame_pool.c
+ */
+
+#if defined(INDIGO_LINUX)
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_frame_pool.h>
+
+#if !defined(MAP_ANONYMOUS)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#define FRAME_POOL_MAGIC		0x46524D42
+#define FRAME_POOL_HEADER		64
+#define FRAME_POOL_CLASSES	260
+#define FRAME_POOL_HEAP			-1
+
+typedef struct frame_block {
+	uint32_t magic;
+	int size_class;
+	size_t size;
+	bool hugetlb;
+	struct frame_block *next;
+} frame_block;
+
+indigo_frame_pool_hugepages_mode indigo_frame_pool_hugepages = INDIGO_FRAME_POOL_NO_HUGEPAGES;
+long indigo_frame_pool_limit = INDIGO_FRAME_POOL_LIMIT;
+
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static frame_block *pool[FRAME_POOL_CLASSES];
+static indigo_frame_pool_stats pool_stats;
+
+// size classes are 4 per power of two, index of size in (2^p, 2^(p+1)] is 4 * p + q where q is 1..4
+
+static int size_class(size_t size, size_t *class_size) {
+	int p = 63 - __builtin_clzl(size - 1);
+	size_t step = (size_t)1 << (p - 2);
+	size_t q = (size + step - 1) / step - 4;
+	*class_size = (4 + q) * step;
+	return 4 * p + (int)q;
+}
+
+static void prefault(void *base, size_t size) {
+	for (size_t offset = 0; offset < size; offset += 4096)
+		((volatile char *)base)[offset] = 0;
+}
+
+static frame_block *map_block(size_t size) {
+	void *base = MAP_FAILED;
+	bool hugetlb = false;
+#if defined(INDIGO_LINUX)
+	if (indigo_frame_pool_hugepages == INDIGO_FRAME_POOL_EXPLICIT_HUGEPAGES) {
+		base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+		if (base == MAP_FAILED)
+			INDIGO_DEBUG(indigo_debug("Frame pool: failed to map %ldMB from huge page pool, using transparent huge pages", size >> 20));
+		else
+			hugetlb = true;
+	}
+#endif
+	if (base == MAP_FAILED) {
+		base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (base == MAP_FAILED)
+			return NULL;
+#if defined(INDIGO_LINUX)
+		if (indigo_frame_pool_hugepages != INDIGO_FRAME_POOL_NO_HUGEPAGES)
+			madvise(base, size, MADV_HUGEPAGE);
+#endif
+		prefault(base, size);
+	}
+	frame_block *block = base;
+	block->hugetlb = hugetlb;
+	block->size = size;
+	return block;
+}
+
+void *indigo_alloc_frame_buffer(long size) {
+	size += 2880;
+	int mod2880 = size % 2880;
+	if (mod2880)
+		size += 2880 - mod2880;
+	size_t total = size + FRAME_POOL_HEADER;
+	frame_block *block = NULL;
+	if (total < INDIGO_FRAME_POOL_MIN_SIZE) {
+		block = indigo_safe_malloc(total);
+		block->size_class = FRAME_POOL_HEAP;
+		block->size = total;
+	} else {
+		size_t class_size;
+		int index = size_class(total, &class_size);
+		if (indigo_frame_pool_hugepages != INDIGO_FRAME_POOL_NO_HUGEPAGES)
+			class_size = (class_size + INDIGO_FRAME_POOL_HUGEPAGE_SIZE - 1) & ~(INDIGO_FRAME_POOL_HUGEPAGE_SIZE - 1);
+		pthread_mutex_lock(&pool_mutex);
+		if ((block = pool[index]) != NULL) {
+			pool[index] = block->next;
+			pool_stats.cached -= block->size;
+			pool_stats.hits++;
+		} else {
+			pthread_mutex_unlock(&pool_mutex);
+			block = map_block(class_size);
+			if (block == NULL)
+				INDIGO_ERROR(indigo_error("Frame pool: failed to map %ldMB", class_size >> 20));
+			// same contract as indigo_alloc_blob_buffer(), callers don't check the result
+			assert(block != NULL);
+			INDIGO_DEBUG(indigo_debug("Frame pool: mapped %ldMB%s", class_size >> 20, block->hugetlb ? " from huge page pool" : ""));
+			pthread_mutex_lock(&pool_mutex);
+			pool_stats.mapped += block->size;
+			if (block->hugetlb)
+				pool_stats.hugepages += block->size;
+			pool_stats.misses++;
+		}
+		pool_stats.used += block->size;
+		pool_stats.buffers++;
+		pthread_mutex_unlock(&pool_mutex);
+		block->size_class = index;
+	}
+	block->magic = FRAME_POOL_MAGIC;
+	block->next = NULL;
+	return (char *)block + FRAME_POOL_HEADER;
+}
+
+void indigo_free_frame_buffer(void *buffer) {
+	if (buffer == NULL)
+		return;
+	frame_block *block = (frame_block *)((char *)buffer - FRAME_POOL_HEADER);
+	assert(block->magic == FRAME_POOL_MAGIC);
+	block->magic = 0;
+	if (block->size_class == FRAME_POOL_HEAP) {
+		free(block);
+		return;
+	}
+	pthread_mutex_lock(&pool_mutex);
+	pool_stats.used -= block->size;
+	pool_stats.buffers--;
+	if (pool_stats.cached + block->size <= indigo_frame_pool_limit) {
+		block->next = pool[block->size_class];
+		pool[block->size_class] = block;
+		pool_stats.cached += block->size;
+		block = NULL;
+	} else {
+		pool_stats.mapped -= block->size;
+		if (block->hugetlb)
+			pool_stats.hugepages -= block->size;
+	}
+	pthread_mutex_unlock(&pool_mutex);
+	if (block != NULL)
+		munmap(block, block->size);
+}
+
+void indigo_frame_pool_statistics(indigo_frame_pool_stats *stats) {
+	pthread_mutex_lock(&pool_mutex);
+	*stats = pool_stats;
+	pthread_mutex_unlock(&pool_mutex);
+}
@@ -34,6 +34,7 @@
 #include <assert.h>
 #include <stdint.h>
 #include <arpa/inet.h>
+#include <zlib.h>
 
 #include <indigo/indigo_json.h>
 #include <indigo/indigo_io.h>
@@ -46,42 +47,128 @@
 
 //#define PROPERTY_SIZE sizeof(indigo_property)+INDIGO_MAX_ITEMS*(sizeof(indigo_item))
 
-static long ws_read(int handle, char *buffer, long length) {
-	uint8_t header[14];
-	int bytes_read = indigo_read(handle, (char *)header, 6);
-	if (bytes_read <= 0) {
-		return bytes_read;
+static void ws_unmask(uint8_t *data, uint64_t length, const uint8_t *masking_key) {
+	uint32_t key32;
+	memcpy(&key32, masking_key, 4);
+	uint64_t key64 = ((uint64_t)key32 << 32) | key32;
+	uint64_t i = 0;
+	for (; i + 8 <= length; i += 8) {
+		uint64_t word;
+		memcpy(&word, data + i, 8);
+		word ^= key64;
+		memcpy(data + i, &word, 8);
+	}
+	for (; i < length; i++) {
+		data[i] ^= masking_key[i & 3];
 	}
-	INDIGO_TRACE_PARSER(indigo_trace("ws_read -> %2x", header[0]));
-	uint8_t *masking_key = header+2;
-	uint64_t payload_length = header[1] & 0x7F;
-	if (payload_length == 0x7E) {
-		bytes_read = indigo_read(handle, (char *)header + 6, 2);
+}
+
+static long ws_read(int handle, int output, char *buffer, long length, z_stream *inflater, char *inflate_buffer) {
+	uint8_t header[14];
+	uint64_t total_length = 0;
+	bool in_message = false;
+	bool compressed = false;
+	char *target = buffer;
+	while (true) {
+		int bytes_read = indigo_read(handle, (char *)header, 6);
 		if (bytes_read <= 0) {
 			return bytes_read;
 		}
-		masking_key = header + 4;
-		payload_length = ntohs(*((uint16_t *)(header+2)));
-	} else if (payload_length == 0x7F) {
-		bytes_read = indigo_read(handle, (char *)header + 6, 8);
-		if (bytes_read <= 0) {
-			return bytes_read;
+		INDIGO_TRACE_PARSER(indigo_trace("ws_read -> %2x", header[0]));
+		if ((header[1] & WS_MASK) == 0) {
+			INDIGO_ERROR(indigo_error("%d -> // Unmasked WebSocket frame", handle));
+			errno = EPROTO;
+			return -1;
+		}
+		uint8_t opcode = header[0] & 0x0F;
+		uint8_t *masking_key = header+2;
+		uint64_t payload_length = header[1] & 0x7F;
+		if (payload_length == 0x7E) {
+			bytes_read = indigo_read(handle, (char *)header + 6, 2);
+			if (bytes_read <= 0) {
+				return bytes_read;
+			}
+			masking_key = header + 4;
+			payload_length = ntohs(*((uint16_t *)(header+2)));
+		} else if (payload_length == 0x7F) {
+			bytes_read = indigo_read(handle, (char *)header + 6, 8);
+			if (bytes_read <= 0) {
+				return bytes_read;
+			}
+			masking_key = header+10;
+			payload_length = ntohll(*((uint64_t *)(header+2)));
+		}
+		if (opcode & 0x08) {
+			// control frames are never fragmented and can be interleaved with fragments of a data message
+			if (opcode == WS_OPCODE_CLOSE) {
+				INDIGO_TRACE_PARSER(indigo_trace("%d -> // WebSocket closed", handle));
+				return 0;
+			}
+			char control[0x7D];
+			if (payload_length > sizeof(control)) {
+				errno = EPROTO;
+				return -1;
+			}
+			if (payload_length > 0 && indigo_read(handle, control, payload_length) <= 0) {
+				return -1;
+			}
+			if (opcode == WS_OPCODE_PING) {
+				ws_unmask((uint8_t *)control, payload_length, masking_key);
+				INDIGO_TRACE_PARSER(indigo_trace("%d -> // WebSocket ping", handle));
+				if (!indigo_json_ws_control(output, WS_OPCODE_PONG, control, (long)payload_length)) {
+					return -1;
+				}
+			}
+			continue;
+		}
+		if (opcode == WS_OPCODE_CONTINUATION) {
+			if (!in_message) {
+				errno = EPROTO;
+				return -1;
+			}
+		} else {
+			in_message = true;
+			compressed = inflater != NULL && (header[0] & WS_RSV1);
+			target = compressed ? inflate_buffer : buffer;
+			total_length = 0;
+		}
+		if (length < total_length + payload_length) {
+			errno = ENODATA;
+			return -1;
+		}
+		if (payload_length > 0) {
+			bytes_read = indigo_read(handle, target + total_length, payload_length);
+			if (bytes_read <= 0) {
+				return bytes_read;
+			}
+			ws_unmask((uint8_t *)target + total_length, payload_length, masking_key);
+			total_length += payload_length;
+		}
+		if (header[0] & WS_FIN) {
+			break;
 		}
-		masking_key = header+10;
-		payload_length = ntohll(*((uint64_t *)(header+2)));
-	}
-	if (length < payload_length) {
-		errno = ENODATA;
-		return -1;
-	}
-	bytes_read = indigo_read(handle, buffer, payload_length);
-	if (bytes_read <= 0) {
-		return bytes_read;
 	}
-	for (uint64_t i = 0; i < payload_length; i++) {
-		buffer[i] ^= masking_key[i%4];
+	if (compressed) {
+		// RFC7692 7.2.2 - append the tail removed by the sender and inflate to the caller's buffer
+		if (length < total_length + 4) {
+			errno = ENODATA;
+			return -1;
+		}
+		memcpy(target + total_length, "\x00\x00\xFF\xFF", 4);
+		inflateReset(inflater);
+		inflater->next_in = (Bytef *)inflate_buffer;
+		inflater->avail_in = (uInt)(total_length + 4);
+		inflater->next_out = (Bytef *)buffer;
+		inflater->avail_out = (uInt)length;
+		int result = inflate(inflater, Z_SYNC_FLUSH);
+		if ((result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) || inflater->avail_in > 0) {
+			INDIGO_ERROR(indigo_error("%d -> // Failed to inflate WebSocket message (%d)", handle, result));
+			errno = inflater->avail_in > 0 ? ENODATA : EPROTO;
+			return -1;
+		}
+		total_length = length - inflater->avail_out;
 	}
-	return payload_length;
+	return total_length;
 }
 
 typedef enum {
@@ -299,6 +386,18 @@ void indigo_json_parse(indigo_device *device, indigo_client *client) {
 	char *name_buffer = indigo_safe_malloc(INDIGO_NAME_SIZE);
 	indigo_property *property = indigo_safe_malloc(sizeof(indigo_property) + INDIGO_PREALLOCATED_COUNT * sizeof(indigo_item));
 	property->allocated_count = INDIGO_PREALLOCATED_COUNT;
+	z_stream *inflater = NULL;
+	char *inflate_buffer = NULL;
+	if (context->web_socket && context->web_socket_deflate) {
+		inflater = indigo_safe_malloc(sizeof(z_stream));
+		if (inflateInit2(inflater, -MAX_WBITS) == Z_OK) {
+			inflate_buffer = indigo_safe_malloc(JSON_BUFFER_SIZE);
+		} else {
+			indigo_error("JSON Parser: failed to initialize permessage-deflate");
+			free(inflater);
+			inflater = NULL;
+		}
+	}
 	char *pointer = buffer;
 	char *value_pointer = value_buffer;
 	char *name_pointer = name_buffer;
@@ -317,7 +416,7 @@ void indigo_json_parse(indigo_device *device, indigo_client *client) {
 			goto exit_loop;
 		}
 		while ((c = *pointer++) == 0) {
-			ssize_t count = (int)context->web_socket ? ws_read(handle, buffer, JSON_BUFFER_SIZE) : indigo_read_line(handle, buffer, JSON_BUFFER_SIZE);
+			ssize_t count = context->web_socket ? ws_read(handle, context->output, buffer, JSON_BUFFER_SIZE - 1, inflater, inflate_buffer) : indigo_read_line(handle, buffer, JSON_BUFFER_SIZE);
 			if (count <= 0) {
 				goto exit_loop;
 			}
@@ -508,6 +607,11 @@ exit_loop:
 	indigo_safe_free(value_buffer);
 	indigo_safe_free(name_buffer);
 	indigo_safe_free(property);
+	if (inflater) {
+		inflateEnd(inflater);
+		free(inflater);
+	}
+	indigo_safe_free(inflate_buffer);
 	close(handle);
 	indigo_log("JSON Parser: parser finished");
 }
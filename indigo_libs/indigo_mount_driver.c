@@ -50,6 +50,11 @@ indigo_result indigo_mount_attach(indigo_device *device, const char* driver_name
 	assert(device != NULL);
 	if (MOUNT_CONTEXT == NULL) {
 		device->device_context = indigo_safe_malloc(sizeof(indigo_mount_context));
+		pthread_mutexattr_t attr;
+		pthread_mutexattr_init(&attr);
+		pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+		pthread_mutex_init(&MOUNT_CONTEXT->alignment_mutex, &attr);
+		pthread_mutexattr_destroy(&attr);
 	}
 	if (MOUNT_CONTEXT != NULL) {
 		if (indigo_device_attach(device, driver_name, version, INDIGO_INTERFACE_MOUNT) == INDIGO_OK) {
@@ -222,19 +227,22 @@ indigo_result indigo_mount_attach(indigo_device *device, const char* driver_name
 			indigo_init_sexagesimal_number_item(MOUNT_RAW_COORDINATES_RA_ITEM, MOUNT_RAW_COORDINATES_RA_ITEM_NAME, "Raw right ascension (0 to 24 hrs)", 0, 24, 0, 0);
 			indigo_init_sexagesimal_number_item(MOUNT_RAW_COORDINATES_DEC_ITEM, MOUNT_RAW_COORDINATES_DEC_ITEM_NAME, "Raw declination (-90 to 90°)", -90, 90, 0, 90);
 			// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_SELECT_POINTS
-			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY = indigo_init_switch_property(NULL, device->name, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY_NAME, MOUNT_ALIGNMENT_GROUP, "Select alignment points", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, MOUNT_MAX_ALIGNMENT_POINTS);
+			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY = indigo_init_switch_property(NULL, device->name, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY_NAME, MOUNT_ALIGNMENT_GROUP, "Select alignment points", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, MOUNT_ALIGNMENT_POINTS_CHUNK);
 			if (MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY == NULL)
 				return INDIGO_FAILED;
 			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->hidden = MOUNT_ALIGNMENT_MODE_CONTROLLER_ITEM->sw.value;
 			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count = 0;
 			// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_DELETE_POINTS
-			MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY = indigo_init_switch_property(NULL, device->name, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY_NAME, MOUNT_ALIGNMENT_GROUP, "Delete alignment point", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, MOUNT_MAX_ALIGNMENT_POINTS + 1);
+			MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY = indigo_init_switch_property(NULL, device->name, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY_NAME, MOUNT_ALIGNMENT_GROUP, "Delete alignment point", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, MOUNT_ALIGNMENT_POINTS_CHUNK + 1);
 			if (MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY == NULL)
 				return INDIGO_FAILED;
 			indigo_init_switch_item(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items, MOUNT_ALIGNMENT_DELETE_ALL_POINTS_ITEM_NAME, "All points", false);
 			sprintf(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items->hints, "warn_on_set:\"Clear all alignment points?\";");
 			MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->hidden = MOUNT_ALIGNMENT_MODE_CONTROLLER_ITEM->sw.value;
 			MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->count = 0;
+			pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
+			indigo_mount_reserve_alignment_points(device, MOUNT_ALIGNMENT_POINTS_CHUNK);
+			pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
 			// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_RESET
 			MOUNT_ALIGNMENT_RESET_PROPERTY = indigo_init_switch_property(NULL, device->name, MOUNT_ALIGNMENT_RESET_PROPERTY_NAME, MOUNT_ALIGNMENT_GROUP, "Reset alignment data", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 1);
 			if (MOUNT_ALIGNMENT_RESET_PROPERTY == NULL)
@@ -282,6 +290,33 @@ indigo_result indigo_mount_attach(indigo_device *device, const char* driver_name
 	return INDIGO_FAILED;
 }
 
+bool indigo_mount_reserve_alignment_points(indigo_device *device, int count) {
+	if (count > MOUNT_MAX_ALIGNMENT_POINTS)
+		return false;
+	int capacity = MOUNT_CONTEXT->alignment_point_capacity;
+	if (count <= capacity)
+		return true;
+	while (capacity < count)
+		capacity = capacity ? 2 * capacity : MOUNT_ALIGNMENT_POINTS_CHUNK;
+	if (capacity > MOUNT_MAX_ALIGNMENT_POINTS)
+		capacity = MOUNT_MAX_ALIGNMENT_POINTS;
+	MOUNT_CONTEXT->alignment_points = indigo_safe_realloc(MOUNT_CONTEXT->alignment_points, capacity * sizeof(indigo_alignment_point));
+	MOUNT_CONTEXT->alignment_cache_points = indigo_safe_realloc(MOUNT_CONTEXT->alignment_cache_points, capacity * sizeof(indigo_alignment_point));
+	for (int i = 0; i < 2; i++)
+		MOUNT_CONTEXT->alignment_cache_vectors[i] = indigo_safe_realloc(MOUNT_CONTEXT->alignment_cache_vectors[i], capacity * sizeof(double[3]));
+	// indigo_resize_property() changes count and clears new items, keep defined items and "All points" item
+	int select_count = MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count;
+	MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY = indigo_resize_property(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, capacity);
+	MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count = select_count;
+	int delete_count = MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->count;
+	indigo_item all_points = MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items[0];
+	MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY = indigo_resize_property(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, capacity + 1);
+	MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items[0] = all_points;
+	MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->count = delete_count;
+	MOUNT_CONTEXT->alignment_point_capacity = capacity;
+	return true;
+}
+
 void indigo_mount_load_alignment_points(indigo_device *device) {
 	int handle = indigo_open_config_file(device->name, 0, O_RDONLY, ".alignment");
 	if (handle > 0) {
@@ -289,6 +324,12 @@ void indigo_mount_load_alignment_points(indigo_device *device) {
 		char buffer[1024], name[INDIGO_NAME_SIZE], label[INDIGO_VALUE_SIZE];
 		indigo_read_line(handle, buffer, sizeof(buffer));
 		sscanf(buffer, "%d", &count);
+		if (count < 0)
+			count = 0;
+		if (count > MOUNT_MAX_ALIGNMENT_POINTS)
+			count = MOUNT_MAX_ALIGNMENT_POINTS;
+		pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
+		indigo_mount_reserve_alignment_points(device, count);
 		MOUNT_CONTEXT->alignment_point_count = count;
 		MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count = count;
 		MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->count = count > 0 ? count + 1 : 0;
@@ -302,6 +343,7 @@ void indigo_mount_load_alignment_points(indigo_device *device) {
 			indigo_init_switch_item(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items + i, name, label, point->used);
 			indigo_init_switch_item(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items + i + 1, name, label, false);
 		}
+		pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
 		close(handle);
 		MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->state = INDIGO_OK_STATE;
 		indigo_update_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
@@ -313,6 +355,7 @@ void indigo_mount_load_alignment_points(indigo_device *device) {
 void indigo_mount_save_alignment_points(indigo_device *device) {
 	int handle = indigo_open_config_file(device->name, 0, O_WRONLY | O_CREAT | O_TRUNC, ".alignment");
 	if (handle > 0) {
+		pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
 		int count = MOUNT_CONTEXT->alignment_point_count;
 		char b1[32], b2[32], b3[32], b4[32], b5[32];
 		indigo_printf(handle, "%d\n", count);
@@ -320,19 +363,23 @@ void indigo_mount_save_alignment_points(indigo_device *device) {
 			indigo_alignment_point *point =  MOUNT_CONTEXT->alignment_points + i;
 			indigo_printf(handle, "%d %s %s %s %s %s %d\n", point->used, indigo_dtoa(point->ra, b1), indigo_dtoa(point->dec, b2), indigo_dtoa(point->raw_ra, b3), indigo_dtoa(point->raw_dec, b4), indigo_dtoa(point->lst, b5), point->side_of_pier);
 		}
+		pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
 		close(handle);
 	}
 }
 
 void indigo_mount_update_alignment_points(indigo_device *device) {
 	indigo_mount_save_alignment_points(device);
+	indigo_mount_update_alignment_cache(device);
 	char label[INDIGO_VALUE_SIZE];
+	pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
 	for (int i = 0; i < MOUNT_CONTEXT->alignment_point_count; i++) {
 		indigo_alignment_point *point =  MOUNT_CONTEXT->alignment_points + i;
 		snprintf(label, INDIGO_VALUE_SIZE, "%s %s %c", indigo_dtos(point->ra, "%2d:%02d:%02d"), indigo_dtos(point->dec, "%2d:%02d:%02d"), point->side_of_pier == MOUNT_SIDE_EAST ? 'E' : 'W');
 		strcpy(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].label, label);
 		strcpy(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items[i + 1].label, label);
 	}
+	pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
 	indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.value, MOUNT_RAW_COORDINATES_DEC_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value);
 	indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.target, MOUNT_RAW_COORDINATES_DEC_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.target);
 	MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
@@ -667,6 +714,8 @@ indigo_result indigo_mount_change_property(indigo_device *device, indigo_client
 				indigo_update_coordinates(device, "Too many alignment points");
 			} else {
 				indigo_property_copy_values(MOUNT_EQUATORIAL_COORDINATES_PROPERTY, property, false);
+				pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
+				indigo_mount_reserve_alignment_points(device, MOUNT_CONTEXT->alignment_point_count + 1);
 				int index = MOUNT_CONTEXT->alignment_point_count++;
 				indigo_alignment_point *point = MOUNT_CONTEXT->alignment_points + index;
 				time_t utc = indigo_get_mount_utc(device);
@@ -699,6 +748,7 @@ indigo_result indigo_mount_change_property(indigo_device *device, indigo_client
 						MOUNT_CONTEXT->alignment_points[i].used = false;
 					}
 				}
+				pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
 
 				indigo_mount_save_alignment_points(device);
 				MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count = MOUNT_CONTEXT->alignment_point_count;
@@ -773,6 +823,7 @@ indigo_result indigo_mount_change_property(indigo_device *device, indigo_client
 	} else if (indigo_property_match_changeable(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_SELECT_POINTS
 		indigo_property_copy_values(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, property, false);
+		pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
 		for (int i = 0; i < MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count; i++) {
 			int index = atoi(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].name);
 			if (index < MOUNT_CONTEXT->alignment_point_count) {
@@ -780,6 +831,7 @@ indigo_result indigo_mount_change_property(indigo_device *device, indigo_client
 				MOUNT_CONTEXT->alignment_points[index].used = used;
 			}
 		}
+		pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
 		indigo_mount_save_alignment_points(device);
 		indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.value, MOUNT_RAW_COORDINATES_DEC_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value);
 		indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.target, MOUNT_RAW_COORDINATES_DEC_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.target);
@@ -790,6 +842,7 @@ indigo_result indigo_mount_change_property(indigo_device *device, indigo_client
 		return INDIGO_OK;
 	} else if (indigo_property_match_changeable(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_DELETE_POINTS
+		pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
 		for (int i = 0; i < property->count; i++) {
 			if (property->items[i].sw.value) {
 				if (!strcmp(property->items[i].name, MOUNT_ALIGNMENT_DELETE_ALL_POINTS_ITEM_NAME)) {
@@ -797,20 +850,23 @@ indigo_result indigo_mount_change_property(indigo_device *device, indigo_client
 				} else {
 					int index = atoi(property->items[i].name);
 					if (index < MOUNT_CONTEXT->alignment_point_count) {
-						memcpy(MOUNT_CONTEXT->alignment_points + index, MOUNT_CONTEXT->alignment_points + index + 1, (MOUNT_CONTEXT->alignment_point_count - index - 1) * sizeof(indigo_alignment_point));
+						memmove(MOUNT_CONTEXT->alignment_points + index, MOUNT_CONTEXT->alignment_points + index + 1, (MOUNT_CONTEXT->alignment_point_count - index - 1) * sizeof(indigo_alignment_point));
 						MOUNT_CONTEXT->alignment_point_count--;
 					}
 				}
 				break;
 			}
 		}
+		pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
 		indigo_mount_update_alignment_points(device);
 		return INDIGO_OK;
 	} else if (indigo_property_match_changeable(MOUNT_ALIGNMENT_RESET_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_RESET
 		indigo_property_copy_values(MOUNT_ALIGNMENT_RESET_PROPERTY, property, false);
 		if (MOUNT_ALIGNMENT_RESET_ITEM->sw.value) {
+			pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
 			MOUNT_CONTEXT->alignment_point_count = 0;
+			pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
 			indigo_mount_update_alignment_points(device);
 		}
 		MOUNT_ALIGNMENT_RESET_PROPERTY->state = INDIGO_OK_STATE;
@@ -898,6 +954,11 @@ indigo_result indigo_mount_detach(indigo_device *device) {
 	indigo_release_property(MOUNT_SNOOP_DEVICES_PROPERTY);
 	indigo_release_property(MOUNT_PEC_PROPERTY);
 	indigo_release_property(MOUNT_PEC_TRAINING_PROPERTY);
+	indigo_safe_free(MOUNT_CONTEXT->alignment_points);
+	indigo_safe_free(MOUNT_CONTEXT->alignment_cache_points);
+	indigo_safe_free(MOUNT_CONTEXT->alignment_cache_vectors[0]);
+	indigo_safe_free(MOUNT_CONTEXT->alignment_cache_vectors[1]);
+	pthread_mutex_destroy(&MOUNT_CONTEXT->alignment_mutex);
 	return indigo_device_detach(device);
 }
 
@@ -1039,38 +1100,113 @@ static indigo_alignment_point* indigo_nearest_alignment_point(indigo_device* dev
 }
 */
 
-static indigo_alignment_point* indigo_find_nearest_alignment_point(indigo_device* device, double lst, double ra, double dec, bool raw) {
-	//  Find nearest alignment point
-	double sin_dec = sin(dec * DEG2RAD);
-	double cos_dec = cos(dec * DEG2RAD);
-	double min_d = 180.0;   //  Larger than 2.0
-	indigo_alignment_point* nearest_point = 0;
-	double ha = 15 * indigo_range24(lst - ra) * DEG2RAD;
+static void ha_dec_to_vector(double ha, double dec, double *vector) {
+	double cos_dec = cos(dec);
+	vector[0] = cos_dec * cos(ha);
+	vector[1] = cos_dec * sin(ha);
+	vector[2] = sin(dec);
+}
 
-	for (int i = 0; i < MOUNT_CONTEXT->alignment_point_count; i++) {
-		//  Skip unused points
+void indigo_mount_update_alignment_cache(indigo_device *device) {
+	pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
+	int count = MOUNT_CONTEXT->alignment_point_count;
+	memcpy(MOUNT_CONTEXT->alignment_cache_points, MOUNT_CONTEXT->alignment_points, count * sizeof(indigo_alignment_point));
+	for (int i = 0; i < count; i++) {
 		indigo_alignment_point *point = MOUNT_CONTEXT->alignment_points + i;
-		if (!point->used)
-			continue;
+		ha_dec_to_vector(15 * indigo_range24(point->lst - point->ra) * DEG2RAD, point->dec * DEG2RAD, MOUNT_CONTEXT->alignment_cache_vectors[0][i]);
+		ha_dec_to_vector(15 * indigo_range24(point->lst - point->raw_ra) * DEG2RAD, point->raw_dec * DEG2RAD, MOUNT_CONTEXT->alignment_cache_vectors[1][i]);
+	}
+	MOUNT_CONTEXT->alignment_cache_count = count;
+	pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
+}
 
-		//  Compute virtual encoder angles for alignment point
-		double p_ha, p_dec;
-		if (raw) {
-			p_ha = 15 * indigo_range24(point->lst - point->raw_ra) * DEG2RAD;
-			p_dec = point->raw_dec * DEG2RAD;
-		} else {
-			p_ha = 15 * indigo_range24(point->lst - point->ra) * DEG2RAD;
-			p_dec = point->dec * DEG2RAD;
+static int indigo_find_nearest_alignment_points(indigo_device* device, double lst, double ra, double dec, bool raw, int max_count, indigo_alignment_point **points, double *distances) {
+	//  Points are changed on several places, rebuild the cache if they don't match it, caller holds alignment_mutex
+	int count = MOUNT_CONTEXT->alignment_point_count;
+	if (count != MOUNT_CONTEXT->alignment_cache_count || memcmp(MOUNT_CONTEXT->alignment_cache_points, MOUNT_CONTEXT->alignment_points, count * sizeof(indigo_alignment_point)))
+		indigo_mount_update_alignment_cache(device);
+	double vector[3];
+	ha_dec_to_vector(15 * indigo_range24(lst - ra) * DEG2RAD, dec * DEG2RAD, vector);
+	double (*vectors)[3] = MOUNT_CONTEXT->alignment_cache_vectors[raw ? 1 : 0];
+	double dots[MOUNT_INTERPOLATED_ALIGNMENT_POINTS];
+	int found = 0;
+	for (int i = 0; i < count; i++) {
+		//  Skip unused points
+		if (!MOUNT_CONTEXT->alignment_points[i].used)
+			continue;
+		//  Nearest points have largest dot product of unit vectors
+		double dot = vector[0] * vectors[i][0] + vector[1] * vectors[i][1] + vector[2] * vectors[i][2];
+		if (found == max_count && dot <= dots[found - 1])
+			continue;
+		int j = found < max_count ? found++ : found - 1;
+		for (; j > 0 && dots[j - 1] < dot; j--) {
+			dots[j] = dots[j - 1];
+			points[j] = points[j - 1];
 		}
-		double d = acos(sin_dec * sin(p_dec) + cos_dec * cos(p_dec) * cos(ha - p_ha)) / DEG2RAD;
-		if (d < min_d) {
-			nearest_point = point;
-			min_d = d;
+		dots[j] = dot;
+		points[j] = MOUNT_CONTEXT->alignment_points + i;
+	}
+	for (int i = 0; i < found; i++)
+		distances[i] = acos(dots[i] > 1 ? 1 : dots[i]) / DEG2RAD;
+	return found;
+}
+
+static indigo_alignment_point* indigo_find_nearest_alignment_point(indigo_device* device, double lst, double ra, double dec, bool raw) {
+	indigo_alignment_point *point;
+	double distance;
+	if (indigo_find_nearest_alignment_points(device, lst, ra, dec, raw, 1, &point, &distance))
+		return point;
+	return NULL;
+}
+
+//  Compute correction from observed (raw == false) or mount (raw == true) position
+static bool indigo_alignment_correction_locked(indigo_device *device, double lst, double ra, double dec, bool raw, double *delta_ra, double *delta_dec) {
+	if (MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM->sw.value) {
+		//  Inverse distance weighted correction of nearest points
+		indigo_alignment_point *points[MOUNT_INTERPOLATED_ALIGNMENT_POINTS];
+		double distances[MOUNT_INTERPOLATED_ALIGNMENT_POINTS];
+		int count = indigo_find_nearest_alignment_points(device, lst, ra, dec, raw, MOUNT_INTERPOLATED_ALIGNMENT_POINTS, points, distances);
+		if (count == 0)
+			return false;
+		double sum_weight = 0, sum_ra = 0, sum_dec = 0;
+		for (int i = 0; i < count; i++) {
+			double d_ra = raw ? points[i]->ra - points[i]->raw_ra : points[i]->raw_ra - points[i]->ra;
+			double d_dec = raw ? points[i]->dec - points[i]->raw_dec : points[i]->raw_dec - points[i]->dec;
+			if (d_ra > 12)
+				d_ra -= 24;
+			if (d_ra < -12)
+				d_ra += 24;
+			if (distances[i] < 1e-6) {
+				*delta_ra = d_ra;
+				*delta_dec = d_dec;
+				return true;
+			}
+			double weight = 1 / (distances[i] * distances[i]);
+			sum_weight += weight;
+			sum_ra += weight * d_ra;
+			sum_dec += weight * d_dec;
 		}
+		*delta_ra = sum_ra / sum_weight;
+		*delta_dec = sum_dec / sum_weight;
+		return true;
 	}
+	indigo_alignment_point* point;
+	if (MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value)
+		point = indigo_find_single_alignment_point(device);
+	else
+		point = indigo_find_nearest_alignment_point(device, lst, ra, dec, raw);
+	if (point == NULL)
+		return false;
+	*delta_ra = raw ? point->ra - point->raw_ra : point->raw_ra - point->ra;
+	*delta_dec = raw ? point->dec - point->raw_dec : point->raw_dec - point->dec;
+	return true;
+}
 
-	//  Return nearest point
-	return nearest_point;
+static bool indigo_alignment_correction(indigo_device *device, double lst, double ra, double dec, bool raw, double *delta_ra, double *delta_dec) {
+	pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
+	bool result = indigo_alignment_correction_locked(device, lst, ra, dec, raw, delta_ra, delta_dec);
+	pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
+	return result;
 }
 
 //  Called to transform an observed position into a position for mount
@@ -1079,7 +1215,7 @@ indigo_result indigo_translated_to_raw(indigo_device *device, double ra, double
 		*raw_ra = ra;
 		*raw_dec = dec;
 		return INDIGO_OK;
-	} else if (MOUNT_ALIGNMENT_MODE_NEAREST_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value) {
+	} else if (MOUNT_ALIGNMENT_MODE_NEAREST_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM->sw.value) {
 		time_t utc = indigo_get_mount_utc(device);
 		double lst = indigo_lst(&utc, MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value);
 		double ha = indigo_range24(lst - ra);
@@ -1087,11 +1223,6 @@ indigo_result indigo_translated_to_raw(indigo_device *device, double ra, double
 			ha -= 24.0;
 		int side_of_pier = (ha >= 0.0) ? MOUNT_SIDE_WEST : MOUNT_SIDE_EAST;
 		return indigo_translated_to_raw_with_lst(device, lst, ra, dec, side_of_pier, raw_ra, raw_dec);
-	} else if (MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM->sw.value) {
-
-		// TBD Rumen
-
-		return INDIGO_OK;
 	}
 	return INDIGO_FAILED;
 }
@@ -1101,16 +1232,12 @@ indigo_result indigo_translated_to_raw_with_lst(indigo_device *device, double ls
 		*raw_ra = ra;
 		*raw_dec = dec;
 		return INDIGO_OK;
-	} else if (MOUNT_ALIGNMENT_MODE_NEAREST_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value) {
-		indigo_alignment_point* point;
-		if (MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value)
-			point = indigo_find_single_alignment_point(device);
-		else
-		  point = indigo_find_nearest_alignment_point(device, lst, ra, dec, false);
-		if (point) {
+	} else if (MOUNT_ALIGNMENT_MODE_NEAREST_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM->sw.value) {
+		double delta_ra, delta_dec;
+		if (indigo_alignment_correction(device, lst, ra, dec, false, &delta_ra, &delta_dec)) {
 			// Transform coordinates
-			*raw_ra = ra + (point->raw_ra - point->ra);
-			*raw_dec = dec + (point->raw_dec - point->dec);
+			*raw_ra = ra + delta_ra;
+			*raw_dec = dec + delta_dec;
 
 			//**  Re-normalize coordinates to ensure they are in range
 			//  RA
@@ -1137,11 +1264,6 @@ indigo_result indigo_translated_to_raw_with_lst(indigo_device *device, double ls
 			*raw_ra = ra;
 			*raw_dec = dec;
 		}
-		return INDIGO_OK;
-	} else if (MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM->sw.value) {
-
-		// TBD Rumen
-
 		return INDIGO_OK;
 	}
 	return INDIGO_FAILED;
@@ -1153,7 +1275,7 @@ indigo_result indigo_raw_to_translated(indigo_device *device, double raw_ra, dou
 		*ra = raw_ra;
 		*dec = raw_dec;
 		return INDIGO_OK;
-	} else if (MOUNT_ALIGNMENT_MODE_NEAREST_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value) {
+	} else if (MOUNT_ALIGNMENT_MODE_NEAREST_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM->sw.value) {
 		time_t utc = indigo_get_mount_utc(device);
 		double lst = indigo_lst(&utc, MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value);
 		double ha = indigo_range24(lst - raw_ra);
@@ -1161,11 +1283,6 @@ indigo_result indigo_raw_to_translated(indigo_device *device, double raw_ra, dou
 			ha -= 24.0;
 		int side_of_pier = (ha >= 0.0) ? MOUNT_SIDE_WEST : MOUNT_SIDE_EAST;
 		return indigo_raw_to_translated_with_lst(device, lst, raw_ra, raw_dec, side_of_pier, ra, dec);
-	} else if (MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM->sw.value) {
-
-		// TBD Rumen
-
-		return INDIGO_OK;
 	}
 	return INDIGO_FAILED;
 }
@@ -1176,16 +1293,12 @@ indigo_result indigo_raw_to_translated_with_lst(indigo_device *device, double ls
 		*ra = raw_ra;
 		*dec = raw_dec;
 		return INDIGO_OK;
-	} else if (MOUNT_ALIGNMENT_MODE_NEAREST_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value) {
-		indigo_alignment_point* point;
-		if (MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value)
-			point = indigo_find_single_alignment_point(device);
-		else
-			point = indigo_find_nearest_alignment_point(device, lst, raw_ra, raw_dec, true);
-		if (point) {
+	} else if (MOUNT_ALIGNMENT_MODE_NEAREST_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value || MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM->sw.value) {
+		double delta_ra, delta_dec;
+		if (indigo_alignment_correction(device, lst, raw_ra, raw_dec, true, &delta_ra, &delta_dec)) {
 			// Transform coordinates
-			*ra = raw_ra + (point->ra - point->raw_ra);
-			*dec = raw_dec + (point->dec - point->raw_dec);
+			*ra = raw_ra + delta_ra;
+			*dec = raw_dec + delta_dec;
 
 			//**  Re-normalize coordinates to ensure they are in range
 			//  RA
@@ -1212,11 +1325,6 @@ indigo_result indigo_raw_to_translated_with_lst(indigo_device *device, double ls
 			*ra = raw_ra;
 			*dec = raw_dec;
 		}
-		return INDIGO_OK;
-	} else if (MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM->sw.value) {
-
-		// TBD Rumen
-
 		return INDIGO_OK;
 	}
 	return INDIGO_FAILED;
@@ -23,6 +23,10 @@
  \file indigo_platesolver_driver.c
  */
 
+#if defined(INDIGO_LINUX)
+#define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -33,9 +37,15 @@
 #include <math.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <limits.h>
+#include <signal.h>
+#include <spawn.h>
 
 #include <indigo/indigo_agent.h>
 #include <indigo/indigo_filter.h>
+#include <indigo/indigo_io.h>
 #include <indigo/indigo_align.h>
 #include <indigo/indigo_platesolver.h>
 
@@ -89,6 +99,277 @@ void indigo_platesolver_save_config(indigo_device *device) {
 	}
 }
 
+static double solve_clock(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+void indigo_platesolver_update_solve_time(indigo_device *device) {
+	double solve_time = solve_clock() - INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->solve_start;
+	AGENT_PLATESOLVER_WCS_SOLVE_TIME_ITEM->number.value = solve_time;
+	/* failed solves usually end on CPU limit or abort, they would skew the average */
+	if (AGENT_PLATESOLVER_WCS_PROPERTY->state != INDIGO_ALERT_STATE && !INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->failed) {
+		INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->solve_time_total += solve_time;
+		INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->solve_count++;
+		AGENT_PLATESOLVER_WCS_AVERAGE_SOLVE_TIME_ITEM->number.value = INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->solve_time_total / INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->solve_count;
+	}
+}
+
+// -------------------------------------------------------------------------------- Solver worker pool
+
+// Worker process (indigo_solver_worker helper) is spawned once per pool slot and spawns solver commands on request,
+// so jobs are not forked from multithreaded server and selected index files stay mapped (and cached) between jobs.
+// Requests are lines "X <command>" (execute), "M <path>" (map file), "R" (release all mapped files) and "S" (sync),
+// worker replies to output pipe with "\001PID <pid>" when the job is started and "\001END <status>" when it is finished.
+
+#define POOL_MARKER					'\001'
+#define POOL_WORKER_EXECUTABLE	"indigo_solver_worker"
+
+extern char **environ;
+
+static int pool_pipe(int fds[2]) {
+#if defined(INDIGO_LINUX)
+	return pipe2(fds, O_CLOEXEC);
+#else
+	if (pipe(fds))
+		return -1;
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+	return 0;
+#endif
+}
+
+// Helper is looked up next to the main executable first and in PATH then
+
+static bool pool_worker_path(char *path, size_t size) {
+	if (indigo_main_argv && indigo_main_argv[0]) {
+		const char *last = strrchr(indigo_main_argv[0], '/');
+		if (last && snprintf(path, size, "%.*s/%s", (int)(last - indigo_main_argv[0]), indigo_main_argv[0], POOL_WORKER_EXECUTABLE) < size && access(path, X_OK) == 0)
+			return true;
+	}
+	return false;
+}
+
+static void pool_stop_worker(indigo_platesolver_worker *worker) {
+	if (worker->pid > 0) {
+		close(worker->request);
+		fclose(worker->output);
+		kill(worker->pid, SIGTERM);
+		waitpid(worker->pid, NULL, 0);
+	}
+	worker->pid = 0;
+}
+
+static bool pool_start_worker(indigo_device *device, indigo_platesolver_worker *worker) {
+	int request_pipe[2], output_pipe[2];
+	if (pool_pipe(request_pipe))
+		return false;
+	if (pool_pipe(output_pipe)) {
+		close(request_pipe[0]);
+		close(request_pipe[1]);
+		return false;
+	}
+	char path[PATH_MAX];
+	char *argv[] = { POOL_WORKER_EXECUTABLE, NULL };
+	sigset_t no_signals;
+	sigemptyset(&no_signals);
+	posix_spawnattr_t attr;
+	posix_spawn_file_actions_t actions;
+	posix_spawnattr_init(&attr);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+	posix_spawnattr_setsigmask(&attr, &no_signals);
+	posix_spawn_file_actions_init(&actions);
+	// all pipe ends are close-on-exec, dup2 clears the flag on worker stdin and stdout only
+	posix_spawn_file_actions_adddup2(&actions, request_pipe[0], STDIN_FILENO);
+	posix_spawn_file_actions_adddup2(&actions, output_pipe[1], STDOUT_FILENO);
+	int result;
+	if (pool_worker_path(path, sizeof(path)))
+		result = posix_spawn(&worker->pid, path, &actions, &attr, argv, environ);
+	else
+		result = posix_spawnp(&worker->pid, POOL_WORKER_EXECUTABLE, &actions, &attr, argv, environ);
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attr);
+	close(request_pipe[0]);
+	close(output_pipe[1]);
+	if (result) {
+		close(request_pipe[1]);
+		close(output_pipe[0]);
+		worker->pid = 0;
+		// don't try again, solver commands are spawned directly from now on
+		INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_unavailable = true;
+		indigo_error("Failed to start %s (%s), solver commands will be executed directly", POOL_WORKER_EXECUTABLE, strerror(result));
+		return false;
+	}
+	worker->request = request_pipe[1];
+	worker->output = fdopen(output_pipe[0], "r");
+	INDIGO_DEBUG(indigo_debug("Solver worker %d started", worker->pid));
+	return true;
+}
+
+static indigo_platesolver_worker *pool_acquire_worker(indigo_device *device, int index) {
+	indigo_platesolver_worker *pool = INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool;
+	indigo_platesolver_worker *worker = NULL;
+	pthread_mutex_lock(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_mutex);
+	while (worker == NULL && !INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_unavailable) {
+		for (int i = 0; i < INDIGO_PLATESOLVER_POOL_SIZE; i++) {
+			if ((index < 0 || index == i) && !pool[i].busy) {
+				worker = pool + i;
+				break;
+			}
+		}
+		if (worker == NULL)
+			pthread_cond_wait(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_cond, &INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_mutex);
+	}
+	if (worker == NULL) {
+		pthread_mutex_unlock(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_mutex);
+		return NULL;
+	}
+	worker->busy = true;
+	if (worker->pid == 0 && !pool_start_worker(device, worker)) {
+		worker->busy = false;
+		worker = NULL;
+	}
+	pthread_mutex_unlock(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_mutex);
+	return worker;
+}
+
+static void pool_release_worker(indigo_device *device, indigo_platesolver_worker *worker, bool failed) {
+	pthread_mutex_lock(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_mutex);
+	if (failed) {
+		// worker died or pipe is out of sync, start new one on next request
+		pool_stop_worker(worker);
+	}
+	worker->busy = false;
+	pthread_cond_broadcast(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_cond);
+	pthread_mutex_unlock(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_mutex);
+}
+
+static bool pool_request(indigo_platesolver_worker *worker, char type, const char *argument) {
+	char request[8 * 1024 + 4];
+	int length = snprintf(request, sizeof(request), "%c %s\n", type, argument ? argument : "");
+	return length < sizeof(request) && indigo_write(worker->request, request, length);
+}
+
+// Fallback used when worker helper is not installed, job is spawned directly in the same way worker does it
+
+static bool direct_execute(indigo_device *device, const char *command, pid_t *pid, bool (*handler)(indigo_device *device, char *line)) {
+	int output_pipe[2];
+	if (pool_pipe(output_pipe))
+		return false;
+	pid_t job = 0;
+	sigset_t no_signals, default_signals;
+	sigemptyset(&no_signals);
+	sigemptyset(&default_signals);
+	sigaddset(&default_signals, SIGPIPE);
+	posix_spawnattr_t attr;
+	posix_spawn_file_actions_t actions;
+	posix_spawnattr_init(&attr);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+	posix_spawnattr_setpgroup(&attr, 0);
+	posix_spawnattr_setsigdefault(&attr, &default_signals);
+	posix_spawnattr_setsigmask(&attr, &no_signals);
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+	posix_spawn_file_actions_adddup2(&actions, output_pipe[1], STDOUT_FILENO);
+	char *argv[] = { "sh", "-c", (char *)command, NULL };
+	int result = posix_spawn(&job, "/bin/sh", &actions, &attr, argv, environ);
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attr);
+	close(output_pipe[1]);
+	if (result) {
+		close(output_pipe[0]);
+		indigo_error("Failed to execute %s (%s)", command, strerror(result));
+		return false;
+	}
+	if (pid)
+		*pid = job;
+	FILE *output = fdopen(output_pipe[0], "r");
+	char *line = NULL;
+	size_t size = 0;
+	bool res = true;
+	while (getline(&line, &size, output) >= 0) {
+		char *nl = strchr(line, '\n');
+		if (nl)
+			*nl = 0;
+		if (handler && !handler(device, line))
+			res = false;
+	}
+	if (line)
+		free(line);
+	fclose(output);
+	int status = -1;
+	while (waitpid(job, &status, 0) < 0 && errno == EINTR)
+		;
+	if (pid)
+		*pid = 0;
+	INDIGO_DEBUG(indigo_debug("Solver job %d finished with status %d", job, status >= 0 && WIFEXITED(status) ? WEXITSTATUS(status) : -1));
+	return res;
+}
+
+bool indigo_platesolver_execute(indigo_device *device, const char *command, pid_t *pid, bool (*handler)(indigo_device *device, char *line)) {
+	if (strchr(command, '\n'))
+		return false;
+	indigo_platesolver_worker *worker = pool_acquire_worker(device, -1);
+	if (worker == NULL)
+		return direct_execute(device, command, pid, handler);
+	if (!pool_request(worker, 'X', command)) {
+		pool_release_worker(device, worker, true);
+		return false;
+	}
+	char *line = NULL;
+	size_t size = 0;
+	bool res = true, finished = false;
+	int status = -1;
+	while (getline(&line, &size, worker->output) >= 0) {
+		char *nl = strchr(line, '\n');
+		if (nl)
+			*nl = 0;
+		if (*line == POOL_MARKER) {
+			int value;
+			if (sscanf(line + 1, "PID %d", &value) == 1) {
+				if (pid)
+					*pid = value;
+			} else if (sscanf(line + 1, "END %d", &status) == 1) {
+				finished = true;
+				break;
+			}
+		} else if (handler && !handler(device, line)) {
+			res = false;
+		}
+	}
+	if (line)
+		free(line);
+	if (pid)
+		*pid = 0;
+	INDIGO_DEBUG(indigo_debug("Solver worker %d: job finished with status %d", worker->pid, status));
+	pool_release_worker(device, worker, !finished);
+	return res && finished;
+}
+
+bool indigo_platesolver_map_files(indigo_device *device, int count, char **paths) {
+	// mapped files are always owned by the first worker
+	indigo_platesolver_worker *worker = pool_acquire_worker(device, 0);
+	if (worker == NULL)
+		return false;
+	bool res = pool_request(worker, 'R', NULL);
+	for (int i = 0; res && i < count; i++)
+		res = pool_request(worker, 'M', paths[i]);
+	res = res && pool_request(worker, 'S', NULL);
+	char *line = NULL;
+	size_t size = 0;
+	int mapped = -1;
+	while (res && getline(&line, &size, worker->output) >= 0) {
+		if (*line == POOL_MARKER && sscanf(line + 1, "END %d", &mapped) == 1)
+			break;
+	}
+	if (line)
+		free(line);
+	INDIGO_DEBUG(indigo_debug("Solver worker %d: %d of %d index files mapped", worker->pid, mapped, count));
+	pool_release_worker(device, worker, mapped < 0);
+	return mapped >= 0;
+}
+
 static bool set_fov(indigo_device *device, double angle, double width, double height) {
 	for (int i = 0; i < FILTER_RELATED_AGENT_LIST_PROPERTY->count; i++) {
 		indigo_item *item = FILTER_RELATED_AGENT_LIST_PROPERTY->items + i;
@@ -374,6 +655,7 @@ static void solve(indigo_platesolver_task *task) {
 	}
 
 	// Solve with a particular plate solver
+	INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->solve_start = solve_clock();
 	bool success = INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->solve(device, task->image, task->size);
 	indigo_safe_free(task->image);
 	indigo_safe_free(task);
@@ -685,7 +967,7 @@ indigo_result indigo_platesolver_device_attach(indigo_device *device, const char
 		strcpy(AGENT_PLATESOLVER_HINTS_DEC_ITEM->number.format, "%m");
 		strcpy(AGENT_PLATESOLVER_HINTS_SCALE_ITEM->number.format, "%m");
 		// -------------------------------------------------------------------------------- WCS property
-		AGENT_PLATESOLVER_WCS_PROPERTY = indigo_init_number_property(NULL, device->name, AGENT_PLATESOLVER_WCS_PROPERTY_NAME, PLATESOLVER_MAIN_GROUP, "WCS solution", INDIGO_OK_STATE, INDIGO_RO_PERM, 10);
+		AGENT_PLATESOLVER_WCS_PROPERTY = indigo_init_number_property(NULL, device->name, AGENT_PLATESOLVER_WCS_PROPERTY_NAME, PLATESOLVER_MAIN_GROUP, "WCS solution", INDIGO_OK_STATE, INDIGO_RO_PERM, 12);
 		if (AGENT_PLATESOLVER_WCS_PROPERTY == NULL)
 			return INDIGO_FAILED;
 		indigo_init_number_item(AGENT_PLATESOLVER_WCS_STATE_ITEM, AGENT_PLATESOLVER_WCS_STATE_ITEM_NAME, "WCS solution state", 0, 5, 0, 0);
@@ -698,6 +980,10 @@ indigo_result indigo_platesolver_device_attach(indigo_device *device, const char
 		indigo_init_number_item(AGENT_PLATESOLVER_WCS_SCALE_ITEM, AGENT_PLATESOLVER_WCS_SCALE_ITEM_NAME, "Pixel scale (°/pixel)", 0, 1000, 0, 0);
 		indigo_init_number_item(AGENT_PLATESOLVER_WCS_PARITY_ITEM, AGENT_PLATESOLVER_WCS_PARITY_ITEM_NAME, "Parity (-1,1)", -1, 1, 0, 0);
 		indigo_init_number_item(AGENT_PLATESOLVER_WCS_INDEX_ITEM, AGENT_PLATESOLVER_WCS_INDEX_ITEM_NAME, "Used index file", 0, 10000, 0, 0);
+		indigo_init_number_item(AGENT_PLATESOLVER_WCS_SOLVE_TIME_ITEM, AGENT_PLATESOLVER_WCS_SOLVE_TIME_ITEM_NAME, "Solve time (s)", 0, 100000, 0, 0);
+		indigo_init_number_item(AGENT_PLATESOLVER_WCS_AVERAGE_SOLVE_TIME_ITEM, AGENT_PLATESOLVER_WCS_AVERAGE_SOLVE_TIME_ITEM_NAME, "Average solve time (s)", 0, 100000, 0, 0);
+		strcpy(AGENT_PLATESOLVER_WCS_SOLVE_TIME_ITEM->number.format, "%.2f");
+		strcpy(AGENT_PLATESOLVER_WCS_AVERAGE_SOLVE_TIME_ITEM->number.format, "%.2f");
 		strcpy(AGENT_PLATESOLVER_WCS_RA_ITEM->number.format, "%m");
 		strcpy(AGENT_PLATESOLVER_WCS_DEC_ITEM->number.format, "%m");
 		strcpy(AGENT_PLATESOLVER_WCS_ANGLE_ITEM->number.format, "%m");
@@ -795,6 +1081,8 @@ indigo_result indigo_platesolver_device_attach(indigo_device *device, const char
 		INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mount_process_state = INDIGO_IDLE_STATE;
 
 		pthread_mutex_init(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mutex, NULL);
+		pthread_mutex_init(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_mutex, NULL);
+		pthread_cond_init(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_cond, NULL);
 		return INDIGO_OK;
 	}
 	return INDIGO_FAILED;
@@ -840,6 +1128,8 @@ indigo_result indigo_platesolver_change_property(indigo_device *device, indigo_c
 		AGENT_PLATESOLVER_USE_INDEX_PROPERTY->state = INDIGO_OK_STATE;
 		indigo_update_property(device, AGENT_PLATESOLVER_USE_INDEX_PROPERTY, NULL);
 		INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->save_config(device);
+		if (INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->map_indexes)
+			indigo_async((void *(*)(void *))INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->map_indexes, device);
 		return INDIGO_OK;
 	} else if (indigo_property_match(AGENT_PLATESOLVER_HINTS_PROPERTY, property)) {
 	// -------------------------------------------------------------------------------- AGENT_PLATESOLVER_HINTS
@@ -946,6 +1236,10 @@ indigo_result indigo_platesolver_device_detach(indigo_device *device) {
 	indigo_release_property(AGENT_PLATESOLVER_ABORT_PROPERTY);
 	indigo_release_property(AGENT_PLATESOLVER_IMAGE_PROPERTY);
 	pthread_mutex_destroy(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->mutex);
+	for (int i = 0; i < INDIGO_PLATESOLVER_POOL_SIZE; i++)
+		pool_stop_worker(INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool + i);
+	pthread_cond_destroy(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_cond);
+	pthread_mutex_destroy(&INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->pool_mutex);
 	return indigo_filter_device_detach(device);
 }
 
@@ -0,0 +1,301 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+/** INDIGO asynchronous video recorder
+ \file indigo_recorder.c
+ */
+
+#if defined(INDIGO_LINUX)
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_recorder.h>
+
+bool indigo_use_direct_io = false;
+
+static double get_time_hd() {
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (double)(now.tv_sec) + now.tv_usec/1e6;
+}
+
+static void set_direct_io(int handle, bool state) {
+#if defined(O_DIRECT)
+	int flags = fcntl(handle, F_GETFL);
+	if (flags != -1)
+		fcntl(handle, F_SETFL, state ? flags | O_DIRECT : flags & ~O_DIRECT);
+#elif defined(F_NOCACHE)
+	fcntl(handle, F_NOCACHE, state ? 1 : 0);
+#endif
+}
+
+static void preallocate(indigo_recorder *recorder, off_t end) {
+	if (end <= recorder->allocated)
+		return;
+	off_t size = ((end - recorder->allocated + INDIGO_RECORDER_PREALLOCATION - 1) / INDIGO_RECORDER_PREALLOCATION) * INDIGO_RECORDER_PREALLOCATION;
+	int result = -1;
+#if defined(INDIGO_LINUX)
+	result = fallocate(recorder->handle, 0, recorder->allocated, size);
+#elif defined(INDIGO_MACOS)
+	fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, size, 0 };
+	result = fcntl(recorder->handle, F_PREALLOCATE, &store);
+	if (result == -1) {
+		store.fst_flags = F_ALLOCATEALL;
+		result = fcntl(recorder->handle, F_PREALLOCATE, &store);
+	}
+#endif
+	if (result == -1) {
+		INDIGO_DEBUG(indigo_debug("indigo_recorder: failed to preallocate %ld bytes (%s)", (long)size, strerror(errno)));
+		// don't try again, file system doesn't support it or is full (in such case write will fail)
+		recorder->allocated = (off_t)1 << (sizeof(off_t) * 8 - 2);
+	} else {
+		recorder->allocated += size;
+	}
+}
+
+static bool write_chunk(indigo_recorder *recorder, unsigned char *data, size_t size, off_t offset) {
+	while (size > 0) {
+		ssize_t bytes_written = pwrite(recorder->handle, data, size, offset);
+		if (bytes_written < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		data += bytes_written;
+		offset += bytes_written;
+		size -= bytes_written;
+	}
+	return true;
+}
+
+static void *recorder_writer(indigo_recorder *recorder) {
+	bool flush = false;
+	pthread_mutex_lock(&recorder->mutex);
+	while (true) {
+		uint64_t pending = recorder->head - recorder->tail;
+		size_t offset = recorder->tail % recorder->size;
+		size_t chunk = pending < recorder->size - offset ? (size_t)pending : recorder->size - offset;
+		if (!recorder->closing)
+			chunk -= chunk % INDIGO_RECORDER_BLOCK_SIZE;
+		if (chunk == 0 || (chunk < INDIGO_RECORDER_BATCH_SIZE && !recorder->closing && !flush)) {
+			if (recorder->closing || recorder->error)
+				break;
+			// flush aligned part of small batches at least once per second
+			struct timespec timeout;
+			struct timeval now;
+			gettimeofday(&now, NULL);
+			timeout.tv_sec = now.tv_sec + 1;
+			timeout.tv_nsec = now.tv_usec * 1000;
+			flush = pthread_cond_timedwait(&recorder->cond, &recorder->mutex, &timeout) == ETIMEDOUT;
+			continue;
+		}
+		flush = false;
+		off_t position = recorder->base + (off_t)recorder->tail;
+		pthread_mutex_unlock(&recorder->mutex);
+		preallocate(recorder, position + chunk);
+		if (recorder->direct && chunk % INDIGO_RECORDER_BLOCK_SIZE) {
+			// unaligned tail of the stream
+			set_direct_io(recorder->handle, false);
+			recorder->direct = false;
+		}
+		bool result = write_chunk(recorder, recorder->buffer + offset, chunk, position);
+		pthread_mutex_lock(&recorder->mutex);
+		if (!result) {
+			recorder->error = errno;
+			INDIGO_ERROR(indigo_error("indigo_recorder: write failed (%s)", strerror(recorder->error)));
+			break;
+		}
+		recorder->tail += chunk;
+		pthread_cond_broadcast(&recorder->space);
+	}
+	pthread_cond_broadcast(&recorder->space);
+	pthread_mutex_unlock(&recorder->mutex);
+	return NULL;
+}
+
+indigo_recorder *indigo_recorder_open(int handle, size_t frame_size) {
+	off_t position = lseek(handle, 0, SEEK_CUR);
+	if (position == -1)
+		return NULL;
+	indigo_recorder *recorder = indigo_safe_malloc(sizeof(indigo_recorder));
+	recorder->handle = handle;
+	recorder->size = INDIGO_RECORDER_BUFFER_SIZE;
+	if (recorder->size < 4 * frame_size)
+		recorder->size = ((4 * frame_size + INDIGO_RECORDER_BLOCK_SIZE - 1) / INDIGO_RECORDER_BLOCK_SIZE) * INDIGO_RECORDER_BLOCK_SIZE;
+	if (posix_memalign((void **)&recorder->buffer, INDIGO_RECORDER_BLOCK_SIZE, recorder->size)) {
+		INDIGO_ERROR(indigo_error("indigo_recorder: could not allocate %ld bytes for buffer", (long)recorder->size));
+		free(recorder);
+		return NULL;
+	}
+	recorder->base = position;
+	recorder->allocated = position;
+	if (indigo_use_direct_io) {
+		// start buffer at block boundary, already written part of the first block is read back and written again
+		recorder->base = position - position % INDIGO_RECORDER_BLOCK_SIZE;
+		size_t prefix = (size_t)(position - recorder->base);
+		if (prefix == 0 || pread(handle, recorder->buffer, prefix, recorder->base) == (ssize_t)prefix) {
+			recorder->head = prefix;
+			recorder->direct = true;
+			set_direct_io(handle, true);
+		} else {
+			INDIGO_DEBUG(indigo_debug("indigo_recorder: direct I/O is not available (%s)", strerror(errno)));
+			recorder->base = position;
+		}
+	}
+	pthread_mutex_init(&recorder->mutex, NULL);
+	pthread_cond_init(&recorder->cond, NULL);
+	pthread_cond_init(&recorder->space, NULL);
+	recorder->start_time = recorder->rate_time = get_time_hd();
+	if (pthread_create(&recorder->thread, NULL, (void *(*)(void *))recorder_writer, recorder)) {
+		INDIGO_ERROR(indigo_error("indigo_recorder: failed to start writer thread"));
+		if (recorder->direct)
+			set_direct_io(handle, false);
+		pthread_mutex_destroy(&recorder->mutex);
+		pthread_cond_destroy(&recorder->cond);
+		pthread_cond_destroy(&recorder->space);
+		free(recorder->buffer);
+		free(recorder);
+		return NULL;
+	}
+	return recorder;
+}
+
+static uint64_t copy_to_buffer(indigo_recorder *recorder, uint64_t head, const unsigned char *data, size_t length) {
+	while (length > 0) {
+		size_t offset = head % recorder->size;
+		size_t chunk = length < recorder->size - offset ? length : recorder->size - offset;
+		memcpy(recorder->buffer + offset, data, chunk);
+		data += chunk;
+		head += chunk;
+		length -= chunk;
+	}
+	return head;
+}
+
+bool indigo_recorder_append(indigo_recorder *recorder, int count, const void **parts, const size_t *lengths) {
+	size_t total = 0;
+	for (int i = 0; i < count; i++)
+		total += lengths[i];
+	pthread_mutex_lock(&recorder->mutex);
+	if (recorder->error) {
+		errno = recorder->error;
+		pthread_mutex_unlock(&recorder->mutex);
+		return false;
+	}
+	if (recorder->size - (recorder->head - recorder->tail) < total) {
+		recorder->dropped++;
+		pthread_mutex_unlock(&recorder->mutex);
+		errno = 0;
+		return false;
+	}
+	uint64_t head = recorder->head;
+	pthread_mutex_unlock(&recorder->mutex);
+	// there is a single producer and writer never touches free space, so data can be copied without lock
+	for (int i = 0; i < count; i++)
+		head = copy_to_buffer(recorder, head, parts[i], lengths[i]);
+	pthread_mutex_lock(&recorder->mutex);
+	recorder->head = head;
+	recorder->frames++;
+	recorder->frame_size = total;
+	if (recorder->head - recorder->tail >= INDIGO_RECORDER_BATCH_SIZE)
+		pthread_cond_signal(&recorder->cond);
+	pthread_mutex_unlock(&recorder->mutex);
+	return true;
+}
+
+bool indigo_recorder_write(indigo_recorder *recorder, const void *data, size_t length) {
+	const unsigned char *bytes = data;
+	while (length > 0) {
+		size_t chunk = length < recorder->size / 2 ? length : recorder->size / 2;
+		pthread_mutex_lock(&recorder->mutex);
+		while (!recorder->error && recorder->size - (recorder->head - recorder->tail) < chunk) {
+			pthread_cond_signal(&recorder->cond);
+			pthread_cond_wait(&recorder->space, &recorder->mutex);
+		}
+		if (recorder->error) {
+			errno = recorder->error;
+			pthread_mutex_unlock(&recorder->mutex);
+			return false;
+		}
+		uint64_t head = recorder->head;
+		pthread_mutex_unlock(&recorder->mutex);
+		head = copy_to_buffer(recorder, head, bytes, chunk);
+		pthread_mutex_lock(&recorder->mutex);
+		recorder->head = head;
+		pthread_mutex_unlock(&recorder->mutex);
+		bytes += chunk;
+		length -= chunk;
+	}
+	return true;
+}
+
+bool indigo_recorder_statistics(indigo_recorder *recorder, double *rate, int *queue) {
+	bool updated = false;
+	pthread_mutex_lock(&recorder->mutex);
+	double now = get_time_hd();
+	if (now - recorder->rate_time >= 1) {
+		recorder->rate = (recorder->tail - recorder->rate_tail) / (now - recorder->rate_time) / (1024.0 * 1024.0);
+		recorder->rate_tail = recorder->tail;
+		recorder->rate_time = now;
+		updated = true;
+	}
+	*rate = recorder->rate;
+	uint64_t pending = recorder->head - recorder->tail;
+	*queue = recorder->frame_size ? (int)((pending + recorder->frame_size - 1) / recorder->frame_size) : 0;
+	pthread_mutex_unlock(&recorder->mutex);
+	return updated;
+}
+
+bool indigo_recorder_close(indigo_recorder *recorder) {
+	pthread_mutex_lock(&recorder->mutex);
+	recorder->closing = true;
+	pthread_cond_signal(&recorder->cond);
+	pthread_mutex_unlock(&recorder->mutex);
+	pthread_join(recorder->thread, NULL);
+	if (recorder->direct)
+		set_direct_io(recorder->handle, false);
+	off_t end = recorder->base + (off_t)recorder->head;
+	bool result = recorder->error == 0;
+	if (result) {
+		if (recorder->allocated > end && ftruncate(recorder->handle, end) == -1) {
+			INDIGO_DEBUG(indigo_debug("indigo_recorder: failed to truncate preallocated space (%s)", strerror(errno)));
+		}
+		INDIGO_DEBUG(indigo_debug("indigo_recorder: %ld frames (%ld dropped) written in %gs", recorder->frames, recorder->dropped, get_time_hd() - recorder->start_time));
+	} else {
+		errno = recorder->error;
+	}
+	lseek(recorder->handle, result ? end : recorder->base + (off_t)recorder->tail, SEEK_SET);
+	pthread_mutex_destroy(&recorder->mutex);
+	pthread_cond_destroy(&recorder->cond);
+	pthread_cond_destroy(&recorder->space);
+	free(recorder->buffer);
+	free(recorder);
+	return result;
+}
@@ -25,6 +25,9 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/time.h>
 
 #include <indigo/indigo_bus.h>
 #include <indigo/indigo_io.h>
@@ -52,10 +55,18 @@ static bool write_long(int handle, uint64_t n) {
 	return indigo_write(handle, (const char *)buffer, 8);
 }
 
+// SER timestamps are 100ns ticks since 0001-01-01 00:00:00 UTC, 62135596800 seconds before Unix epoch
+
+#define SER_EPOCH_OFFSET	62135596800LL
+
+static uint64_t utc_ticks(struct timeval *time) {
+	return (time->tv_sec + SER_EPOCH_OFFSET) * 10000000LL + time->tv_usec * 10LL;
+}
+
 indigo_ser *indigo_ser_open(const char *filename, void *buffer) {
 	indigo_ser *ser = NULL;
 	int handle;
-	if ((handle = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1) {
+	if ((handle = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644)) == -1) {
 		INDIGO_ERROR(indigo_error("indigo_ser: failed to open file for writing"));
 		goto failure;
 	}
@@ -63,12 +74,13 @@ indigo_ser *indigo_ser_open(const char *filename, void *buffer) {
 		INDIGO_ERROR(indigo_error("indigo_ser: could not allocate memory for indigo_ser structure"));
 		goto failure;
 	}
+	memset(ser, 0, sizeof(indigo_ser));
 	ser->handle = handle;
-	ser->count = 0;
 	int result = indigo_write(handle, "LUCAM-RECORDER", 14); // 0
 	result = result && write_int(handle, 0); // 14
 	indigo_raw_header *header = (indigo_raw_header *)buffer;
 	int bits_per_pixel = 8;
+	int planes = 1;
 	switch (header->signature) {
 		case INDIGO_RAW_MONO8:
 			result = result && write_int(handle, 0); // 18
@@ -79,10 +91,12 @@ indigo_ser *indigo_ser_open(const char *filename, void *buffer) {
 			break;
 		case INDIGO_RAW_RGB24:
 			result = result && write_int(handle, 101); // 18
+			planes = 3;
 			break;
 		case INDIGO_RAW_RGB48:
 			result = result && write_int(handle, 101); // 18
 			bits_per_pixel = 16;
+			planes = 3;
 			break;
 	}
 	result = result && write_int(handle, false); // 22
@@ -94,13 +108,17 @@ indigo_ser *indigo_ser_open(const char *filename, void *buffer) {
 	result = result && indigo_write(handle, zero, 40); // 42
 	result = result && indigo_write(handle, zero, 40); // 82
 	result = result && indigo_write(handle, zero, 40); // 122
-	tzset();
-	long time_utc = (time(NULL) + 62135600400L) * 10000000L;
-	long timezone_diff =  (timezone - daylight ? 3600 : 0) * 10000000L;
-	result = result && write_long(handle, time_utc); // 162
-	result = result && write_long(handle, time_utc + timezone_diff); // 170
+	struct timeval now;
+	struct tm local;
+	gettimeofday(&now, NULL);
+	localtime_r(&now.tv_sec, &local);
+	uint64_t time_utc = utc_ticks(&now);
+	result = result && write_long(handle, time_utc + local.tm_gmtoff * 10000000LL); // 162
+	result = result && write_long(handle, time_utc); // 170
 	if (!result)
 		goto failure;
+	if ((ser->recorder = indigo_recorder_open(handle, (size_t)header->width * header->height * planes * bits_per_pixel / 8)) == NULL)
+		goto failure;
 	return ser;
 failure:
 	if (handle != -1) {
@@ -110,17 +128,44 @@ failure:
 	return NULL;
 }
 
-bool indigo_ser_add_frame(indigo_ser *ser, void *buffer, size_t len) {
-	ser->count++;
-	return indigo_write(ser->handle, buffer + 12, len - 12);
+bool indigo_ser_add_frame(indigo_ser *ser, void *buffer, size_t len, const struct timeval *timestamp) {
+	// frame is stamped with the time it was captured if known, otherwise with the time it is written
+	struct timeval now;
+	if (timestamp)
+		now = *timestamp;
+	else
+		gettimeofday(&now, NULL);
+	const void *parts[] = { buffer + 12 };
+	size_t lengths[] = { len - 12 };
+	if (!indigo_recorder_append(ser->recorder, 1, parts, lengths)) {
+		// dropped frame is not an error, it is reported in recorder statistics
+		return errno == 0;
+	}
+	if (ser->count >= ser->timestamps_size) {
+		ser->timestamps_size += 1024;
+		ser->timestamps = indigo_safe_realloc(ser->timestamps, ser->timestamps_size * sizeof(uint64_t));
+	}
+	ser->timestamps[ser->count++] = utc_ticks(&now);
+	return true;
 }
 
 bool indigo_ser_close(indigo_ser *ser) {
 	int handle = ser->handle;
-	if (lseek(handle, 38, SEEK_SET) && write_int(handle, ser->count)) {
-		close(handle);
-		free(ser);
-		return true;
+	bool result = indigo_recorder_close(ser->recorder);
+	if (result && ser->count > 0) {
+		// optional trailer with UTC timestamps of individual frames
+		unsigned char *trailer = indigo_safe_malloc(ser->count * 8);
+		for (int i = 0; i < ser->count; i++) {
+			uint64_t n = ser->timestamps[i];
+			for (int j = 0; j < 8; j++)
+				trailer[i * 8 + j] = n >> (j * 8);
+		}
+		result = indigo_write(handle, (const char *)trailer, ser->count * 8);
+		free(trailer);
 	}
-	return false;
+	result = result && lseek(handle, 38, SEEK_SET) && write_int(handle, ser->count);
+	close(handle);
+	indigo_safe_free(ser->timestamps);
+	free(ser);
+	return result;
 }
@@ -137,15 +137,31 @@ static void start_worker_thread(int *client_socket) {
 					char websocket_key[256] = "";
 					bool use_gzip = false;
 					bool use_imagebytes = false;
+					bool use_deflate = false;
+					long range_start = -1, range_end = -1;
+					char if_range[64] = "";
 					while (indigo_read_line(socket, header, BUFFER_SIZE) > 0) {
 						if (!strncasecmp(header, "Sec-WebSocket-Key: ", 19))
 							strncpy(websocket_key, header + 19, sizeof(websocket_key));
+						if (!strncasecmp(header, "Sec-WebSocket-Extensions:", 25)) {
+							// only default server window size is supported, contexts are reset after each message
+							if (strstr(header + 25, "permessage-deflate") && !strstr(header + 25, "server_max_window_bits"))
+								use_deflate = true;
+						}
 						if (!strcasecmp(header, "Connection: close"))
 							keep_alive = false;
 						if (!strncasecmp(header, "Accept-Encoding:", 16)) {
 							if (strstr(header + 16, "gzip"))
 								use_gzip = true;
 						}
+						if (!strncasecmp(header, "If-Range:", 9)) {
+							if (sscanf(header + 9, " \"%62[^\"]\"", if_range) != 1)
+								strcpy(if_range, "-");
+						}
+						if (!strncasecmp(header, "Range:", 6)) {
+							if (sscanf(header + 6, " bytes=%ld-%ld", &range_start, &range_end) != 2)
+								range_start = range_end = -1;
+						}
 						if (!strncasecmp(header, "Accept:", 7)) {
 							if (strstr(header + 7, "application/imagebytes"))
 								use_imagebytes = true;
@@ -163,10 +179,13 @@ static void start_worker_thread(int *client_socket) {
 							INDIGO_PRINTF(socket, "Connection: upgrade\r\n");
 							base64_encode((unsigned char *)websocket_key, shaHash, 20);
 							INDIGO_PRINTF(socket, "Sec-WebSocket-Accept: %s\r\n", websocket_key);
+							if (use_deflate)
+								INDIGO_PRINTF(socket, "Sec-WebSocket-Extensions: permessage-deflate; server_no_context_takeover; client_no_context_takeover\r\n");
 							INDIGO_PRINTF(socket, "\r\n");
-							INDIGO_TRACE(indigo_trace("%d <- // Protocol switched to JSON-over-WebSockets", socket));
+							INDIGO_TRACE(indigo_trace("%d <- // Protocol switched to JSON-over-WebSockets%s", socket, use_deflate ? " with permessage-deflate" : ""));
 							indigo_client *protocol_adapter = indigo_json_device_adapter(socket, socket, true);
 							assert(protocol_adapter != NULL);
+							((indigo_adapter_context *)protocol_adapter->client_context)->web_socket_deflate = use_deflate;
 							indigo_attach_client(protocol_adapter);
 							indigo_json_parse(NULL, protocol_adapter);
 							indigo_detach_client(protocol_adapter);
@@ -198,13 +217,32 @@ static void start_worker_thread(int *client_socket) {
 									indigo_error("%d <- // Failed to populate BLOB", socket);
 								}
 							}
-							void *working_copy = indigo_use_blob_buffering ? (free_on_exit = malloc(working_size)) : entry->content;
+							// byte ranges are served for uncompressed content only and (with If-Range) for the same BLOB version only
+							char etag[32];
+							snprintf(etag, sizeof(etag), "%lx", entry->version);
+							bool use_range = range_start >= 0 && range_start <= range_end && range_start < working_size && !(use_gzip && indigo_use_blob_compression && strcmp(entry->format, ".jpeg")) && (*if_range == 0 || !strcmp(if_range, etag));
+							long total_size = working_size;
+							long working_offset = 0;
+							if (use_range) {
+								if (range_end >= working_size)
+									range_end = working_size - 1;
+								working_offset = range_start;
+								working_size = range_end - range_start + 1;
+							}
+							void *working_copy = indigo_use_blob_buffering ? (free_on_exit = malloc(working_size)) : entry->content + working_offset;
 							if (working_copy) {
 								char working_format[INDIGO_NAME_SIZE];
 								strcpy(working_format, entry->format);
-								INDIGO_PRINTF(socket, "HTTP/1.1 200 OK\r\n");
+								if (use_range) {
+									INDIGO_PRINTF(socket, "HTTP/1.1 206 Partial Content\r\n");
+									INDIGO_PRINTF(socket, "Content-Range: bytes %ld-%ld/%ld\r\n", range_start, range_end, total_size);
+								} else {
+									INDIGO_PRINTF(socket, "HTTP/1.1 200 OK\r\n");
+								}
 								if (indigo_use_blob_buffering) {
-									if (use_gzip && indigo_use_blob_compression && strcmp(entry->format, ".jpeg")) {
+									if (use_range) {
+										memcpy(working_copy, entry->content + working_offset, working_size);
+									} else if (use_gzip && indigo_use_blob_compression && strcmp(entry->format, ".jpeg")) {
 										unsigned compressed_size = (unsigned)working_size;
 										indigo_compress("image", entry->content, (unsigned)working_size, working_copy, &compressed_size);
 										INDIGO_PRINTF(socket, "Content-Encoding: gzip\r\n");
@@ -217,6 +255,7 @@ static void start_worker_thread(int *client_socket) {
 									unlock_at_exit = NULL;
 								}
 								INDIGO_PRINTF(socket, "Server: INDIGO/%d.%d-%s\r\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD);
+								INDIGO_PRINTF(socket, "ETag: \"%s\"\r\n", etag);
 								if (!strcmp(entry->format, ".jpeg")) {
 									INDIGO_PRINTF(socket, "Content-Type: image/jpeg\r\n");
 								} else {
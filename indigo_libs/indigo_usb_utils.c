@@ -24,8 +24,11 @@
  */
 
 #include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
 
 #include <indigo/indigo_bus.h>
+#include <indigo/indigo_driver.h>
 #include <indigo/indigo_usb_utils.h>
 
 indigo_result indigo_get_usb_path(libusb_device* handle, char *path) {
@@ -42,3 +45,201 @@ indigo_result indigo_get_usb_path(libusb_device* handle, char *path) {
 	}
 	return INDIGO_OK;
 }
+
+// -------------------------------------------------------------------------------- hotplug dispatcher
+
+// Single libusb hotplug callback shared by registered drivers. Each registration is matched by vendor and product IDs and its
+// events are debounced, so a burst of events (e.g. a hub with several devices) results in one rescan of the driver instead of
+// one per event, and unrelated products don't trigger it at all. Handlers are called with NULL device (see indigo_usb_utils.h).
+
+typedef struct {
+	bool used;
+	char name[INDIGO_NAME_SIZE];
+	int vendor_id;
+	int product_count;
+	int product_ids[INDIGO_USB_HOTPLUG_MAX_PRODUCTS];
+	double delay;
+	indigo_usb_hotplug_callback plug;
+	indigo_usb_hotplug_callback unplug;
+	int arrived;
+	bool left;
+	bool running;
+	int events;
+	double first_event;
+	double deadline;
+} hotplug_entry;
+
+static pthread_mutex_t hotplug_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t hotplug_cond = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t hotplug_start_mutex = PTHREAD_MUTEX_INITIALIZER;
+static hotplug_entry hotplug_entries[INDIGO_USB_HOTPLUG_MAX_HANDLERS];
+static libusb_hotplug_callback_handle hotplug_handle;
+static bool hotplug_started = false;
+
+static double hotplug_time() {
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return now.tv_sec + now.tv_usec / 1e6;
+}
+
+static bool hotplug_match(hotplug_entry *entry, struct libusb_device_descriptor *descriptor) {
+	if (entry->vendor_id != LIBUSB_HOTPLUG_MATCH_ANY && entry->vendor_id != descriptor->idVendor)
+		return false;
+	if (entry->product_count == 0)
+		return true;
+	for (int i = 0; i < entry->product_count; i++) {
+		if (entry->product_ids[i] == descriptor->idProduct)
+			return true;
+	}
+	return false;
+}
+
+static void hotplug_schedule(hotplug_entry *entry, bool arrived) {
+	double now = hotplug_time();
+	if (!entry->arrived && !entry->left) {
+		entry->first_event = now;
+		entry->events = 0;
+	}
+	if (arrived)
+		entry->arrived++;
+	else
+		entry->left = true;
+	entry->events++;
+	entry->deadline = now + entry->delay;
+	if (entry->deadline > entry->first_event + INDIGO_USB_HOTPLUG_MAX_DELAY)
+		entry->deadline = entry->first_event + INDIGO_USB_HOTPLUG_MAX_DELAY;
+	pthread_cond_broadcast(&hotplug_cond);
+}
+
+static int LIBUSB_CALL hotplug_callback(libusb_context *ctx, libusb_device *dev, libusb_hotplug_event event, void *user_data) {
+	struct libusb_device_descriptor descriptor;
+	if (libusb_get_device_descriptor(dev, &descriptor) < 0)
+		return 0;
+	INDIGO_TRACE(indigo_trace("Hotplug: %04x:%04x %s", descriptor.idVendor, descriptor.idProduct, event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED ? "arrived" : "left"));
+	pthread_mutex_lock(&hotplug_mutex);
+	for (int i = 0; i < INDIGO_USB_HOTPLUG_MAX_HANDLERS; i++) {
+		hotplug_entry *entry = hotplug_entries + i;
+		if (entry->used && hotplug_match(entry, &descriptor))
+			hotplug_schedule(entry, event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED);
+	}
+	pthread_mutex_unlock(&hotplug_mutex);
+	return 0;
+}
+
+static void *hotplug_worker(hotplug_entry *entry) {
+	pthread_mutex_lock(&hotplug_mutex);
+	int arrived = entry->arrived;
+	bool left = entry->left;
+	entry->arrived = 0;
+	entry->left = false;
+	INDIGO_DEBUG(indigo_debug("Hotplug: %d events for %s coalesced, %s%d devices arrived", entry->events, entry->name, left ? "devices left, " : "", arrived));
+	pthread_mutex_unlock(&hotplug_mutex);
+	if (left && entry->unplug)
+		entry->unplug(NULL);
+	for (int i = 0; i < arrived && entry->plug; i++)
+		entry->plug(NULL);
+	pthread_mutex_lock(&hotplug_mutex);
+	entry->running = false;
+	pthread_cond_broadcast(&hotplug_cond);
+	pthread_mutex_unlock(&hotplug_mutex);
+	return NULL;
+}
+
+static void *hotplug_dispatcher(void *arg) {
+	pthread_mutex_lock(&hotplug_mutex);
+	while (true) {
+		double now = hotplug_time();
+		double next = now + 60;
+		for (int i = 0; i < INDIGO_USB_HOTPLUG_MAX_HANDLERS; i++) {
+			hotplug_entry *entry = hotplug_entries + i;
+			if (!entry->used || entry->running || !(entry->arrived || entry->left))
+				continue;
+			if (entry->deadline <= now) {
+				entry->running = true;
+				if (!INDIGO_ASYNC(hotplug_worker, entry))
+					entry->running = false;
+			} else if (entry->deadline < next) {
+				next = entry->deadline;
+			}
+		}
+		struct timespec end;
+		end.tv_sec = (time_t)next;
+		end.tv_nsec = (long)((next - end.tv_sec) * 1e9);
+		pthread_cond_timedwait(&hotplug_cond, &hotplug_mutex, &end);
+	}
+	return NULL;
+}
+
+static bool hotplug_start() {
+	pthread_mutex_lock(&hotplug_start_mutex);
+	if (!hotplug_started) {
+		indigo_start_usb_event_handler();
+		int rc = libusb_hotplug_register_callback(NULL, LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT, 0, LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY, hotplug_callback, NULL, &hotplug_handle);
+		INDIGO_DEBUG(indigo_debug("Hotplug: libusb_hotplug_register_callback -> %s", rc < 0 ? libusb_error_name(rc) : "OK"));
+		if (rc >= 0)
+			hotplug_started = indigo_async(hotplug_dispatcher, NULL);
+	}
+	pthread_mutex_unlock(&hotplug_start_mutex);
+	return hotplug_started;
+}
+
+int indigo_usb_hotplug_register(const char *name, int vendor_id, int product_count, const int *product_ids, double delay, indigo_usb_hotplug_callback plug, indigo_usb_hotplug_callback unplug) {
+	if (!hotplug_start())
+		return -1;
+	if (product_count > INDIGO_USB_HOTPLUG_MAX_PRODUCTS)
+		product_count = INDIGO_USB_HOTPLUG_MAX_PRODUCTS;
+	pthread_mutex_lock(&hotplug_mutex);
+	int handle = -1;
+	for (int i = 0; i < INDIGO_USB_HOTPLUG_MAX_HANDLERS; i++) {
+		if (!hotplug_entries[i].used && !hotplug_entries[i].running) {
+			handle = i;
+			break;
+		}
+	}
+	if (handle < 0) {
+		pthread_mutex_unlock(&hotplug_mutex);
+		INDIGO_ERROR(indigo_error("Hotplug: too many handlers, %s not registered", name));
+		return -1;
+	}
+	hotplug_entry *entry = hotplug_entries + handle;
+	memset(entry, 0, sizeof(hotplug_entry));
+	indigo_copy_name(entry->name, name);
+	entry->vendor_id = vendor_id;
+	entry->product_count = product_count;
+	if (product_count > 0)
+		memcpy(entry->product_ids, product_ids, product_count * sizeof(int));
+	entry->delay = delay;
+	entry->plug = plug;
+	entry->unplug = unplug;
+	entry->used = true;
+	pthread_mutex_unlock(&hotplug_mutex);
+	libusb_device **list;
+	ssize_t count = libusb_get_device_list(NULL, &list);
+	if (count > 0) {
+		pthread_mutex_lock(&hotplug_mutex);
+		for (int i = 0; i < count; i++) {
+			struct libusb_device_descriptor descriptor;
+			if (libusb_get_device_descriptor(list[i], &descriptor) == 0 && hotplug_match(entry, &descriptor))
+				hotplug_schedule(entry, true);
+		}
+		pthread_mutex_unlock(&hotplug_mutex);
+	}
+	if (count >= 0)
+		libusb_free_device_list(list, 1);
+	INDIGO_DEBUG(indigo_debug("Hotplug: %s registered for %04x (%d products)", name, vendor_id, product_count));
+	return handle;
+}
+
+void indigo_usb_hotplug_deregister(int handle) {
+	if (handle < 0 || handle >= INDIGO_USB_HOTPLUG_MAX_HANDLERS)
+		return;
+	pthread_mutex_lock(&hotplug_mutex);
+	hotplug_entry *entry = hotplug_entries + handle;
+	entry->used = false;
+	entry->arrived = 0;
+	entry->left = false;
+	while (entry->running)
+		pthread_cond_wait(&hotplug_cond, &hotplug_mutex);
+	pthread_mutex_unlock(&hotplug_mutex);
+	INDIGO_DEBUG(indigo_debug("Hotplug: %s deregistered", entry->name));
+}
@@ -130,6 +130,8 @@ typedef struct {
 	int count;
 	indigo_property **properties;
 	pthread_mutex_t mutex;
+	unsigned char *blob_buffer;
+	long blob_buffer_size;
 } parser_context;
 
 bool indigo_use_blob_urls = true;
@@ -496,8 +498,14 @@ static void set_property(parser_context *context, indigo_property *other, char *
 								indigo_copy_name(property_item->blob.format, other_item->blob.format);
 								indigo_copy_value(property_item->blob.url, other_item->blob.url);
 								if (property->perm == INDIGO_RO_PERM) {
+									long old_size = property_item->blob.size;
 									property_item->blob.size = other_item->blob.size;
-									if (other_item->blob.value) {
+									if (other_item->blob.value != NULL && other_item->blob.value == context->blob_buffer) {
+										/* decoded directly into the parser buffer, swap it with the one held by the property instead of copying */
+										context->blob_buffer = property_item->blob.value;
+										context->blob_buffer_size = context->blob_buffer != NULL ? old_size : 0;
+										property_item->blob.value = other_item->blob.value;
+									} else if (other_item->blob.value) {
 										if (property_item->blob.value != NULL)
 											property_item->blob.value = indigo_safe_realloc(property_item->blob.value, property_item->blob.size);
 										else
@@ -781,6 +789,13 @@ static void *set_blob_vector_handler(parser_state state, parser_context *context
 			indigo_copy_value(message, value);
 		}
 	} else if (state == END_TAG) {
+		if (indigo_use_blob_prefetch && property->state == INDIGO_OK_STATE) {
+			for (int i = 0; i < property->count; i++) {
+				indigo_item *item = property->items + i;
+				if (item->blob.value == NULL && *item->blob.url)
+					indigo_prefetch_http_blob_item(item);
+			}
+		}
 		set_property(context, property, message);
 		indigo_clear_property(property);
 		return top_level_handler;
@@ -1309,7 +1324,6 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 	char *value_buffer = indigo_safe_malloc(BUFFER_SIZE + 1); /* +1 to accomodate \0" */
 	char *name_buffer = indigo_safe_malloc(INDIGO_NAME_SIZE);
 	char *message = indigo_safe_malloc(INDIGO_VALUE_SIZE);
-	unsigned char *blob_buffer = NULL;
 	char *pointer = buffer;
 	char *buffer_end = NULL;
 	char *name_pointer = name_buffer;
@@ -1512,11 +1526,19 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 					INDIGO_TRACE_PARSER(indigo_trace("XML Parser: '%c' %d TEXT -> TEXT1", c, depth));
 					break;
 				} else {
+					/* the rest of the text up to the next tag or entity is handled at once */
+					size_t span = strcspn(pointer, "<&");
 					if (depth == 2 || handler == enable_blob_handler) {
 						if (value_pointer - value_buffer < BUFFER_SIZE) {
 							*value_pointer++ = c;
 						}
+						size_t room = BUFFER_SIZE - (value_pointer - value_buffer);
+						if (span < room)
+							room = span;
+						memcpy(value_pointer, pointer, room);
+						value_pointer += room;
 					}
+					pointer += span;
 					INDIGO_TRACE_PARSER(indigo_trace("XML Parser: '%c' %d TEXT", c, depth));
 				}
 				break;
@@ -1564,10 +1586,11 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 					blob_pointer += base64_decode_fast((unsigned char*)blob_pointer, (unsigned char*)pointer, len);
 					pointer += len;
 					blob_len -= len;
+					/* the rest is read straight behind the decoded data and decoded in place, base64_decode_fast() never writes ahead of its input */
 					while (blob_len) {
 						len = ((BUFFER_SIZE) < blob_len) ? (BUFFER_SIZE) : blob_len;
 						ssize_t to_read = len;
-						char *ptr = buffer;
+						char *ptr = (char *)blob_pointer;
 						while(to_read) {
 #if defined(INDIGO_WINDOWS)
 							count = indigo_recv(handle, (void *)ptr, to_read);
@@ -1579,13 +1602,15 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 							ptr += count;
 							to_read -= count;
 						}
-						blob_pointer += base64_decode_fast((unsigned char*)blob_pointer, (unsigned char*)buffer, len);
+						blob_pointer += base64_decode_fast((unsigned char*)blob_pointer, (unsigned char*)blob_pointer, len);
 						blob_len -= len;
 					}
 
-					handler = handler(BLOB, context, NULL, (char *)blob_buffer, message);
-					pointer = buffer;
-					*pointer = 0;
+					handler = handler(BLOB, context, NULL, (char *)context->blob_buffer, message);
+					if (pointer >= buffer_end) {
+						pointer = buffer;
+						*pointer = 0;
+					}
 					state = BLOB_END;
 					INDIGO_TRACE_PARSER(indigo_trace("XML Parser: '%c' %d BLOB -> BLOB_END", c, depth));
 					break;
@@ -1594,7 +1619,7 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 						if (depth == 2) {
 							*value_pointer = 0;
 							blob_pointer += base64_decode_fast((unsigned char*)blob_pointer, (unsigned char*)value_buffer, (int)(value_pointer-value_buffer));
-							handler = handler(BLOB, context, NULL, (char *)blob_buffer, message);
+							handler = handler(BLOB, context, NULL, (char *)context->blob_buffer, message);
 						}
 						state = TEXT1;
 						INDIGO_TRACE_PARSER(indigo_trace("XML Parser: '%c' %d BLOB -> TEXT1", c, depth));
@@ -1631,14 +1656,13 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 						blob_size = property->items[property->count - 1].blob.size;
 						if (blob_size > 0) {
 							state = BLOB;
-							if (blob_buffer != NULL) {
-								unsigned char *ptmp = indigo_safe_realloc(blob_buffer, blob_size + 3); /* +3 to handle indi - reason unknown */
-								assert(ptmp != NULL);
-								blob_buffer = ptmp;
-							} else {
-								blob_buffer = indigo_safe_malloc(blob_size + 3); /* +3 to handle indi - reason unknown */
+							/* 2.0 BLOBs are decoded in place, so the buffer has to hold the encoded data */
+							long size = (device->version >= INDIGO_VERSION_2_0 ? (blob_size + 2) / 3 * 4 : blob_size) + 3; /* +3 to handle indi - reason unknown */
+							if (context->blob_buffer_size < size) {
+								context->blob_buffer = indigo_safe_realloc(context->blob_buffer, size);
+								context->blob_buffer_size = size;
 							}
-							blob_pointer = blob_buffer;
+							blob_pointer = context->blob_buffer;
 						} else {
 							state = TEXT;
 						}
@@ -1681,7 +1705,17 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 					handler = handler(ATTRIBUTE_VALUE, context, name_buffer, value_buffer, message);
 					INDIGO_TRACE_PARSER(indigo_trace("XML Parser: '%c' ATTRIBUTE_VALUE -> ATTRIBUTE_NAME1", c));
 				} else {
-					*value_pointer++ = c;
+					/* the rest of the value up to the closing quote or entity is handled at once */
+					size_t span = strcspn(pointer, q == '"' ? "\"&" : "'&");
+					if (value_pointer - value_buffer < BUFFER_SIZE) {
+						*value_pointer++ = c;
+					}
+					size_t room = BUFFER_SIZE - (value_pointer - value_buffer);
+					if (span < room)
+						room = span;
+					memcpy(value_pointer, pointer, room);
+					value_pointer += room;
+					pointer += span;
 					INDIGO_TRACE_PARSER(indigo_trace("XML Parser: '%c' ATTRIBUTE_VALUE", c));
 				}
 				break;
@@ -1722,7 +1756,7 @@ exit_loop:
 			}
 		}
 	}
-	indigo_safe_free(blob_buffer);
+	indigo_safe_free(context->blob_buffer);
 	indigo_safe_free(name_buffer);
 	indigo_safe_free(message);
 	indigo_safe_free(context->property);
@@ -25,11 +25,14 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include <indigo/indigocat/indigocat_dso.h>
 
 #include <indigo/indigocat/indigocat_precession.h>
+#include <indigo/indigocat/indigocat_index.h>
 
 static bool dso_data_updated = false;
 
@@ -12143,14 +12146,36 @@ static indigocat_dso_entry indigo_dso_data[] = {
 
 indigocat_dso_entry *indigocat_get_dso_data(void) {
 	if (!dso_data_updated) {
-		for (int i = 0; indigo_dso_data[i].id; i++) {
-			double ra = indigo_dso_data[i].ra;
-			double dec = indigo_dso_data[i].dec;
-			indigocat_j2k_to_jnow_pm(&ra, &dec, 0, 0);
-			indigo_dso_data[i].ra_now = ra;
-			indigo_dso_data[i].dec_now = dec;
+		int count = sizeof(indigo_dso_data) / sizeof(indigocat_dso_entry) - 1;
+		double *ra = malloc(2 * count * sizeof(double));
+		double *dec = ra + count;
+		for (int i = 0; i < count; i++) {
+			ra[i] = indigo_dso_data[i].ra;
+			dec[i] = indigo_dso_data[i].dec;
 		}
+		indigocat_j2k_to_jnow_pm_batch(ra, dec, NULL, NULL, count);
+		for (int i = 0; i < count; i++) {
+			indigo_dso_data[i].ra_now = ra[i];
+			indigo_dso_data[i].dec_now = dec[i];
+		}
+		free(ra);
 		dso_data_updated = true;
 	}
 	return indigo_dso_data;
 }
+
+static indigocat_zone_index dso_index = {
+	indigo_dso_data,
+	sizeof(indigo_dso_data) / sizeof(indigocat_dso_entry) - 1,
+	sizeof(indigocat_dso_entry),
+	offsetof(indigocat_dso_entry, ra),
+	offsetof(indigocat_dso_entry, dec),
+	offsetof(indigocat_dso_entry, ra_now),
+	offsetof(indigocat_dso_entry, dec_now),
+	offsetof(indigocat_dso_entry, mag)
+};
+
+int indigocat_search_dsos(double ra, double dec, double radius, float max_mag, bool jnow, indigocat_dso_entry **result, int max_count) {
+	indigocat_get_dso_data();
+	return indigocat_search_zone_index(&dso_index, ra, dec, radius, max_mag, jnow, (void **)result, max_count);
+}
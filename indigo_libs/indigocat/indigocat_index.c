@@ -0,0 +1,178 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+/** INDIGO catalog declination zone index
+ \file indigocat_index.c
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include <indigo/indigocat/indigocat_index.h>
+
+#define DEG2RAD (M_PI / 180.0)
+
+#define FIELD(index, i, offset) (*(double *)((char *)(index)->data + (size_t)(i) * (index)->size + (offset)))
+#define MAG(index, i) (*(float *)((char *)(index)->data + (size_t)(i) * (index)->size + (index)->mag))
+
+static pthread_mutex_t index_mutex = PTHREAD_MUTEX_INITIALIZER;
+static indigocat_zone_index *sorted_index;
+
+static int zone(double dec) {
+	int zone = (int)floor((dec + 90) / INDIGOCAT_ZONE_HEIGHT);
+	return zone < 0 ? 0 : (zone >= INDIGOCAT_ZONE_COUNT ? INDIGOCAT_ZONE_COUNT - 1 : zone);
+}
+
+static double distance(double ra1, double dec1, double ra2, double dec2) {
+	double cos_d = sin(dec1) * sin(dec2) + cos(dec1) * cos(dec2) * cos(ra1 - ra2);
+	return acos(cos_d > 1 ? 1 : (cos_d < -1 ? -1 : cos_d));
+}
+
+static int compare_ra(const void *a, const void *b) {
+	double ra_a = FIELD(sorted_index, *(int *)a, sorted_index->ra);
+	double ra_b = FIELD(sorted_index, *(int *)b, sorted_index->ra);
+	return ra_a < ra_b ? -1 : (ra_a > ra_b ? 1 : 0);
+}
+
+static void build_index(indigocat_zone_index *index) {
+	for (int i = 0; i < index->count; i++)
+		index->zone_size[zone(FIELD(index, i, index->dec))]++;
+	for (int z = 0; z < INDIGOCAT_ZONE_COUNT; z++) {
+		index->zones[z] = malloc((index->zone_size[z] + 1) * sizeof(int));
+		index->zone_size[z] = 0;
+	}
+	double margin = 0;
+	for (int i = 0; i < index->count; i++) {
+		int z = zone(FIELD(index, i, index->dec));
+		index->zones[z][index->zone_size[z]++] = i;
+		double d = distance(FIELD(index, i, index->ra) * 15 * DEG2RAD, FIELD(index, i, index->dec) * DEG2RAD, FIELD(index, i, index->ra_now) * 15 * DEG2RAD, FIELD(index, i, index->dec_now) * DEG2RAD);
+		if (d > margin)
+			margin = d;
+	}
+	/* qsort() has no context argument, the index is passed through static variable guarded by index_mutex */
+	sorted_index = index;
+	for (int z = 0; z < INDIGOCAT_ZONE_COUNT; z++)
+		qsort(index->zones[z], index->zone_size[z], sizeof(int), compare_ra);
+	sorted_index = NULL;
+	index->margin = margin / DEG2RAD;
+	/* release pairs with acquire in indigocat_search_zone_index(), zones are visible before the flag */
+	__atomic_store_n(&index->built, true, __ATOMIC_RELEASE);
+}
+
+static int lower_bound(indigocat_zone_index *index, int *zone, int size, double ra) {
+	int low = 0, high = size;
+	while (low < high) {
+		int mid = (low + high) / 2;
+		if (FIELD(index, zone[mid], index->ra) < ra)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+static int insert(indigocat_zone_index *index, int i, void **result, int count, int max_count) {
+	float mag = MAG(index, i);
+	if (count == max_count && MAG(index, (((char *)result[count - 1] - (char *)index->data) / index->size)) <= mag)
+		return count;
+	int low = 0, high = count;
+	while (low < high) {
+		int mid = (low + high) / 2;
+		if (MAG(index, (((char *)result[mid] - (char *)index->data) / index->size)) <= mag)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	if (count == max_count)
+		count--;
+	memmove(result + low + 1, result + low, (count - low) * sizeof(void *));
+	result[low] = (char *)index->data + (size_t)i * index->size;
+	return count + 1;
+}
+
+int indigocat_search_zone_index(indigocat_zone_index *index, double ra, double dec, double radius, float max_mag, bool jnow, void **result, int max_count) {
+	if (max_count <= 0)
+		return 0;
+	if (!__atomic_load_n(&index->built, __ATOMIC_ACQUIRE)) {
+		pthread_mutex_lock(&index_mutex);
+		if (!__atomic_load_n(&index->built, __ATOMIC_RELAXED))
+			build_index(index);
+		pthread_mutex_unlock(&index_mutex);
+	}
+	ra = fmod(ra, 24);
+	if (ra < 0)
+		ra += 24;
+	size_t ra_offset = jnow ? index->ra_now : index->ra;
+	size_t dec_offset = jnow ? index->dec_now : index->dec;
+	double ra_rad = ra * 15 * DEG2RAD;
+	double dec_rad = dec * DEG2RAD;
+	double radius_rad = radius * DEG2RAD;
+	/* zones are built from J2000 positions, JNow search is widened by the precession distance */
+	double extended = radius + (jnow ? index->margin : 0);
+	double ra_range = 12;
+	if (fabs(dec) + extended < 90) {
+		double sin_range = sin(extended * DEG2RAD) / cos(dec_rad);
+		if (sin_range < 1)
+			ra_range = asin(sin_range) / DEG2RAD / 15;
+	}
+	/* RA interval may wrap around 24h, it is searched in up to two parts */
+	double intervals[2][2];
+	int interval_count = 1;
+	if (ra_range >= 12) {
+		intervals[0][0] = 0;
+		intervals[0][1] = 24;
+	} else if (ra - ra_range < 0) {
+		intervals[0][0] = ra - ra_range + 24;
+		intervals[0][1] = 24;
+		intervals[1][0] = 0;
+		intervals[1][1] = ra + ra_range;
+		interval_count = 2;
+	} else if (ra + ra_range >= 24) {
+		intervals[0][0] = ra - ra_range;
+		intervals[0][1] = 24;
+		intervals[1][0] = 0;
+		intervals[1][1] = ra + ra_range - 24;
+		interval_count = 2;
+	} else {
+		intervals[0][0] = ra - ra_range;
+		intervals[0][1] = ra + ra_range;
+	}
+	int count = 0;
+	for (int z = zone(dec - extended); z <= zone(dec + extended); z++) {
+		int *entries = index->zones[z];
+		int size = index->zone_size[z];
+		for (int k = 0; k < interval_count; k++) {
+			for (int j = lower_bound(index, entries, size, intervals[k][0]); j < size; j++) {
+				int i = entries[j];
+				if (FIELD(index, i, index->ra) > intervals[k][1])
+					break;
+				if (MAG(index, i) > max_mag)
+					continue;
+				if (distance(FIELD(index, i, ra_offset) * 15 * DEG2RAD, FIELD(index, i, dec_offset) * DEG2RAD, ra_rad, dec_rad) > radius_rad)
+					continue;
+				count = insert(index, i, result, count, max_count);
+			}
+		}
+	}
+	return count;
+}
@@ -18,16 +18,7 @@
 #include <indigo/indigocat/indigocat_precession.h>
 #include <indigo/indigocat/indigocat_dynamical_time.h>
 
-equatorial_coords_s indigocat_precess(const equatorial_coords_s *c0, const double eq0, const double eq1) {
-	double rot[3][3];
-	equatorial_coords_s c1 = {0, 0};
-
-	double cosd = cos(c0->dec);
-
-	double x0 = cosd * cos(c0->ra);
-	double y0 = cosd * sin(c0->ra);
-	double z0 = sin(c0->dec);
-
+static void precession_matrix(const double eq0, const double eq1, double rot[3][3]) {
 	double ST = (eq0 - 2000.0) * 0.001;
 	double T = (eq1 - eq0) * 0.001;
 
@@ -54,6 +45,19 @@ equatorial_coords_s indigocat_precess(const equatorial_coords_s *c0, const doubl
 	rot[2][0] = cosA * sinC;
 	rot[2][1] = (-1) * sinA * sinC;
 	rot[2][2] = cosC;
+}
+
+equatorial_coords_s indigocat_precess(const equatorial_coords_s *c0, const double eq0, const double eq1) {
+	double rot[3][3];
+	equatorial_coords_s c1 = {0, 0};
+
+	double cosd = cos(c0->dec);
+
+	double x0 = cosd * cos(c0->ra);
+	double y0 = cosd * sin(c0->ra);
+	double z0 = sin(c0->dec);
+
+	precession_matrix(eq0, eq1, rot);
 
 	double x1 = rot[0][0] * x0 + rot[0][1] * y0 + rot[0][2] * z0;
 	double y1 = rot[1][0] * x0 + rot[1][1] * y0 + rot[1][2] * z0;
@@ -96,6 +100,33 @@ void indigocat_j2k_to_jnow_pm(double *ra, double *dec, double pmra, double pmdec
 	*dec = coordinates.dec * RAD2DEG;
 }
 
+void indigocat_j2k_to_jnow_pm_batch(double *ra, double *dec, const float *pmra, const float *pmdec, int count) {
+	double rot[3][3];
+	double now = 2000 + ((time(NULL) / 86400.0 + 2440587.5 - 0.477677 / 86400.0) - 2451545.0) / 365.25;
+	double pm_scale = (now - 2000.0) * DEG2RAD / 3600000;
+	precession_matrix(2000.0, now, rot);
+	for (int i = 0; i < count; i++) {
+		double a = ra[i] * 15 * DEG2RAD;
+		double d = dec[i] * DEG2RAD;
+		if (pmra && pmra[i] != 0 && pmdec[i] != 0) {
+			a = fmod(a + pm_scale * pmra[i] + 2 * M_PI, 2 * M_PI);
+			d += pm_scale * pmdec[i];
+		}
+		double cosd = cos(d);
+		double x0 = cosd * cos(a);
+		double y0 = cosd * sin(a);
+		double z0 = sin(d);
+		double x1 = rot[0][0] * x0 + rot[0][1] * y0 + rot[0][2] * z0;
+		double y1 = rot[1][0] * x0 + rot[1][1] * y0 + rot[1][2] * z0;
+		double z1 = rot[2][0] * x0 + rot[2][1] * y0 + rot[2][2] * z0;
+		a = atan2(y1, x1);
+		if (a < 0)
+			a += 2 * M_PI;
+		ra[i] = a * RAD2DEG / 15;
+		dec[i] = atan2(z1, sqrt(1 - z1 * z1)) * RAD2DEG;
+	}
+}
+
 void indigocat_jnow_to_j2k(double *ra, double *dec) {
 	equatorial_coords_s coordinates = { *ra * 15 * DEG2RAD, *dec * DEG2RAD };
 	double now = 2000 + ((time(NULL) / 86400.0 + 2440587.5 - 0.477677 / 86400.0) - 2451545.0) / 365.25;
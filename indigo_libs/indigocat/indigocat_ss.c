@@ -27,6 +27,8 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <time.h>
+#include <math.h>
+#include <pthread.h>
 
 #include <indigo/indigocat/indigocat_precession.h>
 #include <indigo/indigocat/indigocat_solar_system.h>
@@ -50,50 +52,125 @@ static indigocat_ss_entry indigo_ss_data[] = {
 	{ 0 }
 };
 
-indigocat_ss_entry *indigocat_get_ss_data(void) {
-	equatorial_coords_s position;
+/* positions are interpolated by Chebyshev series fitted to the exact ones over one day window */
 
-	for (int i = 0; indigo_ss_data[i].id; i++) {
-		switch (indigo_ss_data[i].id) {
-			case MERCURY:
-				indigocat_mercury_equatorial_coords(JDNOW, &position);
-				break;
-			case VENUS:
-				indigocat_venus_equatorial_coords(JDNOW, &position);
-				break;
-			case MARS:
-				indigocat_mars_equatorial_coords(JDNOW, &position);
-				break;
-			case JUPITER:
-				indigocat_jupiter_equatorial_coords(JDNOW, &position);
-				break;
-			case SATURN:
-				indigocat_saturn_equatorial_coords(JDNOW, &position);
-				break;
-			case URANUS:
-				indigocat_uranus_equatorial_coords(JDNOW, &position);
-				break;
-			case NEPTUNE:
-				indigocat_neptune_equatorial_coords(JDNOW, &position);
-				break;
-			case PLUTO:
-				indigocat_pluto_equatorial_coords(JDNOW, &position);
-				break;
-			case SUN:
-				indigocat_sun_equatorial_coords(JDNOW, &position);
-				break;
-			case MOON:
-				indigocat_moon_equatorial_coords(JDNOW, &position);
-				break;
-			default:
-				return indigo_ss_data;
+#define WINDOW			1.0
+#define NODES				16
+
+typedef struct {
+	double start;
+	double coef[3][NODES];
+} ss_cache_entry;
+
+static ss_cache_entry ss_cache[MOON + 1];
+static pthread_mutex_t ss_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool exact_position(indigocat_ss_id id, double jd, equatorial_coords_s *position) {
+	switch (id) {
+		case MERCURY:
+			indigocat_mercury_equatorial_coords(jd, position);
+			break;
+		case VENUS:
+			indigocat_venus_equatorial_coords(jd, position);
+			break;
+		case MARS:
+			indigocat_mars_equatorial_coords(jd, position);
+			break;
+		case JUPITER:
+			indigocat_jupiter_equatorial_coords(jd, position);
+			break;
+		case SATURN:
+			indigocat_saturn_equatorial_coords(jd, position);
+			break;
+		case URANUS:
+			indigocat_uranus_equatorial_coords(jd, position);
+			break;
+		case NEPTUNE:
+			indigocat_neptune_equatorial_coords(jd, position);
+			break;
+		case PLUTO:
+			indigocat_pluto_equatorial_coords(jd, position);
+			break;
+		case SUN:
+			indigocat_sun_equatorial_coords(jd, position);
+			break;
+		case MOON:
+			indigocat_moon_equatorial_coords(jd, position);
+			break;
+		default:
+			return false;
+	}
+	return true;
+}
+
+static void fit_window(indigocat_ss_id id, double start, ss_cache_entry *entry) {
+	/* direction cosines are fitted instead of RA/Dec to avoid discontinuity at 0h */
+	double values[3][NODES];
+	for (int k = 0; k < NODES; k++) {
+		equatorial_coords_s position;
+		double x = cos(M_PI * (k + 0.5) / NODES);
+		exact_position(id, start + (x + 1) * WINDOW / 2, &position);
+		double ra = position.ra * DEG2RAD, dec = position.dec * DEG2RAD;
+		values[0][k] = cos(dec) * cos(ra);
+		values[1][k] = cos(dec) * sin(ra);
+		values[2][k] = sin(dec);
+	}
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < NODES; j++) {
+			double sum = 0;
+			for (int k = 0; k < NODES; k++)
+				sum += values[i][k] * cos(M_PI * j * (k + 0.5) / NODES);
+			entry->coef[i][j] = 2 * sum / NODES;
 		}
-		position.ra /= 15;
-		indigo_ss_data[i].ra = position.ra;
-		indigo_ss_data[i].dec = position.dec;
-		indigocat_j2k_to_jnow_pm(&position.ra, &position.dec, 0, 0);
-		indigo_ss_data[i].ra_now = position.ra;
-		indigo_ss_data[i].dec_now = position.dec;
+	}
+	entry->start = start;
+}
+
+static double chebyshev(const double *coef, double x) {
+	double b1 = 0, b2 = 0;
+	for (int j = NODES - 1; j > 0; j--) {
+		double b = 2 * x * b1 - b2 + coef[j];
+		b2 = b1;
+		b1 = b;
+	}
+	return x * b1 - b2 + coef[0] / 2;
+}
+
+bool indigocat_get_ss_position(indigocat_ss_id id, double jd, double *ra, double *dec) {
+	if (id < MERCURY || id > MOON)
+		return false;
+	double start = floor(jd / WINDOW) * WINDOW;
+	double v[3];
+	pthread_mutex_lock(&ss_cache_mutex);
+	ss_cache_entry *entry = ss_cache + id;
+	if (entry->start != start)
+		fit_window(id, start, entry);
+	double x = 2 * (jd - start) / WINDOW - 1;
+	for (int i = 0; i < 3; i++)
+		v[i] = chebyshev(entry->coef[i], x);
+	pthread_mutex_unlock(&ss_cache_mutex);
+	double r = atan2(v[1], v[0]) * RAD2DEG / 15;
+	*ra = r < 0 ? r + 24 : r;
+	*dec = atan2(v[2], sqrt(v[0] * v[0] + v[1] * v[1])) * RAD2DEG;
+	return true;
+}
+
+indigocat_ss_entry *indigocat_get_ss_data_jd(double jd) {
+	double epoch = 2000 + (jd - 2451545.0) / 365.25;
+	for (int i = 0; indigo_ss_data[i].id; i++) {
+		double ra, dec;
+		if (!indigocat_get_ss_position(indigo_ss_data[i].id, jd, &ra, &dec))
+			break;
+		indigo_ss_data[i].ra = ra;
+		indigo_ss_data[i].dec = dec;
+		equatorial_coords_s position = { ra * 15 * DEG2RAD, dec * DEG2RAD };
+		position = indigocat_precess(&position, 2000.0, epoch);
+		indigo_ss_data[i].ra_now = position.ra * RAD2DEG / 15;
+		indigo_ss_data[i].dec_now = position.dec * RAD2DEG;
 	}
 	return indigo_ss_data;
 }
+
+indigocat_ss_entry *indigocat_get_ss_data(void) {
+	return indigocat_get_ss_data_jd(JDNOW);
+}
@@ -25,11 +25,14 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include <indigo/indigocat/indigocat_star.h>
 
 #include <indigo/indigocat/indigocat_precession.h>
+#include <indigo/indigocat/indigocat_index.h>
 
 static bool star_data_updated = false;
 
@@ -41096,14 +41099,40 @@ static indigocat_star_entry indigo_star_data[] = {
 
 indigocat_star_entry *indigocat_get_star_data(void) {
 	if (!star_data_updated) {
-		for (int i = 0; indigo_star_data[i].hip; i++) {
-			double ra = indigo_star_data[i].ra;
-			double dec = indigo_star_data[i].dec;
-			indigocat_j2k_to_jnow_pm(&ra, &dec, indigo_star_data[i].promora, indigo_star_data[i].promodec);
-			indigo_star_data[i].ra_now = ra;
-			indigo_star_data[i].dec_now = dec;
+		int count = sizeof(indigo_star_data) / sizeof(indigocat_star_entry) - 1;
+		double *ra = malloc(2 * count * sizeof(double));
+		double *dec = ra + count;
+		float *pm = malloc(2 * count * sizeof(float));
+		for (int i = 0; i < count; i++) {
+			ra[i] = indigo_star_data[i].ra;
+			dec[i] = indigo_star_data[i].dec;
+			pm[i] = indigo_star_data[i].promora;
+			pm[count + i] = indigo_star_data[i].promodec;
 		}
+		indigocat_j2k_to_jnow_pm_batch(ra, dec, pm, pm + count, count);
+		for (int i = 0; i < count; i++) {
+			indigo_star_data[i].ra_now = ra[i];
+			indigo_star_data[i].dec_now = dec[i];
+		}
+		free(ra);
+		free(pm);
 		star_data_updated = true;
 	}
 	return indigo_star_data;
 }
+
+static indigocat_zone_index star_index = {
+	indigo_star_data,
+	sizeof(indigo_star_data) / sizeof(indigocat_star_entry) - 1,
+	sizeof(indigocat_star_entry),
+	offsetof(indigocat_star_entry, ra),
+	offsetof(indigocat_star_entry, dec),
+	offsetof(indigocat_star_entry, ra_now),
+	offsetof(indigocat_star_entry, dec_now),
+	offsetof(indigocat_star_entry, mag)
+};
+
+int indigocat_search_stars(double ra, double dec, double radius, float max_mag, bool jnow, indigocat_star_entry **result, int max_count) {
+	indigocat_get_star_data();
+	return indigocat_search_zone_index(&star_index, ra, dec, radius, max_mag, jnow, (void **)result, max_count);
+}
@@ -35,6 +35,7 @@
 #include <arpa/inet.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/time.h>
 #ifdef INDIGO_LINUX
 #include <sys/prctl.h>
 #endif
@@ -50,6 +51,9 @@
 #include <indigo/indigo_xml.h>
 #include <indigo/indigo_token.h>
 #include <indigo/indigo_align.h>
+#include <indigo/indigo_recorder.h>
+#include <indigo/indigo_bus_trace.h>
+#include <indigo/indigo_frame_pool.h>
 #include <indigo/indigocat/indigocat_star.h>
 #include <indigo/indigocat/indigocat_dso.h>
 #include <indigo/indigocat/indigocat_ss.h>
@@ -356,6 +360,7 @@ static struct {
 static int static_drivers_count = 0;
 static int dynamic_drivers_count = 0;
 static bool command_line_drivers = false;
+static int driver_threads = 8;
 
 static indigo_property *info_property;
 static indigo_property *drivers_property;
@@ -367,6 +372,8 @@ static indigo_property *log_level_property;
 static indigo_property *blob_buffering_property;
 static indigo_property *blob_proxy_property;
 static indigo_property *server_features_property;
+static indigo_property *frame_pool_property;
+static indigo_timer *frame_pool_timer;
 
 #ifdef RPI_MANAGEMENT
 static indigo_property *wifi_country_code_property;
@@ -427,6 +434,15 @@ static bool runLoop = true;
 #define SERVER_CTRL_PANEL_ITEM										(SERVER_FEATURES_PROPERTY->items + 1)
 #define SERVER_WEB_APPS_ITEM											(SERVER_FEATURES_PROPERTY->items + 2)
 
+#define SERVER_FRAME_POOL_PROPERTY								frame_pool_property
+#define SERVER_FRAME_POOL_MAPPED_ITEM							(SERVER_FRAME_POOL_PROPERTY->items + 0)
+#define SERVER_FRAME_POOL_USED_ITEM								(SERVER_FRAME_POOL_PROPERTY->items + 1)
+#define SERVER_FRAME_POOL_CACHED_ITEM							(SERVER_FRAME_POOL_PROPERTY->items + 2)
+#define SERVER_FRAME_POOL_HUGEPAGES_ITEM					(SERVER_FRAME_POOL_PROPERTY->items + 3)
+#define SERVER_FRAME_POOL_BUFFERS_ITEM						(SERVER_FRAME_POOL_PROPERTY->items + 4)
+#define SERVER_FRAME_POOL_HITS_ITEM								(SERVER_FRAME_POOL_PROPERTY->items + 5)
+#define SERVER_FRAME_POOL_MISSES_ITEM							(SERVER_FRAME_POOL_PROPERTY->items + 6)
+
 #define SERVER_WIFI_AP_PROPERTY										wifi_ap_property
 #define SERVER_WIFI_AP_SSID_ITEM									(SERVER_WIFI_AP_PROPERTY->items + 0)
 #define SERVER_WIFI_AP_PASSWORD_ITEM							(SERVER_WIFI_AP_PROPERTY->items + 1)
@@ -722,6 +738,22 @@ static void *indigo_add_constellations_lines_json_resource() {
 	return data;
 }
 
+static void update_frame_pool(indigo_device *device) {
+	indigo_frame_pool_stats stats;
+	indigo_frame_pool_statistics(&stats);
+	if (SERVER_FRAME_POOL_MISSES_ITEM->number.value != stats.misses || SERVER_FRAME_POOL_HITS_ITEM->number.value != stats.hits || SERVER_FRAME_POOL_BUFFERS_ITEM->number.value != stats.buffers || SERVER_FRAME_POOL_MAPPED_ITEM->number.value != (stats.mapped >> 20)) {
+		SERVER_FRAME_POOL_MAPPED_ITEM->number.value = (stats.mapped >> 20);
+		SERVER_FRAME_POOL_USED_ITEM->number.value = (stats.used >> 20);
+		SERVER_FRAME_POOL_CACHED_ITEM->number.value = (stats.cached >> 20);
+		SERVER_FRAME_POOL_HUGEPAGES_ITEM->number.value = (stats.hugepages >> 20);
+		SERVER_FRAME_POOL_BUFFERS_ITEM->number.value = stats.buffers;
+		SERVER_FRAME_POOL_HITS_ITEM->number.value = stats.hits;
+		SERVER_FRAME_POOL_MISSES_ITEM->number.value = stats.misses;
+		indigo_update_property(device, SERVER_FRAME_POOL_PROPERTY, NULL);
+	}
+	indigo_reschedule_timer(device, 5, &frame_pool_timer);
+}
+
 #ifdef RPI_MANAGEMENT
 
 static indigo_result execute_command(indigo_device *device, indigo_property *property, char *command, ...) {
@@ -987,6 +1019,15 @@ static indigo_result attach(indigo_device *device) {
 	indigo_init_switch_item(SERVER_BONJOUR_ITEM, SERVER_BONJOUR_ITEM_NAME, "Bonjour", indigo_use_bonjour);
 	indigo_init_switch_item(SERVER_CTRL_PANEL_ITEM, SERVER_CTRL_PANEL_ITEM_NAME, "Control panel / Server manager", use_ctrl_panel);
 	indigo_init_switch_item(SERVER_WEB_APPS_ITEM, SERVER_WEB_APPS_ITEM_NAME, "Web applications", use_web_apps);
+	SERVER_FRAME_POOL_PROPERTY = indigo_init_number_property(NULL, device->name, SERVER_FRAME_POOL_PROPERTY_NAME, MAIN_GROUP, "Frame buffer pool", INDIGO_OK_STATE, INDIGO_RO_PERM, 7);
+	indigo_init_number_item(SERVER_FRAME_POOL_MAPPED_ITEM, SERVER_FRAME_POOL_MAPPED_ITEM_NAME, "Mapped memory [MB]", 0, 1e9, 0, 0);
+	indigo_init_number_item(SERVER_FRAME_POOL_USED_ITEM, SERVER_FRAME_POOL_USED_ITEM_NAME, "Used memory [MB]", 0, 1e9, 0, 0);
+	indigo_init_number_item(SERVER_FRAME_POOL_CACHED_ITEM, SERVER_FRAME_POOL_CACHED_ITEM_NAME, "Cached memory [MB]", 0, 1e9, 0, 0);
+	indigo_init_number_item(SERVER_FRAME_POOL_HUGEPAGES_ITEM, SERVER_FRAME_POOL_HUGEPAGES_ITEM_NAME, "Huge page memory [MB]", 0, 1e9, 0, 0);
+	indigo_init_number_item(SERVER_FRAME_POOL_BUFFERS_ITEM, SERVER_FRAME_POOL_BUFFERS_ITEM_NAME, "Buffers in use", 0, 1e9, 0, 0);
+	indigo_init_number_item(SERVER_FRAME_POOL_HITS_ITEM, SERVER_FRAME_POOL_HITS_ITEM_NAME, "Reused buffers", 0, 1e12, 0, 0);
+	indigo_init_number_item(SERVER_FRAME_POOL_MISSES_ITEM, SERVER_FRAME_POOL_MISSES_ITEM_NAME, "Mapped buffers", 0, 1e12, 0, 0);
+	indigo_set_timer(device, 5, update_frame_pool, &frame_pool_timer);
 #ifdef RPI_MANAGEMENT
 	if (use_rpi_management) {
 		SERVER_WIFI_AP_PROPERTY = indigo_init_text_property(NULL, server_device.name, SERVER_WIFI_AP_PROPERTY_NAME, MAIN_GROUP, "Configure access point WiFi mode", INDIGO_OK_STATE, INDIGO_RW_PERM, 2);
@@ -1072,6 +1113,7 @@ static indigo_result enumerate_properties(indigo_device *device, indigo_client *
 	indigo_define_property(device, SERVER_BLOB_BUFFERING_PROPERTY, NULL);
 	indigo_define_property(device, SERVER_BLOB_PROXY_PROPERTY, NULL);
 	indigo_define_property(device, SERVER_FEATURES_PROPERTY, NULL);
+	indigo_define_property(device, SERVER_FRAME_POOL_PROPERTY, NULL);
 #ifdef RPI_MANAGEMENT
 	if (use_rpi_management) {
 		indigo_define_property(device, SERVER_WIFI_COUNTRY_CODE_PROPERTY, NULL);
@@ -1098,6 +1140,348 @@ static void send_driver_load_error_message(indigo_result result, char *driver_na
 	}
 }
 
+// -------------------------------------------------------------------------------- parallel driver loading
+
+typedef struct {
+	char name[INDIGO_NAME_SIZE];
+	char family[INDIGO_NAME_SIZE];
+	indigo_driver_entry *driver;
+	indigo_result result;
+	double time;
+} driver_task;
+
+typedef struct {
+	driver_task *tasks;
+	int count;
+	int next;
+	pthread_mutex_t mutex;
+} driver_queue;
+
+static double driver_time() {
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return now.tv_sec + now.tv_usec / 1e6;
+}
+
+/* Drivers of the same vendor (indigo_ccd_asi, indigo_wheel_asi, ... or indigo_ccd_qhy and indigo_ccd_qhy2) share SDK or check each other
+   with indigo_driver_initialized(), so they are initialized one after another in the original order. */
+
+static void driver_family(const char *name, char *family) {
+	const char *base = strrchr(name, '/');
+	base = base ? base + 1 : name;
+	const char *vendor = strrchr(base, '_');
+	indigo_copy_name(family, vendor && vendor[1] ? vendor + 1 : base);
+	char *dot = strchr(family, '.');
+	if (dot)
+		*dot = 0;
+	for (char *end = family + strlen(family) - 1; end > family && *end >= '0' && *end <= '9'; end--)
+		*end = 0;
+}
+
+static void init_driver(driver_task *task) {
+	double start = driver_time();
+	if (task->driver) {
+		task->result = task->driver->driver(INDIGO_DRIVER_INIT, NULL);
+		task->driver->initialized = task->result == INDIGO_OK;
+	} else {
+		task->result = indigo_load_driver(task->name, true, &task->driver);
+	}
+	task->time = driver_time() - start;
+	INDIGO_DEBUG(indigo_debug("Driver %s initialized in %.3fs (%s)", task->name, task->time, task->result == INDIGO_OK ? "OK" : "failed"));
+}
+
+static void *driver_worker(driver_queue *queue) {
+	while (true) {
+		pthread_mutex_lock(&queue->mutex);
+		int first = queue->next;
+		while (first < queue->count && queue->tasks[first].family[0] == 0)
+			first++;
+		if (first == queue->count) {
+			queue->next = first;
+			pthread_mutex_unlock(&queue->mutex);
+			return NULL;
+		}
+		char family[INDIGO_NAME_SIZE];
+		indigo_copy_name(family, queue->tasks[first].family);
+		int chain[INDIGO_MAX_DRIVERS], chain_count = 0;
+		for (int i = first; i < queue->count; i++) {
+			if (!strcmp(queue->tasks[i].family, family)) {
+				queue->tasks[i].family[0] = 0;
+				chain[chain_count++] = i;
+			}
+		}
+		queue->next = first + 1;
+		pthread_mutex_unlock(&queue->mutex);
+		for (int i = 0; i < chain_count; i++)
+			init_driver(queue->tasks + chain[i]);
+	}
+}
+
+static void init_drivers(driver_task *tasks, int count) {
+	if (count == 0)
+		return;
+	double start = driver_time();
+	driver_queue queue = { tasks, count, 0, PTHREAD_MUTEX_INITIALIZER };
+	for (int i = 0; i < count; i++)
+		driver_family(tasks[i].name, tasks[i].family);
+	int families = 0;
+	for (int i = 0; i < count; i++) {
+		bool found = false;
+		for (int j = 0; j < i && !found; j++)
+			found = !strcmp(tasks[i].family, tasks[j].family);
+		if (!found)
+			families++;
+	}
+	int thread_count = families < driver_threads ? families : driver_threads;
+	pthread_t threads[thread_count > 1 ? thread_count : 1];
+	int started = 0;
+	for (int i = 0; i < thread_count && thread_count > 1; i++) {
+		if (pthread_create(&threads[started], NULL, (void *(*)(void *))driver_worker, &queue) == 0)
+			started++;
+	}
+	if (started == 0)
+		driver_worker(&queue);
+	for (int i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
+	double elapsed = driver_time() - start, total = 0;
+	int order[count];
+	for (int i = 0; i < count; i++) {
+		order[i] = i;
+		total += tasks[i].time;
+	}
+	for (int i = 1; i < count; i++) {
+		for (int j = i; j > 0 && tasks[order[j]].time > tasks[order[j - 1]].time; j--) {
+			int tmp = order[j];
+			order[j] = order[j - 1];
+			order[j - 1] = tmp;
+		}
+	}
+	for (int i = 0; i < count; i++) {
+		driver_task *task = tasks + order[i];
+		INDIGO_LOG(indigo_log("  %-32s %7.3fs%s", task->name, task->time, task->result == INDIGO_OK ? "" : " (failed)"));
+	}
+	INDIGO_LOG(indigo_log("%d drivers initialized in %.3fs by %d threads (%.3fs if serial)", count, elapsed, started > 0 ? started : 1, total));
+}
+
+// Driver list changes (DRIVERS, LOAD and UNLOAD) are queued by change_property() and applied in order by drivers_handler()
+// holding drivers_mutex. change_property() runs with bus lock held under strict locking while driver INIT needs it, so it
+// must never wait for drivers_mutex, it only appends a request.
+
+typedef struct driver_request {
+	indigo_property *drivers;
+	bool unload;
+	char path[INDIGO_VALUE_SIZE];
+	struct driver_request *next;
+} driver_request;
+
+static pthread_mutex_t drivers_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t driver_requests_mutex = PTHREAD_MUTEX_INITIALIZER;
+static driver_request *driver_requests = NULL;
+static indigo_timer *drivers_timer = NULL;
+static bool drivers_handler_scheduled = false;
+static bool drivers_shutdown = false;
+
+static void apply_drivers(indigo_device *device, indigo_property *request) {
+	indigo_property_copy_values(SERVER_DRIVERS_PROPERTY, request, false);
+	SERVER_DRIVERS_PROPERTY->state = INDIGO_BUSY_STATE;
+	indigo_update_property(device, SERVER_DRIVERS_PROPERTY, NULL);
+	driver_task *tasks = indigo_safe_malloc(SERVER_DRIVERS_PROPERTY->count * sizeof(driver_task));
+	int task_count = 0;
+	for (int i = 0; i < SERVER_DRIVERS_PROPERTY->count; i++) {
+		char *name = SERVER_DRIVERS_PROPERTY->items[i].name;
+		indigo_driver_entry *driver = NULL;
+		for (int j = 0; j < INDIGO_MAX_DRIVERS; j++) {
+			if (!strcmp(indigo_available_drivers[j].name, name)) {
+				driver = &indigo_available_drivers[j];
+				break;
+			}
+		}
+		if (SERVER_DRIVERS_PROPERTY->items[i].sw.value) {
+			if (driver == NULL || !driver->initialized) {
+				driver_task *task = tasks + task_count++;
+				indigo_copy_name(task->name, name);
+				task->driver = driver;
+			}
+		} else if (driver) {
+			indigo_result result = INDIGO_OK;
+			if (driver->dl_handle) {
+				result = indigo_remove_driver(driver);
+				if (result != INDIGO_OK) {
+					SERVER_DRIVERS_PROPERTY->items[i].sw.value = true;
+				}
+			} else if (driver->initialized) {
+				result = driver->driver(INDIGO_DRIVER_SHUTDOWN, NULL);
+				if (result != INDIGO_OK) {
+					SERVER_DRIVERS_PROPERTY->items[i].sw.value = true;
+				} else {
+					driver->initialized = false;
+				}
+			}
+			if (result != INDIGO_OK) {
+				if (result == INDIGO_BUSY) {
+					indigo_send_message(device, "Driver %s is in use, can't be unloaded", name);
+				} else {
+					indigo_send_message(device, "Driver %s failed to unload", name);
+				}
+			}
+		}
+	}
+	init_drivers(tasks, task_count);
+	for (int i = 0; i < task_count; i++) {
+		driver_task *task = tasks + i;
+		indigo_item *item = indigo_get_item(SERVER_DRIVERS_PROPERTY, task->name);
+		if (item && item->sw.value)
+			item->sw.value = task->result == INDIGO_OK;
+		if (task->driver && task->driver->dl_handle && !task->driver->initialized)
+			indigo_remove_driver(task->driver);
+		send_driver_load_error_message(task->result, task->name);
+	}
+	free(tasks);
+	SERVER_DRIVERS_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, SERVER_DRIVERS_PROPERTY, NULL);
+	int handle = 0;
+	if (!command_line_drivers) {
+		indigo_save_property(device, &handle, SERVER_DRIVERS_PROPERTY);
+		close(handle);
+	}
+}
+
+static void load_driver(indigo_device *device, char *path) {
+	char *name = basename(path);
+	for (int i = 0; i < INDIGO_MAX_DRIVERS; i++)
+		if (!strcmp(name, indigo_available_drivers[i].name)) {
+			SERVER_LOAD_PROPERTY->state = INDIGO_ALERT_STATE;
+			indigo_update_property(device, SERVER_LOAD_PROPERTY, "Driver %s (%s) is already loaded", name, indigo_available_drivers[i].description);
+			return;
+		}
+	indigo_driver_entry *driver = NULL;
+	indigo_result result = INDIGO_OK;
+	if ((result = indigo_load_driver(path, true, &driver)) == INDIGO_OK) {
+		bool found = false;
+		for (int i = 0; i < SERVER_DRIVERS_PROPERTY->count; i++) {
+			if (!strcmp(SERVER_DRIVERS_PROPERTY->items[i].name, name)) {
+				SERVER_DRIVERS_PROPERTY->items[i].sw.value = true;
+				SERVER_DRIVERS_PROPERTY->state = INDIGO_OK_STATE;
+				indigo_update_property(device, SERVER_DRIVERS_PROPERTY, NULL);
+				found = true;
+				break;
+			}
+		}
+		if (!found && SERVER_DRIVERS_PROPERTY->count < INDIGO_MAX_DRIVERS) {
+			indigo_delete_property(device, SERVER_DRIVERS_PROPERTY, NULL);
+			indigo_init_switch_item(&SERVER_DRIVERS_PROPERTY->items[SERVER_DRIVERS_PROPERTY->count], driver->name, driver->description, driver->initialized);
+			SERVER_DRIVERS_PROPERTY->count++;
+			SERVER_DRIVERS_PROPERTY->state = INDIGO_OK_STATE;
+			indigo_define_property(device, SERVER_DRIVERS_PROPERTY, NULL);
+		}
+		SERVER_LOAD_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, SERVER_LOAD_PROPERTY, "Driver %s (%s) loaded", name, driver->description);
+	} else {
+		SERVER_LOAD_PROPERTY->state = INDIGO_ALERT_STATE;
+		if (driver && !driver->initialized) {
+			indigo_remove_driver(driver);
+		}
+		send_driver_load_error_message(result, name);
+		indigo_update_property(device, SERVER_LOAD_PROPERTY, NULL);
+	}
+}
+
+static void unload_driver(indigo_device *device, char *path) {
+	char *name = basename(path);
+	for (int i = 0; i < INDIGO_MAX_DRIVERS; i++)
+		if (!strcmp(name, indigo_available_drivers[i].name)) {
+			indigo_result result;
+			if (indigo_available_drivers[i].dl_handle) {
+				result = indigo_remove_driver(&indigo_available_drivers[i]);
+			} else {
+				result = indigo_available_drivers[i].driver(INDIGO_DRIVER_SHUTDOWN, NULL);
+				if (result == INDIGO_OK)
+					indigo_available_drivers[i].initialized = false;
+			}
+			if (result == INDIGO_OK) {
+				for (int j = 0; j < SERVER_DRIVERS_PROPERTY->count; j++) {
+					if (!strcmp(SERVER_DRIVERS_PROPERTY->items[j].name, name)) {
+						SERVER_DRIVERS_PROPERTY->items[j].sw.value = false;
+						SERVER_DRIVERS_PROPERTY->state = INDIGO_OK_STATE;
+						indigo_update_property(device, SERVER_DRIVERS_PROPERTY, NULL);
+						break;
+					}
+				}
+				SERVER_UNLOAD_PROPERTY->state = INDIGO_OK_STATE;
+				indigo_update_property(device, SERVER_UNLOAD_PROPERTY, "Driver %s unloaded", name);
+			} else if (result == INDIGO_BUSY) {
+				SERVER_UNLOAD_PROPERTY->state = INDIGO_ALERT_STATE;
+				indigo_update_property(device, SERVER_UNLOAD_PROPERTY, "Driver %s is in use, can't be unloaded", name);
+			} else {
+				SERVER_UNLOAD_PROPERTY->state = INDIGO_ALERT_STATE;
+				indigo_update_property(device, SERVER_UNLOAD_PROPERTY, "Driver %s failed to unload", name);
+			}
+			return;
+		}
+	SERVER_UNLOAD_PROPERTY->state = INDIGO_ALERT_STATE;
+	indigo_update_property(device, SERVER_UNLOAD_PROPERTY, "Driver %s is not loaded", name);
+}
+
+static void release_driver_request(driver_request *request) {
+	if (request->drivers)
+		indigo_release_property(request->drivers);
+	free(request);
+}
+
+static void drivers_handler(indigo_device *device) {
+	pthread_mutex_lock(&drivers_mutex);
+	while (true) {
+		pthread_mutex_lock(&driver_requests_mutex);
+		driver_request *request = drivers_shutdown ? NULL : driver_requests;
+		if (request)
+			driver_requests = request->next;
+		else
+			drivers_handler_scheduled = false;
+		pthread_mutex_unlock(&driver_requests_mutex);
+		if (request == NULL)
+			break;
+		if (request->drivers)
+			apply_drivers(device, request->drivers);
+		else if (request->unload)
+			unload_driver(device, request->path);
+		else
+			load_driver(device, request->path);
+		release_driver_request(request);
+	}
+	pthread_mutex_unlock(&drivers_mutex);
+}
+
+static void queue_driver_request(indigo_device *device, driver_request *request) {
+	pthread_mutex_lock(&driver_requests_mutex);
+	if (drivers_shutdown) {
+		pthread_mutex_unlock(&driver_requests_mutex);
+		release_driver_request(request);
+		return;
+	}
+	driver_request **last = &driver_requests;
+	while (*last)
+		last = &(*last)->next;
+	*last = request;
+	if (!drivers_handler_scheduled) {
+		drivers_handler_scheduled = indigo_set_timer(device, 0, drivers_handler, &drivers_timer);
+	}
+	pthread_mutex_unlock(&driver_requests_mutex);
+}
+
+static void cancel_driver_requests(indigo_device *device) {
+	pthread_mutex_lock(&driver_requests_mutex);
+	drivers_shutdown = true;
+	pthread_mutex_unlock(&driver_requests_mutex);
+	indigo_cancel_timer_sync(device, &drivers_timer);
+	pthread_mutex_lock(&driver_requests_mutex);
+	while (driver_requests) {
+		driver_request *request = driver_requests;
+		driver_requests = request->next;
+		release_driver_request(request);
+	}
+	pthread_mutex_unlock(&driver_requests_mutex);
+}
+
 static indigo_result change_property(indigo_device *device, indigo_client *client, indigo_property *property) {
 	assert(device != NULL);
 	assert(property != NULL);
@@ -1120,146 +1504,31 @@ static indigo_result change_property(indigo_device *device, indigo_client *clien
 	// -------------------------------------------------------------------------------- DRIVERS
 		if (command_line_drivers && !strcmp(client->name, CONFIG_READER))
 			return INDIGO_OK;
-		indigo_property_copy_values(SERVER_DRIVERS_PROPERTY, property, false);
-		for (int i = 0; i < SERVER_DRIVERS_PROPERTY->count; i++) {
-			char *name = SERVER_DRIVERS_PROPERTY->items[i].name;
-			indigo_driver_entry *driver = NULL;
-			for (int j = 0; j < INDIGO_MAX_DRIVERS; j++) {
-				if (!strcmp(indigo_available_drivers[j].name, name)) {
-					driver = &indigo_available_drivers[j];
-					break;
-				}
-			}
-			if (SERVER_DRIVERS_PROPERTY->items[i].sw.value) {
-				if (driver) {
-					if (driver->dl_handle == NULL && !driver->initialized) {
-						indigo_result result = driver->driver(INDIGO_DRIVER_INIT, NULL);
-						SERVER_DRIVERS_PROPERTY->items[i].sw.value = driver->initialized = result == INDIGO_OK;
-						send_driver_load_error_message(result, driver->name);
-					} else if (driver->dl_handle != NULL && !driver->initialized) {
-						indigo_result result = driver->driver(INDIGO_DRIVER_INIT, NULL);
-						SERVER_DRIVERS_PROPERTY->items[i].sw.value = driver->initialized = result == INDIGO_OK;
-						send_driver_load_error_message(result, driver->name);
-						if (driver && !driver->initialized)
-							indigo_remove_driver(driver);
-					}
-				} else {
-					indigo_result result = indigo_load_driver(name, true, &driver);
-					SERVER_DRIVERS_PROPERTY->items[i].sw.value = result == INDIGO_OK;
-					if (driver && !driver->initialized) {
-						indigo_remove_driver(driver);
-					}
-					send_driver_load_error_message(result, name);
-				}
-			} else if (driver) {
-				indigo_result result = INDIGO_OK;
-				if (driver->dl_handle) {
-					result = indigo_remove_driver(driver);
-					if (result != INDIGO_OK) {
-						SERVER_DRIVERS_PROPERTY->items[i].sw.value = true;
-					}
-				} else if (driver->initialized) {
-					result = driver->driver(INDIGO_DRIVER_SHUTDOWN, NULL);
-					if (result != INDIGO_OK) {
-						SERVER_DRIVERS_PROPERTY->items[i].sw.value = true;
-					} else {
-						driver->initialized = false;
-					}
-				}
-				if (result != INDIGO_OK) {
-					if (result == INDIGO_BUSY) {
-						indigo_send_message(device, "Driver %s is in use, can't be unloaded", name);
-					} else {
-						indigo_send_message(device, "Driver %s failed to unload", name);
-					}
-				}
-			}
-		}
-		SERVER_DRIVERS_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, SERVER_DRIVERS_PROPERTY, NULL);
-		int handle = 0;
-		if (!command_line_drivers) {
-			indigo_save_property(device, &handle, SERVER_DRIVERS_PROPERTY);
-			close(handle);
-		}
+		driver_request *request = indigo_safe_malloc(sizeof(driver_request));
+		request->drivers = indigo_copy_property(NULL, property);
+		queue_driver_request(device, request);
 		return INDIGO_OK;
 	} else if (indigo_property_match(SERVER_LOAD_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- LOAD
 		indigo_property_copy_values(SERVER_LOAD_PROPERTY, property, false);
 		if (*SERVER_LOAD_ITEM->text.value) {
-			char *name = basename(SERVER_LOAD_ITEM->text.value);
-			for (int i = 0; i < INDIGO_MAX_DRIVERS; i++)
-				if (!strcmp(name, indigo_available_drivers[i].name)) {
-					SERVER_LOAD_PROPERTY->state = INDIGO_ALERT_STATE;
-					indigo_update_property(device, SERVER_LOAD_PROPERTY, "Driver %s (%s) is already loaded", name, indigo_available_drivers[i].description);
-					return INDIGO_OK;
-				}
-			indigo_driver_entry *driver = NULL;
-			indigo_result result = INDIGO_OK;
-			if ((result = indigo_load_driver(SERVER_LOAD_ITEM->text.value, true, &driver)) == INDIGO_OK) {
-				bool found = false;
-				for (int i = 0; i < SERVER_DRIVERS_PROPERTY->count; i++) {
-					if (!strcmp(SERVER_DRIVERS_PROPERTY->items[i].name, name)) {
-						SERVER_DRIVERS_PROPERTY->items[i].sw.value = true;
-						SERVER_DRIVERS_PROPERTY->state = INDIGO_OK_STATE;
-						indigo_update_property(device, SERVER_DRIVERS_PROPERTY, NULL);
-						found = true;
-						break;
-					}
-				}
-				if (!found) {
-					indigo_delete_property(device, SERVER_DRIVERS_PROPERTY, NULL);
-					indigo_init_switch_item(&SERVER_DRIVERS_PROPERTY->items[SERVER_DRIVERS_PROPERTY->count++], driver->name, driver->description, driver->initialized);
-					SERVER_DRIVERS_PROPERTY->state = INDIGO_OK_STATE;
-					indigo_define_property(device, SERVER_DRIVERS_PROPERTY, NULL);
-				}
-				SERVER_LOAD_PROPERTY->state = INDIGO_OK_STATE;
-				indigo_update_property(device, SERVER_LOAD_PROPERTY, "Driver %s (%s) loaded", name, driver->description);
-			} else {
-				SERVER_LOAD_PROPERTY->state = INDIGO_ALERT_STATE;
-				if (driver && !driver->initialized) {
-					indigo_remove_driver(driver);
-				}
-				send_driver_load_error_message(result, name);
-				indigo_update_property(device, SERVER_LOAD_PROPERTY, NULL);
-			}
+			driver_request *request = indigo_safe_malloc(sizeof(driver_request));
+			indigo_copy_value(request->path, SERVER_LOAD_ITEM->text.value);
+			SERVER_LOAD_PROPERTY->state = INDIGO_BUSY_STATE;
+			indigo_update_property(device, SERVER_LOAD_PROPERTY, NULL);
+			queue_driver_request(device, request);
 		}
 		return INDIGO_OK;
 	} else if (indigo_property_match(SERVER_UNLOAD_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- UNLOAD
 		indigo_property_copy_values(SERVER_UNLOAD_PROPERTY, property, false);
 		if (*SERVER_UNLOAD_ITEM->text.value) {
-			char *name = basename(SERVER_UNLOAD_ITEM->text.value);
-			for (int i = 0; i < INDIGO_MAX_DRIVERS; i++)
-				if (!strcmp(name, indigo_available_drivers[i].name)) {
-					indigo_result result;
-					if (indigo_available_drivers[i].dl_handle) {
-						result = indigo_remove_driver(&indigo_available_drivers[i]);
-					} else {
-						result = indigo_available_drivers[i].driver(INDIGO_DRIVER_SHUTDOWN, NULL);
-					}
-					if (result == INDIGO_OK) {
-						for (int j = 0; j < SERVER_DRIVERS_PROPERTY->count; j++) {
-							if (!strcmp(SERVER_DRIVERS_PROPERTY->items[j].name, name)) {
-								SERVER_DRIVERS_PROPERTY->items[j].sw.value = false;
-								SERVER_DRIVERS_PROPERTY->state = INDIGO_OK_STATE;
-								indigo_update_property(device, SERVER_DRIVERS_PROPERTY, NULL);
-								break;
-							}
-						}
-						SERVER_UNLOAD_PROPERTY->state = INDIGO_OK_STATE;
-						indigo_update_property(device, SERVER_UNLOAD_PROPERTY, "Driver %s unloaded", name);
-					} else if (result == INDIGO_BUSY) {
-						SERVER_UNLOAD_PROPERTY->state = INDIGO_ALERT_STATE;
-						indigo_update_property(device, SERVER_UNLOAD_PROPERTY, "Driver %s is in use, can't be unloaded", name);
-					} else {
-						SERVER_UNLOAD_PROPERTY->state = INDIGO_ALERT_STATE;
-						indigo_update_property(device, SERVER_UNLOAD_PROPERTY, "Driver %s failed to unload", name);
-					}
-					return INDIGO_OK;
-				}
-			SERVER_UNLOAD_PROPERTY->state = INDIGO_ALERT_STATE;
-			indigo_update_property(device, SERVER_UNLOAD_PROPERTY, "Driver %s is not loaded", name);
+			driver_request *request = indigo_safe_malloc(sizeof(driver_request));
+			request->unload = true;
+			indigo_copy_value(request->path, SERVER_UNLOAD_ITEM->text.value);
+			SERVER_UNLOAD_PROPERTY->state = INDIGO_BUSY_STATE;
+			indigo_update_property(device, SERVER_UNLOAD_PROPERTY, NULL);
+			queue_driver_request(device, request);
 		}
 		return INDIGO_OK;
 	} else if (indigo_property_match(SERVER_RESTART_PROPERTY, property)) {
@@ -1390,7 +1659,9 @@ static indigo_result detach(indigo_device *device) {
 	indigo_delete_property(device, SERVER_LOG_LEVEL_PROPERTY, NULL);
 	indigo_delete_property(device, SERVER_BLOB_BUFFERING_PROPERTY, NULL);
 	indigo_delete_property(device, SERVER_BLOB_PROXY_PROPERTY, NULL);
+	indigo_cancel_timer_sync(device, &frame_pool_timer);
 	indigo_delete_property(device, SERVER_FEATURES_PROPERTY, NULL);
+	indigo_delete_property(device, SERVER_FRAME_POOL_PROPERTY, NULL);
 #ifdef RPI_MANAGEMENT
 	if (use_rpi_management) {
 		indigo_delete_property(device, SERVER_WIFI_COUNTRY_CODE_PROPERTY, NULL);
@@ -1414,6 +1685,7 @@ static indigo_result detach(indigo_device *device) {
 	indigo_release_property(SERVER_BLOB_BUFFERING_PROPERTY);
 	indigo_release_property(SERVER_BLOB_PROXY_PROPERTY);
 	indigo_release_property(SERVER_FEATURES_PROPERTY);
+	indigo_release_property(SERVER_FRAME_POOL_PROPERTY);
 #ifdef RPI_MANAGEMENT
 	indigo_release_property(SERVER_WIFI_COUNTRY_CODE_PROPERTY);
 	indigo_release_property(SERVER_WIFI_AP_PROPERTY);
@@ -1511,6 +1783,8 @@ static void server_main() {
 			i++;
 		}
 	}
+	driver_task *command_line_tasks = indigo_safe_malloc(server_argc * sizeof(driver_task));
+	int command_line_task_count = 0;
 	for (int i = 1; i < server_argc; i++) {
 		if ((!strcmp(server_argv[i], "-p") || !strcmp(server_argv[i], "--port")) && i < server_argc - 1) {
 			indigo_server_tcp_port = atoi(server_argv[i + 1]);
@@ -1557,6 +1831,29 @@ static void server_main() {
 			indigo_use_blob_compression = true;
 		} else if (!strcmp(server_argv[i], "-x") || !strcmp(server_argv[i], "--enable-blob-proxy")) {
 			indigo_proxy_blob = true;
+		} else if (!strcmp(server_argv[i], "-P") || !strcmp(server_argv[i], "--enable-blob-prefetch")) {
+			indigo_use_blob_prefetch = true;
+		} else if (!strcmp(server_argv[i], "-D") || !strcmp(server_argv[i], "--enable-direct-io")) {
+			indigo_use_direct_io = true;
+		} else if (!strcmp(server_argv[i], "-A") || !strcmp(server_argv[i], "--enable-async-log")) {
+			indigo_start_async_log(NULL);
+		} else if ((!strcmp(server_argv[i], "-L") || !strcmp(server_argv[i], "--log-file")) && i < server_argc - 1) {
+			indigo_start_async_log(server_argv[i + 1]);
+			i++;
+		} else if ((!strcmp(server_argv[i], "-R") || !strcmp(server_argv[i], "--record-bus-trace")) && i < server_argc - 1) {
+			indigo_start_bus_trace(server_argv[i + 1]);
+			i++;
+		} else if ((!strcmp(server_argv[i], "-H") || !strcmp(server_argv[i], "--frame-pool-hugepages")) && i < server_argc - 1) {
+			if (!strcmp(server_argv[i + 1], "transparent"))
+				indigo_frame_pool_hugepages = INDIGO_FRAME_POOL_TRANSPARENT_HUGEPAGES;
+			else if (!strcmp(server_argv[i + 1], "explicit"))
+				indigo_frame_pool_hugepages = INDIGO_FRAME_POOL_EXPLICIT_HUGEPAGES;
+			else
+				indigo_frame_pool_hugepages = INDIGO_FRAME_POOL_NO_HUGEPAGES;
+			i++;
+		} else if ((!strcmp(server_argv[i], "-M") || !strcmp(server_argv[i], "--frame-pool-limit")) && i < server_argc - 1) {
+			indigo_frame_pool_limit = atol(server_argv[i + 1]) * 1024L * 1024L;
+			i++;
 #ifdef RPI_MANAGEMENT
 		} else if (!strcmp(server_argv[i], "-f") || !strcmp(server_argv[i], "--enable-rpi-management")) {
 			FILE *output = popen("which s_rpi_ctrl.sh", "r");
@@ -1572,11 +1869,16 @@ static void server_main() {
 				indigo_log("No s_rpi_ctrl.sh found");
 			}
 #endif /* RPI_MANAGEMENT */
+		} else if ((!strcmp(server_argv[i], "-j") || !strcmp(server_argv[i], "--driver-threads")) && i < server_argc - 1) {
+			driver_threads = atoi(server_argv[i + 1]);
+			i++;
 		} else if(server_argv[i][0] != '-') {
-			indigo_load_driver(server_argv[i], true, NULL);
+			indigo_copy_name(command_line_tasks[command_line_task_count++].name, server_argv[i]);
 			command_line_drivers = true;
 		}
 	}
+	init_drivers(command_line_tasks, command_line_task_count);
+	free(command_line_tasks);
 
 	use_ctrl_panel |= use_web_apps;
 
@@ -1746,11 +2048,15 @@ static void server_main() {
 	}
 #endif
 
+	/* drop pending driver list changes and wait for the one in progress */
+	cancel_driver_requests(&server_device);
+	pthread_mutex_lock(&drivers_mutex);
 	for (int i = 0; i < INDIGO_MAX_DRIVERS; i++) {
 		if (indigo_available_drivers[i].driver) {
 			indigo_remove_driver(&indigo_available_drivers[i]);
 		}
 	}
+	pthread_mutex_unlock(&drivers_mutex);
 	for (int i = 0; i < INDIGO_MAX_SERVERS; i++) {
 		if (indigo_available_subprocesses[i].thread_started)
 			indigo_kill_subprocess(&indigo_available_subprocesses[i]);
@@ -1818,6 +2124,9 @@ int main(int argc, const char * argv[]) {
 			printf("options:\n"
 			       "       --  | --do-not-fork\n"
 			       "       -l  | --use-syslog\n"
+			       "       -A  | --enable-async-log              (log is written by background thread)\n"
+			       "       -L  | --log-file file                 (asynchronous log to rotated files)\n"
+			       "       -R  | --record-bus-trace file         (binary trace of bus events for indigo_trace_replay)\n"
 			       "       -p  | --port port                     (default: 7624)\n"
 			       "       -b  | --bonjour name                  (default: hostname)\n"
 			       "       -T  | --master-token token            (master token for devce access default: 0 = none)\n"
@@ -1837,6 +2146,11 @@ int main(int argc, const char * argv[]) {
 			       "       -vvv| --enable-trace\n"
 			       "       -r  | --remote-server host[:port]     (default port: 7624)\n"
 			       "       -x  | --enable-blob-proxy\n"
+			       "       -P  | --enable-blob-prefetch\n"
+			       "       -D  | --enable-direct-io              (bypass page cache when recording video)\n"
+			       "       -H  | --frame-pool-hugepages mode     (none, transparent or explicit, default: none)\n"
+			       "       -M  | --frame-pool-limit MB           (memory cached by frame buffer pool, default: 1024)\n"
+			       "       -j  | --driver-threads count          (drivers initialized in parallel, default: 8)\n"
 			       "       -i  | --indi-driver driver_executable\n"
 			);
 			return 0;
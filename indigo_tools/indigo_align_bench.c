@@ -0,0 +1,140 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// INDIGO coordinate transformation benchmark
+//
+// Converts a set of random objects from J2000 to a target equinox and to horizontal coordinates, once with
+// the single point functions and once with the batch functions, reports objects per second for both and
+// fails if the results differ.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_align.h>
+
+#define TOLERANCE	1e-9
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double angle_difference(double a, double b, double range) {
+	double d = fabs(a - b);
+	return d > range / 2 ? range - d : d;
+}
+
+int main(int argc, const char * argv[]) {
+	int count = 100000;
+	int repeat = 10;
+	double equinox = 2026.5;
+	double latitude = 48.15, longitude = 17.11;
+	for (int i = 1; i < argc; i++) {
+		if ((!strcmp(argv[i], "-n") || !strcmp(argv[i], "--count")) && argc > i + 1) {
+			count = atoi(argv[++i]);
+		} else if ((!strcmp(argv[i], "-r") || !strcmp(argv[i], "--repeat")) && argc > i + 1) {
+			repeat = atoi(argv[++i]);
+		} else if ((!strcmp(argv[i], "-e") || !strcmp(argv[i], "--equinox")) && argc > i + 1) {
+			equinox = atof(argv[++i]);
+		} else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			printf("usage: %s [-n | --count objects (default: 100000)] [-r | --repeat count (default: 10)] [-e | --equinox year (default: 2026.5, 0 = JNow)]\n", argv[0]);
+			return 0;
+		}
+	}
+	if (count <= 0 || repeat <= 0) {
+		fprintf(stderr, "Invalid arguments\n");
+		return 1;
+	}
+	double *ra = indigo_safe_malloc(count * sizeof(double));
+	double *dec = indigo_safe_malloc(count * sizeof(double));
+	double *single_ra = indigo_safe_malloc(count * sizeof(double));
+	double *single_dec = indigo_safe_malloc(count * sizeof(double));
+	double *single_alt = indigo_safe_malloc(count * sizeof(double));
+	double *single_az = indigo_safe_malloc(count * sizeof(double));
+	double *batch_ra = indigo_safe_malloc(count * sizeof(double));
+	double *batch_dec = indigo_safe_malloc(count * sizeof(double));
+	double *batch_alt = indigo_safe_malloc(count * sizeof(double));
+	double *batch_az = indigo_safe_malloc(count * sizeof(double));
+	srand(1);
+	for (int i = 0; i < count; i++) {
+		ra[i] = 24.0 * rand() / RAND_MAX;
+		dec[i] = asin(2.0 * rand() / RAND_MAX - 1) * 180 / M_PI;
+	}
+	time_t utc = time(NULL);
+
+	double start = now();
+	for (int r = 0; r < repeat; r++) {
+		for (int i = 0; i < count; i++) {
+			single_ra[i] = ra[i];
+			single_dec[i] = dec[i];
+			indigo_j2k_to_eq(equinox, single_ra + i, single_dec + i);
+			indigo_radec_to_altaz(single_ra[i], single_dec[i], &utc, latitude, longitude, 0, single_alt + i, single_az + i);
+		}
+	}
+	double single_time = (now() - start) / repeat;
+
+	start = now();
+	for (int r = 0; r < repeat; r++) {
+		indigo_transform_context context;
+		indigo_init_transform_context(&context, equinox, &utc, latitude, longitude);
+		memcpy(batch_ra, ra, count * sizeof(double));
+		memcpy(batch_dec, dec, count * sizeof(double));
+		indigo_j2k_to_eq_batch(&context, batch_ra, batch_dec, count);
+		indigo_radec_to_altaz_batch(&context, batch_ra, batch_dec, batch_alt, batch_az, count);
+	}
+	double batch_time = (now() - start) / repeat;
+
+	/* RA and azimuth differences are scaled to arc lengths, they are ill-conditioned near the poles and zenith */
+	double max_eq = 0, max_hor = 0;
+	for (int i = 0; i < count; i++) {
+		double d = fmax(angle_difference(single_ra[i], batch_ra[i], 24) * 15 * cos(single_dec[i] * M_PI / 180), fabs(single_dec[i] - batch_dec[i]));
+		if (d > max_eq)
+			max_eq = d;
+		d = fmax(angle_difference(single_az[i], batch_az[i], 360) * cos(single_alt[i] * M_PI / 180), fabs(single_alt[i] - batch_alt[i]));
+		if (d > max_hor)
+			max_hor = d;
+	}
+	printf("%d objects, equinox %g, averaged over %d runs\n", count, equinox, repeat);
+	printf("single point: %8.3f ms, %6.1f ns/object\n", single_time * 1e3, single_time * 1e9 / count);
+	printf("batch:        %8.3f ms, %6.1f ns/object (%.1fx)\n", batch_time * 1e3, batch_time * 1e9 / count, single_time / batch_time);
+	printf("max difference %.3g deg equatorial, %.3g deg horizontal\n", max_eq, max_hor);
+	int result = 0;
+	if (max_eq > TOLERANCE || max_hor > TOLERANCE) {
+		fprintf(stderr, "Batch results differ from single point results\n");
+		result = 1;
+	}
+	free(ra);
+	free(dec);
+	free(single_ra);
+	free(single_dec);
+	free(single_alt);
+	free(single_az);
+	free(batch_ra);
+	free(batch_dec);
+	free(batch_alt);
+	free(batch_az);
+	return result;
+}
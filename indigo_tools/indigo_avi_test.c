@@ -0,0 +1,295 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// INDIGO AVI writer test
+//
+// Writes a synthetic OpenDML AVI file of given size (by default over 4GB) with gwavi and parses it back. RIFF AVI and
+// AVIX chain, avih, strh and dmlh frame counts, indx super index, ix00 standard indexes and idx1 of the first RIFF are
+// validated, every indexed frame must carry its sequence number, so dropped frames are tolerated but holes are not.
+// Small frame file is written first, so the first RIFF holds several standard indexes interleaved with frames.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_avi.h>
+
+#define WIDTH				640
+#define HEIGHT			480
+#define SMALL_WIDTH		160
+#define SMALL_HEIGHT	120
+#define SMALL_FRAMES	(3 * GWAVI_STANDARD_INDEX_SIZE)
+
+static int handle;
+static uint32_t frame_size;
+static uint64_t file_size;
+static int errors = 0;
+
+#define CHECK(condition, ...) \
+	if (!(condition)) { \
+		fprintf(stderr, __VA_ARGS__); \
+		fprintf(stderr, "\n"); \
+		if (++errors > 10) \
+			return false; \
+	}
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint16_t get_short(const unsigned char *buffer) {
+	return buffer[0] | buffer[1] << 8;
+}
+
+static uint32_t get_int(const unsigned char *buffer) {
+	return buffer[0] | buffer[1] << 8 | buffer[2] << 16 | (uint32_t)buffer[3] << 24;
+}
+
+static uint64_t get_long(const unsigned char *buffer) {
+	return get_int(buffer) | (uint64_t)get_int(buffer + 4) << 32;
+}
+
+static bool read_at(uint64_t offset, void *buffer, size_t length) {
+	if (offset + length > file_size)
+		return false;
+	return pread(handle, buffer, length, (off_t)offset) == (ssize_t)length;
+}
+
+/* chunk at offset must have given id, its size is returned */
+
+static bool read_chunk(uint64_t offset, const char *id, uint32_t *size) {
+	unsigned char header[8];
+	if (!read_at(offset, header, 8) || memcmp(header, id, 4))
+		return false;
+	*size = get_int(header + 4);
+	return true;
+}
+
+/* frame chunk payload starts with its sequence number and ends with its length */
+
+static bool check_frame(uint64_t data, uint32_t size, uint32_t sequence) {
+	unsigned char header[8], stamp[4];
+	uint32_t length = frame_size - sequence % 4;
+	uint32_t padded = (length + 3) & ~3U;
+	CHECK(read_at(data - 8, header, 8) && !memcmp(header, "00dc", 4), "frame %u: no 00dc chunk at %llu", sequence, (unsigned long long)data - 8);
+	CHECK(get_int(header + 4) == size && size == padded, "frame %u: size %u, chunk size %u, expected %u", sequence, size, get_int(header + 4), padded);
+	CHECK(read_at(data, stamp, 4) && get_int(stamp) == sequence, "frame %u: sequence number %u found", sequence, get_int(stamp));
+	CHECK(read_at(data + length - 4, stamp, 4) && get_int(stamp) == length, "frame %u: trailing length doesn't match", sequence);
+	return true;
+}
+
+static bool validate(const char *filename, unsigned int written_frames) {
+	struct stat st;
+	if ((handle = open(filename, O_RDONLY)) < 0 || fstat(handle, &st) < 0) {
+		perror(filename);
+		return false;
+	}
+	file_size = st.st_size;
+	unsigned char buffer[12];
+	uint32_t size;
+
+	/* RIFF chain */
+	uint64_t riff_end[GWAVI_SUPER_INDEX_SIZE], movi_start[GWAVI_SUPER_INDEX_SIZE], movi_end[GWAVI_SUPER_INDEX_SIZE];
+	uint64_t hdrl = 0, idx1 = 0;
+	int riff_count = 0;
+	for (uint64_t offset = 0; offset < file_size; riff_count++) {
+		CHECK(riff_count < GWAVI_SUPER_INDEX_SIZE, "too many RIFF chunks");
+		CHECK(read_chunk(offset, "RIFF", &size) && read_at(offset + 8, buffer, 4), "no RIFF chunk at %llu", (unsigned long long)offset);
+		CHECK(!memcmp(buffer, riff_count == 0 ? "AVI " : "AVIX", 4), "RIFF %d has wrong form type", riff_count);
+		CHECK(size <= GWAVI_RIFF_SIZE, "RIFF %d is %u bytes long", riff_count, size);
+		riff_end[riff_count] = offset + 8 + size;
+		movi_start[riff_count] = 0;
+		for (uint64_t chunk = offset + 12; chunk < riff_end[riff_count]; ) {
+			CHECK(read_at(chunk, buffer, 12), "truncated chunk at %llu", (unsigned long long)chunk);
+			uint32_t chunk_size = get_int(buffer + 4);
+			if (!memcmp(buffer, "LIST", 4) && !memcmp(buffer + 8, "hdrl", 4)) {
+				CHECK(riff_count == 0, "hdrl in RIFF %d", riff_count);
+				hdrl = chunk;
+			} else if (!memcmp(buffer, "LIST", 4) && !memcmp(buffer + 8, "movi", 4)) {
+				movi_start[riff_count] = chunk;
+				movi_end[riff_count] = chunk + 8 + chunk_size;
+			} else if (!memcmp(buffer, "idx1", 4)) {
+				CHECK(riff_count == 0, "idx1 in RIFF %d", riff_count);
+				idx1 = chunk;
+			}
+			chunk += 8 + ((chunk_size + 1) & ~1U);
+			CHECK(chunk <= riff_end[riff_count], "chunk at %llu exceeds RIFF %d", (unsigned long long)chunk, riff_count);
+		}
+		CHECK(movi_start[riff_count], "no movi LIST in RIFF %d", riff_count);
+		offset = riff_end[riff_count];
+	}
+	CHECK(riff_end[riff_count - 1] == file_size, "trailing data after the last RIFF");
+	CHECK(hdrl && idx1, "hdrl or idx1 is missing");
+	if (errors)
+		return false;
+
+	/* headers */
+	unsigned char header[1024 + 16 * GWAVI_SUPER_INDEX_SIZE];
+	uint32_t hdrl_size;
+	read_chunk(hdrl, "LIST", &hdrl_size);
+	CHECK(hdrl_size + 8 <= sizeof(header) && read_at(hdrl, header, hdrl_size + 8), "hdrl is too long");
+	CHECK(!memcmp(header + 12, "avih", 4), "no avih");
+	uint32_t avih_frames = get_int(header + 20 + 16);
+	uint64_t strl = 12 + 8 + get_int(header + 16);
+	CHECK(!memcmp(header + strl, "LIST", 4) && !memcmp(header + strl + 8, "strl", 4), "no strl");
+	uint64_t odml = strl + 8 + get_int(header + strl + 4);
+	uint64_t strh = strl + 12;
+	CHECK(!memcmp(header + strh, "strh", 4) && !memcmp(header + strh + 8, "vids", 4), "no vids strh");
+	uint32_t strh_length = get_int(header + strh + 8 + 32);
+	uint64_t strf = strh + 8 + get_int(header + strh + 4);
+	CHECK(!memcmp(header + strf, "strf", 4), "no strf");
+	uint64_t indx = strf + 8 + get_int(header + strf + 4);
+	CHECK(!memcmp(header + indx, "indx", 4), "no indx");
+	CHECK(!memcmp(header + odml, "LIST", 4) && !memcmp(header + odml + 8, "odmldmlh", 8), "no odml LIST");
+	uint32_t dmlh_frames = get_int(header + odml + 20);
+	CHECK(dmlh_frames == written_frames && strh_length == written_frames, "%u frames written, dmlh says %u, strh says %u", written_frames, dmlh_frames, strh_length);
+
+	/* super index and standard indexes */
+	unsigned char *super_index = header + indx;
+	CHECK(get_short(super_index + 8) == 4 && super_index[11] == 0 && !memcmp(super_index + 16, "00dc", 4), "indx is not index of indexes");
+	uint32_t super_index_count = get_int(super_index + 12);
+	CHECK(32 + 16 * super_index_count <= get_int(super_index + 4) + 8, "indx has %u entries", super_index_count);
+	uint32_t sequence = 0, riff_frames = 0;
+	unsigned char *index = NULL;
+	int riff = 0;
+	for (uint32_t i = 0; i < super_index_count && errors == 0; i++) {
+		unsigned char *entry = super_index + 32 + 16 * i;
+		uint64_t offset = get_long(entry);
+		uint32_t entry_size = get_int(entry + 8), duration = get_int(entry + 12);
+		while (riff < riff_count && offset >= riff_end[riff])
+			riff++;
+		CHECK(riff < riff_count && offset >= movi_start[riff] && offset + entry_size <= movi_end[riff], "indx entry %u at %llu is outside of movi", i, (unsigned long long)offset);
+		CHECK(read_chunk(offset, "ix00", &size) && size + 8 == entry_size, "indx entry %u doesn't point to ix00", i);
+		index = indigo_safe_realloc(index, entry_size);
+		CHECK(read_at(offset, index, entry_size), "can't read ix00 %u", i);
+		CHECK(get_short(index + 8) == 2 && index[11] == 1 && !memcmp(index + 16, "00dc", 4), "ix00 %u is not index of chunks", i);
+		CHECK(get_int(index + 12) == duration && 32 + 8 * duration <= entry_size, "ix00 %u has %u entries, indx says %u", i, get_int(index + 12), duration);
+		uint64_t base = get_long(index + 20);
+		CHECK(base == movi_start[riff], "ix00 %u base offset is not movi of RIFF %d", i, riff);
+		for (uint32_t j = 0; j < duration && errors == 0; j++, sequence++) {
+			uint64_t data = base + get_int(index + 32 + 8 * j);
+			uint32_t frame_size = get_int(index + 36 + 8 * j);
+			CHECK(data > movi_start[riff] && data + frame_size <= movi_end[riff], "frame %u is outside of movi of RIFF %d", sequence, riff);
+			check_frame(data, frame_size, sequence);
+			if (riff == 0)
+				riff_frames++;
+		}
+	}
+	CHECK(sequence == written_frames, "%u frames written, %u frames indexed", written_frames, sequence);
+
+	/* legacy index of the first RIFF */
+	CHECK(read_chunk(idx1, "idx1", &size) && size == 16 * avih_frames && avih_frames == riff_frames, "idx1 has %u entries, avih says %u, first RIFF has %u frames", size / 16, avih_frames, riff_frames);
+	index = indigo_safe_realloc(index, size);
+	CHECK(read_at(idx1 + 8, index, size), "can't read idx1");
+	for (uint32_t i = 0; i < size / 16 && errors == 0; i++) {
+		unsigned char *entry = index + 16 * i;
+		CHECK(!memcmp(entry, "00dc", 4) && get_int(entry + 4) == 0x10, "idx1 entry %u is not a key frame", i);
+		/* idx1 offsets are relative to 'movi' form type and point to chunk header */
+		check_frame(movi_start[0] + 8 + get_int(entry + 8) + 8, get_int(entry + 12), i);
+	}
+	indigo_safe_free(index);
+	close(handle);
+	printf("%llu bytes, %d RIFF chunks, %u super index entries, %u frames (%u in idx1)\n", (unsigned long long)file_size, riff_count, super_index_count, sequence, avih_frames);
+	return errors == 0;
+}
+
+static int run(const char *filename, unsigned int width, unsigned int height, uint64_t target, bool keep) {
+	frame_size = width * height * 3;
+	if (target < frame_size) {
+		fprintf(stderr, "Invalid arguments\n");
+		return 1;
+	}
+	errors = 0;
+	unsigned char *frame = indigo_safe_malloc(frame_size);
+	struct gwavi_t *gwavi = gwavi_open(filename, width, height, "Y800", 30);
+	if (gwavi == NULL) {
+		fprintf(stderr, "Can't create %s\n", filename);
+		return 1;
+	}
+	double start = now();
+	long attempts = 0;
+	/* frame lengths vary, so chunk padding is exercised too */
+	while (gwavi->position < target) {
+		uint32_t sequence = gwavi->total_frames;
+		uint32_t length = frame_size - sequence % 4;
+		frame[0] = sequence; frame[1] = sequence >> 8; frame[2] = sequence >> 16; frame[3] = sequence >> 24;
+		frame[length - 4] = length; frame[length - 3] = length >> 8; frame[length - 2] = length >> 16; frame[length - 1] = length >> 24;
+		attempts++;
+		if (!gwavi_add_frame(gwavi, frame, length)) {
+			perror("gwavi_add_frame");
+			return 1;
+		}
+		/* frame was dropped, let the writer catch up */
+		if (gwavi->total_frames == sequence)
+			indigo_usleep(1000);
+	}
+	unsigned int written_frames = gwavi->total_frames;
+	long dropped = gwavi->recorder->dropped;
+	if (!gwavi_close(gwavi)) {
+		perror("gwavi_close");
+		return 1;
+	}
+	printf("%ux%u: %u frames written in %.1f s, %ld dropped\n", width, height, written_frames, now() - start, dropped);
+	free(frame);
+	int result = 0;
+	if (attempts != written_frames + dropped) {
+		fprintf(stderr, "%ld frames added, %ld accounted for\n", attempts, written_frames + dropped);
+		result = 1;
+	}
+	if (!validate(filename, written_frames))
+		result = 1;
+	if (!keep)
+		unlink(filename);
+	return result;
+}
+
+int main(int argc, const char * argv[]) {
+	indigo_main_argc = argc;
+	indigo_main_argv = argv;
+	const char *filename = "/tmp/indigo_avi_test.avi";
+	uint64_t target = 4608L * 1024L * 1024L;
+	bool keep = false;
+	for (int i = 1; i < argc; i++) {
+		if ((!strcmp(argv[i], "-s") || !strcmp(argv[i], "--size")) && argc > i + 1) {
+			target = (uint64_t)(atof(argv[++i]) * 1024 * 1024 * 1024);
+		} else if (!strcmp(argv[i], "-d") || !strcmp(argv[i], "--direct")) {
+			indigo_use_direct_io = true;
+		} else if (!strcmp(argv[i], "-k") || !strcmp(argv[i], "--keep")) {
+			keep = true;
+		} else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			printf("usage: %s [-s | --size GB (default: 4.5)] [-d | --direct] [-k | --keep] [file (default: %s)]\n", argv[0], filename);
+			return 0;
+		} else {
+			filename = argv[i];
+		}
+	}
+	int result = run(filename, SMALL_WIDTH, SMALL_HEIGHT, (uint64_t)SMALL_FRAMES * SMALL_WIDTH * SMALL_HEIGHT * 3, false);
+	result |= run(filename, WIDTH, HEIGHT, target, keep);
+	printf(result ? "FAILED\n" : "OK\n");
+	return result;
+}
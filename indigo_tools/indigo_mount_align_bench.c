@@ -0,0 +1,148 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// INDIGO mount alignment benchmark
+//
+// Attaches a bare mount device, fills its alignment model with random points and measures how many
+// translated <-> raw coordinate translations per second nearest point and multi point modes sustain.
+// Round trips are checked to stay within tolerance of the original coordinates.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_mount_driver.h>
+
+#define TOLERANCE	(10.0 / 3600)
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static indigo_result bench_attach(indigo_device *device) {
+	return indigo_mount_attach(device, "Mount alignment benchmark", INDIGO_VERSION_CURRENT);
+}
+
+static indigo_device bench_device = INDIGO_DEVICE_INITIALIZER(
+	"Mount Alignment Bench",
+	bench_attach,
+	indigo_mount_enumerate_properties,
+	indigo_mount_change_property,
+	NULL,
+	indigo_mount_detach
+);
+
+static double range24(double hours) {
+	return fmod(hours + 24000, 24);
+}
+
+static double random_ra() {
+	return 24.0 * rand() / RAND_MAX;
+}
+
+static double random_dec() {
+	return asin(2.0 * rand() / RAND_MAX - 1) * 180 / M_PI;
+}
+
+static double translations(indigo_device *device, int count, double lst, double *max_error) {
+	double start = now();
+	*max_error = 0;
+	for (int i = 0; i < count; i++) {
+		double ra = random_ra(), dec = random_dec() * 0.9, raw_ra, raw_dec, back_ra, back_dec;
+		int side_of_pier = range24(lst - ra) < 12 ? MOUNT_SIDE_WEST : MOUNT_SIDE_EAST;
+		indigo_translated_to_raw_with_lst(device, lst, ra, dec, side_of_pier, &raw_ra, &raw_dec);
+		indigo_raw_to_translated_with_lst(device, lst, raw_ra, raw_dec, side_of_pier, &back_ra, &back_dec);
+		double d_ra = fabs(back_ra - ra);
+		if (d_ra > 12)
+			d_ra = 24 - d_ra;
+		double error = fmax(d_ra * 15 * cos(dec * M_PI / 180), fabs(back_dec - dec));
+		if (error > *max_error)
+			*max_error = error;
+	}
+	return 2 * count / (now() - start);
+}
+
+int main(int argc, const char * argv[]) {
+	indigo_main_argc = argc;
+	indigo_main_argv = argv;
+	int point_count = 1000;
+	int count = 1000000;
+	for (int i = 1; i < argc; i++) {
+		if ((!strcmp(argv[i], "-p") || !strcmp(argv[i], "--points")) && argc > i + 1) {
+			point_count = atoi(argv[++i]);
+		} else if ((!strcmp(argv[i], "-n") || !strcmp(argv[i], "--count")) && argc > i + 1) {
+			count = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			printf("usage: %s [-p | --points count (default: 1000, max: %d)] [-n | --count translations (default: 1000000)]\n", argv[0], MOUNT_MAX_ALIGNMENT_POINTS);
+			return 0;
+		}
+	}
+	if (point_count <= 0 || point_count > MOUNT_MAX_ALIGNMENT_POINTS || count <= 0) {
+		fprintf(stderr, "Invalid arguments\n");
+		return 1;
+	}
+	indigo_start();
+	indigo_device *device = &bench_device;
+	if (indigo_attach_device(device) != INDIGO_OK) {
+		fprintf(stderr, "Can't attach mount device\n");
+		return 1;
+	}
+	/* model with a constant offset and small noise, so round trips can be checked */
+	srand(1);
+	double lst = 6.0;
+	pthread_mutex_lock(&MOUNT_CONTEXT->alignment_mutex);
+	indigo_mount_reserve_alignment_points(device, point_count);
+	MOUNT_CONTEXT->alignment_point_count = point_count;
+	for (int i = 0; i < point_count; i++) {
+		indigo_alignment_point *point = MOUNT_CONTEXT->alignment_points + i;
+		point->used = true;
+		point->lst = lst;
+		point->ra = random_ra();
+		point->dec = random_dec() * 0.9;
+		point->raw_ra = range24(point->ra + 0.01 + 0.0001 * rand() / RAND_MAX);
+		point->raw_dec = point->dec - 0.1 - 0.001 * rand() / RAND_MAX;
+		point->side_of_pier = range24(lst - point->ra) < 12 ? MOUNT_SIDE_WEST : MOUNT_SIDE_EAST;
+	}
+	pthread_mutex_unlock(&MOUNT_CONTEXT->alignment_mutex);
+	indigo_mount_update_alignment_cache(device);
+
+	int result = 0;
+	indigo_item *modes[] = { MOUNT_ALIGNMENT_MODE_NEAREST_POINT_ITEM, MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM };
+	printf("%d alignment points, %d round trips per mode\n", point_count, count);
+	for (int m = 0; m < 2; m++) {
+		indigo_set_switch(MOUNT_ALIGNMENT_MODE_PROPERTY, modes[m], true);
+		double max_error;
+		double rate = translations(device, count, lst, &max_error);
+		printf("%-20s %12.0f translations/s, max round trip error %.2f\"\n", modes[m]->label, rate, max_error * 3600);
+		if (max_error > TOLERANCE) {
+			fprintf(stderr, "%s round trip error exceeds tolerance\n", modes[m]->label);
+			result = 1;
+		}
+	}
+	indigo_detach_device(device);
+	indigo_stop();
+	return result;
+}
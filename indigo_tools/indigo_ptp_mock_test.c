@@ -0,0 +1,291 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// INDIGO PTP transfer test
+//
+// Compiles PTP transport of ccd_ptp driver against a libusb mock, which plays a camera sending an object in a data
+// container followed by a response. Synchronous and pipelined asynchronous data phases, failed and never completing
+// (cancelled) transfers, and recycling of download buffers are checked, as well as that no transfer is leaked.
+
+#include "../indigo_drivers/ccd_ptp/indigo_ptp.c"
+
+#define MOCK_EP_IN		0x81
+#define MOCK_EP_OUT		0x02
+#define MOCK_QUEUE_SIZE	16
+
+// -------------------------------------------------------------------------------- libusb mock
+
+static struct {
+	unsigned char *data;	// data container followed by response container
+	int length;
+	int position;
+	int boundary;					// end of data container, transfer never crosses it
+	int fail_at;					// camera stops sending data at this position (-1 = never)
+	bool stuck;						// cancelled transfers never complete
+} camera;
+
+static struct {
+	struct libusb_transfer *transfer;
+	bool cancelled;
+} queue[MOCK_QUEUE_SIZE];
+
+static int queue_count, in_flight, max_in_flight, allocated_transfers, freed_transfers, event_calls;
+
+static int camera_read(unsigned char *buffer, int length, int *actual_length) {
+	int end = camera.position < camera.boundary ? camera.boundary : camera.length;
+	int count = end - camera.position < length ? end - camera.position : length;
+	*actual_length = 0;
+	if (camera.fail_at >= 0 && camera.position < camera.boundary && camera.position + count > camera.fail_at)
+		return LIBUSB_ERROR_TIMEOUT;
+	memcpy(buffer, camera.data + camera.position, count);
+	camera.position += count;
+	*actual_length = count;
+	return LIBUSB_SUCCESS;
+}
+
+int LIBUSB_CALL libusb_bulk_transfer(libusb_device_handle *dev_handle, unsigned char endpoint, unsigned char *data, int length, int *actual_length, unsigned int timeout) {
+	if (endpoint == MOCK_EP_OUT) {
+		*actual_length = length;
+		return LIBUSB_SUCCESS;
+	}
+	return camera_read(data, length, actual_length);
+}
+
+struct libusb_transfer * LIBUSB_CALL libusb_alloc_transfer(int iso_packets) {
+	allocated_transfers++;
+	return indigo_safe_malloc(sizeof(struct libusb_transfer));
+}
+
+void LIBUSB_CALL libusb_free_transfer(struct libusb_transfer *transfer) {
+	freed_transfers++;
+	free(transfer);
+}
+
+int LIBUSB_CALL libusb_submit_transfer(struct libusb_transfer *transfer) {
+	if (queue_count == MOCK_QUEUE_SIZE)
+		return LIBUSB_ERROR_BUSY;
+	queue[queue_count].transfer = transfer;
+	queue[queue_count++].cancelled = false;
+	if (++in_flight > max_in_flight)
+		max_in_flight = in_flight;
+	return LIBUSB_SUCCESS;
+}
+
+int LIBUSB_CALL libusb_cancel_transfer(struct libusb_transfer *transfer) {
+	for (int i = 0; i < queue_count; i++) {
+		if (queue[i].transfer == transfer) {
+			queue[i].cancelled = true;
+			return LIBUSB_SUCCESS;
+		}
+	}
+	return LIBUSB_ERROR_NOT_FOUND;
+}
+
+// transfers complete in order of submission, timeout is not waited for
+
+int LIBUSB_CALL libusb_handle_events_timeout_completed(libusb_context *ctx, struct timeval *tv, int *completed) {
+	event_calls++;
+	if (queue_count == 0 || (completed && *completed))
+		return LIBUSB_SUCCESS;
+	if (queue[0].cancelled && camera.stuck)
+		return LIBUSB_SUCCESS;
+	struct libusb_transfer *transfer = queue[0].transfer;
+	bool cancelled = queue[0].cancelled;
+	memmove(queue, queue + 1, --queue_count * sizeof(queue[0]));
+	in_flight--;
+	if (cancelled) {
+		transfer->actual_length = 0;
+		transfer->status = LIBUSB_TRANSFER_CANCELLED;
+	} else {
+		transfer->status = camera_read(transfer->buffer, transfer->length, &transfer->actual_length) == LIBUSB_SUCCESS ? LIBUSB_TRANSFER_COMPLETED : LIBUSB_TRANSFER_TIMED_OUT;
+	}
+	transfer->callback(transfer);
+	return LIBUSB_SUCCESS;
+}
+
+const char * LIBUSB_CALL libusb_error_name(int errcode) {
+	return errcode < 0 ? "LIBUSB_ERROR" : "LIBUSB_SUCCESS";
+}
+
+int LIBUSB_CALL libusb_clear_halt(libusb_device_handle *dev_handle, unsigned char endpoint) {
+	return LIBUSB_SUCCESS;
+}
+
+int LIBUSB_CALL libusb_open(libusb_device *dev, libusb_device_handle **dev_handle) {
+	return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+void LIBUSB_CALL libusb_close(libusb_device_handle *dev_handle) {
+}
+
+int LIBUSB_CALL libusb_get_device_descriptor(libusb_device *dev, struct libusb_device_descriptor *desc) {
+	return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+int LIBUSB_CALL libusb_get_config_descriptor(libusb_device *dev, uint8_t config_index, struct libusb_config_descriptor **config) {
+	return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+void LIBUSB_CALL libusb_free_config_descriptor(struct libusb_config_descriptor *config) {
+}
+
+int LIBUSB_CALL libusb_kernel_driver_active(libusb_device_handle *dev_handle, int interface_number) {
+	return 0;
+}
+
+int LIBUSB_CALL libusb_detach_kernel_driver(libusb_device_handle *dev_handle, int interface_number) {
+	return LIBUSB_SUCCESS;
+}
+
+int LIBUSB_CALL libusb_claim_interface(libusb_device_handle *dev_handle, int interface_number) {
+	return LIBUSB_SUCCESS;
+}
+
+// -------------------------------------------------------------------------------- Test
+
+static int failures = 0;
+
+#define CHECK(condition, ...) \
+	if (!(condition)) { \
+		fprintf(stderr, __VA_ARGS__); \
+		fprintf(stderr, "\n"); \
+		failures++; \
+	}
+
+static void put_container(unsigned char *buffer, uint32_t length, uint16_t type, uint16_t code) {
+	ptp_container *container = (ptp_container *)buffer;
+	container->length = length;
+	container->type = type;
+	container->code = code;
+	container->transaction_id = 0;
+}
+
+// prepare camera to send object of given size, fail_at is position within the object
+
+static void prepare_object(int size, int fail_at, bool stuck) {
+	free(camera.data);
+	camera.boundary = PTP_CONTAINER_HDR_SIZE + size;
+	camera.length = camera.boundary + PTP_CONTAINER_HDR_SIZE;
+	camera.data = indigo_safe_malloc(camera.length);
+	put_container(camera.data, camera.boundary, ptp_container_data, ptp_operation_GetObject);
+	for (int i = 0; i < size; i++)
+		camera.data[PTP_CONTAINER_HDR_SIZE + i] = (unsigned char)(rand() >> 7);
+	put_container(camera.data + camera.boundary, PTP_CONTAINER_HDR_SIZE, ptp_container_response, ptp_response_OK);
+	camera.position = 0;
+	camera.fail_at = fail_at < 0 ? -1 : PTP_CONTAINER_HDR_SIZE + fail_at;
+	camera.stuck = stuck;
+	max_in_flight = event_calls = 0;
+}
+
+static bool download(indigo_device *device, const char *label, int size, void **buffer) {
+	uint32_t received = 0;
+	bool result = ptp_transaction_1_0_i(device, ptp_operation_GetObject, 1, buffer, &received);
+	if (result && buffer) {
+		CHECK(received == size, "%s: %u bytes received, %d expected", label, received, size);
+		CHECK(memcmp(*buffer, camera.data + PTP_CONTAINER_HDR_SIZE, size) == 0, "%s: data differ", label);
+	}
+	CHECK(queue_count == 0 || camera.stuck, "%s: %d transfers left in flight", label, queue_count);
+	printf("%-28s %9d bytes, %s, %d transfers in flight, %d event calls\n", label, size, result ? "OK" : "failed", max_in_flight, event_calls);
+	return result;
+}
+
+int main(int argc, const char * argv[]) {
+	indigo_main_argc = argc;
+	indigo_main_argv = argv;
+	indigo_device *device = indigo_safe_malloc(sizeof(indigo_device));
+	strcpy(device->name, "PTP Mock");
+	device->private_data = indigo_safe_malloc(sizeof(ptp_private_data));
+	device->device_context = indigo_safe_malloc(sizeof(indigo_ccd_context));
+	PRIVATE_DATA->handle = (libusb_device_handle *)&camera;
+	PRIVATE_DATA->ep_in = MOCK_EP_IN;
+	PRIVATE_DATA->ep_out = MOCK_EP_OUT;
+	pthread_mutex_init(&PRIVATE_DATA->usb_mutex, NULL);
+	PRIVATE_DATA->operation_code_label = ptp_operation_code_label;
+	PRIVATE_DATA->response_code_label = ptp_response_code_label;
+	PRIVATE_DATA->event_code_label = ptp_event_code_label;
+	PRIVATE_DATA->property_code_name = ptp_property_code_name;
+	PRIVATE_DATA->property_code_label = ptp_property_code_label;
+	PRIVATE_DATA->property_value_code_label = ptp_property_value_code_label;
+	CCD_EXPOSURE_PROPERTY = indigo_init_number_property(NULL, device->name, CCD_EXPOSURE_PROPERTY_NAME, CCD_MAIN_GROUP, "Start exposure", INDIGO_OK_STATE, INDIGO_RW_PERM, 1);
+	srand(1);
+	void *buffer = NULL, *first = NULL, *second = NULL;
+	int large = 25 * 1000 * 1000 + 1;
+
+	prepare_object(100000, -1, false);
+	CHECK(download(device, "synchronous", 100000, &buffer), "synchronous download failed");
+	free(buffer);
+
+	prepare_object(PTP_ASYNC_TRANSFER_SIZE * 2, -1, false);
+	CHECK(download(device, "asynchronous, aligned", PTP_ASYNC_TRANSFER_SIZE * 2, &buffer), "aligned asynchronous download failed");
+	ptp_set_image_buffer(device, buffer, PTP_ASYNC_TRANSFER_SIZE * 2);
+
+	prepare_object(large, -1, false);
+	CHECK(download(device, "asynchronous", large, &first), "asynchronous download failed");
+	CHECK(max_in_flight == PTP_ASYNC_TRANSFER_COUNT, "%d transfers in flight, %d expected", max_in_flight, PTP_ASYNC_TRANSFER_COUNT);
+	ptp_set_image_buffer(device, first, large);
+	CHECK(PRIVATE_DATA->spare_buffer == buffer, "previous image buffer is not kept as spare");
+
+	/* spare buffer is too small, it is replaced and the buffer of the previous image becomes spare again */
+	prepare_object(large, -1, false);
+	CHECK(download(device, "asynchronous, new buffer", large, &second), "asynchronous download failed");
+	CHECK(PRIVATE_DATA->spare_buffer == NULL, "too small spare buffer kept");
+	ptp_set_image_buffer(device, second, large);
+	CHECK(PRIVATE_DATA->spare_buffer == first, "previous image buffer is not kept as spare");
+
+	prepare_object(large, -1, false);
+	CHECK(download(device, "asynchronous, recycled", large, &buffer), "asynchronous download failed");
+	CHECK(buffer == first, "spare buffer not reused");
+	ptp_set_image_buffer(device, buffer, large);
+
+	/* buffer handed to caller and freed by it (e.g. skipped object) is not remembered */
+	prepare_object(large, -1, false);
+	CHECK(download(device, "asynchronous, discarded", large, &buffer), "asynchronous download failed");
+	CHECK(PRIVATE_DATA->spare_buffer == NULL, "spare buffer not taken");
+	free(buffer);
+	ptp_set_image_buffer(device, indigo_safe_malloc(1000), 0);
+	CHECK(PRIVATE_DATA->spare_buffer == first && PRIVATE_DATA->image_buffer_size == 0, "buffer of unknown size is kept for reuse");
+
+	prepare_object(large, -1, false);
+	CHECK(download(device, "asynchronous, no data_in", large, NULL), "asynchronous download without data_in failed");
+
+	prepare_object(large, 7000000, false);
+	CHECK(!download(device, "asynchronous, timeout", large, &buffer), "failed transfer not reported");
+
+	/* cancelled transfers never complete, waiting is bounded and they free themselves when they finally complete */
+	prepare_object(large, 7000000, true);
+	CHECK(!download(device, "asynchronous, stuck", large, &buffer), "failed transfer not reported");
+	CHECK(event_calls <= 7000000 / PTP_ASYNC_TRANSFER_SIZE + PTP_ASYNC_TRANSFER_COUNT + PTP_TIMEOUT / 1000, "%d event calls while draining", event_calls);
+	CHECK(queue_count > 0, "cancelled transfers completed");
+	camera.stuck = false;
+	while (queue_count > 0)
+		libusb_handle_events_timeout_completed(NULL, NULL, NULL);
+
+	ptp_release_image_buffers(device);
+	CHECK(allocated_transfers == freed_transfers, "%d transfers allocated, %d freed", allocated_transfers, freed_transfers);
+	printf("%d transfers allocated and freed\n", allocated_transfers);
+	free(camera.data);
+	indigo_release_property(CCD_EXPOSURE_PROPERTY);
+	free(device->device_context);
+	free(device->private_data);
+	free(device);
+	printf(failures ? "FAILED\n" : "OK\n");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// INDIGO platesolver latency benchmark
+//
+// Solves a series of neighbouring fields (e.g. frames of a mosaic or of a dithered sequence, which use the same index
+// files) repeatedly, first with solver commands spawned directly from this process and then through the platesolver
+// worker pool with the index files mapped, as platesolver agents do. Latency of the first (cold) solve and of the
+// repeated solves is reported for both. indigo_solver_worker must be next to this binary or in PATH. Note that index
+// files stay in page cache once read, so for a cold direct run drop caches first (e.g. "echo 3 >/proc/sys/vm/drop_caches").
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_platesolver.h>
+
+#define DEFAULT_SOLVER		"solve-field --overwrite --no-plots --no-verify-uniformize --cpulimit 60 \"%s\" 2>&1"
+#define DEFAULT_MARKER		"Field center"
+
+typedef struct {
+	double first, min, max, total;
+	int count, solved;
+} latency;
+
+static const char *marker = DEFAULT_MARKER;
+static bool solved;
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void account(latency *stats, double time) {
+	if (solved)
+		stats->solved++;
+	if (stats->count++ == 0) {
+		stats->first = time;
+		return;
+	}
+	if (stats->count == 2 || time < stats->min)
+		stats->min = time;
+	if (time > stats->max)
+		stats->max = time;
+	stats->total += time;
+}
+
+static void report(const char *label, latency *stats) {
+	printf("%-12s first %8.3f s", label, stats->first);
+	if (stats->count > 1)
+		printf(", repeated %8.3f s min %8.3f s avg %8.3f s max", stats->min, stats->total / (stats->count - 1), stats->max);
+	printf(", %d of %d solved\n", stats->solved, stats->count);
+}
+
+static bool output_handler(indigo_device *device, char *line) {
+	if (strstr(line, marker))
+		solved = true;
+	return true;
+}
+
+static bool run(indigo_device *device, const char *solver, int rounds, int image_count, char **images, latency *stats) {
+	char command[8 * 1024];
+	for (int round = 0; round < rounds; round++) {
+		for (int i = 0; i < image_count; i++) {
+			pid_t pid;
+			snprintf(command, sizeof(command), solver, images[i]);
+			solved = false;
+			double start = now();
+			if (!indigo_platesolver_execute(device, command, &pid, output_handler)) {
+				fprintf(stderr, "Execution of '%s' failed\n", command);
+				return false;
+			}
+			account(stats, now() - start);
+		}
+	}
+	return true;
+}
+
+int main(int argc, const char * argv[]) {
+	indigo_main_argc = argc;
+	indigo_main_argv = argv;
+	const char *solver = DEFAULT_SOLVER;
+	int rounds = 3;
+	char **images = NULL, **indexes = NULL;
+	int image_count = 0, index_count = 0;
+	for (int i = 1; i < argc; i++) {
+		if ((!strcmp(argv[i], "-n") || !strcmp(argv[i], "--rounds")) && argc > i + 1) {
+			rounds = atoi(argv[++i]);
+		} else if ((!strcmp(argv[i], "-s") || !strcmp(argv[i], "--solver")) && argc > i + 1) {
+			solver = argv[++i];
+		} else if ((!strcmp(argv[i], "-m") || !strcmp(argv[i], "--marker")) && argc > i + 1) {
+			marker = argv[++i];
+		} else if ((!strcmp(argv[i], "-i") || !strcmp(argv[i], "--index")) && argc > i + 1) {
+			indexes = realloc(indexes, (index_count + 1) * sizeof(char *));
+			indexes[index_count++] = (char *)argv[++i];
+		} else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			printf("usage: %s [-n | --rounds count (default: 3)] [-s | --solver command_template (default: '%s')] [-m | --marker solved_output_text (default: '%s')] [-i | --index index_file ...] image ...\n", argv[0], DEFAULT_SOLVER, DEFAULT_MARKER);
+			return 0;
+		} else {
+			images = realloc(images, (image_count + 1) * sizeof(char *));
+			images[image_count++] = (char *)argv[i];
+		}
+	}
+	if (rounds <= 0 || image_count == 0 || strstr(solver, "%s") == NULL) {
+		fprintf(stderr, "Invalid arguments, see %s --help\n", argv[0]);
+		return 1;
+	}
+	platesolver_private_data *private_data = indigo_safe_malloc(sizeof(platesolver_private_data));
+	pthread_mutex_init(&private_data->pool_mutex, NULL);
+	pthread_cond_init(&private_data->pool_cond, NULL);
+	indigo_device device = { 0 };
+	strcpy(device.name, "Solver Bench");
+	device.private_data = private_data;
+
+	latency direct = { 0 }, pool = { 0 };
+	// solver commands are spawned directly while the pool is marked unavailable
+	private_data->pool_unavailable = true;
+	int result = run(&device, solver, rounds, image_count, images, &direct) ? 0 : 1;
+	private_data->pool_unavailable = false;
+	if (result == 0 && index_count > 0) {
+		double start = now();
+		if (!indigo_platesolver_map_files(&device, index_count, indexes)) {
+			fprintf(stderr, "Failed to map index files\n");
+			result = 1;
+		} else {
+			printf("%d index file(s) mapped in %.3f s\n", index_count, now() - start);
+		}
+	}
+	if (result == 0)
+		result = run(&device, solver, rounds, image_count, images, &pool) ? 0 : 1;
+	if (result == 0) {
+		printf("%d field(s) solved %d times\n", image_count, rounds);
+		report("direct", &direct);
+		report("worker pool", &pool);
+	}
+	for (int i = 0; i < INDIGO_PLATESOLVER_POOL_SIZE; i++) {
+		if (private_data->pool[i].pid > 0) {
+			close(private_data->pool[i].request);
+			fclose(private_data->pool[i].output);
+		}
+	}
+	free(images);
+	free(indexes);
+	return result;
+}
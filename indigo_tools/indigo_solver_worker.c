@@ -0,0 +1,176 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// INDIGO platesolver worker
+//
+// Spawned by platesolver agents for each solver pool slot. Reads requests from stdin and writes replies and job
+// output to stdout. Requests are lines "X <command>" (execute), "M <path>" (map file), "R" (release all mapped files)
+// and "S" (sync), worker replies with "\001PID <pid>" when the job is started and "\001END <status>" when it is
+// finished. Mapped files stay mapped (and cached) between jobs, up to half of physical memory.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#define POOL_MARKER					'\001'
+#define POOL_MAX_MAPPED_FILES		4096
+
+extern char **environ;
+
+static void close_inherited_files(void) {
+#if defined(SYS_close_range)
+	if (syscall(SYS_close_range, 3, ~0U, 0) == 0)
+		return;
+#endif
+	long max = sysconf(_SC_OPEN_MAX);
+	if (max < 0 || max > 65536)
+		max = 65536;
+	for (int fd = 3; fd < max; fd++)
+		close(fd);
+}
+
+static size_t map_budget(void) {
+	long pages = sysconf(_SC_PHYS_PAGES);
+	long page_size = sysconf(_SC_PAGESIZE);
+	if (pages <= 0 || page_size <= 0)
+		return (size_t)1 << 30;
+	return (size_t)pages * page_size / 2;
+}
+
+static void reply(const char *tag, int value) {
+	char buffer[32];
+	int length = snprintf(buffer, sizeof(buffer), "%c%s %d\n", POOL_MARKER, tag, value);
+	while (length > 0) {
+		ssize_t written = write(STDOUT_FILENO, buffer, length);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+			break;
+		length -= written;
+	}
+}
+
+static void execute(char *command, sigset_t *default_signals) {
+	pid_t pid = 0;
+	int status = -1;
+	sigset_t no_signals;
+	sigemptyset(&no_signals);
+	posix_spawnattr_t attr;
+	posix_spawn_file_actions_t actions;
+	posix_spawnattr_init(&attr);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+	posix_spawnattr_setpgroup(&attr, 0);
+	posix_spawnattr_setsigdefault(&attr, default_signals);
+	posix_spawnattr_setsigmask(&attr, &no_signals);
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+	char *argv[] = { "sh", "-c", command, NULL };
+	if (posix_spawn(&pid, "/bin/sh", &actions, &attr, argv, environ) == 0) {
+		reply("PID", pid);
+		while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+			;
+	}
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attr);
+	reply("END", status >= 0 && WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+}
+
+int main(int argc, const char * argv[]) {
+	static char buffer[16 * 1024];
+	static void *map_address[POOL_MAX_MAPPED_FILES];
+	static size_t map_length[POOL_MAX_MAPPED_FILES];
+	int map_count = 0, length = 0;
+	size_t mapped = 0, budget = map_budget();
+	close_inherited_files();
+	signal(SIGPIPE, SIG_IGN);
+	sigset_t default_signals;
+	sigemptyset(&default_signals);
+	sigaddset(&default_signals, SIGPIPE);
+	while (true) {
+		char *nl = memchr(buffer, '\n', length);
+		if (nl == NULL) {
+			if (length == sizeof(buffer))
+				length = 0;
+			ssize_t bytes_read = read(STDIN_FILENO, buffer + length, sizeof(buffer) - length);
+			if (bytes_read < 0 && errno == EINTR)
+				continue;
+			if (bytes_read <= 0)
+				break;
+			length += bytes_read;
+			continue;
+		}
+		*nl = 0;
+		char *argument = buffer + 2;
+		switch (buffer[0]) {
+			case 'X': {
+				execute(argument, &default_signals);
+				break;
+			}
+			case 'M': {
+				int fd = open(argument, O_RDONLY | O_CLOEXEC);
+				struct stat st;
+				if (fd >= 0 && map_count < POOL_MAX_MAPPED_FILES && fstat(fd, &st) == 0 && st.st_size > 0) {
+					if (mapped + st.st_size > budget) {
+						fprintf(stderr, "indigo_solver_worker: %s not mapped, %zu MB budget exhausted\n", argument, budget >> 20);
+					} else {
+						void *address = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+						if (address != MAP_FAILED) {
+							madvise(address, st.st_size, MADV_WILLNEED);
+							map_address[map_count] = address;
+							map_length[map_count++] = st.st_size;
+							mapped += st.st_size;
+						}
+					}
+				}
+				if (fd >= 0)
+					close(fd);
+				break;
+			}
+			case 'R': {
+				while (map_count > 0) {
+					map_count--;
+					munmap(map_address[map_count], map_length[map_count]);
+				}
+				mapped = 0;
+				break;
+			}
+			case 'S': {
+				reply("END", map_count);
+				break;
+			}
+		}
+		length -= nl + 1 - buffer;
+		memmove(buffer, nl + 1, length);
+	}
+	return 0;
+}
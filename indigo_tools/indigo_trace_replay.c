@@ -0,0 +1,312 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// INDIGO bus trace replay tool
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_client.h>
+#include <indigo/indigo_token.h>
+#include <indigo/indigo_bus_trace.h>
+
+#define INDIGO_DEFAULT_PORT 7624
+
+static const char *event_text[] = { "", "define", "update", "delete", "change", "enumerate" };
+
+static bool replay_all = false;
+static bool print_verbose = false;
+static volatile bool interrupted = false;
+static unsigned long defined = 0, updated = 0, deleted = 0;
+
+static indigo_result client_attach(indigo_client *client) {
+	indigo_enumerate_properties(client, &INDIGO_ALL_PROPERTIES);
+	return INDIGO_OK;
+}
+
+static indigo_result client_define_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	__atomic_add_fetch(&defined, 1, __ATOMIC_RELAXED);
+	return INDIGO_OK;
+}
+
+static indigo_result client_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	__atomic_add_fetch(&updated, 1, __ATOMIC_RELAXED);
+	return INDIGO_OK;
+}
+
+static indigo_result client_delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	__atomic_add_fetch(&deleted, 1, __ATOMIC_RELAXED);
+	return INDIGO_OK;
+}
+
+static indigo_client client = {
+	"indigo_trace_replay", false, NULL, INDIGO_OK, INDIGO_VERSION_CURRENT, NULL,
+	client_attach,
+	client_define_property,
+	client_update_property,
+	client_delete_property,
+	NULL,
+	NULL
+};
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void signal_handler(int signo) {
+	interrupted = true;
+}
+
+static void print_help(const char *name) {
+	printf("INDIGO bus trace replay tool v.%d.%d-%s built on %s %s.\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD, __DATE__, __TIME__);
+	printf("usage: %s [options] trace_file\n", name);
+	printf("       %s info [-e] trace_file\n", name);
+	printf("options:\n"
+	       "       -h  | --help\n"
+	       "       -e  | --extended-info                (print every replayed or recorded event)\n"
+	       "       -a  | --all-changes                  (replay also changes issued by local clients and agents)\n"
+	       "       -s  | --speed factor                 (default: 1 = original speed, 0 = as fast as possible)\n"
+	       "       -v  | --enable-log\n"
+	       "       -vv | --enable-debug\n"
+	       "       -vvv| --enable-trace\n"
+	       "       -r  | --remote-server host[:port]   (default: localhost)\n"
+	       "       -p  | --port port                   (default: 7624)\n"
+	       "       -T  | --token token\n"
+	       "       -t  | --time-to-wait seconds        (time to wait for definitions, default: 2)\n"
+	);
+}
+
+static void print_record(indigo_bus_trace_record *record) {
+	const char *device, *name;
+	indigo_bus_trace_names(record, &device, &name);
+	printf("%12.6f %-9s %s%s.%s [%d items, %llu bytes]\n", record->time / 1e9, event_text[record->event < 6 ? record->event : 0], record->flags & INDIGO_BUS_TRACE_REMOTE ? "*" : " ", device, name, record->count, (unsigned long long)record->payload);
+}
+
+static int info(indigo_bus_trace_reader *reader) {
+	unsigned long long count[6] = { 0 }, payload[6] = { 0 }, remote = 0;
+	uint64_t last = 0;
+	indigo_bus_trace_record *record;
+	while ((record = indigo_bus_trace_next(reader))) {
+		int event = record->event < 6 ? record->event : 0;
+		count[event]++;
+		payload[event] += record->payload;
+		if (event == INDIGO_BUS_TRACE_CHANGE && (record->flags & INDIGO_BUS_TRACE_REMOTE))
+			remote++;
+		last = record->time;
+		if (print_verbose)
+			print_record(record);
+	}
+	time_t start = reader->header->start_time / 1000000000ULL;
+	char buffer[64];
+	strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", localtime(&start));
+	printf("Recorded %s, duration %.3fs, %llu events, %llu dropped\n", buffer, last / 1e9, (unsigned long long)reader->header->count, (unsigned long long)reader->header->dropped);
+	for (int i = 1; i < 6; i++)
+		printf("%-9s %10llu events %14llu bytes\n", event_text[i], count[i], payload[i]);
+	printf("%llu changes issued by remote clients\n", remote);
+	return 0;
+}
+
+static int replay(indigo_bus_trace_reader *reader, double speed) {
+	indigo_bus_trace_record *record;
+	unsigned long sent = 0, skipped = 0;
+	uint64_t first = 0;
+	double start = 0;
+	unsigned long start_updated = updated;
+	while (!interrupted && (record = indigo_bus_trace_next(reader))) {
+		if (record->event != INDIGO_BUS_TRACE_CHANGE)
+			continue;
+		if (!replay_all && !(record->flags & INDIGO_BUS_TRACE_REMOTE))
+			continue;
+		if (record->type == INDIGO_BLOB_VECTOR) {
+			skipped++;
+			continue;
+		}
+		if (start == 0) {
+			first = record->time;
+			start = now();
+		} else if (speed > 0) {
+			double delay = (record->time - first) / 1e9 / speed - (now() - start);
+			while (delay > 0 && !interrupted) {
+				indigo_usleep((unsigned)((delay > 1 ? 1 : delay) * ONE_SECOND_DELAY));
+				delay = (record->time - first) / 1e9 / speed - (now() - start);
+			}
+		}
+		indigo_property *property = indigo_bus_trace_decode(record);
+		property->access_token = indigo_get_device_or_master_token(property->device);
+		if (print_verbose)
+			print_record(record);
+		indigo_change_property(&client, property);
+		indigo_release_property(property);
+		sent++;
+	}
+	double elapsed = start > 0 ? now() - start : 0;
+	printf("Replayed %lu changes in %.3fs, %lu BLOB changes skipped\n", sent, elapsed, skipped);
+	printf("Received %lu updates (%.1f/s), %lu definitions, %lu deletions\n", updated - start_updated, elapsed > 0 ? (updated - start_updated) / elapsed : 0, defined, deleted);
+	return 0;
+}
+
+int main(int argc, const char * argv[]) {
+	indigo_main_argc = argc;
+	indigo_main_argv = argv;
+	indigo_use_host_suffix = false;
+
+	if (argc < 2) {
+		print_help(argv[0]);
+		return 0;
+	}
+
+	double time_to_wait = 2;
+	double speed = 1;
+	int port = INDIGO_DEFAULT_PORT;
+	char hostname[255] = "localhost";
+	const char *file_name = NULL;
+	bool info_requested = false;
+
+	int arg_base = 1;
+	if (!strcmp(argv[1], "info")) {
+		info_requested = true;
+		arg_base = 2;
+	}
+
+	for (int i = arg_base; i < argc; i++) {
+		if (!strcmp(argv[i], "-e") || !strcmp(argv[i], "--extended-info")) {
+			print_verbose = true;
+		} else if (!strcmp(argv[i], "-a") || !strcmp(argv[i], "--all-changes")) {
+			replay_all = true;
+		} else if (!strcmp(argv[i], "-s") || !strcmp(argv[i], "--speed")) {
+			if (argc > i+1) {
+				i++;
+				speed = atof(argv[i]);
+			} else {
+				fprintf(stderr, "No speed specified\n");
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "-r") || !strcmp(argv[i], "--remote-server")) {
+			if (argc > i+1) {
+				i++;
+				char port_str[100];
+				if (sscanf(argv[i], "%[^:]:%s", hostname, port_str) > 1) {
+					port = atoi(port_str);
+				}
+			} else {
+				fprintf(stderr, "No hostname specified\n");
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "-p") || !strcmp(argv[i], "--port")) {
+			if (argc > i+1) {
+				i++;
+				port = atoi(argv[i]);
+			} else {
+				fprintf(stderr, "No port specified\n");
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "-T") || !strcmp(argv[i], "--token")) {
+			if (argc > i+1) {
+				i++;
+				indigo_set_master_token(indigo_string_to_token(argv[i]));
+			} else {
+				fprintf(stderr, "No token specified\n");
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "-t") || !strcmp(argv[i], "--time-to-wait")) {
+			if (argc > i+1) {
+				i++;
+				time_to_wait = atof(argv[i]);
+			} else {
+				fprintf(stderr, "No time to wait specified\n");
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			print_help(argv[0]);
+			return 0;
+		} else if (argv[i][0] == '-') {
+			/* skip unknown options */
+		} else {
+			file_name = argv[i];
+		}
+	}
+
+	if (file_name == NULL) {
+		fprintf(stderr, "No trace file specified\n");
+		return 1;
+	}
+	if (port <= 0) {
+		fprintf(stderr, "Invalid port specified\n");
+		return 1;
+	}
+	if (speed < 0) {
+		fprintf(stderr, "Invalid speed specified\n");
+		return 1;
+	}
+	if (time_to_wait < 0) {
+		fprintf(stderr, "Invalid time to wait specified\n");
+		return 1;
+	}
+
+	indigo_bus_trace_reader *reader = indigo_bus_trace_open(file_name);
+	if (reader == NULL) {
+		fprintf(stderr, "Can't open %s: %s\n", file_name, strerror(errno));
+		return 1;
+	}
+	if (info_requested) {
+		int result = info(reader);
+		indigo_bus_trace_close(reader);
+		return result;
+	}
+
+	signal(SIGINT, signal_handler);
+	signal(SIGTERM, signal_handler);
+	indigo_start();
+	indigo_attach_client(&client);
+	indigo_server_entry *server;
+	indigo_connect_server(hostname, hostname, port, &server);
+	int wait_connection = 1000;
+	bool connected = false;
+	char error_message[INDIGO_VALUE_SIZE] = {0};
+	while (wait_connection--) {
+		if (true == (connected = indigo_connection_status(server, error_message))) {
+			break;
+		} else {
+			indigo_usleep(10000);
+		}
+	}
+	int result = 0;
+	if (connected) {
+		indigo_usleep(time_to_wait * ONE_SECOND_DELAY);
+		result = replay(reader, speed);
+	} else {
+		fprintf(stderr, "Connection failed: %s\n", error_message);
+		result = 1;
+	}
+	indigo_bus_trace_close(reader);
+	indigo_disconnect_server(server);
+	indigo_detach_client(&client);
+	indigo_stop();
+	return result;
+}
@@ -0,0 +1,250 @@
+// Copyright (c) 2026 agent
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by agent <agent@local>
+
+// INDIGO XML parser throughput benchmark
+//
+// Feeds server -> client protocol traffic through a pipe into indigo_xml_parse() exactly as a remote
+// server connection does and reports parser throughput. The traffic is either a capture (e.g. recorded with
+// "socat -r capture.xml TCP-LISTEN:7625 TCP:localhost:7624" or taken from an INDI server) or is synthesised.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_io.h>
+#include <indigo/indigo_xml.h>
+#include <indigo/indigo_base64.h>
+#include <indigo/indigo_client_xml.h>
+
+static unsigned long defined = 0, updated = 0, deleted = 0, messages = 0;
+
+static indigo_result client_define_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	__atomic_add_fetch(&defined, 1, __ATOMIC_RELAXED);
+	return INDIGO_OK;
+}
+
+static indigo_result client_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	__atomic_add_fetch(&updated, 1, __ATOMIC_RELAXED);
+	return INDIGO_OK;
+}
+
+static indigo_result client_delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	__atomic_add_fetch(&deleted, 1, __ATOMIC_RELAXED);
+	return INDIGO_OK;
+}
+
+static indigo_result client_send_message(indigo_client *client, indigo_device *device, const char *message) {
+	__atomic_add_fetch(&messages, 1, __ATOMIC_RELAXED);
+	return INDIGO_OK;
+}
+
+static indigo_client client = {
+	"indigo_xml_bench", false, NULL, INDIGO_OK, INDIGO_VERSION_CURRENT, NULL,
+	NULL,
+	client_define_property,
+	client_update_property,
+	client_delete_property,
+	client_send_message,
+	NULL
+};
+
+typedef struct {
+	int handle;
+	char *data;
+	size_t size;
+	int repeat;
+} feeder_context;
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *feeder(void *arg) {
+	feeder_context *context = arg;
+	for (int i = 0; i < context->repeat; i++) {
+		if (!indigo_write(context->handle, context->data, context->size))
+			break;
+	}
+	close(context->handle);
+	return NULL;
+}
+
+static void append(char **data, size_t *size, size_t *allocated, const char *format, ...) {
+	va_list args;
+	while (true) {
+		va_start(args, format);
+		int length = vsnprintf(*data + *size, *allocated - *size, format, args);
+		va_end(args);
+		if (*size + length < *allocated) {
+			*size += length;
+			return;
+		}
+		*allocated = 2 * (*allocated) + length;
+		*data = indigo_safe_realloc(*data, *allocated);
+	}
+}
+
+// Typical session: a few devices are defined and then the traffic is dominated by number vector updates
+// (coordinates, exposure countdown, temperatures), status messages and an occasional BLOB.
+
+static char *synthesize(int updates, int blob_size, size_t *size) {
+	size_t allocated = 1024 * 1024;
+	char *data = indigo_safe_malloc(allocated);
+	*size = 0;
+	append(&data, size, &allocated, "<defSwitchVector device='Mount Bench' name='CONNECTION' group='Main' label='Connection status' perm='rw' state='Ok' rule='OneOfMany' hints='order: 0; widget: button;'>\n<defSwitch name='CONNECTED' label='Connected'>On</defSwitch>\n<defSwitch name='DISCONNECTED' label='Disconnected'>Off</defSwitch>\n</defSwitchVector>\n");
+	append(&data, size, &allocated, "<defNumberVector device='Mount Bench' name='MOUNT_EQUATORIAL_COORDINATES' group='Main' label='Equatorial EOD coordinates' perm='rw' state='Ok'>\n<defNumber name='RA' label='Right ascension (0 to 24 hrs)' min='0' max='24' step='0' format='%%12.9m' target='5.5'>5.5</defNumber>\n<defNumber name='DEC' label='Declination (-180 to 180\xc2\xb0)' min='-180' max='180' step='0' format='%%12.9m' target='-5.25'>-5.25</defNumber>\n</defNumberVector>\n");
+	append(&data, size, &allocated, "<defTextVector device='Mount Bench' name='INFO' group='General' label='Info' perm='ro' state='Idle'>\n<defText name='DEVICE_DRIVER' label='Driver'>indigo_mount_bench</defText>\n<defText name='DEVICE_VERSION' label='Version'>2.0.0</defText>\n<defText name='DEVICE_NAME' label='Name'>Mount &amp; &quot;Bench&quot;</defText>\n</defTextVector>\n");
+	append(&data, size, &allocated, "<defNumberVector device='CCD Bench' name='CCD_EXPOSURE' group='Camera' label='Start exposure' perm='rw' state='Idle'>\n<defNumber name='EXPOSURE' label='Start exposure' min='0' max='3600' step='1' format='%%g' target='0'>0</defNumber>\n</defNumberVector>\n");
+	append(&data, size, &allocated, "<defNumberVector device='CCD Bench' name='CCD_TEMPERATURE' group='Camera' label='Sensor temperature' perm='rw' state='Ok'>\n<defNumber name='TEMPERATURE' label='Temperature (\xc2\xb0""C)' min='-50' max='50' step='1' format='%%g' target='-10'>-10</defNumber>\n</defNumberVector>\n");
+	append(&data, size, &allocated, "<defBLOBVector device='CCD Bench' name='CCD_IMAGE' group='Image' label='Image data' perm='ro' state='Idle'>\n<defBLOB name='IMAGE' label='Image'/>\n</defBLOBVector>\n");
+	char *blob = NULL;
+	if (blob_size > 0) {
+		blob = indigo_safe_malloc(4 * ((blob_size + 2) / 3) + 1);
+		char *raw = indigo_safe_malloc(blob_size);
+		for (int i = 0; i < blob_size; i++)
+			raw[i] = (char)(i * 7);
+		base64_encode((unsigned char *)blob, (unsigned char *)raw, blob_size);
+		free(raw);
+	}
+	for (int i = 0; i < updates; i++) {
+		append(&data, size, &allocated, "<setNumberVector device='Mount Bench' name='MOUNT_EQUATORIAL_COORDINATES' state='Busy'>\n<oneNumber name='RA' target='5.5'>%.9f</oneNumber>\n<oneNumber name='DEC' target='-5.25'>%.9f</oneNumber>\n</setNumberVector>\n", 5.5 + i * 1e-5, -5.25 - i * 1e-5);
+		if (i % 4 == 0)
+			append(&data, size, &allocated, "<setNumberVector device='CCD Bench' name='CCD_EXPOSURE' state='Busy'>\n<oneNumber name='EXPOSURE' target='%d'>%d</oneNumber>\n</setNumberVector>\n", updates - i, updates - i);
+		if (i % 16 == 0)
+			append(&data, size, &allocated, "<setNumberVector device='CCD Bench' name='CCD_TEMPERATURE' state='Busy' message='Cooling to -10 &amp; waiting'>\n<oneNumber name='TEMPERATURE' target='-10'>%.2f</oneNumber>\n</setNumberVector>\n", -10 + (i % 100) / 100.0);
+		if (i % 64 == 0)
+			append(&data, size, &allocated, "<message device='Mount Bench' message='Slewing to &lt;%d&gt;'/>\n", i);
+		if (blob && i % 1024 == 1023)
+			append(&data, size, &allocated, "<setBLOBVector device='CCD Bench' name='CCD_IMAGE' state='Ok'>\n<oneBLOB name='IMAGE' format='.raw' size='%d'>\n%s\n</oneBLOB>\n</setBLOBVector>\n", blob_size, blob);
+	}
+	indigo_safe_free(blob);
+	return data;
+}
+
+static char *load(const char *file_name, size_t *size) {
+	FILE *file = fopen(file_name, "r");
+	if (file == NULL)
+		return NULL;
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	char *data = indigo_safe_malloc(length + 1);
+	*size = fread(data, 1, length, file);
+	fclose(file);
+	return data;
+}
+
+static void print_help(const char *name) {
+	printf("INDIGO XML parser throughput benchmark v.%d.%d-%s built on %s %s.\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD, __DATE__, __TIME__);
+	printf("usage: %s [options] [capture_file]\n", name);
+	printf("options:\n"
+	       "       -h  | --help\n"
+	       "       -r  | --repeat count                (feed the traffic count times, default: 10)\n"
+	       "       -u  | --updates count               (synthetic traffic update cycles, default: 100000)\n"
+	       "       -b  | --blob-size bytes             (synthetic BLOB size, 0 = no BLOBs, default: 65536)\n"
+	       "       -v  | --enable-log\n"
+	       "       -vv | --enable-debug\n"
+	       "       -vvv| --enable-trace\n"
+	);
+}
+
+int main(int argc, const char * argv[]) {
+	indigo_main_argc = argc;
+	indigo_main_argv = argv;
+	indigo_use_host_suffix = false;
+
+	int repeat = 10;
+	int updates = 100000;
+	int blob_size = 65536;
+	const char *file_name = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if ((!strcmp(argv[i], "-r") || !strcmp(argv[i], "--repeat")) && argc > i + 1) {
+			repeat = atoi(argv[++i]);
+		} else if ((!strcmp(argv[i], "-u") || !strcmp(argv[i], "--updates")) && argc > i + 1) {
+			updates = atoi(argv[++i]);
+		} else if ((!strcmp(argv[i], "-b") || !strcmp(argv[i], "--blob-size")) && argc > i + 1) {
+			blob_size = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			print_help(argv[0]);
+			return 0;
+		} else if (argv[i][0] == '-') {
+			/* skip unknown options */
+		} else {
+			file_name = argv[i];
+		}
+	}
+	if (repeat <= 0 || updates < 0 || blob_size < 0) {
+		fprintf(stderr, "Invalid arguments\n");
+		return 1;
+	}
+
+	feeder_context context = { 0 };
+	if (file_name) {
+		context.data = load(file_name, &context.size);
+		if (context.data == NULL) {
+			fprintf(stderr, "Can't open %s: %s\n", file_name, strerror(errno));
+			return 1;
+		}
+	} else {
+		context.data = synthesize(updates, blob_size, &context.size);
+	}
+	context.repeat = repeat;
+
+	int input[2];
+	if (pipe(input) < 0) {
+		fprintf(stderr, "Can't create pipe: %s\n", strerror(errno));
+		return 1;
+	}
+	int output = open("/dev/null", O_WRONLY);
+	context.handle = input[1];
+
+	indigo_start();
+	indigo_attach_client(&client);
+	indigo_device *protocol_adapter = indigo_xml_client_adapter("bench", "", input[0], output);
+	indigo_attach_device(protocol_adapter);
+	pthread_t thread;
+	double start = now();
+	pthread_create(&thread, NULL, feeder, &context);
+	indigo_xml_parse(protocol_adapter, NULL);
+	double elapsed = now() - start;
+	pthread_join(thread, NULL);
+	indigo_detach_device(protocol_adapter);
+	free(protocol_adapter->device_context);
+	free(protocol_adapter);
+	indigo_detach_client(&client);
+	indigo_stop();
+
+	double total = (double)context.size * repeat;
+	unsigned long events = defined + updated + deleted + messages;
+	printf("Parsed %.1f MB in %.3fs: %.1f MB/s\n", total / 1e6, elapsed, elapsed > 0 ? total / 1e6 / elapsed : 0);
+	printf("%lu events (%.0f/s): %lu definitions, %lu updates, %lu deletions, %lu messages\n", events, elapsed > 0 ? events / elapsed : 0, defined, updated, deleted, messages);
+	free(context.data);
+	return 0;
+}